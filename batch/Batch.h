@@ -0,0 +1,106 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "BlueNoise.h"
+#include "EnvironmentMap.h"
+#include "MajorantGrid.h"
+#include "RenderCommon.h"
+#include "TransferFunction.h"
+#include "VolumeData.h"
+
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct BatchCamera {
+    std::string Name;
+    F32         Yaw = 0.0f;
+    F32         Pitch = 0.0f;
+    F32         Zoom = 1.0f;
+};
+
+// One entry of the "Jobs" array of a job file, angles of the cameras are given in degrees there.
+// The output path may refer to {job} and {camera}, one image is written per camera.
+struct BatchJob {
+    std::string Name;
+    std::string VolumePath;
+    std::string TransferFunctionPath = "content/TransferFunctions/ManixTransferFunction.json";
+    std::string EnvironmentPath = "content/Textures/qwantani_2k.dds";
+    std::string OutputPath = "{job}_{camera}.png";
+
+    uint32_t Width = 1280;
+    uint32_t Height = 720;
+    uint32_t SampleCount = 256;
+    F32      Density = 100.0f;
+    F32      Exposure = 12.0f;
+    F32      TileErrorThreshold = 0.15f;
+    bool     IsDenoising = false;
+
+    std::vector<BatchCamera> Cameras;
+};
+
+// Everything a job reads, held for as long as the job is queued or rendered
+struct BatchScene {
+    std::shared_ptr<VolumeData const>          Volume;
+    std::shared_ptr<TransferFunctionSet const> TransferFunctions;
+    std::shared_ptr<MajorantGrid const>        Majorants;
+    std::shared_ptr<EnvironmentMap const>      Environment;
+};
+
+// Volumes, transfer functions, environment maps and majorant grids shared by jobs with the same files.
+// Least recently used entries are released once the estimated size exceeds the budget, entries still
+// held by a queued job are kept. Not thread safe, the loader thread is the only user.
+class DatasetCache {
+public:
+    DatasetCache(size_t memoryBudget);
+
+    BatchScene Acquire(BatchJob const& job);
+
+    size_t GetMemoryUsage() const { return m_MemoryUsage; }
+
+private:
+    struct Entry {
+        std::string                 Key;
+        std::shared_ptr<void const> pData;
+        size_t                      Size;
+    };
+
+    template<typename T, typename Load>
+    std::shared_ptr<T const> FindOrLoad(std::string const& key, Load&& load);
+
+    void Evict();
+
+private:
+    std::list<Entry> m_Entries;
+    size_t           m_MemoryBudget = 0;
+    size_t           m_MemoryUsage = 0;
+};
+
+std::vector<BatchJob> LoadBatchJobs(std::string const& fileName);
+
+// 8-bit RGB PNG of a tone mapped image, the linear values are sRGB encoded as by the swap chain
+void WritePNG(std::string const& fileName, std::vector<Hawk::Math::Vec4> const& image, uint32_t width, uint32_t height);
@@ -0,0 +1,74 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Batch.h"
+
+#include <nlohmann/json.hpp>
+#include <fstream>
+
+std::vector<BatchJob> LoadBatchJobs(std::string const& fileName) {
+
+    std::ifstream file(fileName);
+    if (!file.is_open())
+        throw std::runtime_error("Failed to open file: " + fileName);
+
+    nlohmann::json root;
+    file >> root;
+
+    if (!root.contains("Jobs"))
+        throw std::runtime_error("Missing jobs in " + fileName);
+
+    std::vector<BatchJob> jobs;
+    for (auto const& e : root.at("Jobs")) {
+        BatchJob job;
+        job.Name = e.value("Name", "job" + std::to_string(std::size(jobs)));
+        if (!e.contains("Volume"))
+            throw std::runtime_error("Missing volume for " + job.Name + " in " + fileName);
+        job.VolumePath = e["Volume"].get<std::string>();
+        job.TransferFunctionPath = e.value("TransferFunction", job.TransferFunctionPath);
+        job.EnvironmentPath = e.value("Environment", job.EnvironmentPath);
+        job.OutputPath = e.value("Output", job.OutputPath);
+        job.Width = e.value("Width", job.Width);
+        job.Height = e.value("Height", job.Height);
+        job.SampleCount = e.value("Samples", job.SampleCount);
+        job.Density = e.value("Density", job.Density);
+        job.Exposure = e.value("Exposure", job.Exposure);
+        job.TileErrorThreshold = e.value("TileErrorThreshold", job.TileErrorThreshold);
+        job.IsDenoising = e.value("Denoise", job.IsDenoising);
+
+        for (auto const& c : e.value("Cameras", nlohmann::json::array())) {
+            BatchCamera camera;
+            camera.Name = c.value("Name", "camera" + std::to_string(std::size(job.Cameras)));
+            camera.Yaw = Hawk::Math::Radians(c.value("Yaw", 0.0f));
+            camera.Pitch = Hawk::Math::Radians(c.value("Pitch", 0.0f));
+            camera.Zoom = c.value("Zoom", camera.Zoom);
+            job.Cameras.push_back(camera);
+        }
+
+        if (job.Width == 0 || job.Height == 0 || job.SampleCount == 0 || std::empty(job.Cameras))
+            throw std::runtime_error("Nothing to render for " + job.Name + " in " + fileName);
+        jobs.push_back(std::move(job));
+    }
+    return jobs;
+}
@@ -0,0 +1,127 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Batch.h"
+
+#include <algorithm>
+#include <filesystem>
+
+namespace {
+    size_t EstimateSize(VolumeData const& volume) {
+        size_t size = 0;
+        for (uint32_t mipLevel = 0; mipLevel < volume.GetMipLevelCount(); mipLevel++)
+            size += sizeof(uint16_t) * std::size(volume.GetIntensity(mipLevel));
+        return size;
+    }
+
+    // The intensity ranges and histograms are not visible, they are per cell as well
+    size_t EstimateSize(MajorantGrid const& grid) {
+        const size_t cellSize = 2 * sizeof(F32) + sizeof(MajorantGrid::Control) + 2 * sizeof(uint16_t) + MajorantGrid::HistogramBinCount * sizeof(uint16_t);
+        return cellSize * std::size(grid.GetMajorants());
+    }
+
+    size_t EstimateSize(EnvironmentMap const& environment) {
+        return sizeof(Hawk::Math::Vec3) * std::size(environment.GetTexels()) + sizeof(EnvironmentMap::AliasEntry) * std::size(environment.GetAliasTable());
+    }
+
+    size_t EstimateSize(TransferFunctionSet const&) {
+        return sizeof(TransferFunctionSet);
+    }
+
+    std::string NormalizePath(std::string const& fileName) {
+        return std::filesystem::absolute(fileName).lexically_normal().string();
+    }
+}
+
+DatasetCache::DatasetCache(size_t memoryBudget)
+    : m_MemoryBudget(memoryBudget) {
+
+}
+
+BatchScene DatasetCache::Acquire(BatchJob const& job) {
+
+    const auto volumePath = NormalizePath(job.VolumePath);
+    const auto transferFunctionPath = NormalizePath(job.TransferFunctionPath);
+
+    BatchScene scene;
+    scene.Volume = this->FindOrLoad<VolumeData>("volume:" + volumePath, [&]() {
+        auto pVolume = std::make_shared<VolumeData>();
+        pVolume->LoadFromFile(job.VolumePath);
+        return pVolume;
+    });
+
+    scene.TransferFunctions = this->FindOrLoad<TransferFunctionSet>("transfer-function:" + transferFunctionPath, [&]() {
+        auto pFunctions = std::make_shared<TransferFunctionSet>();
+        pFunctions->LoadFromFile(job.TransferFunctionPath);
+        return pFunctions;
+    });
+
+    scene.Environment = this->FindOrLoad<EnvironmentMap>("environment:" + NormalizePath(job.EnvironmentPath), [&]() {
+        auto pEnvironment = std::make_shared<EnvironmentMap>();
+        pEnvironment->LoadFromFile(job.EnvironmentPath);
+        return pEnvironment;
+    });
+
+    // The intensity ranges are computed once per volume, a new transfer function only updates a copy
+    scene.Majorants = this->FindOrLoad<MajorantGrid>("majorants:" + volumePath + "|" + transferFunctionPath, [&]() {
+        auto pRanges = this->FindOrLoad<MajorantGrid>("intensity-ranges:" + volumePath, [&]() {
+            auto pGrid = std::make_shared<MajorantGrid>();
+            pGrid->Initialize(*scene.Volume, 0);
+            return pGrid;
+        });
+        auto pGrid = std::make_shared<MajorantGrid>(*pRanges);
+        pGrid->Update(scene.TransferFunctions->Opacity, 256);
+        return pGrid;
+    });
+
+    this->Evict();
+    return scene;
+}
+
+template<typename T, typename Load>
+std::shared_ptr<T const> DatasetCache::FindOrLoad(std::string const& key, Load&& load) {
+
+    auto iterator = std::find_if(m_Entries.begin(), m_Entries.end(), [&](Entry const& entry) { return entry.Key == key; });
+    if (iterator != m_Entries.end()) {
+        m_Entries.splice(m_Entries.begin(), m_Entries, iterator);
+        return std::static_pointer_cast<T const>(m_Entries.front().pData);
+    }
+
+    std::shared_ptr<T const> pData = load();
+    const size_t size = EstimateSize(*pData);
+    m_Entries.push_front(Entry{ key, pData, size });
+    m_MemoryUsage += size;
+    return pData;
+}
+
+void DatasetCache::Evict() {
+
+    for (auto iterator = m_Entries.end(); iterator != m_Entries.begin() && m_MemoryUsage > m_MemoryBudget;) {
+        --iterator;
+        if (iterator->pData.use_count() > 1)
+            continue;
+        m_MemoryUsage -= iterator->Size;
+        iterator = m_Entries.erase(iterator);
+    }
+}
@@ -0,0 +1,131 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Batch.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+
+namespace {
+    uint32_t ComputeCRC32(uint32_t crc, uint8_t const* pData, size_t size) {
+        static const auto table = []() {
+            std::array<uint32_t, 256> table = {};
+            for (uint32_t index = 0; index < 256; index++) {
+                uint32_t value = index;
+                for (uint32_t bit = 0; bit < 8; bit++)
+                    value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+                table[index] = value;
+            }
+            return table;
+        }();
+
+        crc = ~crc;
+        for (size_t index = 0; index < size; index++)
+            crc = table[(crc ^ pData[index]) & 0xFF] ^ (crc >> 8);
+        return ~crc;
+    }
+
+    uint32_t ComputeAdler32(uint8_t const* pData, size_t size) {
+        uint32_t a = 1;
+        uint32_t b = 0;
+        for (size_t index = 0; index < size; index++) {
+            a = (a + pData[index]) % 65521;
+            b = (b + a) % 65521;
+        }
+        return (b << 16) | a;
+    }
+
+    void WriteUInt32(std::vector<uint8_t>& data, uint32_t value) {
+        data.push_back(static_cast<uint8_t>(value >> 24));
+        data.push_back(static_cast<uint8_t>(value >> 16));
+        data.push_back(static_cast<uint8_t>(value >> 8));
+        data.push_back(static_cast<uint8_t>(value));
+    }
+
+    void WriteChunk(std::ofstream& file, char const* type, std::vector<uint8_t> const& payload) {
+        std::vector<uint8_t> chunk;
+        WriteUInt32(chunk, static_cast<uint32_t>(std::size(payload)));
+        chunk.insert(chunk.end(), type, type + 4);
+        chunk.insert(chunk.end(), payload.begin(), payload.end());
+        WriteUInt32(chunk, ComputeCRC32(0, std::data(chunk) + 4, std::size(chunk) - 4));
+        file.write(reinterpret_cast<char const*>(std::data(chunk)), std::size(chunk));
+    }
+
+    uint8_t EncodeSRGB(F32 value) {
+        const F32 x = std::clamp(value, 0.0f, 1.0f);
+        const F32 encoded = x <= 0.0031308f ? 12.92f * x : 1.055f * std::pow(x, 1.0f / 2.4f) - 0.055f;
+        return static_cast<uint8_t>(std::round(255.0f * encoded));
+    }
+}
+
+void WritePNG(std::string const& fileName, std::vector<Hawk::Math::Vec4> const& image, uint32_t width, uint32_t height) {
+
+    constexpr size_t BlockSizeMax = 65535;
+
+    // Rows are prefixed with filter type 0
+    std::vector<uint8_t> scanlines;
+    scanlines.reserve(size_t(height) * (3 * size_t(width) + 1));
+    for (uint32_t y = 0; y < height; y++) {
+        scanlines.push_back(0);
+        for (uint32_t x = 0; x < width; x++) {
+            auto const& color = image[size_t(y) * width + x];
+            scanlines.push_back(EncodeSRGB(color.x));
+            scanlines.push_back(EncodeSRGB(color.y));
+            scanlines.push_back(EncodeSRGB(color.z));
+        }
+    }
+
+    // Stored deflate blocks, the images are written once and compression is left to other tools
+    std::vector<uint8_t> stream = { 0x78, 0x01 };
+    for (size_t offset = 0; offset < std::size(scanlines); offset += BlockSizeMax) {
+        const auto size = static_cast<uint16_t>(std::min(BlockSizeMax, std::size(scanlines) - offset));
+        stream.push_back(offset + size == std::size(scanlines) ? 1 : 0);
+        stream.push_back(static_cast<uint8_t>(size));
+        stream.push_back(static_cast<uint8_t>(size >> 8));
+        stream.push_back(static_cast<uint8_t>(~size));
+        stream.push_back(static_cast<uint8_t>(~size >> 8));
+        stream.insert(stream.end(), scanlines.begin() + offset, scanlines.begin() + offset + size);
+    }
+    WriteUInt32(stream, ComputeAdler32(std::data(scanlines), std::size(scanlines)));
+
+    std::vector<uint8_t> header;
+    WriteUInt32(header, width);
+    WriteUInt32(header, height);
+    header.insert(header.end(), { 8, 2, 0, 0, 0 });
+
+    std::ofstream file(fileName, std::ios::binary);
+    if (!file.is_open())
+        throw std::runtime_error("Failed to open file: " + fileName);
+
+    const uint8_t signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    file.write(reinterpret_cast<char const*>(signature), sizeof(signature));
+    WriteChunk(file, "IHDR", header);
+    WriteChunk(file, "sRGB", { 0 });
+    WriteChunk(file, "IDAT", stream);
+    WriteChunk(file, "IEND", {});
+    if (!file)
+        throw std::runtime_error("Failed to write file: " + fileName);
+}
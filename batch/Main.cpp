@@ -0,0 +1,259 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Batch.h"
+#include "RenderStatistics.h"
+#include "RendererCPU.h"
+
+#include <Hawk/Components/Camera.hpp>
+#include <fmt/format.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace {
+    struct BatchOptions {
+        std::string JobPath;
+        std::string TracePath;
+        uint32_t    ThreadCount = std::thread::hardware_concurrency();
+        size_t      CacheSize = size_t(2048) << 20;
+        uint32_t    QueueDepth = 2;
+    };
+
+    struct PreparedJob {
+        BatchJob   Job;
+        BatchScene Scene;
+    };
+
+    // Jobs whose data is loaded, the loader waits while QueueDepth of them are ahead of the renderer
+    class JobQueue {
+    public:
+        JobQueue(uint32_t depth) : m_Depth(depth) {}
+
+        void Push(PreparedJob&& job) {
+            std::unique_lock lock(m_Mutex);
+            m_ConditionPush.wait(lock, [&]() { return std::size(m_Jobs) < m_Depth; });
+            m_Jobs.push_back(std::move(job));
+            m_ConditionPop.notify_one();
+        }
+
+        void Close() {
+            std::unique_lock lock(m_Mutex);
+            m_IsClosed = true;
+            m_ConditionPop.notify_one();
+        }
+
+        std::optional<PreparedJob> Pop() {
+            std::unique_lock lock(m_Mutex);
+            m_ConditionPop.wait(lock, [&]() { return !std::empty(m_Jobs) || m_IsClosed; });
+            if (std::empty(m_Jobs))
+                return std::nullopt;
+
+            PreparedJob job = std::move(m_Jobs.front());
+            m_Jobs.pop_front();
+            m_ConditionPush.notify_one();
+            return job;
+        }
+
+    private:
+        std::mutex              m_Mutex;
+        std::condition_variable m_ConditionPush;
+        std::condition_variable m_ConditionPop;
+        std::deque<PreparedJob> m_Jobs;
+        uint32_t                m_Depth = 0;
+        bool                    m_IsClosed = false;
+    };
+
+    // Same frame setup as CreateBenchmarkFrame with the defaults of ApplicationVolumeRender
+    FrameBuffer CreateBatchFrame(BatchJob const& job, BatchScene const& scene, BlueNoise const& noise, BatchCamera const& camera, uint32_t frameIndex) {
+
+        constexpr uint32_t StepCount = 180;
+
+        Hawk::Components::Camera orbit = {};
+        orbit.Rotate(Hawk::Components::Camera::LocalUp, camera.Yaw);
+        orbit.Rotate(orbit.Right(), camera.Pitch);
+
+        const auto dimension = scene.Volume->GetDimension();
+        const auto world = ComputeWorldMatrix(dimension.x, dimension.y, dimension.z);
+
+        FrameBuffer frame = {};
+        SetFrameMatrices(frame, world, orbit.ToMatrix(), ComputeProjectionMatrix(camera.Zoom, job.Width, job.Height));
+        SetFrameBoundingBox(frame, scene.Majorants->GetContentMin(), scene.Majorants->GetContentMax());
+        SetFrameClipRegion(frame, {}, Hawk::Math::Box(), Hawk::Math::Mat4x4(1.0f));
+        frame.StepSize = Hawk::Math::Distance(VolumeBoundingBoxMin, VolumeBoundingBoxMax) / StepCount;
+        SetFrameLevelOfDetail(frame, ComputeFootprintLevelOfDetail(world, dimension, camera.Zoom, job.Height), 0, scene.Majorants->GetMipLevelMax(), 1);
+        frame.Density = job.Density;
+        frame.Exposure = job.Exposure;
+        frame.TrackingMode = TrackingModeDelta;
+        frame.TransmittanceEstimator = TransmittanceEstimatorRatio;
+        frame.LightSampling = LightSamplingMIS;
+        frame.EnvironmentDimension = Hawk::Math::Vec2u(scene.Environment->GetWidth(), scene.Environment->GetHeight());
+        frame.MajorantGridDimension = scene.Majorants->GetDimension();
+        frame.FrameIndex = frameIndex;
+        frame.SampleSequence = SampleSequenceSobol;
+        frame.TileErrorThreshold = job.TileErrorThreshold;
+        frame.BlueNoiseSize = noise.GetSize();
+        frame.RenderTargetDim = Hawk::Math::Vec2(static_cast<F32>(job.Width), static_cast<F32>(job.Height));
+        frame.InvRenderTargetDim = Hawk::Math::Vec2(1.0f, 1.0f) / frame.RenderTargetDim;
+        return frame;
+    }
+
+    void RenderJob(RendererCPU& renderer, BlueNoise const& noise, PreparedJob const& prepared, Profiler* pProfiler) {
+
+        auto const& job = prepared.Job;
+        auto const& scene = prepared.Scene;
+
+        if (renderer.GetWidth() != job.Width || renderer.GetHeight() != job.Height)
+            renderer.Resize(job.Width, job.Height);
+        renderer.SetVolume(scene.Volume.get());
+        renderer.SetEnvironmentMap(scene.Environment.get());
+        renderer.SetMajorantGrid(scene.Majorants.get());
+        renderer.SetBlueNoise(&noise);
+        renderer.SetTransferFunctions(*scene.TransferFunctions, 256);
+
+        for (auto const& camera : job.Cameras) {
+            RenderStatistics statistics;
+            F64 time = 0.0;
+
+            // Only the last frame is denoised, the accumulation itself is never filtered
+            for (uint32_t frameIndex = 0; frameIndex < job.SampleCount; frameIndex++) {
+                if (pProfiler)
+                    pProfiler->BeginFrame();
+                renderer.SetDenoising(job.IsDenoising && frameIndex + 1 == job.SampleCount);
+                renderer.RenderFrame(CreateBatchFrame(job, scene, noise, camera, frameIndex));
+
+                auto const& frameStatistics = renderer.GetFrameStatistics();
+                RenderStatistics::Frame frame = {};
+                frame.FrameTime = static_cast<F32>(frameStatistics.FrameTime);
+                frame.RenderTime = static_cast<F32>(frameStatistics.FrameTime);
+                frame.SampleCount = frameStatistics.SampleCount;
+                frame.ActiveTileCount = frameStatistics.TileCount;
+                statistics.AddFrame(frame);
+                time += frameStatistics.FrameTime;
+            }
+
+            const std::filesystem::path path = fmt::format(fmt::runtime(job.OutputPath), fmt::arg("job", job.Name), fmt::arg("camera", camera.Name));
+            if (path.has_parent_path())
+                std::filesystem::create_directories(path.parent_path());
+            {
+                Profiler::Scope scope(pProfiler, "Write PNG");
+                WritePNG(path.string(), renderer.GetToneMap(), job.Width, job.Height);
+            }
+            // Percentiles over the last ValueHistory::Length frames of the camera, the throughput over all of them
+            const auto percentiles = statistics.GetRenderTimes().GetPercentiles();
+            const F64 sampleRate = time > 0.0 ? F64(statistics.GetSampleCount()) / time : 0.0;
+            fmt::print("{:<16} {:<12} {:>10.2f} s  p50 {:.2f} p95 {:.2f} p99 {:.2f} ms  {:>8.2f} Msamples/s  {}\n", job.Name, camera.Name, time,
+                1000.0f * percentiles.P50, 1000.0f * percentiles.P95, 1000.0f * percentiles.P99, 1.0e-6 * sampleRate, path.string());
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+
+    BatchOptions options;
+    bool isUsage = false;
+    for (int32_t index = 1; index < argc; index++) {
+        auto NextArgument = [&]() -> std::string {
+            if (index + 1 >= argc)
+                throw std::runtime_error(std::string("Missing value for ") + argv[index]);
+            return argv[++index];
+        };
+
+        if (!std::strcmp(argv[index], "--threads"))
+            options.ThreadCount = std::stoul(NextArgument());
+        else if (!std::strcmp(argv[index], "--cache-size"))
+            options.CacheSize = size_t(std::stoul(NextArgument())) << 20;
+        else if (!std::strcmp(argv[index], "--queue-depth"))
+            options.QueueDepth = std::max(static_cast<uint32_t>(std::stoul(NextArgument())), 1u);
+        else if (!std::strcmp(argv[index], "--trace"))
+            options.TracePath = NextArgument();
+        else if (argv[index][0] != '-' && options.JobPath.empty())
+            options.JobPath = argv[index];
+        else
+            isUsage = true;
+    }
+
+    if (isUsage || options.JobPath.empty()) {
+        fmt::print("Usage: {} <jobs.json> [--threads N] [--cache-size MB] [--queue-depth N] [--trace trace.json]\n", argv[0]);
+        return 1;
+    }
+
+    try {
+        const auto jobs = LoadBatchJobs(options.JobPath);
+
+        ThreadPool threadPool(options.ThreadCount);
+        RendererCPU renderer(threadPool);
+
+        // The trace holds the last Profiler::TraceFrameCount frames of the run
+        std::unique_ptr<Profiler> pProfiler = options.TracePath.empty() ? nullptr : std::make_unique<Profiler>();
+        renderer.SetProfiler(pProfiler.get());
+
+        BlueNoise noise;
+        noise.Initialize(BlueNoise::DefaultSize);
+
+        fmt::print("{} jobs, {} threads\n", std::size(jobs), options.ThreadCount);
+
+        // Loading overlaps rendering, memory is bounded by the queue depth and the cache budget. Everything that
+        // may throw outside of the jobs is set up before the loader starts, it is always joined.
+        JobQueue queue(options.QueueDepth);
+        std::atomic<uint32_t> failureCount = 0;
+        std::thread loader([&]() {
+            DatasetCache cache(options.CacheSize);
+            for (auto const& job : jobs) {
+                try {
+                    queue.Push(PreparedJob{ job, cache.Acquire(job) });
+                } catch (std::exception const& e) {
+                    std::cerr << job.Name << ": " << e.what() << std::endl;
+                    failureCount++;
+                }
+            }
+            queue.Close();
+        });
+
+        while (auto prepared = queue.Pop()) {
+            try {
+                RenderJob(renderer, noise, *prepared, pProfiler.get());
+            } catch (std::exception const& e) {
+                std::cerr << prepared->Job.Name << ": " << e.what() << std::endl;
+                failureCount++;
+            }
+        }
+        loader.join();
+
+        if (pProfiler)
+            pProfiler->WriteChromeTrace(options.TracePath);
+        return failureCount > 0 ? 1 : 0;
+    } catch (std::exception const& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,148 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "BlueNoise.h"
+#include "EnvironmentMap.h"
+#include "MajorantGrid.h"
+#include "RenderCommon.h"
+#include "TransferFunction.h"
+#include "VolumeData.h"
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+class RendererCPU;
+class ThreadPool;
+
+struct BenchmarkOptions {
+    std::string VolumePath = "content/Textures/manix.dat";
+    std::string EnvironmentPath = "content/Textures/qwantani_2k.dds";
+    std::string TransferFunctionPath = "content/TransferFunctions/ManixTransferFunction.json";
+    std::string Filter;
+
+    uint32_t Width = 1280;
+    uint32_t Height = 720;
+    uint32_t FrameCount = 32;
+    uint32_t ThreadCount = std::thread::hardware_concurrency();
+    uint32_t PhantomSize = 0;
+};
+
+struct BenchmarkScene {
+    VolumeData          Volume;
+    EnvironmentMap      Environment;
+    TransferFunctionSet TransferFunctions;
+    MajorantGrid        Majorants;
+    BlueNoise           Noise;
+};
+
+struct BenchmarkCamera {
+    const char* Name;
+    F32         Yaw;
+    F32         Pitch;
+    F32         Zoom;
+};
+
+// Same defaults as ApplicationVolumeRender
+struct BenchmarkRenderSettings {
+    F32      Density = 100.0f;
+    F32      Exposure = 12.0f;
+    uint32_t StepCount = 180;
+    uint32_t TrackingMode = TrackingModeDelta;
+    uint32_t TransmittanceEstimator = TransmittanceEstimatorRatio;
+    uint32_t LightSampling = LightSamplingMIS;
+    uint32_t SampleSequence = SampleSequenceSobol;
+    F32      TileErrorThreshold = 0.15f;
+    uint32_t LevelOfDetailDepthBias = 1;
+    F32      LevelOfDetailBias = 0.0f;
+    bool     IsAutomaticLevelOfDetail = true;
+    bool     IsContentBoundingBox = true;
+};
+
+void LoadBenchmarkScene(BenchmarkScene& scene, BenchmarkOptions const& options);
+
+// Synthetic CT-like phantom (soft tissue with a bone shell), used when the Manix data set is not available
+void GeneratePhantomVolume(VolumeData& volume, uint32_t size);
+
+std::vector<BenchmarkCamera> GetBenchmarkCameras();
+
+// References render this many times the frames of a measured run without adaptive sampling, so the first frames
+// they share with it don't matter
+constexpr uint32_t BenchmarkReferenceScale = 16;
+
+FrameBuffer CreateBenchmarkFrame(BenchmarkScene const& scene, BenchmarkCamera const& camera, BenchmarkRenderSettings const& settings, uint32_t width, uint32_t height, uint32_t frameIndex);
+
+std::unique_ptr<RendererCPU> CreateBenchmarkRenderer(ThreadPool& threadPool, BenchmarkScene const& scene, BenchmarkOptions const& options);
+
+// Accumulates BenchmarkReferenceScale times FrameCount frames
+void RenderReference(RendererCPU& renderer, BenchmarkScene const& scene, BenchmarkCamera const& camera, BenchmarkRenderSettings const& settings, BenchmarkOptions const& options);
+
+// Over the RGB channels of two images of the same size
+F64 ComputeRMSE(std::vector<Hawk::Math::Vec4> const& image, std::vector<Hawk::Math::Vec4> const& reference);
+
+// Mean SSIM of the luminance of two tone mapped images over 7x7 windows
+F64 ComputeSSIM(std::vector<Hawk::Math::Vec4> const& image, std::vector<Hawk::Math::Vec4> const& reference, uint32_t width, uint32_t height);
+
+void BenchmarkRendererCPU(BenchmarkScene const& scene, BenchmarkOptions const& options);
+
+void BenchmarkVolumeMarcher(BenchmarkScene const& scene, BenchmarkOptions const& options);
+
+void BenchmarkDeltaTracking(BenchmarkScene const& scene, BenchmarkOptions const& options);
+
+void BenchmarkTransmittance(BenchmarkScene const& scene, BenchmarkOptions const& options);
+
+void BenchmarkLevelOfDetail(BenchmarkScene const& scene, BenchmarkOptions const& options);
+
+void BenchmarkVolumeLayout(BenchmarkScene const& scene, BenchmarkOptions const& options);
+
+void BenchmarkLightSampling(BenchmarkScene const& scene, BenchmarkOptions const& options);
+
+void BenchmarkSampleSequence(BenchmarkScene const& scene, BenchmarkOptions const& options);
+
+void BenchmarkSchedule(BenchmarkScene const& scene, BenchmarkOptions const& options);
+
+void BenchmarkBrickSampler(BenchmarkScene const& scene, BenchmarkOptions const& options);
+
+void BenchmarkContentBounds(BenchmarkScene const& scene, BenchmarkOptions const& options);
+
+void BenchmarkClipRegion(BenchmarkScene const& scene, BenchmarkOptions const& options);
+
+void BenchmarkAdaptiveSampling(BenchmarkScene const& scene, BenchmarkOptions const& options);
+
+void BenchmarkTileScheduler(BenchmarkScene const& scene, BenchmarkOptions const& options);
+
+void BenchmarkResolutionScale(BenchmarkScene const& scene, BenchmarkOptions const& options);
+
+void BenchmarkReprojection(BenchmarkScene const& scene, BenchmarkOptions const& options);
+
+void BenchmarkDenoiser(BenchmarkScene const& scene, BenchmarkOptions const& options);
+
+void BenchmarkAutoExposure(BenchmarkScene const& scene, BenchmarkOptions const& options);
+
+void BenchmarkDynamicResolution(BenchmarkScene const& scene, BenchmarkOptions const& options);
+
+void BenchmarkOpacityIndex(BenchmarkScene const& scene, BenchmarkOptions const& options);
@@ -0,0 +1,83 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Benchmark.h"
+#include "RendererCPU.h"
+
+#include <fmt/format.h>
+
+// Time to reach the error the non-adaptive run has after FrameCount frames. The threshold of the
+// non-adaptive run is zero, so it only retires the tiles without variance, as the luminance-sum
+// heuristic retired the empty ones.
+void BenchmarkAdaptiveSampling(BenchmarkScene const& scene, BenchmarkOptions const& options) {
+
+    constexpr uint32_t FrameScale = 4;
+    constexpr F32 Thresholds[] = { 0.0f, 0.3f, 0.2f, 0.15f, 0.1f };
+
+    ThreadPool threadPool(options.ThreadCount);
+
+    const auto pRenderer = CreateBenchmarkRenderer(threadPool, scene, options);
+    RendererCPU& renderer = *pRenderer;
+
+    for (auto const& camera : GetBenchmarkCameras()) {
+        BenchmarkRenderSettings settings = {};
+        RenderReference(renderer, scene, camera, settings, options);
+        const std::vector<Hawk::Math::Vec4> reference = renderer.GetColorSum();
+
+        struct Result {
+            uint32_t FrameCount = 0;
+            uint32_t TileCount = 0;
+            uint64_t SampleCount = 0;
+            F64      Time = 0.0;
+            F64      RMSE = 0.0;
+            bool     IsConverged = false;
+        };
+
+        // Frames until the RMSE reaches the target, or FrameScale times more frames than the non-adaptive run
+        auto Measure = [&](F32 threshold, F64 targetRMSE) {
+            settings.TileErrorThreshold = threshold;
+            Result result;
+            for (uint32_t frameIndex = 0; frameIndex < FrameScale * options.FrameCount && !result.IsConverged; frameIndex++) {
+                renderer.RenderFrame(CreateBenchmarkFrame(scene, camera, settings, options.Width, options.Height, frameIndex));
+                result.FrameCount = frameIndex + 1;
+                result.TileCount = renderer.GetFrameStatistics().TileCount;
+                result.SampleCount += renderer.GetFrameStatistics().SampleCount;
+                result.Time += renderer.GetFrameStatistics().FrameTime;
+                result.RMSE = ComputeRMSE(renderer.GetColorSum(), reference);
+                result.IsConverged = targetRMSE > 0.0 ? result.RMSE <= targetRMSE : frameIndex + 1 == options.FrameCount;
+            }
+            return result;
+        };
+
+        const Result baseline = Measure(0.0f, 0.0);
+
+        fmt::print("{} (target RMSE {:.6f}, reference: {} frames)\n", camera.Name, baseline.RMSE, BenchmarkReferenceScale * options.FrameCount);
+        fmt::print("{:>10} {:>8} {:>12} {:>12} {:>10} {:>12} {:>9}\n", "threshold", "frames", "last tiles", "samples", "ms", "RMSE", "speedup");
+        for (F32 threshold : Thresholds) {
+            const Result result = threshold > 0.0f ? Measure(threshold, baseline.RMSE) : baseline;
+            fmt::print("{:>10.3f} {:>8} {:>12} {:>12} {:>10.1f} {:>12.6f} {:>9}\n", threshold, result.FrameCount, result.TileCount, result.SampleCount, 1000.0 * result.Time, result.RMSE,
+                result.IsConverged ? fmt::format("{:.2f}x", baseline.Time / result.Time) : "-");
+        }
+    }
+}
@@ -0,0 +1,130 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "AutoExposure.h"
+#include "Benchmark.h"
+#include "RendererCPU.h"
+
+#include <fmt/format.h>
+
+#include <chrono>
+#include <numeric>
+
+void BenchmarkAutoExposure(BenchmarkScene const& scene, BenchmarkOptions const& options) {
+
+    constexpr uint32_t Width = 3840;
+    constexpr uint32_t Height = 2160;
+    constexpr uint32_t TileSize = RendererCPU::TileSize;
+    constexpr uint32_t RepeatCount = 8;
+
+    ThreadPool threadPool(options.ThreadCount);
+
+    const auto pRenderer = CreateBenchmarkRenderer(threadPool, scene, options);
+    RendererCPU& renderer = *pRenderer;
+    renderer.SetAutoExposure(true);
+
+    BenchmarkRenderSettings settings = {};
+    AutoExposure::Desc desc = {};
+
+    // The renderer adapts over the first frames, the table shows where it settles per camera
+    fmt::print("{:<10} {:>10} {:>10} {:>12} {:>14}\n", "camera", "key", "exposure", "frame, ms", "exposure, ms");
+    std::vector<Hawk::Math::Vec4> image;
+    for (auto const& camera : GetBenchmarkCameras()) {
+        F64 frameTime = 0.0;
+        F64 exposureTime = 0.0;
+        for (uint32_t frameIndex = 0; frameIndex < options.FrameCount; frameIndex++) {
+            renderer.RenderFrame(CreateBenchmarkFrame(scene, camera, settings, options.Width, options.Height, frameIndex));
+            frameTime += renderer.GetFrameStatistics().FrameTime;
+            exposureTime += renderer.GetFrameStatistics().ExposureTime;
+        }
+        fmt::print("{:<10} {:>10.4f} {:>10.2f} {:>12.2f} {:>14.3f}\n", camera.Name, renderer.GetAutoExposure().GetKey(), renderer.GetExposure(),
+            1000.0 * frameTime / options.FrameCount, 1000.0 * exposureTime / options.FrameCount);
+        if (std::empty(image))
+            image = renderer.GetColorSum();
+    }
+
+    // The histogram is timed on a 4K upscale of the first image
+    std::vector<Hawk::Math::Vec4> imageUHD(size_t(Width) * Height);
+    for (uint32_t y = 0; y < Height; y++)
+        for (uint32_t x = 0; x < Width; x++)
+            imageUHD[size_t(y) * Width + x] = image[size_t(y * options.Height / Height) * options.Width + x * options.Width / Width];
+
+    const uint32_t tilesX = (Width + TileSize - 1) / TileSize;
+    const uint32_t tilesY = (Height + TileSize - 1) / TileSize;
+
+    AutoExposure autoExposure(threadPool);
+    autoExposure.SetDesc(desc);
+    autoExposure.Resize(tilesX * tilesY);
+
+    auto Time = [&](auto&& function) {
+        F64 timeMin = std::numeric_limits<F64>::max();
+        for (uint32_t repeat = 0; repeat < RepeatCount; repeat++) {
+            const auto timeStart = std::chrono::high_resolution_clock::now();
+            function();
+            timeMin = std::min(timeMin, std::chrono::duration<F64>(std::chrono::high_resolution_clock::now() - timeStart).count());
+        }
+        return timeMin;
+    };
+
+    // Every step-th tile is active, as after the tiles of the converged regions have retired
+    auto MeasureHistogram = [&](uint32_t step) {
+        std::vector<uint32_t> tiles;
+        for (uint32_t index = 0; index < tilesX * tilesY; index += step)
+            tiles.push_back(index);
+
+        return Time([&] {
+            threadPool.ParallelFor(static_cast<uint32_t>(std::size(tiles)), [&](uint32_t index, uint32_t threadID) {
+                const uint32_t x0 = (tiles[index] % tilesX) * TileSize;
+                const uint32_t y0 = (tiles[index] / tilesX) * TileSize;
+                autoExposure.UpdateTile(tiles[index], threadID, imageUHD, Width, x0, y0, std::min(x0 + TileSize, Width), std::min(y0 + TileSize, Height));
+            });
+            autoExposure.Update(0.0f);
+        });
+    };
+
+    // Reference key from the sorted log luminances of the sampled pixels
+    F64 logKeySorted = 0.0;
+    const F64 timeSort = Time([&] {
+        std::vector<F32> values;
+        values.reserve(std::size(imageUHD));
+        for (auto const& color : imageUHD)
+            if (const F32 luminance = 0.2126f * color.x + 0.7152f * color.y + 0.0722f * color.z; color.w > 0.0f && luminance >= std::exp2(F32(AutoExposure::LogLuminanceMin)))
+                values.push_back(std::log2(luminance));
+        std::sort(values.begin(), values.end());
+
+        const size_t first = static_cast<size_t>(desc.PercentileLow * std::size(values));
+        const size_t last = static_cast<size_t>(desc.PercentileHigh * std::size(values));
+        logKeySorted = std::accumulate(values.begin() + first, values.begin() + last, 0.0) / F64(last - first);
+    });
+
+    fmt::print("\n{}x{}, {} tiles, {} threads\n", Width, Height, tilesX * tilesY, threadPool.GetThreadCount());
+    fmt::print("{:<20} {:>10} {:>12}\n", "method", "time, ms", "log2 key");
+    for (uint32_t step : { 1u, 4u, 20u }) {
+        autoExposure.Resize(tilesX * tilesY);
+        MeasureHistogram(1);
+        const F64 time = MeasureHistogram(step);
+        fmt::print("{:<20} {:>10.3f} {:>12.4f}\n", fmt::format("histogram {}% tiles", 100 / step), 1000.0 * time, std::log2(autoExposure.GetKey()));
+    }
+    fmt::print("{:<20} {:>10.3f} {:>12.4f}\n", "sort", 1000.0 * timeSort, logKeySorted);
+}
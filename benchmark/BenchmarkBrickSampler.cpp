@@ -0,0 +1,144 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Benchmark.h"
+#include "BrickPool.h"
+
+#include <fmt/format.h>
+
+#include <chrono>
+#include <random>
+
+namespace {
+    using SampleArray = std::vector<F32, PageAlignedAllocator<F32>>;
+
+    // Texture coordinates in structure of arrays order, the count is a multiple of eight
+    struct SampleSet {
+        const char* Name;
+        SampleArray X;
+        SampleArray Y;
+        SampleArray Z;
+
+        void Push(Hawk::Math::Vec3 const& texcoord) {
+            X.push_back(texcoord.x);
+            Y.push_back(texcoord.y);
+            Z.push_back(texcoord.z);
+        }
+    };
+
+    // Coherent: half-voxel steps along a 64x64 grid of oblique rays in marching order. Random: uniform
+    // positions over the volume, the same number of samples.
+    std::vector<SampleSet> GenerateSampleSets(Hawk::Math::Vec3u const& dimension) {
+
+        constexpr uint32_t GridSize = 64;
+
+        std::mt19937 generator(11);
+        std::uniform_real_distribution<F32> distribution(0.0f, 1.0f);
+
+        const F32 step = 0.5f / (std::max)({ dimension.x, dimension.y, dimension.z });
+        const Hawk::Math::Vec3 direction = Hawk::Math::Normalize(Hawk::Math::Vec3(0.3f, 0.2f, 1.0f));
+
+        std::vector<SampleSet> sampleSets;
+        auto& coherent = sampleSets.emplace_back(SampleSet{ "coherent" });
+        for (uint32_t v = 0; v < GridSize; v++) {
+            for (uint32_t u = 0; u < GridSize; u++) {
+                const Hawk::Math::Vec3 origin = Hawk::Math::Vec3((u + distribution(generator)) / GridSize, (v + distribution(generator)) / GridSize, 0.0f);
+                const Shading::Intersection intersect = Shading::IntersectAABB({ origin, direction, 0.0f, 0.0f }, { Hawk::Math::Vec3(0.0f, 0.0f, 0.0f), Hawk::Math::Vec3(1.0f, 1.0f, 1.0f) });
+                for (F32 t = 0.0f; t < intersect.Max; t += step)
+                    coherent.Push(origin + t * direction);
+            }
+        }
+        while (std::size(coherent.X) % 8)
+            coherent.Push(Hawk::Math::Vec3(0.5f, 0.5f, 0.5f));
+
+        const size_t sampleCount = std::size(coherent.X);
+        auto& random = sampleSets.emplace_back(SampleSet{ "random" });
+        for (size_t index = 0; index < sampleCount; index++)
+            random.Push(Hawk::Math::Vec3(distribution(generator), distribution(generator), distribution(generator)));
+        return sampleSets;
+    }
+
+    struct SamplerResult {
+        F64 Time;
+        F64 ErrorMax;
+    };
+
+    template<typename Sample>
+    SamplerResult RunSampler(SampleSet const& sampleSet, std::vector<F32> const& reference, Sample&& sample) {
+
+        std::vector<F32, PageAlignedAllocator<F32>> intensity(std::size(sampleSet.X));
+
+        const auto timeStart = std::chrono::high_resolution_clock::now();
+        for (size_t index = 0; index < std::size(intensity); index += 8)
+            sample(index, std::data(intensity) + index);
+        const F64 time = std::chrono::duration<F64>(std::chrono::high_resolution_clock::now() - timeStart).count();
+
+        F64 errorMax = 0.0;
+        for (size_t index = 0; index < std::size(intensity); index++)
+            errorMax = std::max(errorMax, F64(std::abs(intensity[index] - reference[index])));
+        return { time, errorMax };
+    }
+}
+
+void BenchmarkBrickSampler(BenchmarkScene const& scene, BenchmarkOptions const& options) {
+
+    BrickPool pool;
+    pool.Initialize(scene.Volume);
+
+    const auto dimension = scene.Volume.GetDimension();
+    const auto brickDimension = pool.GetBrickDimension();
+    fmt::print("Single thread, {}x{}x{} bricks of {}^3, {} stored, {:.1f} MiB (volume {:.1f} MiB)\n",
+        brickDimension.x, brickDimension.y, brickDimension.z, BrickPool::BrickSize, pool.GetBrickCount() - 1,
+        pool.GetMemorySize() / 1048576.0, sizeof(uint16_t) * std::size(scene.Volume.GetIntensity()) / 1048576.0);
+    fmt::print("{:<10} {:<14} {:>12} {:>14} {:>12}\n", "access", "sampler", "ns/sample", "Msamples/s", "max error");
+
+    for (auto const& sampleSet : GenerateSampleSets(dimension)) {
+        const size_t sampleCount = std::size(sampleSet.X);
+
+        std::vector<F32> reference(sampleCount);
+        for (size_t index = 0; index < sampleCount; index++)
+            reference[index] = scene.Volume.SampleIntensity(Hawk::Math::Vec3(sampleSet.X[index], sampleSet.Y[index], sampleSet.Z[index]));
+
+        const SamplerResult results[] = {
+            RunSampler(sampleSet, reference, [&](size_t first, F32* pIntensity) {
+                for (size_t lane = 0; lane < 8; lane++)
+                    pIntensity[lane] = scene.Volume.SampleIntensity(Hawk::Math::Vec3(sampleSet.X[first + lane], sampleSet.Y[first + lane], sampleSet.Z[first + lane]));
+            }),
+            RunSampler(sampleSet, reference, [&](size_t first, F32* pIntensity) {
+                for (size_t lane = 0; lane < 8; lane++)
+                    pIntensity[lane] = pool.SampleIntensity(Hawk::Math::Vec3(sampleSet.X[first + lane], sampleSet.Y[first + lane], sampleSet.Z[first + lane]));
+            }),
+            RunSampler(sampleSet, reference, [&](size_t first, F32* pIntensity) {
+                pool.SampleIntensity8(std::data(sampleSet.X) + first, std::data(sampleSet.Y) + first, std::data(sampleSet.Z) + first, pIntensity);
+            })
+        };
+        const char* names[] = { "volume", "brick", "brick x8" };
+
+        for (size_t index = 0; index < std::size(results); index++) {
+            auto const& result = results[index];
+            fmt::print("{:<10} {:<14} {:>12.2f} {:>14.1f} {:>12.2e}\n", sampleSet.Name, names[index],
+                1.0e9 * result.Time / sampleCount, 1.0e-6 * sampleCount / result.Time, result.ErrorMax);
+        }
+    }
+}
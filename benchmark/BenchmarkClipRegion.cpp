@@ -0,0 +1,148 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Benchmark.h"
+#include "ThreadPool.h"
+#include "VolumeMarcher.h"
+
+#include <fmt/format.h>
+
+#include <chrono>
+
+// Ray marching of the primary rays through a clip region: the intervals are clipped analytically once per ray
+// and the macrocells outside of the region are culled from the majorant grid, shrinking the content bounds.
+void BenchmarkClipRegion(BenchmarkScene const& scene, BenchmarkOptions const& options) {
+
+    struct ClipConfiguration {
+        const char*                    Name;
+        std::vector<Hawk::Math::Plane> Planes;
+        Hawk::Math::Box                CropBox;
+        Hawk::Math::Mat4x4             CropBoxTransform;
+    };
+
+    const ClipConfiguration configurations[] = {
+        { "none", {}, Hawk::Math::Box(), Hawk::Math::Mat4x4(1.0f) },
+        { "half", { Hawk::Math::Plane(1.0f, 0.0f, 0.0f, 0.0f) }, Hawk::Math::Box(), Hawk::Math::Mat4x4(1.0f) },
+        { "wedge", { Hawk::Math::Plane(1.0f, 0.0f, 0.0f, 0.0f), Hawk::Math::Plane(0.0f, 1.0f, -1.0f, 0.0f) }, Hawk::Math::Box(), Hawk::Math::Mat4x4(1.0f) },
+        { "crop", {}, Hawk::Math::Box(Hawk::Math::Vec3(-0.2f, -0.2f, -0.2f), Hawk::Math::Vec3(0.2f, 0.2f, 0.2f)),
+            Hawk::Math::RotateY(Hawk::Math::Radians(30.0f)) * Hawk::Math::RotateX(Hawk::Math::Radians(20.0f)) }
+    };
+
+    ThreadPool threadPool(options.ThreadCount);
+
+    const auto opacity = scene.TransferFunctions.Opacity.GenerateTable(256);
+    std::vector<F32> opacityTable(std::size(opacity));
+    for (size_t index = 0; index < std::size(opacity); index++)
+        opacityTable[index] = opacity[index] / 255.0f;
+
+    const BenchmarkCamera camera = GetBenchmarkCameras()[2];
+    fmt::print("Camera {}\n", camera.Name);
+    fmt::print("{:<10} {:>12} {:>12} {:>12} {:>12}\n", "clip", "culled cells", "steps", "ms", "Mrays/s");
+
+    RayStream stream;
+    for (auto const& configuration : configurations) {
+        MajorantGrid majorants = scene.Majorants;
+
+        F64 steps = 0.0;
+        F64 time = 0.0;
+        uint64_t rayCount = 0;
+        size_t culledCount = 0;
+
+        for (uint32_t frameIndex = 0; frameIndex < options.FrameCount; frameIndex++) {
+            FrameBuffer frame = CreateBenchmarkFrame(scene, camera, BenchmarkRenderSettings{}, options.Width, options.Height, frameIndex);
+            SetFrameClipRegion(frame, configuration.Planes, configuration.CropBox, configuration.CropBoxTransform);
+
+            const Shading::ClipRegion clipRegion = Shading::GetClipRegion(frame);
+            majorants.Update(scene.TransferFunctions.Opacity, 256, clipRegion);
+            SetFrameBoundingBox(frame, majorants.GetContentMin(), majorants.GetContentMax());
+
+            culledCount = 0;
+            for (size_t index = 0; index < std::size(majorants.GetMajorants()); index++)
+                culledCount += majorants.GetMajorants()[index] == 0.0f && scene.Majorants.GetMajorants()[index] > 0.0f;
+
+            stream.Resize(size_t(options.Width) * options.Height);
+            for (uint32_t y = 0; y < options.Height; y++) {
+                for (uint32_t x = 0; x < options.Width; x++) {
+                    const size_t index = size_t(y) * options.Width + x;
+                    const Hawk::Math::Vec2u id = Hawk::Math::Vec2u(x, y);
+                    const Shading::CSampler sequence = Shading::InitSampler(frame, std::data(scene.Noise.GetTexels()), id, 0);
+                    const Shading::Ray ray = Shading::CreateCameraRay(id, Shading::SamplePixelJitter(sequence), frame.InvRenderTargetDim, frame.InvWorldViewProjectionMatrix);
+
+                    stream.OriginX[index] = ray.Origin.x;
+                    stream.OriginY[index] = ray.Origin.y;
+                    stream.OriginZ[index] = ray.Origin.z;
+                    stream.DirectionX[index] = ray.Direction.x;
+                    stream.DirectionY[index] = ray.Direction.y;
+                    stream.DirectionZ[index] = ray.Direction.z;
+                    stream.Min[index] = ray.Min;
+                    stream.Max[index] = ray.Max;
+                    stream.Threshold[index] = -std::log(1.0f - Shading::Sample1D(sequence, 2)) / frame.Density;
+                    stream.Jitter[index] = Shading::Sample1D(sequence, 3);
+                }
+            }
+
+            VolumeMarcher::Desc desc = {};
+            desc.pVolume = &scene.Volume;
+            desc.pOpacityTable = std::data(opacityTable);
+            desc.OpacityTableSize = static_cast<uint32_t>(std::size(opacityTable));
+            desc.BoundingBoxMin = frame.BoundingBoxMin;
+            desc.BoundingBoxMax = frame.BoundingBoxMax;
+            desc.ClipRegion = clipRegion;
+            desc.StepSize = frame.StepSize;
+            desc.Density = frame.Density;
+            const VolumeMarcher marcher(desc);
+
+            const auto timeStart = std::chrono::high_resolution_clock::now();
+            threadPool.ParallelFor(options.Height, [&](uint32_t row, uint32_t threadID) {
+                marcher.MarchScalar(stream, size_t(row) * options.Width, options.Width);
+            });
+            time += std::chrono::duration<F64>(std::chrono::high_resolution_clock::now() - timeStart).count();
+
+            for (size_t index = 0; index < stream.Size(); index++) {
+                const auto origin = Hawk::Math::Vec3(stream.OriginX[index], stream.OriginY[index], stream.OriginZ[index]);
+                const auto direction = Hawk::Math::Vec3(stream.DirectionX[index], stream.DirectionY[index], stream.DirectionZ[index]);
+                const Shading::Ray ray = { origin, direction, 0.0f, 0.0f };
+                const Shading::Intersection intersect = Shading::ClipRay(ray, Shading::IntersectAABB(ray, { frame.BoundingBoxMin, frame.BoundingBoxMax }), clipRegion);
+                if (intersect.Max < intersect.Min)
+                    continue;
+
+                const F32 firstT = std::max(intersect.Min, stream.Min[index]) + stream.Jitter[index] * frame.StepSize;
+                const F32 maxT = std::min(intersect.Max, stream.Max[index]);
+                if (stream.IsScattered[index]) {
+                    const auto position = Hawk::Math::Vec3(stream.PositionX[index], stream.PositionY[index], stream.PositionZ[index]);
+                    steps += std::round((Hawk::Math::Dot(position - origin, direction) - firstT) / frame.StepSize) + 1.0;
+                } else {
+                    steps += std::max(std::ceil((maxT - firstT) / frame.StepSize), 0.0f);
+                }
+            }
+            rayCount += stream.Size();
+        }
+
+        fmt::print("{:<10} {:>12} {:>12.1f} {:>12.2f} {:>12.2f}\n", configuration.Name,
+            culledCount,
+            steps / rayCount,
+            1.0e3 * time / options.FrameCount,
+            rayCount / time * 1.0e-6);
+    }
+}
@@ -0,0 +1,128 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Benchmark.h"
+#include "ThreadPool.h"
+#include "VolumeMarcher.h"
+
+#include <fmt/format.h>
+
+#include <chrono>
+
+// Ray marching of the primary rays clipped to the whole volume and to the content bounds of the transfer
+// function. Steps are the opacity lookups of the RayMarching loop, recovered from where each ray stopped.
+void BenchmarkContentBounds(BenchmarkScene const& scene, BenchmarkOptions const& options) {
+
+    ThreadPool threadPool(options.ThreadCount);
+
+    const auto opacity = scene.TransferFunctions.Opacity.GenerateTable(256);
+    std::vector<F32> opacityTable(std::size(opacity));
+    for (size_t index = 0; index < std::size(opacity); index++)
+        opacityTable[index] = opacity[index] / 255.0f;
+
+    const auto contentMin = scene.Majorants.GetContentMin();
+    const auto contentMax = scene.Majorants.GetContentMax();
+    fmt::print("Content bounds [{:.3f}, {:.3f}] x [{:.3f}, {:.3f}] x [{:.3f}, {:.3f}], {:.1f}% of the volume\n",
+        contentMin.x, contentMax.x, contentMin.y, contentMax.y, contentMin.z, contentMax.z,
+        100.0f * (contentMax.x - contentMin.x) * (contentMax.y - contentMin.y) * (contentMax.z - contentMin.z));
+    fmt::print("{:<10} {:>12} {:>12} {:>12} {:>12} {:>9}\n", "camera", "volume steps", "content steps", "volume ms", "content ms", "speedup");
+
+    RayStream stream;
+    for (auto const& camera : GetBenchmarkCameras()) {
+        F64 steps[2] = {};
+        F64 time[2] = {};
+        uint64_t rayCount = 0;
+
+        for (uint32_t frameIndex = 0; frameIndex < options.FrameCount; frameIndex++) {
+            for (uint32_t mode = 0; mode < 2; mode++) {
+                BenchmarkRenderSettings settings;
+                settings.IsContentBoundingBox = mode == 1;
+
+                const FrameBuffer frame = CreateBenchmarkFrame(scene, camera, settings, options.Width, options.Height, frameIndex);
+                stream.Resize(size_t(options.Width) * options.Height);
+                for (uint32_t y = 0; y < options.Height; y++) {
+                    for (uint32_t x = 0; x < options.Width; x++) {
+                        const size_t index = size_t(y) * options.Width + x;
+                        const Hawk::Math::Vec2u id = Hawk::Math::Vec2u(x, y);
+                        const Shading::CSampler sampler = Shading::InitSampler(frame, std::data(scene.Noise.GetTexels()), id, 0);
+                        const Shading::Ray ray = Shading::CreateCameraRay(id, Shading::SamplePixelJitter(sampler), frame.InvRenderTargetDim, frame.InvWorldViewProjectionMatrix);
+
+                        stream.OriginX[index] = ray.Origin.x;
+                        stream.OriginY[index] = ray.Origin.y;
+                        stream.OriginZ[index] = ray.Origin.z;
+                        stream.DirectionX[index] = ray.Direction.x;
+                        stream.DirectionY[index] = ray.Direction.y;
+                        stream.DirectionZ[index] = ray.Direction.z;
+                        stream.Min[index] = ray.Min;
+                        stream.Max[index] = ray.Max;
+                        stream.Threshold[index] = -std::log(1.0f - Shading::Sample1D(sampler, 2)) / frame.Density;
+                        stream.Jitter[index] = Shading::Sample1D(sampler, 3);
+                    }
+                }
+
+                VolumeMarcher::Desc desc = {};
+                desc.pVolume = &scene.Volume;
+                desc.pOpacityTable = std::data(opacityTable);
+                desc.OpacityTableSize = static_cast<uint32_t>(std::size(opacityTable));
+                desc.BoundingBoxMin = frame.BoundingBoxMin;
+                desc.BoundingBoxMax = frame.BoundingBoxMax;
+                desc.StepSize = frame.StepSize;
+                desc.Density = frame.Density;
+                const VolumeMarcher marcher(desc);
+
+                const uint32_t rowCount = options.Height;
+                const auto timeStart = std::chrono::high_resolution_clock::now();
+                threadPool.ParallelFor(rowCount, [&](uint32_t row, uint32_t threadID) {
+                    marcher.MarchScalar(stream, size_t(row) * options.Width, options.Width);
+                });
+                time[mode] += std::chrono::duration<F64>(std::chrono::high_resolution_clock::now() - timeStart).count();
+
+                for (size_t index = 0; index < stream.Size(); index++) {
+                    const auto origin = Hawk::Math::Vec3(stream.OriginX[index], stream.OriginY[index], stream.OriginZ[index]);
+                    const auto direction = Hawk::Math::Vec3(stream.DirectionX[index], stream.DirectionY[index], stream.DirectionZ[index]);
+                    const Shading::Intersection intersect = Shading::IntersectAABB({ origin, direction, 0.0f, 0.0f }, { frame.BoundingBoxMin, frame.BoundingBoxMax });
+                    if (intersect.Max < intersect.Min)
+                        continue;
+
+                    const F32 firstT = std::max(intersect.Min, stream.Min[index]) + stream.Jitter[index] * frame.StepSize;
+                    const F32 maxT = std::min(intersect.Max, stream.Max[index]);
+                    if (stream.IsScattered[index]) {
+                        const auto position = Hawk::Math::Vec3(stream.PositionX[index], stream.PositionY[index], stream.PositionZ[index]);
+                        steps[mode] += std::round((Hawk::Math::Dot(position - origin, direction) - firstT) / frame.StepSize) + 1.0;
+                    } else {
+                        steps[mode] += std::max(std::ceil((maxT - firstT) / frame.StepSize), 0.0f);
+                    }
+                }
+            }
+            rayCount += stream.Size();
+        }
+
+        fmt::print("{:<10} {:>12.1f} {:>12.1f} {:>12.2f} {:>12.2f} {:>8.2f}x\n", camera.Name,
+            steps[0] / rayCount,
+            steps[1] / rayCount,
+            1.0e3 * time[0] / options.FrameCount,
+            1.0e3 * time[1] / options.FrameCount,
+            time[0] / time[1]);
+    }
+}
@@ -0,0 +1,77 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Benchmark.h"
+#include "RendererCPU.h"
+
+#include <fmt/format.h>
+
+void BenchmarkDeltaTracking(BenchmarkScene const& scene, BenchmarkOptions const& options) {
+
+    ThreadPool threadPool(options.ThreadCount);
+
+    const auto pRenderer = CreateBenchmarkRenderer(threadPool, scene, options);
+    RendererCPU& renderer = *pRenderer;
+
+    BenchmarkRenderSettings settingsDelta = {};
+    settingsDelta.TrackingMode = TrackingModeDelta;
+    settingsDelta.TransmittanceEstimator = TransmittanceEstimatorTracking;
+
+    BenchmarkRenderSettings settingsMarching = {};
+    settingsMarching.TrackingMode = TrackingModeRayMarching;
+    settingsMarching.TransmittanceEstimator = TransmittanceEstimatorTracking;
+
+    for (auto const& camera : GetBenchmarkCameras()) {
+        RenderReference(renderer, scene, camera, settingsDelta, options);
+        const std::vector<Hawk::Math::Vec4> reference = renderer.GetColorSum();
+
+        struct Sample {
+            F64 Time;
+            F64 RMSE;
+        };
+
+        // RMSE after 1, 2, 4, ... frames against the cumulative render time
+        auto Measure = [&](BenchmarkRenderSettings const& settings) {
+            std::vector<Sample> samples;
+            F64 time = 0.0;
+            for (uint32_t frameIndex = 0; frameIndex < options.FrameCount; frameIndex++) {
+                renderer.RenderFrame(CreateBenchmarkFrame(scene, camera, settings, options.Width, options.Height, frameIndex));
+                time += renderer.GetFrameStatistics().FrameTime;
+                if (std::has_single_bit(frameIndex + 1))
+                    samples.push_back({ time, ComputeRMSE(renderer.GetColorSum(), reference) });
+            }
+            return samples;
+        };
+
+        const auto samplesMarching = Measure(settingsMarching);
+        const auto samplesDelta = Measure(settingsDelta);
+
+        fmt::print("{} (reference: {} frames of delta tracking)\n", camera.Name, BenchmarkReferenceScale * options.FrameCount);
+        fmt::print("{:>8} {:>16} {:>14} {:>16} {:>14}\n", "frames", "marching, ms", "marching RMSE", "delta, ms", "delta RMSE");
+        for (size_t index = 0; index < std::size(samplesDelta); index++)
+            fmt::print("{:>8} {:>16.1f} {:>14.6f} {:>16.1f} {:>14.6f}\n", 1u << index,
+                1000.0 * samplesMarching[index].Time, samplesMarching[index].RMSE,
+                1000.0 * samplesDelta[index].Time, samplesDelta[index].RMSE);
+    }
+}
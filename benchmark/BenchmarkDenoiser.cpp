@@ -0,0 +1,85 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Benchmark.h"
+#include "RendererCPU.h"
+
+#include <fmt/format.h>
+
+void BenchmarkDenoiser(BenchmarkScene const& scene, BenchmarkOptions const& options) {
+
+
+    ThreadPool threadPool(options.ThreadCount);
+
+    const auto pRenderer = CreateBenchmarkRenderer(threadPool, scene, options);
+    RendererCPU& renderer = *pRenderer;
+
+    BenchmarkRenderSettings settings = {};
+
+    struct Result {
+        std::vector<F64> SSIM;
+        std::vector<F64> Time;
+        F64              DenoiseTime = 0.0;
+    };
+
+    // The target is the SSIM that plain accumulation reaches after FrameCount frames, the denoised run
+    // is timed until it first gets there, denoising included
+    fmt::print("{:<10} {:<9} {:>8} {:>8} {:>8} {:>12} {:>12} {:>10}\n", "camera", "denoiser", "SSIM 1", "SSIM 4", "SSIM N", "denoise, ms", "target, ms", "speedup");
+    for (auto const& camera : GetBenchmarkCameras()) {
+        renderer.SetDenoising(false);
+        RenderReference(renderer, scene, camera, settings, options);
+        const std::vector<Hawk::Math::Vec4> reference = renderer.GetToneMap();
+
+        auto Measure = [&](bool isDenoising) -> Result {
+            renderer.SetDenoising(isDenoising);
+
+            Result result;
+            F64 time = 0.0;
+            for (uint32_t frameIndex = 0; frameIndex < options.FrameCount; frameIndex++) {
+                renderer.RenderFrame(CreateBenchmarkFrame(scene, camera, settings, options.Width, options.Height, frameIndex));
+                time += renderer.GetFrameStatistics().FrameTime;
+                result.DenoiseTime += renderer.GetFrameStatistics().DenoiseTime;
+                result.SSIM.push_back(ComputeSSIM(renderer.GetToneMap(), reference, options.Width, options.Height));
+                result.Time.push_back(time);
+            }
+            result.DenoiseTime /= options.FrameCount;
+            return result;
+        };
+
+        const Result resultPlain = Measure(false);
+        const Result resultDenoised = Measure(true);
+
+        const F64 target = resultPlain.SSIM.back();
+        for (auto const* pResult : { &resultPlain, &resultDenoised }) {
+            const auto iterator = std::find_if(pResult->SSIM.begin(), pResult->SSIM.end(), [&](F64 value) { return value >= target; });
+            const F64 targetTime = iterator != pResult->SSIM.end() ? pResult->Time[iterator - pResult->SSIM.begin()] : 0.0;
+
+            fmt::print("{:<10} {:<9} {:>8.4f} {:>8.4f} {:>8.4f} {:>12.2f} {:>12} {:>10}\n", camera.Name, pResult == &resultDenoised ? "a-trous" : "none",
+                pResult->SSIM[0], pResult->SSIM[std::min<size_t>(3, std::size(pResult->SSIM) - 1)], pResult->SSIM.back(),
+                1000.0 * pResult->DenoiseTime,
+                targetTime > 0.0 ? fmt::format("{:.2f}", 1000.0 * targetTime) : "-",
+                targetTime > 0.0 ? fmt::format("{:.2f}x", resultPlain.Time.back() / targetTime) : "-");
+        }
+    }
+}
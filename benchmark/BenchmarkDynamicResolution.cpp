@@ -0,0 +1,90 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Benchmark.h"
+#include "RendererCPU.h"
+#include "ResolutionController.h"
+
+#include <fmt/format.h>
+
+void BenchmarkDynamicResolution(BenchmarkScene const& scene, BenchmarkOptions const& options) {
+
+    ThreadPool threadPool(options.ThreadCount);
+
+    const auto pRenderer = CreateBenchmarkRenderer(threadPool, scene, options);
+    RendererCPU& renderer = *pRenderer;
+
+    BenchmarkRenderSettings settings = {};
+
+    // The camera stays still, so the accumulation only restarts when the controller changes the scale. The frame
+    // time is measured over the second half of the frames, once the controller has settled.
+    fmt::print("{:<10} {:>10} {:>12} {:>8} {:>10} {:>12} {:>10} {:>8}\n", "camera", "target, ms", "full, ms", "scale", "size", "frame, ms", "deviation", "resets");
+    for (auto const& camera : GetBenchmarkCameras()) {
+        renderer.Resize(options.Width, options.Height);
+        F64 timeFull = 0.0;
+        for (uint32_t frameIndex = 0; frameIndex < 4; frameIndex++) {
+            renderer.RenderFrame(CreateBenchmarkFrame(scene, camera, settings, options.Width, options.Height, frameIndex));
+            timeFull += renderer.GetFrameStatistics().FrameTime / 4.0;
+        }
+
+        for (F32 target : { 16.7f, 33.3f }) {
+            ResolutionController::Desc desc = {};
+            desc.FrameTimeTarget = 1.0e-3f * target;
+
+            ResolutionController controller;
+            controller.SetDesc(desc);
+
+            Hawk::Math::Vec2u dimension = Hawk::Math::Vec2u(options.Width, options.Height);
+            renderer.Resize(dimension.x, dimension.y);
+
+            uint32_t frameIndex = 0;
+            uint32_t resetCount = 0;
+            F64 timeSum = 0.0;
+            F64 timeSquaredSum = 0.0;
+            uint32_t timeCount = 0;
+            for (uint32_t frame = 0; frame < options.FrameCount; frame++) {
+                renderer.RenderFrame(CreateBenchmarkFrame(scene, camera, settings, dimension.x, dimension.y, frameIndex++));
+
+                const F64 time = renderer.GetFrameStatistics().FrameTime;
+                if (frame >= options.FrameCount / 2) {
+                    timeSum += time;
+                    timeSquaredSum += time * time;
+                    timeCount++;
+                }
+
+                if (controller.Update(static_cast<F32>(time), F32(dimension.x) / options.Width)) {
+                    dimension = ResolutionController::GetRenderDimension(options.Width, options.Height, controller.GetScale());
+                    renderer.Resize(dimension.x, dimension.y);
+                    frameIndex = 0;
+                    resetCount++;
+                }
+            }
+
+            const F64 timeMean = timeSum / std::max(timeCount, 1u);
+            const F64 timeDeviation = std::sqrt(std::max(timeSquaredSum / std::max(timeCount, 1u) - timeMean * timeMean, 0.0));
+            fmt::print("{:<10} {:>10.1f} {:>12.2f} {:>8.3f} {:>10} {:>12.2f} {:>9.1f}% {:>8}\n", camera.Name, target, 1000.0 * timeFull,
+                controller.GetScale(), fmt::format("{}x{}", dimension.x, dimension.y), 1000.0 * timeMean, 100.0 * timeDeviation / timeMean, resetCount);
+        }
+    }
+}
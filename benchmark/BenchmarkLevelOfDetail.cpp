@@ -0,0 +1,78 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Benchmark.h"
+#include "RendererCPU.h"
+
+#include <fmt/format.h>
+
+void BenchmarkLevelOfDetail(BenchmarkScene const& scene, BenchmarkOptions const& options) {
+
+    ThreadPool threadPool(options.ThreadCount);
+
+    const auto pRenderer = CreateBenchmarkRenderer(threadPool, scene, options);
+    RendererCPU& renderer = *pRenderer;
+
+    struct Result {
+        F64 FrameTime;
+        F64 RMSE;
+    };
+
+    fmt::print("{:>6} {:<9} {:>6} {:>12} {:>12} {:>9} {:>12} {:>12}\n", "zoom", "tracking", "LOD", "fixed, ms", "auto, ms", "speedup", "fixed RMSE", "auto RMSE");
+    for (F32 zoom : { 1.0f, 2.0f, 4.0f, 8.0f }) {
+        const BenchmarkCamera camera = { "front", 0.0f, 0.0f, zoom };
+
+        for (uint32_t trackingMode : { uint32_t(TrackingModeRayMarching), uint32_t(TrackingModeDelta) }) {
+            BenchmarkRenderSettings settingsFixed = {};
+            settingsFixed.TrackingMode = trackingMode;
+            settingsFixed.IsAutomaticLevelOfDetail = false;
+
+            BenchmarkRenderSettings settingsAuto = settingsFixed;
+            settingsAuto.IsAutomaticLevelOfDetail = true;
+
+            // The reference is the fixed level path, so the automatic level error includes the filtering bias
+            RenderReference(renderer, scene, camera, settingsFixed, options);
+            const std::vector<Hawk::Math::Vec4> reference = renderer.GetColorSum();
+
+            auto Measure = [&](BenchmarkRenderSettings const& settings) -> Result {
+                F64 time = 0.0;
+                for (uint32_t frameIndex = 0; frameIndex < options.FrameCount; frameIndex++) {
+                    renderer.RenderFrame(CreateBenchmarkFrame(scene, camera, settings, options.Width, options.Height, frameIndex));
+                    time += renderer.GetFrameStatistics().FrameTime;
+                }
+                return { time / options.FrameCount, ComputeRMSE(renderer.GetColorSum(), reference) };
+            };
+
+            const Result resultFixed = Measure(settingsFixed);
+            const Result resultAuto = Measure(settingsAuto);
+
+            const FrameBuffer frame = CreateBenchmarkFrame(scene, camera, settingsAuto, options.Width, options.Height, 0);
+            fmt::print("{:>6.1f} {:<9} {:>6} {:>12.2f} {:>12.2f} {:>8.2f}x {:>12.6f} {:>12.6f}\n", zoom,
+                trackingMode == TrackingModeDelta ? "delta" : "marching",
+                fmt::format("{}/{}", Shading::GetLevelOfDetail(frame, 0), Shading::GetLevelOfDetail(frame, 1)),
+                1000.0 * resultFixed.FrameTime, 1000.0 * resultAuto.FrameTime, resultFixed.FrameTime / resultAuto.FrameTime,
+                resultFixed.RMSE, resultAuto.RMSE);
+        }
+    }
+}
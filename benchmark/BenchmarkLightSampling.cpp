@@ -0,0 +1,98 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Benchmark.h"
+#include "RendererCPU.h"
+
+#include <fmt/format.h>
+
+void BenchmarkLightSampling(BenchmarkScene const& scene, BenchmarkOptions const& options) {
+
+    ThreadPool threadPool(options.ThreadCount);
+
+    const auto pRenderer = CreateBenchmarkRenderer(threadPool, scene, options);
+    RendererCPU& renderer = *pRenderer;
+
+    struct Technique {
+        const char* Name;
+        uint32_t    Value;
+    };
+
+    const Technique techniques[] = {
+        { "bsdf", LightSamplingBSDF },
+        { "mis", LightSamplingMIS }
+    };
+
+    struct Sample {
+        F64 Time;
+        F64 RMSE;
+    };
+
+    for (auto const& camera : GetBenchmarkCameras()) {
+        BenchmarkRenderSettings settings = {};
+        settings.LightSampling = LightSamplingMIS;
+        RenderReference(renderer, scene, camera, settings, options);
+        const std::vector<Hawk::Math::Vec4> reference = renderer.GetColorSum();
+
+        // RMSE after 1, 2, 4, ... frames against the cumulative render time
+        std::vector<std::vector<Sample>> samples;
+        for (auto const& technique : techniques) {
+            settings.LightSampling = technique.Value;
+            auto& techniqueSamples = samples.emplace_back();
+
+            F64 time = 0.0;
+            for (uint32_t frameIndex = 0; frameIndex < options.FrameCount; frameIndex++) {
+                renderer.RenderFrame(CreateBenchmarkFrame(scene, camera, settings, options.Width, options.Height, frameIndex));
+                time += renderer.GetFrameStatistics().FrameTime;
+                if (std::has_single_bit(frameIndex + 1))
+                    techniqueSamples.push_back({ time, ComputeRMSE(renderer.GetColorSum(), reference) });
+            }
+        }
+
+        fmt::print("{} (reference: {} frames of MIS)\n", camera.Name, BenchmarkReferenceScale * options.FrameCount);
+        fmt::print("{:>8}", "frames");
+        for (auto const& technique : techniques)
+            fmt::print(" {:>14} {:>14}", fmt::format("{}, ms", technique.Name), fmt::format("{} RMSE", technique.Name));
+        fmt::print("\n");
+
+        for (size_t index = 0; index < std::size(samples[0]); index++) {
+            fmt::print("{:>8}", 1u << index);
+            for (auto const& techniqueSamples : samples)
+                fmt::print(" {:>14.1f} {:>14.6f}", 1000.0 * techniqueSamples[index].Time, techniqueSamples[index].RMSE);
+            fmt::print("\n");
+        }
+
+        // Frames and time each technique needs to get at least as low as BSDF sampling after all of its frames
+        const F64 target = samples[0].back().RMSE;
+        fmt::print("{:>8}", "target");
+        for (auto const& techniqueSamples : samples) {
+            auto iterator = std::find_if(techniqueSamples.begin(), techniqueSamples.end(), [&](Sample const& sample) { return sample.RMSE <= target; });
+            if (iterator != techniqueSamples.end())
+                fmt::print(" {:>14} {:>14.6f}", fmt::format("{:.1f} ({}f)", 1000.0 * iterator->Time, 1u << (iterator - techniqueSamples.begin())), iterator->RMSE);
+            else
+                fmt::print(" {:>14} {:>14}", "-", "-");
+        }
+        fmt::print("\n");
+    }
+}
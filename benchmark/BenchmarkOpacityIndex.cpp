@@ -0,0 +1,83 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Benchmark.h"
+
+#include <fmt/format.h>
+
+#include <chrono>
+#include <random>
+
+// Rebuild of the visible intensity intervals of the opacity transfer function, and of the majorant grid that rejects
+// the cells outside of them, as on every edit of the transfer function.
+void BenchmarkOpacityIndex(BenchmarkScene const& scene, BenchmarkOptions const& options) {
+
+    constexpr uint32_t BuildCount = 1024;
+    constexpr uint32_t UpdateCount = 16;
+    constexpr uint32_t QueryCount = 1 << 20;
+
+    auto const& opacity = scene.TransferFunctions.Opacity;
+
+    OpacityIntervalIndex index;
+    auto timeStart = std::chrono::high_resolution_clock::now();
+    for (uint32_t iteration = 0; iteration < BuildCount; iteration++)
+        index.Build(opacity.PLF);
+    const F64 buildTime = std::chrono::duration<F64>(std::chrono::high_resolution_clock::now() - timeStart).count() / BuildCount;
+
+    // Intensity ranges from a few voxels of one material to a cell across several of them
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<F32> distributionCenter(0.0f, 1.0f);
+    std::uniform_real_distribution<F32> distributionWidth(0.0f, 0.05f);
+    std::vector<Hawk::Math::Vec2> ranges(QueryCount);
+    for (auto& range : ranges) {
+        const F32 center = distributionCenter(generator);
+        const F32 width = distributionWidth(generator);
+        range = Hawk::Math::Vec2(center - width, center + width);
+    }
+
+    uint32_t visibleCount = 0;
+    timeStart = std::chrono::high_resolution_clock::now();
+    for (auto const& range : ranges)
+        visibleCount += index.IsVisible(range.x, range.y);
+    const F64 queryTime = std::chrono::duration<F64>(std::chrono::high_resolution_clock::now() - timeStart).count() / QueryCount;
+
+    fmt::print("{} intervals, build {:.2f} us, query {:.1f} ns, {:.1f}% of the ranges visible\n", std::size(index.Intervals()), 1.0e6 * buildTime, 1.0e9 * queryTime, 100.0 * visibleCount / QueryCount);
+
+    const auto dimension = scene.Majorants.GetDimension();
+    fmt::print("Majorant grid {}x{}x{}\n", dimension.x, dimension.y, dimension.z);
+    fmt::print("{:<10} {:>12} {:>14}\n", "sampling", "update, us", "empty cells");
+    for (uint32_t samplingCount : { 256u, 1024u, 4096u }) {
+        MajorantGrid majorants = scene.Majorants;
+
+        timeStart = std::chrono::high_resolution_clock::now();
+        for (uint32_t iteration = 0; iteration < UpdateCount; iteration++)
+            majorants.Update(opacity, samplingCount);
+        const F64 updateTime = std::chrono::duration<F64>(std::chrono::high_resolution_clock::now() - timeStart).count() / UpdateCount;
+
+        size_t emptyCount = 0;
+        for (F32 majorant : majorants.GetMajorants())
+            emptyCount += majorant == 0.0f;
+        fmt::print("{:<10} {:>12.1f} {:>13.1f}%\n", samplingCount, 1.0e6 * updateTime, 100.0 * emptyCount / std::size(majorants.GetMajorants()));
+    }
+}
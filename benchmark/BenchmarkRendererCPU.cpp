@@ -0,0 +1,59 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Benchmark.h"
+#include "RendererCPU.h"
+
+#include <fmt/format.h>
+
+void BenchmarkRendererCPU(BenchmarkScene const& scene, BenchmarkOptions const& options) {
+
+    ThreadPool threadPool(options.ThreadCount);
+
+    const auto pRenderer = CreateBenchmarkRenderer(threadPool, scene, options);
+    RendererCPU& renderer = *pRenderer;
+
+    fmt::print("{:<10} {:>12} {:>12} {:>14} {:>10}\n", "camera", "frame, ms", "tiles", "samples/s", "Mrays/s");
+    for (auto const& camera : GetBenchmarkCameras()) {
+        F64 time = 0.0;
+        uint64_t sampleCount = 0;
+        uint64_t tileCount = 0;
+
+        // Frames past the sample dispersion only trace tiles with content, as on the GPU
+        for (uint32_t frameIndex = 0; frameIndex < options.FrameCount; frameIndex++) {
+            renderer.RenderFrame(CreateBenchmarkFrame(scene, camera, BenchmarkRenderSettings{}, options.Width, options.Height, frameIndex));
+            auto const& statistics = renderer.GetFrameStatistics();
+            time += statistics.FrameTime;
+            sampleCount += statistics.SampleCount;
+            tileCount += statistics.TileCount;
+        }
+
+        // One sample is a primary march plus one scattered (shadow) march
+        fmt::print("{:<10} {:>12.2f} {:>12} {:>14.0f} {:>10.2f}\n", camera.Name,
+            1000.0 * time / options.FrameCount,
+            tileCount / options.FrameCount,
+            sampleCount / time,
+            2.0e-6 * sampleCount / time);
+    }
+}
@@ -0,0 +1,80 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Benchmark.h"
+#include "RendererCPU.h"
+
+#include <fmt/format.h>
+
+void BenchmarkReprojection(BenchmarkScene const& scene, BenchmarkOptions const& options) {
+
+
+    ThreadPool threadPool(options.ThreadCount);
+
+    const auto pRenderer = CreateBenchmarkRenderer(threadPool, scene, options);
+    RendererCPU& renderer = *pRenderer;
+
+    BenchmarkRenderSettings settings = {};
+
+    // The history is FrameCount samples at the original camera, the first frame after the rotation is
+    // compared with the converged image of the rotated camera, with and without the history. Only the pixels
+    // whose new sample scatters can keep their history.
+    fmt::print("{:<10} {:>8} {:>10} {:>10} {:>12} {:>12} {:>12} {:>12}\n", "camera", "yaw, deg", "scattered", "retained", "samples/px", "frame, ms", "RMSE", "RMSE reset");
+    for (auto const& camera : GetBenchmarkCameras()) {
+        for (F32 angle : { 0.0f, 0.25f, 1.0f, 5.0f }) {
+            BenchmarkCamera rotated = camera;
+            rotated.Yaw += Hawk::Math::Radians(angle);
+
+            renderer.SetReprojection(false);
+            RenderReference(renderer, scene, rotated, settings, options);
+            const std::vector<Hawk::Math::Vec4> reference = renderer.GetColorSum();
+
+            renderer.RenderFrame(CreateBenchmarkFrame(scene, rotated, settings, options.Width, options.Height, 0));
+            const F64 errorReset = ComputeRMSE(renderer.GetColorSum(), reference);
+
+            renderer.SetReprojection(true);
+            renderer.InvalidateHistory();
+            for (uint32_t frameIndex = 0; frameIndex < options.FrameCount; frameIndex++)
+                renderer.RenderFrame(CreateBenchmarkFrame(scene, camera, settings, options.Width, options.Height, frameIndex));
+            renderer.RenderFrame(CreateBenchmarkFrame(scene, rotated, settings, options.Width, options.Height, 0));
+
+            uint64_t scatteredCount = 0;
+            uint64_t retainedCount = 0;
+            F64 sampleCount = 0.0;
+            for (size_t index = 0; index < std::size(renderer.GetColorSum()); index++) {
+                scatteredCount += renderer.GetDepth()[index] > 0.0f;
+                retainedCount += renderer.GetColorSum()[index].w > 1.0f;
+                sampleCount += renderer.GetColorSum()[index].w;
+            }
+
+            const size_t pixelCount = std::size(renderer.GetColorSum());
+            fmt::print("{:<10} {:>8.2f} {:>9.1f}% {:>9.1f}% {:>12.2f} {:>12.2f} {:>12.6f} {:>12.6f}\n", camera.Name, angle,
+                100.0 * scatteredCount / pixelCount,
+                100.0 * retainedCount / pixelCount,
+                sampleCount / pixelCount,
+                1000.0 * renderer.GetFrameStatistics().FrameTime,
+                ComputeRMSE(renderer.GetColorSum(), reference), errorReset);
+        }
+    }
+}
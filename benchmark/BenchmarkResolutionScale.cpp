@@ -0,0 +1,93 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Benchmark.h"
+#include "RendererCPU.h"
+
+#include <fmt/format.h>
+
+void BenchmarkResolutionScale(BenchmarkScene const& scene, BenchmarkOptions const& options) {
+
+
+    ThreadPool threadPool(options.ThreadCount);
+
+    const auto pRenderer = CreateBenchmarkRenderer(threadPool, scene, options);
+    RendererCPU& renderer = *pRenderer;
+
+    // Bilinear with the coordinates clamped to the rendered pixels, the same as the TextureBlit pass
+    auto Upsample = [&](std::vector<Hawk::Math::Vec4> const& image, uint32_t width, uint32_t height) -> std::vector<Hawk::Math::Vec4> {
+        std::vector<Hawk::Math::Vec4> result(size_t(options.Width) * options.Height);
+        for (uint32_t y = 0; y < options.Height; y++) {
+            for (uint32_t x = 0; x < options.Width; x++) {
+                const F32 u = std::clamp((x + 0.5f) * width / options.Width, 0.5f, width - 0.5f) - 0.5f;
+                const F32 v = std::clamp((y + 0.5f) * height / options.Height, 0.5f, height - 0.5f) - 0.5f;
+                const uint32_t x0 = static_cast<uint32_t>(u);
+                const uint32_t y0 = static_cast<uint32_t>(v);
+                const uint32_t x1 = std::min(x0 + 1, width - 1);
+                const uint32_t y1 = std::min(y0 + 1, height - 1);
+                const F32 tx = u - x0;
+                const F32 ty = v - y0;
+
+                const auto row0 = image[size_t(y0) * width + x0] * (1.0f - tx) + image[size_t(y0) * width + x1] * tx;
+                const auto row1 = image[size_t(y1) * width + x0] * (1.0f - tx) + image[size_t(y1) * width + x1] * tx;
+                result[size_t(y) * options.Width + x] = row0 * (1.0f - ty) + row1 * ty;
+            }
+        }
+        return result;
+    };
+
+    BenchmarkRenderSettings settings = {};
+
+    // Every interaction frame is the first sample of a new camera, it is compared with the converged full resolution image
+    fmt::print("{:<10} {:>6} {:>10} {:>6} {:>12} {:>9} {:>12}\n", "camera", "scale", "size", "LOD", "frame, ms", "speedup", "RMSE");
+    for (auto const& camera : GetBenchmarkCameras()) {
+        renderer.Resize(options.Width, options.Height);
+        RenderReference(renderer, scene, camera, settings, options);
+        const std::vector<Hawk::Math::Vec4> reference = renderer.GetColorSum();
+
+        F64 timeFull = 0.0;
+        for (uint32_t scale : { 1u, 2u, 4u }) {
+            const uint32_t width = (options.Width + scale - 1) / scale;
+            const uint32_t height = (options.Height + scale - 1) / scale;
+            renderer.Resize(width, height);
+
+            const FrameBuffer frame = CreateBenchmarkFrame(scene, camera, settings, width, height, 0);
+
+            F64 time = 0.0;
+            for (uint32_t frameIndex = 0; frameIndex < options.FrameCount; frameIndex++) {
+                renderer.RenderFrame(frame);
+                time += renderer.GetFrameStatistics().FrameTime;
+            }
+            time /= options.FrameCount;
+            if (scale == 1)
+                timeFull = time;
+
+            fmt::print("{:<10} {:>6} {:>10} {:>6} {:>12.2f} {:>8.2f}x {:>12.6f}\n", camera.Name, fmt::format("1/{}", scale),
+                fmt::format("{}x{}", width, height),
+                Shading::GetLevelOfDetail(frame, 0),
+                1000.0 * time, timeFull / time,
+                ComputeRMSE(Upsample(renderer.GetColorSum(), width, height), reference));
+        }
+    }
+}
@@ -0,0 +1,90 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Benchmark.h"
+#include "RendererCPU.h"
+
+#include <fmt/format.h>
+
+void BenchmarkSampleSequence(BenchmarkScene const& scene, BenchmarkOptions const& options) {
+
+    ThreadPool threadPool(options.ThreadCount);
+
+    const auto pRenderer = CreateBenchmarkRenderer(threadPool, scene, options);
+    RendererCPU& renderer = *pRenderer;
+
+    struct Sequence {
+        const char* Name;
+        uint32_t    Value;
+    };
+
+    const Sequence sequences[] = {
+        { "random", SampleSequenceRandom },
+        { "sobol", SampleSequenceSobol },
+        { "rank-1", SampleSequenceRank1 }
+    };
+
+    for (auto const& camera : GetBenchmarkCameras()) {
+        BenchmarkRenderSettings settings = {};
+        settings.SampleSequence = SampleSequenceRandom;
+        RenderReference(renderer, scene, camera, settings, options);
+        const std::vector<Hawk::Math::Vec4> reference = renderer.GetColorSum();
+
+        // RMSE after every frame, all sequences take the same time per frame
+        std::vector<std::vector<F64>> errors;
+        for (auto const& sequence : sequences) {
+            settings.SampleSequence = sequence.Value;
+            auto& sequenceErrors = errors.emplace_back();
+            for (uint32_t frameIndex = 0; frameIndex < options.FrameCount; frameIndex++) {
+                renderer.RenderFrame(CreateBenchmarkFrame(scene, camera, settings, options.Width, options.Height, frameIndex));
+                sequenceErrors.push_back(ComputeRMSE(renderer.GetColorSum(), reference));
+            }
+        }
+
+        fmt::print("{} (reference: {} frames of random samples)\n", camera.Name, BenchmarkReferenceScale * options.FrameCount);
+        fmt::print("{:>8}", "frames");
+        for (auto const& sequence : sequences)
+            fmt::print(" {:>14}", fmt::format("{} RMSE", sequence.Name));
+        fmt::print("\n");
+
+        for (uint32_t frameCount = 1; frameCount <= options.FrameCount; frameCount *= 2) {
+            fmt::print("{:>8}", frameCount);
+            for (auto const& sequenceErrors : errors)
+                fmt::print(" {:>14.6f}", sequenceErrors[frameCount - 1]);
+            fmt::print("\n");
+        }
+
+        // Frames each sequence needs to get at least as low as random samples after all of their frames
+        const F64 target = errors[0].back();
+        fmt::print("{:>8}", "target");
+        for (auto const& sequenceErrors : errors) {
+            auto iterator = std::find_if(sequenceErrors.begin(), sequenceErrors.end(), [&](F64 error) { return error <= target; });
+            if (iterator != sequenceErrors.end())
+                fmt::print(" {:>14}", fmt::format("{} frames", iterator - sequenceErrors.begin() + 1));
+            else
+                fmt::print(" {:>14}", "-");
+        }
+        fmt::print("\n");
+    }
+}
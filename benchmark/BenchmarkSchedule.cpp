@@ -0,0 +1,94 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Benchmark.h"
+#include "RendererCPU.h"
+
+#include <fmt/format.h>
+
+void BenchmarkSchedule(BenchmarkScene const& scene, BenchmarkOptions const& options) {
+
+    ThreadPool threadPool(options.ThreadCount);
+
+    const auto pRenderer = CreateBenchmarkRenderer(threadPool, scene, options);
+    RendererCPU& renderer = *pRenderer;
+
+    struct Schedule {
+        const char*           Name;
+        RendererCPU::Schedule Value;
+    };
+
+    const Schedule schedules[] = {
+        { "pixel", RendererCPU::SchedulePixel },
+        { "tile", RendererCPU::ScheduleTile },
+        { "wavefront", RendererCPU::ScheduleWavefront }
+    };
+
+    struct Tracking {
+        const char* Name;
+        uint32_t    TrackingMode;
+        uint32_t    TransmittanceEstimator;
+    };
+
+    // Ray marching with binary visibility is where packets matter, delta and ratio tracking are the defaults
+    const Tracking trackings[] = {
+        { "marching", TrackingModeRayMarching, TransmittanceEstimatorTracking },
+        { "delta", TrackingModeDelta, TransmittanceEstimatorRatio }
+    };
+
+    fmt::print("{:<10} {:<10} {:<10} {:>12} {:>10} {:>10} {:>12}\n", "camera", "tracking", "schedule", "frame, ms", "Mrays/s", "speedup", "RMSE");
+    for (auto const& camera : GetBenchmarkCameras()) {
+        for (auto const& tracking : trackings) {
+            BenchmarkRenderSettings settings = {};
+            settings.TrackingMode = tracking.TrackingMode;
+            settings.TransmittanceEstimator = tracking.TransmittanceEstimator;
+
+            // Every schedule traces the same rays, the images are compared with the one of the first schedule
+            std::vector<Hawk::Math::Vec4> reference;
+            F64 timePixel = 0.0;
+            for (auto const& schedule : schedules) {
+                renderer.SetSchedule(schedule.Value);
+
+                F64 time = 0.0;
+                uint64_t sampleCount = 0;
+                for (uint32_t frameIndex = 0; frameIndex < options.FrameCount; frameIndex++) {
+                    renderer.RenderFrame(CreateBenchmarkFrame(scene, camera, settings, options.Width, options.Height, frameIndex));
+                    time += renderer.GetFrameStatistics().FrameTime;
+                    sampleCount += renderer.GetFrameStatistics().SampleCount;
+                }
+
+                if (reference.empty()) {
+                    reference = renderer.GetColorSum();
+                    timePixel = time;
+                }
+
+                fmt::print("{:<10} {:<10} {:<10} {:>12.2f} {:>10.2f} {:>10.2f} {:>12.2e}\n", camera.Name, tracking.Name, schedule.Name,
+                    1000.0 * time / options.FrameCount,
+                    2.0e-6 * sampleCount / time,
+                    timePixel / time,
+                    ComputeRMSE(renderer.GetColorSum(), reference));
+            }
+        }
+    }
+}
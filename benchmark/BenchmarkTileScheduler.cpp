@@ -0,0 +1,96 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Benchmark.h"
+#include "RendererCPU.h"
+
+#include <fmt/format.h>
+
+#include <chrono>
+#include <thread>
+
+void BenchmarkTileScheduler(BenchmarkScene const& scene, BenchmarkOptions const& options) {
+
+    struct Scheduler {
+        const char* Name;
+        bool        IsWorkStealing;
+    };
+
+    const Scheduler schedulers[] = {
+        { "counter", false },
+        { "stealing", true }
+    };
+
+    // The close-up leaves a few tiles with most of the volume in them, which is where the order matters
+    const auto cameras = GetBenchmarkCameras();
+    const auto& camera = cameras.back();
+
+    BenchmarkRenderSettings settings = {};
+
+    fmt::print("{:<8} {:<10} {:>12} {:>12} {:>14} {:>10} {:>14}\n", "threads", "scheduler", "frame, ms", "utilization", "slowest, ms", "steals", "cancel, ms");
+    for (uint32_t threadCount : { 4u, 16u, 64u }) {
+        ThreadPool threadPool(threadCount);
+
+        const auto pRenderer = CreateBenchmarkRenderer(threadPool, scene, options);
+        RendererCPU& renderer = *pRenderer;
+        renderer.SetSchedule(RendererCPU::ScheduleTile);
+
+        for (auto const& scheduler : schedulers) {
+            renderer.SetWorkStealing(scheduler.IsWorkStealing);
+
+            F64 time = 0.0;
+            F64 utilization = 0.0;
+            F64 slowestTile = 0.0;
+            uint64_t stealCount = 0;
+            for (uint32_t frameIndex = 0; frameIndex < options.FrameCount; frameIndex++) {
+                renderer.RenderFrame(CreateBenchmarkFrame(scene, camera, settings, options.Width, options.Height, frameIndex));
+                auto const& statistics = renderer.GetFrameStatistics();
+                time += statistics.FrameTime;
+                utilization += statistics.Utilization;
+                slowestTile = std::max(slowestTile, statistics.SlowestTileTime);
+                stealCount += statistics.StealCount;
+            }
+
+            // Cancels a frame a quarter of the way in, the latency is the time until RenderFrame returns
+            const F64 frameTime = time / options.FrameCount;
+            std::chrono::high_resolution_clock::time_point cancelTime;
+            std::thread worker([&]() {
+                renderer.RenderFrame(CreateBenchmarkFrame(scene, camera, settings, options.Width, options.Height, options.FrameCount));
+            });
+            std::this_thread::sleep_for(std::chrono::duration<F64>(0.25 * frameTime));
+            cancelTime = std::chrono::high_resolution_clock::now();
+            renderer.Cancel();
+            worker.join();
+            const F64 cancelLatency = std::chrono::duration<F64>(std::chrono::high_resolution_clock::now() - cancelTime).count();
+
+            fmt::print("{:<8} {:<10} {:>12.2f} {:>11.1f}% {:>14.2f} {:>10} {:>14.2f}{}\n", threadCount, scheduler.Name,
+                1000.0 * frameTime,
+                100.0 * utilization / options.FrameCount,
+                1000.0 * slowestTile,
+                stealCount / options.FrameCount,
+                1000.0 * cancelLatency,
+                renderer.GetFrameStatistics().IsCancelled ? "" : " (finished)");
+        }
+    }
+}
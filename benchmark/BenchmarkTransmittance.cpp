@@ -0,0 +1,103 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Benchmark.h"
+#include "RendererCPU.h"
+
+#include <fmt/format.h>
+
+void BenchmarkTransmittance(BenchmarkScene const& scene, BenchmarkOptions const& options) {
+
+    ThreadPool threadPool(options.ThreadCount);
+
+    const auto pRenderer = CreateBenchmarkRenderer(threadPool, scene, options);
+    RendererCPU& renderer = *pRenderer;
+
+    struct Estimator {
+        const char* Name;
+        uint32_t    Value;
+    };
+
+    const Estimator estimators[] = {
+        { "tracking", TransmittanceEstimatorTracking },
+        { "ratio", TransmittanceEstimatorRatio },
+        { "residual", TransmittanceEstimatorResidualRatio }
+    };
+
+    struct Sample {
+        F64 Time;
+        F64 RMSE;
+    };
+
+    // The residual is tracked against the mean opacity of a cell, which pays off in thin media and costs in dense ones
+    for (F32 density : { 100.0f, 10.0f }) {
+        for (auto const& camera : GetBenchmarkCameras()) {
+            BenchmarkRenderSettings settings = {};
+            settings.Density = density;
+            settings.TransmittanceEstimator = TransmittanceEstimatorTracking;
+            RenderReference(renderer, scene, camera, settings, options);
+            const std::vector<Hawk::Math::Vec4> reference = renderer.GetColorSum();
+
+            // RMSE after 1, 2, 4, ... frames against the cumulative render time
+            std::vector<std::vector<Sample>> samples;
+            for (auto const& estimator : estimators) {
+                settings.TransmittanceEstimator = estimator.Value;
+                auto& estimatorSamples = samples.emplace_back();
+
+                F64 time = 0.0;
+                for (uint32_t frameIndex = 0; frameIndex < options.FrameCount; frameIndex++) {
+                    renderer.RenderFrame(CreateBenchmarkFrame(scene, camera, settings, options.Width, options.Height, frameIndex));
+                    time += renderer.GetFrameStatistics().FrameTime;
+                    if (std::has_single_bit(frameIndex + 1))
+                        estimatorSamples.push_back({ time, ComputeRMSE(renderer.GetColorSum(), reference) });
+                }
+            }
+
+            fmt::print("{}, density {} (reference: {} frames of binary tracking)\n", camera.Name, density, BenchmarkReferenceScale * options.FrameCount);
+            fmt::print("{:>8}", "frames");
+            for (auto const& estimator : estimators)
+                fmt::print(" {:>14} {:>14}", fmt::format("{}, ms", estimator.Name), fmt::format("{} RMSE", estimator.Name));
+            fmt::print("\n");
+
+            for (size_t index = 0; index < std::size(samples[0]); index++) {
+                fmt::print("{:>8}", 1u << index);
+                for (auto const& estimatorSamples : samples)
+                    fmt::print(" {:>14.1f} {:>14.6f}", 1000.0 * estimatorSamples[index].Time, estimatorSamples[index].RMSE);
+                fmt::print("\n");
+            }
+
+            // Time each estimator needs to get at least as low as binary tracking after all of its frames
+            const F64 target = samples[0].back().RMSE;
+            fmt::print("{:>8}", "target");
+            for (auto const& estimatorSamples : samples) {
+                auto iterator = std::find_if(estimatorSamples.begin(), estimatorSamples.end(), [&](Sample const& sample) { return sample.RMSE <= target; });
+                if (iterator != estimatorSamples.end())
+                    fmt::print(" {:>14.1f} {:>14.6f}", 1000.0 * iterator->Time, iterator->RMSE);
+                else
+                    fmt::print(" {:>14} {:>14}", "-", "-");
+            }
+            fmt::print("\n");
+        }
+    }
+}
@@ -0,0 +1,218 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Benchmark.h"
+#include "RenderCommon.h"
+#include "VolumeLayout.h"
+
+#include <fmt/format.h>
+
+#include <chrono>
+#include <random>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    enum PerfEvent : uint32_t {
+        PerfEventCacheMisses,
+        PerfEventTLBMisses
+    };
+
+    // Hardware event counter of the calling thread. Not available outside of Linux, or when perf events are restricted.
+    class PerfCounter {
+    public:
+        PerfCounter(PerfEvent event) {
+#if defined(__linux__)
+            perf_event_attr attribute = {};
+            attribute.size = sizeof(attribute);
+            attribute.disabled = 1;
+            attribute.exclude_kernel = 1;
+            attribute.exclude_hv = 1;
+            if (event == PerfEventCacheMisses) {
+                attribute.type = PERF_TYPE_HARDWARE;
+                attribute.config = PERF_COUNT_HW_CACHE_MISSES;
+            } else {
+                attribute.type = PERF_TYPE_HW_CACHE;
+                attribute.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            }
+            m_Descriptor = static_cast<int32_t>(syscall(SYS_perf_event_open, &attribute, 0, -1, -1, 0));
+#endif
+        }
+
+        ~PerfCounter() {
+#if defined(__linux__)
+            if (m_Descriptor >= 0)
+                close(m_Descriptor);
+#endif
+        }
+
+        PerfCounter(PerfCounter const&) = delete;
+
+        PerfCounter& operator=(PerfCounter const&) = delete;
+
+        bool IsValid() const { return m_Descriptor >= 0; }
+
+        void Start() {
+#if defined(__linux__)
+            if (m_Descriptor >= 0) {
+                ioctl(m_Descriptor, PERF_EVENT_IOC_RESET, 0);
+                ioctl(m_Descriptor, PERF_EVENT_IOC_ENABLE, 0);
+            }
+#endif
+        }
+
+        uint64_t Stop() {
+
+            uint64_t value = 0;
+#if defined(__linux__)
+            if (m_Descriptor >= 0) {
+                ioctl(m_Descriptor, PERF_EVENT_IOC_DISABLE, 0);
+                if (read(m_Descriptor, &value, sizeof(value)) != sizeof(value))
+                    value = 0;
+            }
+#endif
+            return value;
+        }
+
+    private:
+        int32_t m_Descriptor = -1;
+    };
+
+    struct RaySet {
+        const char*               Name;
+        std::vector<Shading::Ray> Rays;
+    };
+
+    // Rays in texture coordinates: a 64x64 jittered grid of rays along each axis, in scanline order like
+    // neighboring pixels, and the same number of rays in random directions through random points
+    std::vector<RaySet> GenerateRaySets() {
+
+        constexpr uint32_t GridSize = 64;
+
+        std::mt19937 generator(7);
+        std::uniform_real_distribution<F32> distribution(0.0f, 1.0f);
+
+        std::vector<RaySet> raySets;
+        const char* axisNames[] = { "+x", "+y", "+z" };
+        for (uint32_t axis = 0; axis < 3; axis++) {
+            auto& raySet = raySets.emplace_back(RaySet{ axisNames[axis] });
+            for (uint32_t v = 0; v < GridSize; v++) {
+                for (uint32_t u = 0; u < GridSize; u++) {
+                    Hawk::Math::Vec3 origin = {};
+                    Hawk::Math::Vec3 direction = {};
+                    origin[(axis + 1) % 3] = (u + distribution(generator)) / GridSize;
+                    origin[(axis + 2) % 3] = (v + distribution(generator)) / GridSize;
+                    direction[axis] = 1.0f;
+                    raySet.Rays.push_back({ origin, direction, 0.0f, 1.0f });
+                }
+            }
+        }
+
+        auto& raySet = raySets.emplace_back(RaySet{ "random" });
+        for (uint32_t index = 0; index < GridSize * GridSize; index++) {
+            const Hawk::Math::Vec3 origin = Hawk::Math::Vec3(distribution(generator), distribution(generator), distribution(generator));
+            const F32 cosTheta = 2.0f * distribution(generator) - 1.0f;
+            const F32 sinTheta = std::sqrt(1.0f - cosTheta * cosTheta);
+            const F32 phi = 2.0f * 3.14159265f * distribution(generator);
+            const Hawk::Math::Vec3 direction = Hawk::Math::Vec3(sinTheta * std::cos(phi), sinTheta * std::sin(phi), cosTheta);
+
+            const Shading::Intersection intersect = Shading::IntersectAABB({ origin, direction, 0.0f, 0.0f }, { Hawk::Math::Vec3(0.0f, 0.0f, 0.0f), Hawk::Math::Vec3(1.0f, 1.0f, 1.0f) });
+            raySet.Rays.push_back({ origin, direction, std::max(intersect.Min, 0.0f), intersect.Max });
+        }
+        return raySets;
+    }
+
+    struct LayoutResult {
+        F64      Time;
+        uint64_t SampleCount;
+        uint64_t CacheMisses;
+        uint64_t TLBMisses;
+        bool     IsCounted;
+        F64      Checksum;
+    };
+
+    // Half-voxel steps along every ray, sampled with the trilinear filter of the layout
+    template<typename Layout>
+    LayoutResult MarchRays(VolumeBuffer<Layout> const& buffer, RaySet const& raySet) {
+
+        const auto dimension = buffer.GetDimension();
+        const F32 step = 0.5f / (std::max)({ dimension.x, dimension.y, dimension.z });
+
+        PerfCounter counterCache(PerfEventCacheMisses);
+        PerfCounter counterTLB(PerfEventTLBMisses);
+
+        LayoutResult result = {};
+        const auto timeStart = std::chrono::high_resolution_clock::now();
+        counterCache.Start();
+        counterTLB.Start();
+
+        for (auto const& ray : raySet.Rays) {
+            for (F32 t = ray.Min; t < ray.Max; t += step) {
+                result.Checksum += buffer.SampleIntensity(ray.Origin + t * ray.Direction);
+                result.SampleCount++;
+            }
+        }
+
+        result.TLBMisses = counterTLB.Stop();
+        result.CacheMisses = counterCache.Stop();
+        result.Time = std::chrono::duration<F64>(std::chrono::high_resolution_clock::now() - timeStart).count();
+        result.IsCounted = counterCache.IsValid() && counterTLB.IsValid();
+        return result;
+    }
+}
+
+void BenchmarkVolumeLayout(BenchmarkScene const& scene, BenchmarkOptions const& options) {
+
+    const VolumeBuffer<VolumeLayoutLinear>   bufferLinear(scene.Volume);
+    const VolumeBuffer<VolumeLayoutMorton>   bufferMorton(scene.Volume);
+    const VolumeBuffer<VolumeLayoutTiled<8>> bufferTiled(scene.Volume);
+
+    fmt::print("Single thread, memory: {} {:.1f} MiB, {} {:.1f} MiB, {} {:.1f} MiB\n",
+        VolumeLayoutLinear::Name, bufferLinear.GetMemorySize() / 1048576.0,
+        VolumeLayoutMorton::Name, bufferMorton.GetMemorySize() / 1048576.0,
+        VolumeLayoutTiled<8>::Name, bufferTiled.GetMemorySize() / 1048576.0);
+    fmt::print("{:<8} {:<8} {:>12} {:>14} {:>16} {:>16}\n", "rays", "layout", "ns/sample", "Msamples/s", "cache misses/1k", "dTLB misses/1k");
+
+    for (auto const& raySet : GenerateRaySets()) {
+        const LayoutResult results[] = { MarchRays(bufferLinear, raySet), MarchRays(bufferMorton, raySet), MarchRays(bufferTiled, raySet) };
+        const char* names[] = { VolumeLayoutLinear::Name, VolumeLayoutMorton::Name, VolumeLayoutTiled<8>::Name };
+
+        for (size_t index = 0; index < std::size(results); index++) {
+            auto const& result = results[index];
+            if (result.Checksum != results[0].Checksum)
+                throw std::runtime_error(fmt::format("Layout {} samples differ from the linear layout", names[index]));
+
+            const F64 perThousand = 1000.0 / result.SampleCount;
+            fmt::print("{:<8} {:<8} {:>12.2f} {:>14.1f} {:>16} {:>16}\n", raySet.Name, names[index],
+                1.0e9 * result.Time / result.SampleCount, 1.0e-6 * result.SampleCount / result.Time,
+                result.IsCounted ? fmt::format("{:.2f}", perThousand * result.CacheMisses) : "n/a",
+                result.IsCounted ? fmt::format("{:.2f}", perThousand * result.TLBMisses) : "n/a");
+        }
+    }
+}
@@ -0,0 +1,138 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Benchmark.h"
+#include "ThreadPool.h"
+#include "VolumeMarcher.h"
+
+#include <fmt/format.h>
+
+#include <chrono>
+
+namespace {
+    // Primary rays of one frame in 16x16 tile order, as RendererCPU submits them
+    void GeneratePrimaryStream(FrameBuffer const& frame, BlueNoise const& noise, uint32_t width, uint32_t height, RayStream& stream, std::vector<size_t>& tileOffsets) {
+
+        constexpr uint32_t TileSize = 16;
+
+        stream.Resize(size_t(width) * height);
+        tileOffsets.clear();
+
+        size_t index = 0;
+        for (uint32_t tileY = 0; tileY < height; tileY += TileSize) {
+            for (uint32_t tileX = 0; tileX < width; tileX += TileSize) {
+                tileOffsets.push_back(index);
+                for (uint32_t y = tileY; y < std::min(tileY + TileSize, height); y++) {
+                    for (uint32_t x = tileX; x < std::min(tileX + TileSize, width); x++, index++) {
+                        const Hawk::Math::Vec2u id = Hawk::Math::Vec2u(x, y);
+                        const Shading::CSampler sampler = Shading::InitSampler(frame, std::data(noise.GetTexels()), id, 0);
+                        const Shading::Ray ray = Shading::CreateCameraRay(id, Shading::SamplePixelJitter(sampler), frame.InvRenderTargetDim, frame.InvWorldViewProjectionMatrix);
+
+                        stream.OriginX[index] = ray.Origin.x;
+                        stream.OriginY[index] = ray.Origin.y;
+                        stream.OriginZ[index] = ray.Origin.z;
+                        stream.DirectionX[index] = ray.Direction.x;
+                        stream.DirectionY[index] = ray.Direction.y;
+                        stream.DirectionZ[index] = ray.Direction.z;
+                        stream.Min[index] = ray.Min;
+                        stream.Max[index] = ray.Max;
+                        stream.Threshold[index] = -std::log(1.0f - Shading::Sample1D(sampler, 2)) / frame.Density;
+                        stream.Jitter[index] = Shading::Sample1D(sampler, 3);
+                    }
+                }
+            }
+        }
+        tileOffsets.push_back(index);
+    }
+}
+
+void BenchmarkVolumeMarcher(BenchmarkScene const& scene, BenchmarkOptions const& options) {
+
+    ThreadPool threadPool(options.ThreadCount);
+
+    const auto opacity = scene.TransferFunctions.Opacity.GenerateTable(256);
+    std::vector<F32> opacityTable(std::size(opacity));
+    for (size_t index = 0; index < std::size(opacity); index++)
+        opacityTable[index] = opacity[index] / 255.0f;
+
+    fmt::print("Packet marching: {}\n", VolumeMarcher::GetInstructionSet());
+    fmt::print("{:<10} {:>14} {:>14} {:>10} {:>12}\n", "camera", "scalar Mrays/s", "packet Mrays/s", "speedup", "mismatches");
+
+    RayStream scalar;
+    RayStream packet;
+    std::vector<size_t> tileOffsets;
+
+    for (auto const& camera : GetBenchmarkCameras()) {
+        F64 timeScalar = 0.0;
+        F64 timePacket = 0.0;
+        uint64_t rayCount = 0;
+        uint64_t mismatchCount = 0;
+
+        for (uint32_t frameIndex = 0; frameIndex < options.FrameCount; frameIndex++) {
+            const FrameBuffer frame = CreateBenchmarkFrame(scene, camera, BenchmarkRenderSettings{}, options.Width, options.Height, frameIndex);
+            GeneratePrimaryStream(frame, scene.Noise, options.Width, options.Height, scalar, tileOffsets);
+            packet = scalar;
+
+            VolumeMarcher::Desc desc = {};
+            desc.pVolume = &scene.Volume;
+            desc.pOpacityTable = std::data(opacityTable);
+            desc.OpacityTableSize = static_cast<uint32_t>(std::size(opacityTable));
+            desc.BoundingBoxMin = frame.BoundingBoxMin;
+            desc.BoundingBoxMax = frame.BoundingBoxMax;
+            desc.StepSize = frame.StepSize;
+            desc.Density = frame.Density;
+            const VolumeMarcher marcher(desc);
+
+            const uint32_t tileCount = static_cast<uint32_t>(std::size(tileOffsets) - 1);
+            auto Measure = [&](auto&& march) {
+                const auto timeStart = std::chrono::high_resolution_clock::now();
+                threadPool.ParallelFor(tileCount, [&](uint32_t tile, uint32_t threadID) {
+                    march(tileOffsets[tile], tileOffsets[tile + 1] - tileOffsets[tile]);
+                });
+                return std::chrono::duration<F64>(std::chrono::high_resolution_clock::now() - timeStart).count();
+            };
+
+            timeScalar += Measure([&](size_t first, size_t count) { marcher.MarchScalar(scalar, first, count); });
+            timePacket += Measure([&](size_t first, size_t count) { marcher.MarchPacket(packet, first, count); });
+            rayCount += scalar.Size();
+
+            // Both paths evaluate the same expressions, only FMA contraction may move a scatter point
+            for (size_t index = 0; index < scalar.Size(); index++) {
+                if (scalar.IsScattered[index] != packet.IsScattered[index]) {
+                    mismatchCount++;
+                } else if (scalar.IsScattered[index]) {
+                    const auto a = Hawk::Math::Vec3(scalar.PositionX[index], scalar.PositionY[index], scalar.PositionZ[index]);
+                    const auto b = Hawk::Math::Vec3(packet.PositionX[index], packet.PositionY[index], packet.PositionZ[index]);
+                    mismatchCount += Hawk::Math::Distance(a, b) > 1.0e-4f;
+                }
+            }
+        }
+
+        fmt::print("{:<10} {:>14.2f} {:>14.2f} {:>9.2f}x {:>12}\n", camera.Name,
+            1.0e-6 * rayCount / timeScalar,
+            1.0e-6 * rayCount / timePacket,
+            timeScalar / timePacket,
+            mismatchCount);
+    }
+}
@@ -0,0 +1,283 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Benchmark.h"
+#include "RendererCPU.h"
+
+#include <Hawk/Components/Camera.hpp>
+#include <fmt/format.h>
+
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+void LoadBenchmarkScene(BenchmarkScene& scene, BenchmarkOptions const& options) {
+
+    if (options.PhantomSize > 0) {
+        GeneratePhantomVolume(scene.Volume, options.PhantomSize);
+    } else {
+        if (!std::filesystem::exists(options.VolumePath))
+            throw std::runtime_error("Failed to open file: " + options.VolumePath + " (use --phantom <size> to run without it)");
+        scene.Volume.LoadFromFile(options.VolumePath);
+    }
+
+    scene.Environment.LoadFromFile(options.EnvironmentPath);
+    scene.TransferFunctions.LoadFromFile(options.TransferFunctionPath);
+
+    scene.Majorants.Initialize(scene.Volume, 0);
+    scene.Majorants.Update(scene.TransferFunctions.Opacity, 256);
+
+    scene.Noise.Initialize(BlueNoise::DefaultSize);
+}
+
+void GeneratePhantomVolume(VolumeData& volume, uint32_t size) {
+
+    // Intensities are raw values in [0, 4096], normalized the same way as VolumeData::LoadFromFile
+    auto Smoothstep = [](F32 edge0, F32 edge1, F32 x) -> F32 {
+        const F32 t = std::clamp((x - edge0) / (edge1 - edge0), 0.0f, 1.0f);
+        return t * t * (3.0f - 2.0f * t);
+    };
+
+    std::vector<uint16_t> intensity(size_t(size) * size * size);
+    for (uint32_t z = 0; z < size; z++) {
+        for (uint32_t y = 0; y < size; y++) {
+            for (uint32_t x = 0; x < size; x++) {
+                const auto p = 2.0f * (Hawk::Math::Vec3(F32(x), F32(y), F32(z)) + Hawk::Math::Vec3(0.5f, 0.5f, 0.5f)) / F32(size) - Hawk::Math::Vec3(1.0f, 1.0f, 1.0f);
+                const auto r = Hawk::Math::Length(Hawk::Math::Vec3(p.x, 1.15f * p.y, 0.9f * p.z));
+                const auto ripple = 0.02f * std::sin(11.0f * p.x) * std::sin(13.0f * p.y) * std::sin(7.0f * p.z);
+
+                const F32 tissue = 1050.0f * (1.0f - Smoothstep(0.80f, 0.84f, r + ripple));
+                const F32 bone = 700.0f * Smoothstep(0.62f, 0.66f, r + ripple) * (1.0f - Smoothstep(0.72f, 0.76f, r + ripple));
+                const F32 core = 900.0f * (1.0f - Smoothstep(0.16f, 0.20f, Hawk::Math::Length(p - Hawk::Math::Vec3(0.2f, -0.1f, 0.15f))));
+
+                const F32 value = std::round(65535.0f * (tissue + bone + core) / 4096.0f);
+                intensity[(size_t(z) * size + y) * size + x] = static_cast<uint16_t>(std::clamp(value, 0.0f, 65535.0f));
+            }
+        }
+    }
+    volume.Initialize(size, size, size, std::move(intensity));
+}
+
+std::vector<BenchmarkCamera> GetBenchmarkCameras() {
+
+    return {
+        { "front", 0.0f, 0.0f, 1.0f },
+        { "side", Hawk::Math::Radians(90.0f), 0.0f, 1.0f },
+        { "oblique", Hawk::Math::Radians(35.0f), Hawk::Math::Radians(-25.0f), 1.0f },
+        { "close-up", Hawk::Math::Radians(-20.0f), Hawk::Math::Radians(10.0f), 0.45f }
+    };
+}
+
+FrameBuffer CreateBenchmarkFrame(BenchmarkScene const& scene, BenchmarkCamera const& camera, BenchmarkRenderSettings const& settings, uint32_t width, uint32_t height, uint32_t frameIndex) {
+
+    Hawk::Components::Camera orbit = {};
+    orbit.Rotate(Hawk::Components::Camera::LocalUp, camera.Yaw);
+    orbit.Rotate(orbit.Right(), camera.Pitch);
+
+    const auto dimension = scene.Volume.GetDimension();
+
+    const auto world = ComputeWorldMatrix(dimension.x, dimension.y, dimension.z);
+
+    FrameBuffer frame = {};
+    SetFrameMatrices(frame, world, orbit.ToMatrix(), ComputeProjectionMatrix(camera.Zoom, width, height));
+
+    if (settings.IsContentBoundingBox)
+        SetFrameBoundingBox(frame, scene.Majorants.GetContentMin(), scene.Majorants.GetContentMax());
+    else
+        SetFrameBoundingBox(frame, Hawk::Math::Vec3(0.0f, 0.0f, 0.0f), Hawk::Math::Vec3(1.0f, 1.0f, 1.0f));
+    SetFrameClipRegion(frame, {}, Hawk::Math::Box(), Hawk::Math::Mat4x4(1.0f));
+    frame.StepSize = Hawk::Math::Distance(VolumeBoundingBoxMin, VolumeBoundingBoxMax) / settings.StepCount;
+    if (settings.IsAutomaticLevelOfDetail)
+        SetFrameLevelOfDetail(frame, ComputeFootprintLevelOfDetail(world, dimension, camera.Zoom, height) + settings.LevelOfDetailBias, 0, scene.Majorants.GetMipLevelMax(), settings.LevelOfDetailDepthBias);
+    else
+        SetFrameLevelOfDetail(frame, 0.0f, 0, 0, 0);
+    frame.Density = settings.Density;
+    frame.Exposure = settings.Exposure;
+    frame.TrackingMode = settings.TrackingMode;
+    frame.TransmittanceEstimator = settings.TransmittanceEstimator;
+    frame.LightSampling = settings.LightSampling;
+    frame.EnvironmentDimension = Hawk::Math::Vec2u(scene.Environment.GetWidth(), scene.Environment.GetHeight());
+    frame.MajorantGridDimension = scene.Majorants.GetDimension();
+    frame.FrameIndex = frameIndex;
+    frame.SampleSequence = settings.SampleSequence;
+    frame.TileErrorThreshold = settings.TileErrorThreshold;
+    frame.BlueNoiseSize = scene.Noise.GetSize();
+    frame.RenderTargetDim = Hawk::Math::Vec2(static_cast<F32>(width), static_cast<F32>(height));
+    frame.InvRenderTargetDim = Hawk::Math::Vec2(1.0f, 1.0f) / frame.RenderTargetDim;
+    return frame;
+}
+
+std::unique_ptr<RendererCPU> CreateBenchmarkRenderer(ThreadPool& threadPool, BenchmarkScene const& scene, BenchmarkOptions const& options) {
+
+    auto pRenderer = std::make_unique<RendererCPU>(threadPool);
+    pRenderer->Resize(options.Width, options.Height);
+    pRenderer->SetVolume(&scene.Volume);
+    pRenderer->SetEnvironmentMap(&scene.Environment);
+    pRenderer->SetBlueNoise(&scene.Noise);
+    pRenderer->SetMajorantGrid(&scene.Majorants);
+    pRenderer->SetTransferFunctions(scene.TransferFunctions, 256);
+    return pRenderer;
+}
+
+void RenderReference(RendererCPU& renderer, BenchmarkScene const& scene, BenchmarkCamera const& camera, BenchmarkRenderSettings const& settings, BenchmarkOptions const& options) {
+
+    BenchmarkRenderSettings settingsReference = settings;
+    settingsReference.TileErrorThreshold = 0.0f;
+    for (uint32_t frameIndex = 0; frameIndex < BenchmarkReferenceScale * options.FrameCount; frameIndex++)
+        renderer.RenderFrame(CreateBenchmarkFrame(scene, camera, settingsReference, options.Width, options.Height, frameIndex));
+}
+
+F64 ComputeRMSE(std::vector<Hawk::Math::Vec4> const& image, std::vector<Hawk::Math::Vec4> const& reference) {
+
+    F64 sumSquaredError = 0.0;
+    for (size_t index = 0; index < std::size(image); index++) {
+        for (uint32_t channel = 0; channel < 3; channel++) {
+            const F64 delta = F64(image[index][channel]) - F64(reference[index][channel]);
+            sumSquaredError += delta * delta;
+        }
+    }
+    return std::sqrt(sumSquaredError / (3.0 * std::size(image)));
+}
+
+F64 ComputeSSIM(std::vector<Hawk::Math::Vec4> const& image, std::vector<Hawk::Math::Vec4> const& reference, uint32_t width, uint32_t height) {
+
+    constexpr int32_t Radius = 3;
+    constexpr F64 C1 = 0.01 * 0.01;
+    constexpr F64 C2 = 0.03 * 0.03;
+
+    auto Luminance = [](Hawk::Math::Vec4 const& color) -> F64 { return 0.2126 * color.x + 0.7152 * color.y + 0.0722 * color.z; };
+
+    // Windows are clipped at the borders
+    F64 sum = 0.0;
+    for (int32_t y = 0; y < int32_t(height); y++) {
+        for (int32_t x = 0; x < int32_t(width); x++) {
+            F64 meanX = 0.0, meanY = 0.0, momentX = 0.0, momentY = 0.0, momentXY = 0.0;
+            uint32_t count = 0;
+            for (int32_t v = std::max(y - Radius, 0); v <= std::min(y + Radius, int32_t(height) - 1); v++) {
+                for (int32_t u = std::max(x - Radius, 0); u <= std::min(x + Radius, int32_t(width) - 1); u++) {
+                    const F64 a = Luminance(image[size_t(v) * width + u]);
+                    const F64 b = Luminance(reference[size_t(v) * width + u]);
+                    meanX += a;
+                    meanY += b;
+                    momentX += a * a;
+                    momentY += b * b;
+                    momentXY += a * b;
+                    count++;
+                }
+            }
+            meanX /= count;
+            meanY /= count;
+            const F64 varianceX = momentX / count - meanX * meanX;
+            const F64 varianceY = momentY / count - meanY * meanY;
+            const F64 covariance = momentXY / count - meanX * meanY;
+            sum += (2.0 * meanX * meanY + C1) * (2.0 * covariance + C2) / ((meanX * meanX + meanY * meanY + C1) * (varianceX + varianceY + C2));
+        }
+    }
+    return sum / (F64(width) * height);
+}
+
+int main(int argc, char* argv[]) {
+
+    struct BenchmarkEntry {
+        const char* Name;
+        void (*Function)(BenchmarkScene const&, BenchmarkOptions const&);
+    };
+
+    const BenchmarkEntry benchmarks[] = {
+        { "RendererCPU", BenchmarkRendererCPU },
+        { "VolumeMarcher", BenchmarkVolumeMarcher },
+        { "DeltaTracking", BenchmarkDeltaTracking },
+        { "Transmittance", BenchmarkTransmittance },
+        { "LevelOfDetail", BenchmarkLevelOfDetail },
+        { "VolumeLayout", BenchmarkVolumeLayout },
+        { "LightSampling", BenchmarkLightSampling },
+        { "BrickSampler", BenchmarkBrickSampler },
+        { "Schedule", BenchmarkSchedule },
+        { "SampleSequence", BenchmarkSampleSequence },
+        { "ContentBounds", BenchmarkContentBounds },
+        { "ClipRegion", BenchmarkClipRegion },
+        { "AdaptiveSampling", BenchmarkAdaptiveSampling },
+        { "TileScheduler", BenchmarkTileScheduler },
+        { "ResolutionScale", BenchmarkResolutionScale },
+        { "Reprojection", BenchmarkReprojection },
+        { "Denoiser", BenchmarkDenoiser },
+        { "AutoExposure", BenchmarkAutoExposure },
+        { "DynamicResolution", BenchmarkDynamicResolution },
+        { "OpacityIndex", BenchmarkOpacityIndex }
+    };
+
+    BenchmarkOptions options;
+    for (int32_t index = 1; index < argc; index++) {
+        auto NextArgument = [&]() -> std::string {
+            if (index + 1 >= argc)
+                throw std::runtime_error(std::string("Missing value for ") + argv[index]);
+            return argv[++index];
+        };
+
+        if (!std::strcmp(argv[index], "--volume"))
+            options.VolumePath = NextArgument();
+        else if (!std::strcmp(argv[index], "--environment"))
+            options.EnvironmentPath = NextArgument();
+        else if (!std::strcmp(argv[index], "--transfer-function"))
+            options.TransferFunctionPath = NextArgument();
+        else if (!std::strcmp(argv[index], "--filter"))
+            options.Filter = NextArgument();
+        else if (!std::strcmp(argv[index], "--width"))
+            options.Width = std::stoul(NextArgument());
+        else if (!std::strcmp(argv[index], "--height"))
+            options.Height = std::stoul(NextArgument());
+        else if (!std::strcmp(argv[index], "--frames"))
+            options.FrameCount = std::stoul(NextArgument());
+        else if (!std::strcmp(argv[index], "--threads"))
+            options.ThreadCount = std::stoul(NextArgument());
+        else if (!std::strcmp(argv[index], "--phantom"))
+            options.PhantomSize = std::stoul(NextArgument());
+        else {
+            fmt::print("Usage: {} [--filter name] [--volume file] [--environment file] [--transfer-function file]\n"
+                       "       [--width N] [--height N] [--frames N] [--threads N] [--phantom size]\n", argv[0]);
+            for (auto const& benchmark : benchmarks)
+                fmt::print("  {}\n", benchmark.Name);
+            return 1;
+        }
+    }
+
+    try {
+        BenchmarkScene scene;
+        LoadBenchmarkScene(scene, options);
+
+        const auto dimension = scene.Volume.GetDimension();
+        fmt::print("Volume {}x{}x{}, {}x{}, {} threads\n", dimension.x, dimension.y, dimension.z, options.Width, options.Height, options.ThreadCount);
+
+        for (auto const& benchmark : benchmarks) {
+            if (!options.Filter.empty() && std::string(benchmark.Name).find(options.Filter) == std::string::npos)
+                continue;
+            fmt::print("\n[{}]\n", benchmark.Name);
+            benchmark.Function(scene, options);
+        }
+    } catch (std::exception const& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
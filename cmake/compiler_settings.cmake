@@ -4,13 +4,26 @@ set(CMAKE_CXX_EXTENSIONS OFF)
 
 add_compile_options($<$<CXX_COMPILER_ID:MSVC>:/MP>)
 
+# Only the SIMD sources get these, see SOURCE_CORE_SIMD
+option(VOLUME_RENDER_ENABLE_AVX2 "Build the CPU volume marcher for AVX2, SSE2 otherwise" ON)
+set(SIMD_COMPILE_OPTIONS)
+if(VOLUME_RENDER_ENABLE_AVX2)
+    list(APPEND SIMD_COMPILE_OPTIONS $<IF:$<CXX_COMPILER_ID:MSVC>,/arch:AVX2,-mavx2>)
+    list(APPEND SIMD_COMPILE_OPTIONS $<$<NOT:$<CXX_COMPILER_ID:MSVC>>:-mfma>)
+endif()
+
 if(WIN32)
    set(PLATFORM_WIN32 TRUE CACHE INTERNAL "Target platform: Win32")
    message("Target platform: Win32. SDK Version: " ${CMAKE_SYSTEM_VERSION})
+elseif(UNIX)
+   set(PLATFORM_LINUX TRUE CACHE INTERNAL "Target platform: Linux")
+   message("Target platform: Linux. Only the core library, the benchmark and the batch renderer are built")
 endif()
 
 if(PLATFORM_WIN32)
     set(GLOBAL_COMPILE_DEFINITIONS GLFW_EXPOSE_NATIVE_WIN32=1 NOMINMAX)
+elseif(PLATFORM_LINUX)
+    set(GLOBAL_COMPILE_DEFINITIONS)
 else()
     message(FATAL_ERROR "Unknown platform")
 endif()
@@ -27,11 +27,24 @@
 Texture2D<float3> TextureColorSRV : register(t0);
 StructuredBuffer<uint> BufferDispersionTiles : register(t1);
 RWTexture2D<float4> TextureColorSumUAV : register(u0);
+RWTexture2D<float> TextureColorMomentUAV : register(u1);
 
+// The w component counts the samples of the pixel, retired tiles stop accumulating before the others
 [numthreads(THREAD_GROUP_SIZE_X, THREAD_GROUP_SIZE_Y, 1)]
 void Accumulate(uint3 threadID : SV_GroupThreadID, uint3 groupID : SV_GroupID)
 {
+    if (!IsTileInPass(BufferDispersionTiles, groupID.x))
+        return;
+
     uint2 id = GetThreadIDFromTileList(BufferDispersionTiles, groupID.x, threadID.xy);
-    float alpha = 1.0f / (FrameBuffer.FrameIndex + 1.0f);
-    TextureColorSumUAV[id] = lerp(TextureColorSumUAV[id], float4(TextureColorSRV[id].xyz, 1.0), float4(alpha, alpha, alpha, alpha));
+    float4 colorSum = FrameBuffer.FrameIndex == 0 ? 0.0f : TextureColorSumUAV[id];
+    float colorMoment = FrameBuffer.FrameIndex == 0 ? 0.0f : TextureColorMomentUAV[id];
+
+    float3 color = TextureColorSRV[id].xyz;
+    float luminance = Luminance(color);
+    float count = colorSum.w + 1.0f;
+    float alpha = 1.0f / count;
+
+    TextureColorSumUAV[id] = float4(lerp(colorSum.xyz, color, alpha), count);
+    TextureColorMomentUAV[id] = lerp(colorMoment, luminance * luminance, alpha);
 }
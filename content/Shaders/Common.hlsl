@@ -31,6 +31,26 @@ static const float FLT_EPSILON = 1.192092896e-07f;
 static const float FLT_MAX = 3.402823466e+38f;
 static const float FLT_MIN = 1.175494351e-38f;
 
+static const uint TRACKING_MODE_RAY_MARCHING = 0;
+static const uint TRACKING_MODE_DELTA = 1;
+
+static const uint TRANSMITTANCE_ESTIMATOR_TRACKING = 0;
+static const uint TRANSMITTANCE_ESTIMATOR_RATIO = 1;
+static const uint TRANSMITTANCE_ESTIMATOR_RESIDUAL_RATIO = 2;
+
+static const uint LIGHT_SAMPLING_BSDF = 0;
+static const uint LIGHT_SAMPLING_MIS = 1;
+
+static const uint SAMPLE_SEQUENCE_RANDOM = 0;
+static const uint SAMPLE_SEQUENCE_SOBOL = 1;
+static const uint SAMPLE_SEQUENCE_RANK1 = 2;
+
+static const uint SAMPLER_DIMENSIONS_PER_BOUNCE = 16;
+
+static const uint CLIP_PLANE_COUNT_MAX = 6;
+
+static const uint TILE_PASS_COUNT_MAX = 4;
+
 cbuffer ConstantFrameBuffer : register(b0)
 {
     struct
@@ -55,7 +75,8 @@ cbuffer ConstantFrameBuffer : register(b0)
 
         uint FrameIndex;
         float StepSize;
-        float2 FrameOffset;
+        uint SampleSequence;
+        uint BlueNoiseSize;
         
         float2 InvRenderTargetDim;
         float2 RenderTargetDim;
@@ -65,9 +86,34 @@ cbuffer ConstantFrameBuffer : register(b0)
 
         float Exposure;
         float3 BoundingBoxMax;
+
+        uint3 MajorantGridDimension;
+        uint TrackingMode;
+
+        uint TransmittanceEstimator;
+        uint LevelOfDetail;
+        uint LevelOfDetailDepthBias;
+        uint LevelOfDetailMax;
+
+        uint2 EnvironmentDimension;
+        uint LightSampling;
+        float TileErrorThreshold;
+
+        float4x4 CropBoxMatrix;
+        float4 ClipPlanes[CLIP_PLANE_COUNT_MAX];
+
+        float3 CropBoxMin;
+        uint ClipPlaneCount;
+
+        float3 CropBoxMax;
+        uint TilePass;
     } FrameBuffer;
 }
 
+// Selected tiles per pass count in the first TILE_PASS_COUNT_MAX elements, then the pass count of every tile
+StructuredBuffer<uint> BufferTilePasses : register(t14);
+Texture2D<float> TextureBlueNoise : register(t15);
+
 struct Ray
 {
     float3 Origin;
@@ -88,6 +134,9 @@ struct AABB
     float3 Max;
 };
 
+// The volume fills this cube of model space, FrameBuffer.BoundingBoxMin/Max is the part of it rays are clipped to
+static const AABB VOLUME_BOUNDING_BOX = { -0.5f, -0.5f, -0.5f, +0.5f, +0.5f, +0.5f };
+
 struct CRNG
 {
     uint Seed;
@@ -108,6 +157,11 @@ float Med3(float a, float b, float c)
     return clamp(a, min(b, c), max(b, c));
 }
 
+float Luminance(float3 color)
+{
+    return dot(float3(0.2126, 0.7152, 0.0722), color);
+}
+
 float2 EncodeNormal(float3 normal)
 {
     float2 packed = normal.xy * (1.f / (abs(normal.x) + abs(normal.y) + abs(normal.z)));
@@ -146,9 +200,40 @@ Intersection IntersectAABB(Ray ray, AABB aabb)
     return intersect;
 }
 
+// Narrows the interval of a ray to the clip planes and the crop box once, before marching, instead of testing every sample
+Intersection ClipRay(Ray ray, Intersection intersect)
+{
+    for (uint index = 0; index < FrameBuffer.ClipPlaneCount; index++)
+    {
+        const float4 plane = FrameBuffer.ClipPlanes[index];
+        const float offset = dot(plane.xyz, ray.Origin) + plane.w;
+        const float cosine = dot(plane.xyz, ray.Direction);
+
+        // Rays parallel to a plane are kept or clipped as a whole
+        if (cosine > 0.0f)
+            intersect.Min = max(intersect.Min, -offset / cosine);
+        else if (cosine < 0.0f)
+            intersect.Max = min(intersect.Max, -offset / cosine);
+        else if (offset < 0.0f)
+            intersect.Max = -FLT_MAX;
+    }
+
+    Ray rayCrop;
+    rayCrop.Origin = mul(FrameBuffer.CropBoxMatrix, float4(ray.Origin, 1.0f)).xyz;
+    rayCrop.Direction = mul(FrameBuffer.CropBoxMatrix, float4(ray.Direction, 0.0f)).xyz;
+    rayCrop.Min = 0.0f;
+    rayCrop.Max = 0.0f;
+
+    const AABB cropBox = { FrameBuffer.CropBoxMin, FrameBuffer.CropBoxMax };
+    const Intersection crop = IntersectAABB(rayCrop, cropBox);
+    intersect.Min = max(intersect.Min, crop.Min);
+    intersect.Max = min(intersect.Max, crop.Max);
+    return intersect;
+}
+
 Ray CreateCameraRay(uint2 id, float2 offset, float2 invDimension, float4x4 invWVP)
 {
-    float2 ncdXY = ScreenSpaceToNDC(id, invDimension);
+    float2 ncdXY = ScreenSpaceToNDC(float2(id) + offset, invDimension);
 
     float4 rayStart = mul(invWVP, float4(ncdXY, 0.0, 1.0f));
     float4 rayEnd = mul(invWVP, float4(ncdXY, 1.0f, 1.0f));
@@ -172,19 +257,150 @@ uint PCGHash(uint seed)
     return (word >> 22u) ^ word;
 }
 
+float ToUnitFloat(uint x)
+{
+    return asfloat(0x3f800000 | (x >> 9)) - 1.0;
+}
+
 float Rand(inout CRNG rng)
 {
     rng.Seed = PCGHash(rng.Seed);
-    uint u = 0x3f800000 | (rng.Seed >> 9);
-    return asfloat(u) - 1.0;
+    return ToUnitFloat(rng.Seed);
+}
+
+uint HashCombine(uint seed, uint value)
+{
+    return seed ^ (PCGHash(value) + 0x9E3779B9u + (seed << 6) + (seed >> 2));
+}
+
+// Owen scrambling of the bits of x, most significant first (Burley, Practical Hash-based Owen Scrambling)
+uint NestedUniformScramble(uint x, uint seed)
+{
+    x = reversebits(x);
+    x += seed;
+    x ^= x * 0x6C50B47Cu;
+    x ^= x * 0xB82F1E52u;
+    x ^= x * 0xC7AFE638u;
+    x ^= x * 0x8D22F6E6u;
+    return reversebits(x);
+}
+
+// Generator matrices of the first four Sobol dimensions (Joe and Kuo), column i is applied for bit i of the index
+static const uint SobolDirections[128] =
+{
+    0x80000000u, 0x40000000u, 0x20000000u, 0x10000000u, 0x08000000u, 0x04000000u, 0x02000000u, 0x01000000u,
+    0x00800000u, 0x00400000u, 0x00200000u, 0x00100000u, 0x00080000u, 0x00040000u, 0x00020000u, 0x00010000u,
+    0x00008000u, 0x00004000u, 0x00002000u, 0x00001000u, 0x00000800u, 0x00000400u, 0x00000200u, 0x00000100u,
+    0x00000080u, 0x00000040u, 0x00000020u, 0x00000010u, 0x00000008u, 0x00000004u, 0x00000002u, 0x00000001u,
+    
+    0x80000000u, 0xC0000000u, 0xA0000000u, 0xF0000000u, 0x88000000u, 0xCC000000u, 0xAA000000u, 0xFF000000u,
+    0x80800000u, 0xC0C00000u, 0xA0A00000u, 0xF0F00000u, 0x88880000u, 0xCCCC0000u, 0xAAAA0000u, 0xFFFF0000u,
+    0x80008000u, 0xC000C000u, 0xA000A000u, 0xF000F000u, 0x88008800u, 0xCC00CC00u, 0xAA00AA00u, 0xFF00FF00u,
+    0x80808080u, 0xC0C0C0C0u, 0xA0A0A0A0u, 0xF0F0F0F0u, 0x88888888u, 0xCCCCCCCCu, 0xAAAAAAAAu, 0xFFFFFFFFu,
+    
+    0x80000000u, 0xC0000000u, 0x60000000u, 0x90000000u, 0xE8000000u, 0x5C000000u, 0x8E000000u, 0xC5000000u,
+    0x68800000u, 0x9CC00000u, 0xEE600000u, 0x55900000u, 0x80680000u, 0xC09C0000u, 0x60EE0000u, 0x90550000u,
+    0xE8808000u, 0x5CC0C000u, 0x8E606000u, 0xC5909000u, 0x6868E800u, 0x9C9C5C00u, 0xEEEE8E00u, 0x5555C500u,
+    0x8000E880u, 0xC0005CC0u, 0x60008E60u, 0x9000C590u, 0xE8006868u, 0x5C009C9Cu, 0x8E00EEEEu, 0xC5005555u,
+    
+    0x80000000u, 0xC0000000u, 0x20000000u, 0x50000000u, 0xF8000000u, 0x74000000u, 0xA2000000u, 0x93000000u,
+    0xD8800000u, 0x25400000u, 0x59E00000u, 0xE6D00000u, 0x78080000u, 0xB40C0000u, 0x82020000u, 0xC3050000u,
+    0x208F8000u, 0x51474000u, 0xFBEA2000u, 0x75D93000u, 0xA0858800u, 0x914E5400u, 0xDBE79E00u, 0x25DB6D00u,
+    0x58800080u, 0xE54000C0u, 0x79E00020u, 0xB6D00050u, 0x800800F8u, 0xC00C0074u, 0x200200A2u, 0x50050093u
+};
+
+// Generating vector of the base-2 embedded rank-1 lattice sequence, see Shading::Rank1Generator
+static const uint Rank1Generator[32] =
+{
+    1u, 30941u, 12149u, 27337u, 15471u, 5909u, 23763u, 64141u,
+    64471u, 36319u, 32667u, 56837u, 49533u, 51257u, 37839u, 13465u,
+    52323u, 17729u, 2257u, 48671u, 55975u, 58231u, 23637u, 33199u,
+    54579u, 45017u, 10423u, 863u, 41365u, 53185u, 24499u, 28151u
+};
+
+uint Sobol(uint index, uint dimension)
+{
+    uint x = 0;
+    for (uint bit = 0; index != 0; index >>= 1, bit++)
+        x ^= (index & 1) ? SobolDirections[32 * dimension + bit] : 0;
+    return x;
 }
 
-CRNG InitCRND(uint2 id, uint frameIndex)
+// Sample vector of one pixel, frame and path vertex, dimensions are indexed relative to the vertex
+struct CSampler
 {
-    CRNG rng = { frameIndex + PCGHash((id.x << 16) | id.y) };
+    uint Index;
+    uint Dimension;
+    uint Seed;
+    uint2 Pixel;
+};
+
+CSampler InitSampler(uint2 id, uint frameIndex, uint bounce)
+{
+    CSampler sequence = { frameIndex, bounce * SAMPLER_DIMENSIONS_PER_BOUNCE, PCGHash((id.x << 16) | id.y), id };
+    return sequence;
+}
+
+// Every pixel walks its own sequence, so the extra passes of a tile take the next samples of its pixels
+uint GetSampleIndex(Texture2D<float4> colorSum, uint2 id)
+{
+    return FrameBuffer.FrameIndex == 0 ? 0 : (uint) colorSum[id].w;
+}
+
+float Sample1D(CSampler sequence, uint offset)
+{
+    const uint dimension = sequence.Dimension + offset;
+    
+    [branch]
+    if (FrameBuffer.SampleSequence == SAMPLE_SEQUENCE_SOBOL)
+    {
+        const uint index = NestedUniformScramble(sequence.Index, HashCombine(sequence.Seed, dimension / 4));
+        return ToUnitFloat(NestedUniformScramble(Sobol(index, dimension % 4), HashCombine(sequence.Seed, dimension)));
+    }
+    
+    [branch]
+    if (FrameBuffer.SampleSequence == SAMPLE_SEQUENCE_RANK1)
+    {
+        const uint size = FrameBuffer.BlueNoiseSize;
+        const uint shift = PCGHash(dimension);
+        const uint2 texel = (sequence.Pixel + uint2(shift & 0xFFFF, shift >> 16)) % size;
+        const uint rotation = uint(TextureBlueNoise.Load(int3(texel, 0)) * 4294967296.0);
+        return ToUnitFloat(reversebits(sequence.Index) * Rank1Generator[dimension % 32] + rotation);
+    }
+    
+    return ToUnitFloat(PCGHash(HashCombine(HashCombine(sequence.Seed, sequence.Index), dimension)));
+}
+
+float2 Sample2D(CSampler sequence, uint offset)
+{
+    return float2(Sample1D(sequence, offset), Sample1D(sequence, offset + 1));
+}
+
+// Generator for tracking loops, which take an unbounded number of random numbers, seeded from a dimension
+CRNG SampleRNG(CSampler sequence, uint offset)
+{
+    CRNG rng = { PCGHash(HashCombine(HashCombine(sequence.Seed, sequence.Index), sequence.Dimension + offset) ^ 0x5BD1E995u) };
     return rng;
 }
 
+// Subpixel offset of the camera ray in [-0.5, 0.5)^2, the first dimensions of the primary vertex
+float2 SamplePixelJitter(CSampler sequence)
+{
+    return Sample2D(sequence, 0) - 0.5f;
+}
+
+// Mip level of the volume sampled by rays at the given path depth, FrameBuffer.LevelOfDetail for primary rays
+uint GetLevelOfDetail(uint depth)
+{
+    return min(FrameBuffer.LevelOfDetail + depth * FrameBuffer.LevelOfDetailDepthBias, FrameBuffer.LevelOfDetailMax);
+}
+
+// FrameBuffer.StepSize is the step of the primary level of detail, the step doubles with every coarser level
+float GetStepSize(uint levelOfDetail)
+{
+    return FrameBuffer.StepSize * float(1u << (levelOfDetail - FrameBuffer.LevelOfDetail));
+}
+
 float3 GetNormalizedTexcoord(float3 position, AABB aabb)
 {
     return (position - aabb.Min) / (aabb.Max - aabb.Min);
@@ -195,9 +411,91 @@ float3 GetWorldPosition(float3 texcoord, AABB aabb)
     return texcoord * (aabb.Max - aabb.Min) + aabb.Min;
 }
 
+struct GridTraversal
+{
+    int3 Cell;
+    int3 Step;
+    float3 DeltaT;
+    float3 NextT;
+};
+
+// 3D-DDA over the cells of a grid spanning the bounding box. Origin and direction are given in grid coordinates
+GridTraversal InitGridTraversal(float3 origin, float3 direction, float t, uint3 dimension)
+{
+    const float3 position = origin + t * direction;
+    const bool3 isParallel = direction == 0.0f;
+    
+    GridTraversal grid;
+    grid.Cell = clamp(int3(floor(position)), 0, int3(dimension) - 1);
+    grid.Step = direction >= 0.0f ? 1 : -1;
+    grid.DeltaT = isParallel ? FLT_MAX : abs(rcp(direction));
+    grid.NextT = isParallel ? FLT_MAX : t + (float3(grid.Cell + max(grid.Step, 0)) - position) / direction;
+    return grid;
+}
+
+float GetGridTraversalExit(GridTraversal grid)
+{
+    return Min3(grid.NextT.x, grid.NextT.y, grid.NextT.z);
+}
+
+bool AdvanceGridTraversal(inout GridTraversal grid, uint3 dimension)
+{
+    const uint axis = (grid.NextT.x <= grid.NextT.y && grid.NextT.x <= grid.NextT.z) ? 0 : (grid.NextT.y <= grid.NextT.z ? 1 : 2);
+    grid.Cell[axis] += grid.Step[axis];
+    grid.NextT[axis] += grid.DeltaT[axis];
+    return grid.Cell[axis] >= 0 && grid.Cell[axis] < int(dimension[axis]);
+}
+
 uint2 GetThreadIDFromTileList(StructuredBuffer<uint> tiles, uint threadGroupID, uint2 offset)
 {
     uint packedTile = tiles[threadGroupID];
     uint2 unpackedGroupID = uint2(packedTile & 0xFFFF, (packedTile >> 16) & 0xFFFF);
     return uint2(THREAD_GROUP_SIZE_X, THREAD_GROUP_SIZE_Y) * unpackedGroupID + offset;
 }
+
+uint2 GetTileCount()
+{
+    const uint2 tileSize = uint2(THREAD_GROUP_SIZE_X, THREAD_GROUP_SIZE_Y);
+    return (uint2(FrameBuffer.RenderTargetDim) + tileSize - 1) / tileSize;
+}
+
+uint GetTilePassCount(float error, float threshold)
+{
+    if (!(error > threshold))
+        return 0;
+    if (!(threshold > 0.0f))
+        return 1;
+    return 1 + (uint) min(log2(error / threshold), float(TILE_PASS_COUNT_MAX - 1));
+}
+
+uint ApplyTilePassBudget(uint passCount, uint tileCount)
+{
+    uint selectedCount = 0;
+    for (uint index = 0; index < TILE_PASS_COUNT_MAX; index++)
+        selectedCount += BufferTilePasses[index];
+
+    uint budget = tileCount - min(selectedCount, tileCount);
+    for (uint count = TILE_PASS_COUNT_MAX; count > 1; count--)
+    {
+        const uint histogram = BufferTilePasses[count - 1];
+        const uint extraCount = histogram > 0 ? min(count - 1, budget / histogram) : count - 1;
+        if (count == passCount)
+            return 1 + extraCount;
+        if (extraCount < count - 1)
+            break;
+        budget -= extraCount * histogram;
+    }
+    return min(passCount, 1u);
+}
+
+// Extra passes of a frame only render the tiles the budget gives that many passes
+bool IsTileInPass(StructuredBuffer<uint> tiles, uint threadGroupID)
+{
+    if (FrameBuffer.TilePass == 0)
+        return true;
+
+    const uint packedTile = tiles[threadGroupID];
+    const uint2 tileCount = GetTileCount();
+    const uint passCount = BufferTilePasses[TILE_PASS_COUNT_MAX + ((packedTile >> 16) & 0xFFFF) * tileCount.x + (packedTile & 0xFFFF)];
+    return FrameBuffer.TilePass < ApplyTilePassBudget(passCount, tileCount.x * tileCount.y);
+}
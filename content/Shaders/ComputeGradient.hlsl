@@ -28,47 +28,46 @@ Texture3D<float> TextureSrc : register(t0);
 Texture1D<float> TextureTransferFunction : register(t1);
 RWTexture3D<float4> TextureDst : register(u0);
 
-float GetIntensity(int3 location, int3 offset)
+// maxLocation is the last texel of TextureSrc, queried once per thread instead of once per tap
+float GetIntensity(int3 location, int3 offset, int3 maxLocation)
 {
-    int3 dimension;
-    TextureSrc.GetDimensions(dimension.x, dimension.y, dimension.z);
-    return TextureSrc.Load(uint4(clamp(location + offset, int3(0, 0, 0), int3(dimension.x, dimension.y, dimension.z) - int3(1, 1, 1)), 0));
+    return TextureSrc.Load(int4(clamp(location + offset, int3(0, 0, 0), maxLocation), 0));
 }
 
-float3 ComputeGradientCD(int3 location)
+float3 ComputeGradientCD(int3 location, int3 maxLocation)
 {
-    float dx = GetIntensity(location, int3(1, 0, 0)) - GetIntensity(location, int3(-1, 0, 0));
-    float dy = GetIntensity(location, int3(0, 1, 0)) - GetIntensity(location, int3(0, -1, 0));
-    float dz = GetIntensity(location, int3(0, 0, 1)) - GetIntensity(location, int3(0, 0, -1));
+    float dx = GetIntensity(location, int3(1, 0, 0), maxLocation) - GetIntensity(location, int3(-1, 0, 0), maxLocation);
+    float dy = GetIntensity(location, int3(0, 1, 0), maxLocation) - GetIntensity(location, int3(0, -1, 0), maxLocation);
+    float dz = GetIntensity(location, int3(0, 0, 1), maxLocation) - GetIntensity(location, int3(0, 0, -1), maxLocation);
     return float3(dx, dy, dz);
 }
 
-float3 ComputeGradientFD(int3 location)
+float3 ComputeGradientFD(int3 location, int3 maxLocation)
 {
-    float p = GetIntensity(location, int3(0, 0, 0));
-    float dx = GetIntensity(location, int3(1, 0, 0)) - p;
-    float dy = GetIntensity(location, int3(0, 1, 0)) - p;
-    float dz = GetIntensity(location, int3(0, 0, 1)) - p;
+    float p = GetIntensity(location, int3(0, 0, 0), maxLocation);
+    float dx = GetIntensity(location, int3(1, 0, 0), maxLocation) - p;
+    float dy = GetIntensity(location, int3(0, 1, 0), maxLocation) - p;
+    float dz = GetIntensity(location, int3(0, 0, 1), maxLocation) - p;
     return float3(dx, dy, dz);
 }
 
-float3 ComputeGradientFiltered(int3 location)
+float3 ComputeGradientFiltered(int3 location, int3 maxLocation)
 {
-    float3 G0 = ComputeGradientCD(location + int3(0, 0, 0));
-    float3 G1 = ComputeGradientCD(location + int3(0, 0, 1));
-    float3 G2 = ComputeGradientCD(location + int3(0, 1, 0));
-    float3 G3 = ComputeGradientCD(location + int3(0, 1, 1));
-    float3 G4 = ComputeGradientCD(location + int3(1, 0, 0));
-    float3 G5 = ComputeGradientCD(location + int3(1, 0, 1));
-    float3 G6 = ComputeGradientCD(location + int3(1, 1, 0));
-    float3 G7 = ComputeGradientCD(location + int3(1, 1, 1));
+    float3 G0 = ComputeGradientCD(location + int3(0, 0, 0), maxLocation);
+    float3 G1 = ComputeGradientCD(location + int3(0, 0, 1), maxLocation);
+    float3 G2 = ComputeGradientCD(location + int3(0, 1, 0), maxLocation);
+    float3 G3 = ComputeGradientCD(location + int3(0, 1, 1), maxLocation);
+    float3 G4 = ComputeGradientCD(location + int3(1, 0, 0), maxLocation);
+    float3 G5 = ComputeGradientCD(location + int3(1, 0, 1), maxLocation);
+    float3 G6 = ComputeGradientCD(location + int3(1, 1, 0), maxLocation);
+    float3 G7 = ComputeGradientCD(location + int3(1, 1, 1), maxLocation);
  
     float3 L0 = lerp(lerp(G0, G2, 0.5), lerp(G4, G6, 0.5), 0.5);
     float3 L1 = lerp(lerp(G1, G3, 0.5), lerp(G5, G7, 0.5), 0.5);
     return lerp(G0, lerp(L0, L1, 0.5), 0.5);
 }
 
-float3 ComputeGradientSobel(uint3 location)
+float3 ComputeGradientSobel(uint3 location, int3 maxLocation)
 {
     int Gx[3][3][3] =
     {
@@ -100,7 +99,7 @@ float3 ComputeGradientSobel(uint3 location)
         {
             for (int z = -1; z <= 1; z++)
             {
-                float intensity = GetIntensity(location, int3(x, y, z));
+                float intensity = GetIntensity(location, int3(x, y, z), maxLocation);
                 dx += Gx[x + 1][y + 1][z + 1] * intensity;
                 dy += Gy[x + 1][y + 1][z + 1] * intensity;
                 dz += Gz[x + 1][y + 1][z + 1] * intensity;
@@ -110,14 +109,17 @@ float3 ComputeGradientSobel(uint3 location)
     return float3(dx, dy, dz) / 16.0;
 }
 
-float3 Gradient(uint3 location)
+float3 Gradient(uint3 location, int3 maxLocation)
 {
-    return ComputeGradientSobel(location);
+    return ComputeGradientSobel(location, maxLocation);
 }
 
 [numthreads(4, 4, 4)]
 void ComputeGradient(uint3 threadID : SV_DispatchThreadID, uint lineID : SV_GroupIndex)
 {
-    float3 gradient = Gradient(threadID);
+    int3 dimension;
+    TextureSrc.GetDimensions(dimension.x, dimension.y, dimension.z);
+    
+    float3 gradient = Gradient(threadID, dimension - int3(1, 1, 1));
     TextureDst[threadID] = float4(gradient, 0); //float4(length(gradient) < FLT_MIN ? float3(0.0f, 0.0f, 0.0f) : normalize(gradient), length(gradient));
 }
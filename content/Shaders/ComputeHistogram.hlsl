@@ -0,0 +1,77 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Common.hlsl"
+
+#define WAVEFRONT_SIZE (THREAD_GROUP_SIZE_X) * (THREAD_GROUP_SIZE_Y)
+
+// Keep in step with AutoExposure, the bin is the exponent and the top log2(HISTOGRAM_BINS_PER_STOP) mantissa bits
+static const uint HISTOGRAM_BIN_COUNT = 128;
+static const uint HISTOGRAM_BINS_PER_STOP = 8;
+static const uint HISTOGRAM_MANTISSA_SHIFT = 20;
+static const int HISTOGRAM_LOG_LUMINANCE_MIN = -12;
+
+Texture2D<float4> TextureColorSumSRV : register(t0);
+StructuredBuffer<uint> BufferDispersionTiles : register(t1);
+RWStructuredBuffer<uint> BufferTileHistograms : register(u0);
+RWStructuredBuffer<uint> BufferHistogram : register(u1);
+
+groupshared uint SharedHistogram[HISTOGRAM_BIN_COUNT];
+
+uint GetHistogramBin(float luminance)
+{
+    const int bin = int(asuint(luminance) >> HISTOGRAM_MANTISSA_SHIFT) - (127 + HISTOGRAM_LOG_LUMINANCE_MIN) * int(HISTOGRAM_BINS_PER_STOP);
+    return uint(clamp(bin, 0, int(HISTOGRAM_BIN_COUNT) - 1));
+}
+
+[numthreads(THREAD_GROUP_SIZE_X, THREAD_GROUP_SIZE_Y, 1)]
+void ComputeHistogram(uint3 threadID : SV_GroupThreadID, uint3 groupID : SV_GroupID, uint lineID : SV_GroupIndex)
+{
+    for (uint bin = lineID; bin < HISTOGRAM_BIN_COUNT; bin += WAVEFRONT_SIZE)
+        SharedHistogram[bin] = 0;
+    GroupMemoryBarrierWithGroupSync();
+
+    // Pixels without samples or below the range of the histogram are left out, as on the CPU
+    const uint2 id = GetThreadIDFromTileList(BufferDispersionTiles, groupID.x, threadID.xy);
+    const float4 colorSum = TextureColorSumSRV.Load(int3(id, 0));
+    const float luminance = Luminance(colorSum.xyz);
+    if (all(id < uint2(FrameBuffer.RenderTargetDim)) && colorSum.w > 0.0f && luminance >= exp2(HISTOGRAM_LOG_LUMINANCE_MIN))
+        InterlockedAdd(SharedHistogram[GetHistogramBin(luminance)], 1);
+    GroupMemoryBarrierWithGroupSync();
+
+    // The image histogram gets the difference to what the tile binned before, negative counts wrap around
+    const uint tile = BufferDispersionTiles[groupID.x];
+    const uint tileCountX = (uint(FrameBuffer.RenderTargetDim.x) + THREAD_GROUP_SIZE_X - 1) / THREAD_GROUP_SIZE_X;
+    const uint tileOffset = (((tile >> 16) & 0xFFFF) * tileCountX + (tile & 0xFFFF)) * HISTOGRAM_BIN_COUNT;
+    for (uint bin = lineID; bin < HISTOGRAM_BIN_COUNT; bin += WAVEFRONT_SIZE)
+    {
+        const uint count = SharedHistogram[bin];
+        const uint countPrevious = BufferTileHistograms[tileOffset + bin];
+        if (count != countPrevious)
+        {
+            BufferTileHistograms[tileOffset + bin] = count;
+            InterlockedAdd(BufferHistogram[bin], count - countPrevious);
+        }
+    }
+}
@@ -29,6 +29,7 @@ struct VolumeDesc
     AABB BoundingBox;
     float StepSize;
     float DensityScale;
+    uint LevelOfDetail;
 };
 
 struct ScatterEvent
@@ -48,6 +49,8 @@ Texture1D<float3> TextureTransferFunctionSpecular : register(t3);
 Texture1D<float1> TextureTransferFunctionRoughness : register(t4);
 Texture1D<float1> TextureTransferFunctionOpacity : register(t5);
 StructuredBuffer<uint> BufferDispersionTiles : register(t6);
+Texture3D<float> TextureMajorant : register(t7);
+Texture2D<float4> TextureColorSum : register(t8);
 
 RWTexture2D<float3> TextureDiffuseUAV : register(u0);
 RWTexture2D<float3> TextureSpecularUAV : register(u1);
@@ -60,12 +63,12 @@ SamplerState SamplerAnisotropic : register(s2);
 
 float GetIntensity(VolumeDesc desc, float3 position)
 {
-    return TextureVolumeIntensity.SampleLevel(SamplerLinear, GetNormalizedTexcoord(position, desc.BoundingBox), 0);
+    return TextureVolumeIntensity.SampleLevel(SamplerLinear, GetNormalizedTexcoord(position, VOLUME_BOUNDING_BOX), desc.LevelOfDetail);
 }
 
 float3 GetGradient(VolumeDesc desc, float3 position)
 {
-    return TextureVolumeGradient.SampleLevel(SamplerLinear, GetNormalizedTexcoord(position, desc.BoundingBox), 0);
+    return TextureVolumeGradient.SampleLevel(SamplerLinear, GetNormalizedTexcoord(position, VOLUME_BOUNDING_BOX), 0);
 }
  
 float GetOpacity(VolumeDesc desc, float3 position)
@@ -88,30 +91,23 @@ float GetRoughness(VolumeDesc desc, float3 position)
     return TextureTransferFunctionRoughness.SampleLevel(SamplerLinear, GetIntensity(desc, position), 0);
 }
 
-ScatterEvent RayMarching(Ray ray, VolumeDesc desc, inout CRNG rng)
+bool RayMarching(Ray ray, VolumeDesc desc, float2 u, out float3 position)
 {
-    ScatterEvent event;
-    event.Position = float3(0.0f, 0.0f, 0.0f);
-    event.Normal = float3(0.0f, 0.0f, 0.0f);
-    event.Diffuse = float3(0.0f, 0.0f, 0.0f);
-    event.Specular = float3(0.0f, 0.0f, 0.0f);
-    event.Roughness = 0.0f;
-    event.IsValid = false;
-      
-    Intersection intersect = IntersectAABB(ray, desc.BoundingBox);
+    position = float3(0.0, 0.0, 0.0f);
+    
+    Intersection intersect = ClipRay(ray, IntersectAABB(ray, desc.BoundingBox));
 	
     [branch]
     if (intersect.Max < intersect.Min)
-        return event;
+        return false;
 
     const float minT = max(intersect.Min, ray.Min);
     const float maxT = min(intersect.Max, ray.Max);
     
-    const float threshold = -log(1.0 - Rand(rng)) / desc.DensityScale;
+    const float threshold = -log(1.0 - u.x) / desc.DensityScale;
 	
     float sum = 0.0f;
-    float t = minT + Rand(rng) * desc.StepSize;
-    float3 position = float3(0.0, 0.0, 0.0f);
+    float t = minT + u.y * desc.StepSize;
     
     [loop]
     while (sum < threshold)
@@ -119,11 +115,88 @@ ScatterEvent RayMarching(Ray ray, VolumeDesc desc, inout CRNG rng)
         position = ray.Origin + t * ray.Direction;
         [branch]
         if (t >= maxT)
-            return event;
+            return false;
 
         sum += desc.DensityScale * GetOpacity(desc, position) * desc.StepSize;
         t += desc.StepSize;
     }
+    return true;
+}
+
+bool DeltaTracking(Ray ray, VolumeDesc desc, inout CRNG rng, out float3 position)
+{
+    position = float3(0.0, 0.0, 0.0f);
+    
+    Intersection intersect = ClipRay(ray, IntersectAABB(ray, desc.BoundingBox));
+	
+    [branch]
+    if (intersect.Max < intersect.Min)
+        return false;
+
+    const float minT = max(intersect.Min, ray.Min);
+    const float maxT = min(intersect.Max, ray.Max);
+    
+    const uint3 dimension = FrameBuffer.MajorantGridDimension;
+    const float3 scale = float3(dimension) / (VOLUME_BOUNDING_BOX.Max - VOLUME_BOUNDING_BOX.Min);
+    GridTraversal grid = InitGridTraversal((ray.Origin - VOLUME_BOUNDING_BOX.Min) * scale, ray.Direction * scale, minT, dimension);
+    
+    float t = minT;
+    
+    [loop]
+    while (t < maxT)
+    {
+        const float exitT = min(GetGridTraversalExit(grid), maxT);
+        const float majorant = desc.DensityScale * TextureMajorant.Load(int4(grid.Cell, 0));
+        
+        [branch]
+        if (majorant > 0.0f)
+        {
+            const float sampleT = t - log(1.0f - Rand(rng)) / majorant;
+            [branch]
+            if (sampleT < exitT)
+            {
+                t = sampleT;
+                position = ray.Origin + t * ray.Direction;
+                [branch]
+                if (Rand(rng) * majorant < desc.DensityScale * GetOpacity(desc, position))
+                    return true;
+                continue;
+            }
+        }
+        
+        t = exitT;
+        [branch]
+        if (!AdvanceGridTraversal(grid, dimension))
+            break;
+    }
+    return false;
+}
+
+ScatterEvent ComputeScatterEvent(Ray ray, VolumeDesc desc, CSampler sequence)
+{
+    ScatterEvent event;
+    event.Position = float3(0.0f, 0.0f, 0.0f);
+    event.Normal = float3(0.0f, 0.0f, 0.0f);
+    event.Diffuse = float3(0.0f, 0.0f, 0.0f);
+    event.Specular = float3(0.0f, 0.0f, 0.0f);
+    event.Roughness = 0.0f;
+    event.IsValid = false;
+    
+    float3 position;
+    bool isScattered;
+    
+    [branch]
+    if (FrameBuffer.TrackingMode == TRACKING_MODE_DELTA)
+    {
+        CRNG rng = SampleRNG(sequence, 2);
+        isScattered = DeltaTracking(ray, desc, rng, position);
+    }
+    else
+        isScattered = RayMarching(ray, desc, Sample2D(sequence, 2), position);
+    
+    [branch]
+    if (!isScattered)
+        return event;
    
     const float3 gradient = GetGradient(desc, position);
     const precise float factor = rsqrt(dot(gradient, gradient));
@@ -149,18 +222,22 @@ ScatterEvent RayMarching(Ray ray, VolumeDesc desc, inout CRNG rng)
 [numthreads(THREAD_GROUP_SIZE_X, THREAD_GROUP_SIZE_Y, 1)]
 void GenerateRays(uint3 threadID : SV_GroupThreadID, uint3 groupID : SV_GroupID)
 {
+    if (!IsTileInPass(BufferDispersionTiles, groupID.x))
+        return;
+
     uint2 id = GetThreadIDFromTileList(BufferDispersionTiles, groupID.x, threadID.xy);
     
-    CRNG rng = InitCRND(id, FrameBuffer.FrameIndex);
-    Ray ray = CreateCameraRay(id, FrameBuffer.FrameOffset, FrameBuffer.InvRenderTargetDim, FrameBuffer.InvWorldViewProjectionMatrix);
+    CSampler sequence = InitSampler(id, GetSampleIndex(TextureColorSum, id), 0);
+    Ray ray = CreateCameraRay(id, SamplePixelJitter(sequence), FrameBuffer.InvRenderTargetDim, FrameBuffer.InvWorldViewProjectionMatrix);
  	
     VolumeDesc desc;
     desc.BoundingBox.Min = FrameBuffer.BoundingBoxMin;
     desc.BoundingBox.Max = FrameBuffer.BoundingBoxMax;
-    desc.StepSize = FrameBuffer.StepSize;
+    desc.LevelOfDetail = GetLevelOfDetail(0);
+    desc.StepSize = GetStepSize(desc.LevelOfDetail);
     desc.DensityScale = FrameBuffer.Density;
        
-    ScatterEvent event = RayMarching(ray, desc, rng);
+    ScatterEvent event = ComputeScatterEvent(ray, desc, sequence);
     if (event.IsValid)
     {
         float3 normal = { 0.0f, 0.0f, 0.0f };
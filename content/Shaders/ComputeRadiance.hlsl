@@ -24,11 +24,26 @@
 
 #include "Common.hlsl"
 
+// Sample dimensions of the radiance vertex
+static const uint RADIANCE_DIMENSION_DIRECTION = 0;
+static const uint RADIANCE_DIMENSION_LOBE = 2;
+static const uint RADIANCE_DIMENSION_LIGHT = 4;
+static const uint RADIANCE_DIMENSION_RAY_BSDF = 8;
+static const uint RADIANCE_DIMENSION_RAY_LIGHT = 10;
+
 struct VolumeDesc
 {
     AABB BoundingBox;
     float StepSize;
     float DensityScale;
+    uint LevelOfDetail;
+};
+
+struct EnvironmentAliasEntry
+{
+    float Probability;
+    uint Alias;
+    float Pdf;
 };
 
 struct GBuffer
@@ -49,6 +64,10 @@ Texture2D<float4> TextureNormal : register(t4);
 Texture2D<float> TextureDepth : register(t5);
 Texture2D<float3> TextureEnvironment : register(t6);
 StructuredBuffer<uint> BufferDispersionTiles : register(t7);
+Texture3D<float> TextureMajorant : register(t8);
+Texture3D<float2> TextureControl : register(t9);
+StructuredBuffer<EnvironmentAliasEntry> BufferEnvironmentAlias : register(t10);
+Texture2D<float4> TextureColorSum : register(t11);
 
 RWTexture2D<float3> TextureRadianceAV : register(u0);
 
@@ -82,9 +101,8 @@ float GGX_Distribution(float NdotH, float alpha)
     return aa * rcp(M_PI * f * f);
 }
 
-float3 SampleGGXDir(float3 normal, float alpha, inout CRNG rng)
+float3 SampleGGXDir(float3 normal, float alpha, float2 xi)
 {
-    float2 xi = float2(Rand(rng), Rand(rng));
     float phi = 2.0 * M_PI * xi.x;
     float cosTheta = sqrt(max(0.0f, (1.0 - xi.y) * rcp(1.0 + alpha * alpha * xi.y - xi.y)));
     float sinTheta = sqrt(max(0.0f, 1.0 - cosTheta * cosTheta));
@@ -93,7 +111,7 @@ float3 SampleGGXDir(float3 normal, float alpha, inout CRNG rng)
 
 float GetIntensity(VolumeDesc desc, float3 position)
 {
-    return TextureVolumeIntensity.SampleLevel(SamplerLinear, GetNormalizedTexcoord(position, desc.BoundingBox), 0);
+    return TextureVolumeIntensity.SampleLevel(SamplerLinear, GetNormalizedTexcoord(position, VOLUME_BOUNDING_BOX), desc.LevelOfDetail);
 }
 
 float GetOpacity(VolumeDesc desc, float3 position)
@@ -101,16 +119,119 @@ float GetOpacity(VolumeDesc desc, float3 position)
     return TextureTransferFunctionOpacity.SampleLevel(SamplerLinear, GetIntensity(desc, position), 0);
 }
 
+// The environment is looked up along the normal matrix transform of a ray direction, normalized so the
+// lookup can be inverted by SampleEnvironment
+float3 GetEnvironmentDirection(float3 direction)
+{
+    return normalize(mul((float3x3) FrameBuffer.NormalMatrix, direction));
+}
+
 float3 GetEnvironment(float3 direction)
 {
-    const float theta = acos(direction.y) / M_PI;
+    const float theta = acos(clamp(direction.y, -1.0f, 1.0f)) / M_PI;
     const float phi = atan2(direction.x, -direction.z) / M_PI * 0.5f;
     return TextureEnvironment.SampleLevel(SamplerAnisotropic, float2(phi, theta), 0);
 }
 
+// Texel densities of the alias table are over [0, 1]^2, a lat-long texel covers 2 pi^2 sin(theta) of solid angle.
+// The normal matrix scales with the voxel spacing, so densities are converted to the solid angle of ray directions.
+float GetEnvironmentPdf(float3 direction)
+{
+    const float3 v = mul((float3x3) FrameBuffer.NormalMatrix, direction);
+    const float r = length(v);
+    const float3 environment = v / r;
+    
+    const float sinTheta = sqrt(saturate(1.0f - environment.y * environment.y));
+    [branch]
+    if (sinTheta == 0.0f)
+        return 0.0f;
+    
+    const uint2 dimension = FrameBuffer.EnvironmentDimension;
+    const float u = atan2(environment.x, -environment.z) / M_PI * 0.5f;
+    const float w = acos(clamp(environment.y, -1.0f, 1.0f)) / M_PI;
+    const uint x = uint(int(floor(u * dimension.x)) + int(dimension.x)) % dimension.x;
+    const uint y = min(uint(w * dimension.y), dimension.y - 1);
+    
+    const float pdf = BufferEnvironmentAlias[y * dimension.x + x].Pdf / (2.0f * M_PI * M_PI * sinTheta);
+    return pdf * abs(determinant((float3x3) FrameBuffer.NormalMatrix)) / (r * r * r);
+}
+
+float3 SampleEnvironment(CSampler sequence, out float pdf)
+{
+    const uint2 dimension = FrameBuffer.EnvironmentDimension;
+    const uint count = dimension.x * dimension.y;
+    
+    uint index = min(uint(Sample1D(sequence, RADIANCE_DIMENSION_LIGHT) * count), count - 1);
+    const EnvironmentAliasEntry entry = BufferEnvironmentAlias[index];
+    index = Sample1D(sequence, RADIANCE_DIMENSION_LIGHT + 1) < entry.Probability ? index : entry.Alias;
+    
+    const float offsetX = Sample1D(sequence, RADIANCE_DIMENSION_LIGHT + 2);
+    const float offsetY = Sample1D(sequence, RADIANCE_DIMENSION_LIGHT + 3);
+    const float theta = M_PI * (float(index / dimension.x) + offsetY) / dimension.y;
+    const float phi = 2.0f * M_PI * (float(index % dimension.x) + offsetX) / dimension.x;
+    const float sinTheta = sin(theta);
+    
+    const float3 environment = float3(sinTheta * sin(phi), cos(theta), -sinTheta * cos(phi));
+    const float3 v = mul((float3x3) FrameBuffer.InvNormalMatrix, environment);
+    const float r = length(v);
+    
+    pdf = sinTheta > 0.0f ? BufferEnvironmentAlias[index].Pdf / (2.0f * M_PI * M_PI * sinTheta) : 0.0f;
+    pdf *= abs(determinant((float3x3) FrameBuffer.NormalMatrix)) * r * r * r;
+    return v / r;
+}
+
+// Lobes are picked by the Fresnel reflectance at the view direction, so the density of a direction can be evaluated
+float GetSpecularProbability(GBuffer buffer)
+{
+    const float3 F = FresnelSchlick(buffer.Specular, saturate(dot(buffer.Normal, buffer.View)));
+    const float ps = length(F);
+    const float pd = length(1.0f - F);
+    return ps / (ps + pd);
+}
+
+float3 SampleBSDF(GBuffer buffer, float specularProbability, CSampler sequence)
+{
+    const float2 xi = Sample2D(sequence, RADIANCE_DIMENSION_DIRECTION);
+    
+    [branch]
+    if (Sample1D(sequence, RADIANCE_DIMENSION_LOBE) < specularProbability)
+        return reflect(-buffer.View, SampleGGXDir(buffer.Normal, buffer.Roughness * buffer.Roughness, xi));
+    return SampleGGXDir(buffer.Normal, 1.0, xi);
+}
+
+// BSDF times the cosine term, and the density of SampleBSDF in pdf
+float3 EvaluateBSDF(GBuffer buffer, float3 L, float specularProbability, out float pdf)
+{
+    const float3 N = buffer.Normal;
+    const float3 V = buffer.View;
+    const float3 H = normalize(V + L);
+    const float alpha = buffer.Roughness * buffer.Roughness;
+    
+    const float NdotL = dot(N, L);
+    const float NdotV = saturate(dot(N, V));
+    const float NdotH = saturate(dot(N, H));
+    const float VdotH = saturate(dot(V, H));
+    
+    const float D = GGX_Distribution(NdotH, alpha);
+    pdf = lerp(saturate(NdotL) / M_PI, D * NdotH * rcp(max(4.0 * VdotH, 1e-6)), specularProbability);
+    
+    [branch]
+    if (NdotL <= 0.0f)
+        return float3(0.0, 0.0, 0.0);
+    
+    const float3 F = FresnelSchlick(buffer.Specular, VdotH);
+    const float G = GGX_PartialGeometry(NdotV, alpha) * GGX_PartialGeometry(NdotL, alpha);
+    return (1.0f - F) * buffer.Diffuse * (NdotL / M_PI) + (D * G * rcp(max(4.0 * NdotV, 1e-6))) * F;
+}
+
+float PowerHeuristic(float pdf, float pdfOther)
+{
+    return pdf * pdf * rcp(pdf * pdf + pdfOther * pdfOther);
+}
+
 GBuffer LoadGBuffer(uint2 id, float2 offset, float2 invDimension, float4x4 invWVP)
 {
-    float2 ncdXY = ScreenSpaceToNDC(id, invDimension);
+    float2 ncdXY = ScreenSpaceToNDC(float2(id) + offset, invDimension);
     float4 rayStart = mul(invWVP, float4(ncdXY, 0.0f, 1.0f));
     float4 rayEnd = mul(invWVP, float4(ncdXY, TextureDepth[id], 1.0f));
     rayStart /= rayStart.w;
@@ -128,9 +249,9 @@ GBuffer LoadGBuffer(uint2 id, float2 offset, float2 invDimension, float4x4 invWV
     return buffer;
 }
 
-bool RayMarching(Ray ray, VolumeDesc desc, inout CRNG rng)
+bool RayMarching(Ray ray, VolumeDesc desc, float2 u)
 {
-    Intersection intersect = IntersectAABB(ray, desc.BoundingBox);
+    Intersection intersect = ClipRay(ray, IntersectAABB(ray, desc.BoundingBox));
 	
     [branch]
     if (intersect.Max < intersect.Min)
@@ -139,10 +260,10 @@ bool RayMarching(Ray ray, VolumeDesc desc, inout CRNG rng)
     const float minT = max(intersect.Min, ray.Min);
     const float maxT = min(intersect.Max, ray.Max);
     
-    const float threshold = -log(Rand(rng)) / desc.DensityScale;
+    const float threshold = -log(u.x) / desc.DensityScale;
 	
     float sum = 0.0f;
-    float t = minT + Rand(rng) * desc.StepSize;
+    float t = minT + u.y * desc.StepSize;
     float3 position = float3(0.0, 0.0, 0.0f);
     
     [loop]
@@ -158,60 +279,191 @@ bool RayMarching(Ray ray, VolumeDesc desc, inout CRNG rng)
     return true;
 }
 
+bool DeltaTracking(Ray ray, VolumeDesc desc, inout CRNG rng)
+{
+    Intersection intersect = ClipRay(ray, IntersectAABB(ray, desc.BoundingBox));
+	
+    [branch]
+    if (intersect.Max < intersect.Min)
+        return false;
+
+    const float minT = max(intersect.Min, ray.Min);
+    const float maxT = min(intersect.Max, ray.Max);
+    
+    const uint3 dimension = FrameBuffer.MajorantGridDimension;
+    const float3 scale = float3(dimension) / (VOLUME_BOUNDING_BOX.Max - VOLUME_BOUNDING_BOX.Min);
+    GridTraversal grid = InitGridTraversal((ray.Origin - VOLUME_BOUNDING_BOX.Min) * scale, ray.Direction * scale, minT, dimension);
+    
+    float t = minT;
+    
+    [loop]
+    while (t < maxT)
+    {
+        const float exitT = min(GetGridTraversalExit(grid), maxT);
+        const float majorant = desc.DensityScale * TextureMajorant.Load(int4(grid.Cell, 0));
+        
+        [branch]
+        if (majorant > 0.0f)
+        {
+            const float sampleT = t - log(1.0f - Rand(rng)) / majorant;
+            [branch]
+            if (sampleT < exitT)
+            {
+                t = sampleT;
+                [branch]
+                if (Rand(rng) * majorant < desc.DensityScale * GetOpacity(desc, ray.Origin + t * ray.Direction))
+                    return true;
+                continue;
+            }
+        }
+        
+        t = exitT;
+        [branch]
+        if (!AdvanceGridTraversal(grid, dimension))
+            break;
+    }
+    return false;
+}
+
+// Ratio tracking weights every tentative collision by the probability of it being null instead of
+// terminating the ray. The residual variant tracks only the difference to the control (the mean of the cell)
+// and accounts for the control analytically. Russian roulette ends rays with little transmittance left.
+float RatioTracking(Ray ray, VolumeDesc desc, bool isResidual, inout CRNG rng)
+{
+    const float RouletteThreshold = 0.1f;
+    
+    Intersection intersect = ClipRay(ray, IntersectAABB(ray, desc.BoundingBox));
+	
+    [branch]
+    if (intersect.Max < intersect.Min)
+        return 1.0f;
+
+    const float minT = max(intersect.Min, ray.Min);
+    const float maxT = min(intersect.Max, ray.Max);
+    
+    const uint3 dimension = FrameBuffer.MajorantGridDimension;
+    const float3 scale = float3(dimension) / (VOLUME_BOUNDING_BOX.Max - VOLUME_BOUNDING_BOX.Min);
+    GridTraversal grid = InitGridTraversal((ray.Origin - VOLUME_BOUNDING_BOX.Min) * scale, ray.Direction * scale, minT, dimension);
+    
+    float transmittance = 1.0f;
+    float t = minT;
+    
+    [loop]
+    while (t < maxT)
+    {
+        const float exitT = min(GetGridTraversalExit(grid), maxT);
+        const float2 cell = isResidual ? TextureControl.Load(int4(grid.Cell, 0)) : float2(0.0f, TextureMajorant.Load(int4(grid.Cell, 0)));
+        const float control = desc.DensityScale * cell.x;
+        const float residual = desc.DensityScale * cell.y;
+        
+        transmittance *= exp(-control * (exitT - t));
+        
+        [branch]
+        if (residual > 0.0f)
+        {
+            [loop]
+            while (true)
+            {
+                t -= log(1.0f - Rand(rng)) / residual;
+                [branch]
+                if (t >= exitT)
+                    break;
+                transmittance *= 1.0f - (desc.DensityScale * GetOpacity(desc, ray.Origin + t * ray.Direction) - control) / residual;
+                
+                [branch]
+                if (transmittance < RouletteThreshold)
+                {
+                    [branch]
+                    if (Rand(rng) * RouletteThreshold >= transmittance)
+                        return 0.0f;
+                    transmittance = RouletteThreshold;
+                }
+            }
+        }
+        
+        t = exitT;
+        [branch]
+        if (!AdvanceGridTraversal(grid, dimension))
+            break;
+    }
+    return transmittance;
+}
+
+// Tracking estimators draw from a generator seeded by the dimension, ray marching takes it and the next one as the threshold and jitter
+float EstimateTransmittance(Ray ray, VolumeDesc desc, CSampler sequence, uint dimension)
+{
+    CRNG rng = SampleRNG(sequence, dimension);
+    
+    [branch]
+    if (FrameBuffer.TransmittanceEstimator != TRANSMITTANCE_ESTIMATOR_TRACKING)
+        return RatioTracking(ray, desc, FrameBuffer.TransmittanceEstimator == TRANSMITTANCE_ESTIMATOR_RESIDUAL_RATIO, rng);
+    else if (FrameBuffer.TrackingMode == TRACKING_MODE_DELTA)
+        return !DeltaTracking(ray, desc, rng);
+    else
+        return !RayMarching(ray, desc, Sample2D(sequence, dimension));
+}
+
 [numthreads(THREAD_GROUP_SIZE_X, THREAD_GROUP_SIZE_Y, 1)]
 void ComputeRadiance(uint3 threadID : SV_GroupThreadID, uint3 groupID : SV_GroupID)
 {
+    if (!IsTileInPass(BufferDispersionTiles, groupID.x))
+        return;
+
     uint2 id = GetThreadIDFromTileList(BufferDispersionTiles, groupID.x, threadID.xy);
-    CRNG rng = InitCRND(id, FrameBuffer.FrameIndex);
-    GBuffer buffer = LoadGBuffer(id, FrameBuffer.FrameOffset, FrameBuffer.InvRenderTargetDim, FrameBuffer.InvWorldViewProjectionMatrix);
+    const uint sampleIndex = GetSampleIndex(TextureColorSum, id);
+    CSampler sequence = InitSampler(id, sampleIndex, 1);
+    GBuffer buffer = LoadGBuffer(id, SamplePixelJitter(InitSampler(id, sampleIndex, 0)), FrameBuffer.InvRenderTargetDim, FrameBuffer.InvWorldViewProjectionMatrix);
 
     if (any(buffer.Diffuse))
     {
         VolumeDesc desc;
         desc.BoundingBox.Min = FrameBuffer.BoundingBoxMin;
         desc.BoundingBox.Max = FrameBuffer.BoundingBoxMax;
-        desc.StepSize = FrameBuffer.StepSize;
+        desc.LevelOfDetail = GetLevelOfDetail(1);
+        desc.StepSize = GetStepSize(desc.LevelOfDetail);
         desc.DensityScale = FrameBuffer.Density;
       
         Ray ray;
+        ray.Origin = buffer.Position;
         ray.Min = 0;
         ray.Max = FLT_MAX;
-     
-        float3 throughput = float3(0.0, 0.0, 0.0);
         
-        const float3 N = buffer.Normal;
-        const float3 V = buffer.View;
-        const float alpha = buffer.Roughness * buffer.Roughness;
+        const float specularProbability = GetSpecularProbability(buffer);
         
-        const float3 H = SampleGGXDir(N, alpha, rng);
-        const float3 F = FresnelSchlick(buffer.Specular, saturate(dot(V, H)));
-					
-        const float pd = length(1 - F);
-        const float ps = length(F);
-        const float pdf = ps / (ps + pd);
-     	
-        if (Rand(rng) < pdf)
+        float pdfBSDF;
+        const float3 directionBSDF = SampleBSDF(buffer, specularProbability, sequence);
+        float3 throughputBSDF = EvaluateBSDF(buffer, directionBSDF, specularProbability, pdfBSDF);
+        throughputBSDF = pdfBSDF > 0.0f ? throughputBSDF / pdfBSDF : 0.0f;
+        
+        float3 radiance = float3(0.0, 0.0, 0.0);
+        
+        // Next-event estimation: the light ray tracks with its own dimensions of the sample vector
+        [branch]
+        if (FrameBuffer.LightSampling == LIGHT_SAMPLING_MIS)
         {
-            const float3 L = reflect(-V, H);
-            const float NdotL = saturate(dot(N, L));
-            const float NdotV = saturate(dot(N, V));
-            const float NdotH = saturate(dot(N, H));
-            const float VdotH = saturate(dot(V, H));
-		
-            const float G = GGX_PartialGeometry(NdotV, alpha) * GGX_PartialGeometry(NdotL, alpha);
-            ray.Origin = buffer.Position;
-            ray.Direction = L;
-            throughput += (G * F * VdotH) * rcp(max(NdotV * NdotH, 1e-6)) / (pdf);
+            throughputBSDF *= PowerHeuristic(pdfBSDF, GetEnvironmentPdf(directionBSDF));
+            
+            float pdfLight;
+            float pdfLightBSDF;
+            const float3 directionLight = SampleEnvironment(sequence, pdfLight);
+            float3 throughputLight = EvaluateBSDF(buffer, directionLight, specularProbability, pdfLightBSDF);
+            throughputLight = pdfLight > 0.0f ? throughputLight / pdfLight * PowerHeuristic(pdfLight, pdfLightBSDF) : 0.0f;
+            
+            [branch]
+            if (any(throughputLight > 0.0f))
+            {
+                ray.Direction = directionLight;
+                radiance += EstimateTransmittance(ray, desc, sequence, RADIANCE_DIMENSION_RAY_LIGHT) * throughputLight * GetEnvironment(GetEnvironmentDirection(directionLight));
+            }
         }
-        else
+        
+        [branch]
+        if (any(throughputBSDF > 0.0f))
         {
-            const float3 L = SampleGGXDir(N, 1.0, rng);
-            ray.Origin = buffer.Position;
-            ray.Direction = L;
-            throughput += (1 - F) * buffer.Diffuse / (1 - pdf);
+            ray.Direction = directionBSDF;
+            radiance += EstimateTransmittance(ray, desc, sequence, RADIANCE_DIMENSION_RAY_BSDF) * throughputBSDF * GetEnvironment(GetEnvironmentDirection(directionBSDF));
         }
-             
-        bool isIntersect = RayMarching(ray, desc, rng);
-        TextureRadianceAV[id] = !isIntersect * throughput * GetEnvironment(mul((float3x3) FrameBuffer.NormalMatrix, ray.Direction));;
+        
+        TextureRadianceAV[id] = radiance;
     }
 }
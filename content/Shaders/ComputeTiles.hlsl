@@ -26,20 +26,16 @@
 
 #define WAVEFRONT_SIZE (THREAD_GROUP_SIZE_X) * (THREAD_GROUP_SIZE_Y)
 
-Texture2D<float3> TextureColorSRV : register(t0);
-Texture2D<float> TextureDepthSRV : register(t1);
+Texture2D<float4> TextureColorSumSRV : register(t0);
+Texture2D<float> TextureColorMomentSRV : register(t1);
 AppendStructuredBuffer<uint> BufferTiles : register(u0);
+RWStructuredBuffer<uint> BufferTilePassesUAV : register(u1);
 
 groupshared float SharedBuffer[WAVEFRONT_SIZE];
 
-float Luminance(float3 color)
-{
-    return dot(float3(0.2126, 0.7152, 0.0722), color);
-}
-
 float ReductionSum(uint lineID)
 {
-    [unrool(WAVEFRONT_SIZE / 2)]
+    [unroll(WAVEFRONT_SIZE / 2)]
     for (uint stride = WAVEFRONT_SIZE / 2; stride > 0; stride = stride >> 1)
     {
         if (lineID < stride) 
@@ -49,18 +45,13 @@ float ReductionSum(uint lineID)
     return SharedBuffer[0];
 }
 
-float ComputeSum(uint3 threadID, uint lineID, Texture2D<float3> sourceTexture)
+float ComputeSum(uint lineID, float value)
 {
-    SharedBuffer[lineID] = Luminance(sourceTexture[threadID.xy]);
+    SharedBuffer[lineID] = value;
     GroupMemoryBarrierWithGroupSync();
-    return ReductionSum(lineID);
-}
-
-float ComputeSum(uint3 threadID, uint lineID, Texture2D<float> sourceTexture)
-{
-    SharedBuffer[lineID] = sourceTexture[threadID.xy];
+    const float sum = ReductionSum(lineID);
     GroupMemoryBarrierWithGroupSync();
-    return ReductionSum(lineID);
+    return sum;
 }
 
 [numthreads(1, 1, 1)]
@@ -73,11 +64,28 @@ void ResetTiles(uint3 groupID : SV_GroupID, uint lineID : SV_GroupIndex)
 void ComputeTiles(uint3 threadID : SV_DispatchThreadID, uint lineID : SV_GroupIndex, uint3 groupID : SV_GroupID)
 {
     const uint tileID = (0xFFFF & groupID.x) | ((0xFFFF & groupID.y) << 16);
-       
-    float colorSum = 0.75 * ComputeSum(threadID, lineID, TextureColorSRV);
-    float depthSum = 0.25 * ComputeSum(threadID, lineID, TextureDepthSRV);
-    float totalSum = colorSum + depthSum;
-     
-    if (totalSum > 0 && lineID == 0)
-        BufferTiles.Append(tileID);
+
+    // The variance of a pixel mean is the sample variance of the luminance over the number of samples
+    const float4 colorSum = TextureColorSumSRV[threadID.xy];
+    const float luminance = Luminance(colorSum.xyz);
+    const float variance = max(TextureColorMomentSRV[threadID.xy] - luminance * luminance, 0.0f) / max(colorSum.w, 1.0f);
+
+    const float luminanceSum = ComputeSum(lineID, luminance);
+    const float varianceSum = ComputeSum(lineID, variance);
+
+    // RMS standard error of the pixel means over the mean luminance of the tile
+    const float LuminanceEpsilon = 1.0e-3f;
+    const float error = sqrt(varianceSum / WAVEFRONT_SIZE) / (luminanceSum / WAVEFRONT_SIZE + LuminanceEpsilon);
+
+    // The extra passes are budgeted by the passes that read the counts
+    const uint passCount = GetTilePassCount(error, FrameBuffer.TileErrorThreshold);
+    if (lineID == 0)
+    {
+        BufferTilePassesUAV[TILE_PASS_COUNT_MAX + groupID.y * GetTileCount().x + groupID.x] = passCount;
+        if (passCount > 0)
+        {
+            BufferTiles.Append(tileID);
+            InterlockedAdd(BufferTilePassesUAV[passCount - 1], 1);
+        }
+    }
 }
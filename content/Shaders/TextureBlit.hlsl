@@ -22,8 +22,10 @@
  * SOFTWARE.
  */
 
+#include "Common.hlsl"
+
 Texture2D<float4> TextureSrc : register(t0);
-SamplerState SamplerPoint : register(s0);
+SamplerState SamplerLinear : register(s0);
 
 void BlitVS(uint id : SV_VertexID, out float4 position : SV_Position, out float2 texcoord : TEXCOORD)
 {
@@ -33,5 +35,9 @@ void BlitVS(uint id : SV_VertexID, out float4 position : SV_Position, out float2
 
 float4 BlitPS(float4 position : SV_Position, float2 texcoord : TEXCOORD) : SV_TARGET0
 {
-    return TextureSrc.Sample(SamplerPoint, texcoord);
+    // Only the RenderTargetDim corner of the texture is rendered, it is clamped to keep the stale texels out of the filter
+    float2 dimension;
+    TextureSrc.GetDimensions(dimension.x, dimension.y);
+    const float2 location = clamp(texcoord * FrameBuffer.RenderTargetDim, 0.5f, FrameBuffer.RenderTargetDim - 0.5f);
+    return TextureSrc.SampleLevel(SamplerLinear, location / dimension, 0);
 }
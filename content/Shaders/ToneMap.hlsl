@@ -60,10 +60,21 @@ float3 LinearToSRGB(float3 color)
     return sRGB;
 }
 
-[numthreads(THREAD_GROUP_SIZE_X, THREAD_GROUP_SIZE_Y, 1)]
-void ToneMap(uint3 threadID : SV_GroupThreadID, uint3 groupID : SV_GroupID)
+void ToneMapPixel(uint2 id)
 {
-    uint2 id = GetThreadIDFromTileList(BufferDispersionTiles, groupID.x, threadID.xy);
     float3 colorHDR = TextureHDR.Load(int3(id.xy, 0)).xyz;
     TextureLDR[id] = float4(ToneMapUncharted2Function(colorHDR, FrameBuffer.Exposure), 1.0f);
 }
+
+[numthreads(THREAD_GROUP_SIZE_X, THREAD_GROUP_SIZE_Y, 1)]
+void ToneMap(uint3 threadID : SV_GroupThreadID, uint3 groupID : SV_GroupID)
+{
+    ToneMapPixel(GetThreadIDFromTileList(BufferDispersionTiles, groupID.x, threadID.xy));
+}
+
+// Every pixel, for when the exposure changed and the retired tiles would keep the old one
+[numthreads(THREAD_GROUP_SIZE_X, THREAD_GROUP_SIZE_Y, 1)]
+void ToneMapImage(uint3 threadID : SV_DispatchThreadID)
+{
+    ToneMapPixel(threadID.xy);
+}
@@ -25,6 +25,9 @@
 #pragma once
 
 #include "Common.h"
+#include "ProfilerD3D11.h"
+
+#include <memory>
 
 struct ApplicationDesc {
     std::string Tittle = "Application <DX11>";
@@ -81,6 +84,9 @@ public:
 
     virtual void RenderGUI(DX::ComPtr<ID3D11RenderTargetView> pRTV) = 0;
 
+    // While the image is converged Run blocks on input events instead of presenting frames back to back
+    virtual bool IsConverged() const { return false; }
+
     auto Run() -> void;
 
 private:
@@ -99,6 +105,9 @@ protected:
 
     static constexpr uint32_t FrameCount = 3;
 
+    // Frames presented after an input event before a converged application waits again, so the GUI can settle
+    static constexpr uint32_t IdleFrameCount = 3;
+
     GLFWwindow* m_pWindow = {};
     HANDLE      m_FenceEvent = {};
     uint32_t    m_FenceValue = {};
@@ -115,6 +124,8 @@ protected:
     DX::ComPtr<IDXGISwapChain3>           m_pSwapChain;
     DX::ComPtr<ID3DUserDefinedAnnotation> m_pAnnotation;
     DX::ComPtr<ID3D11RenderTargetView>    m_pRTV[FrameCount];
+    std::unique_ptr<Profiler>             m_pProfiler;
+    std::unique_ptr<ProfilerD3D11>        m_pProfilerD3D11;
     TimePoint       m_LastFrame;
     ApplicationDesc m_ApplicationDesc;
     GLFWWindowState m_GLFWState = {};
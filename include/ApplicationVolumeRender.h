@@ -25,10 +25,16 @@
 #pragma once
 
 #include "Application.h"
-#include "TransferFunction.h"
+#include "RenderStatistics.h"
+#include "RendererCPU.h"
+#include "RendererD3D11.h"
+#include "ResolutionController.h"
 
 #include <Hawk/Components/Camera.hpp>
 #include <Hawk/Math/Functions.hpp>
+#include <Hawk/Math/Geometry.hpp>
+
+#include <array>
 
 class ApplicationVolumeRender final : public Application {
 public:
@@ -36,10 +42,12 @@ public:
 
     ApplicationVolumeRender(ApplicationDesc const& desc);
 private:
-    void InitializeVolumeTexture();
+    void InitializeVolume();
 
     void InitializeTransferFunction();
 
+    void InitializeMajorantGrid();
+
     void InitializeSamplerStates();
 
     void InitializeShaders();
@@ -48,10 +56,12 @@ private:
 
     void InitializeBuffers();
 
-    void InitializeTileBuffer();
-
     void InitializeEnvironmentMap();
 
+    void InitializeBlueNoise();
+
+    std::unique_ptr<RendererCPU> CreateRendererCPU() const;
+
     void Resize(int32_t width, int32_t height) override;
 
     void EventMouseWheel(float delta) override;
@@ -64,77 +74,76 @@ private:
 
     void RenderGUI(DX::ComPtr<ID3D11RenderTargetView> pRTV) override;
 
-    void TextureBlit(DX::ComPtr<ID3D11ShaderResourceView> pSrc, DX::ComPtr<ID3D11RenderTargetView> pDst);
+    void RenderGUIPerformance(bool* pIsOpen);
 
-private:
-    using D3D11ArrayUnorderedAccessView = std::vector< DX::ComPtr<ID3D11UnorderedAccessView>>;
-    using D3D11ArrayShadeResourceView = std::vector< DX::ComPtr<ID3D11ShaderResourceView>>;
+    bool IsConverged() const override { return m_IsConverged; }
+
+    void UpdateConvergence();
 
-    D3D11ArrayShadeResourceView   m_pSRVVolumeIntensity;
-    D3D11ArrayUnorderedAccessView m_pUAVVolumeIntensity;
+    void UpdateResolutionScale();
 
-    DX::ComPtr<ID3D11ShaderResourceView>  m_pSRVGradient;
-    DX::ComPtr<ID3D11UnorderedAccessView> m_pUAVGradient;
+    void UpdateStatistics();
 
-    DX::ComPtr<ID3D11ShaderResourceView> m_pSRVDiffuseTF;
-    DX::ComPtr<ID3D11ShaderResourceView> m_pSRVSpecularTF;
-    DX::ComPtr<ID3D11ShaderResourceView> m_pSRVRoughnessTF;
-    DX::ComPtr<ID3D11ShaderResourceView> m_pSRVOpacityTF;
-    DX::ComPtr<ID3D11ShaderResourceView> m_pSRVEnvironment;
+    Hawk::Math::Vec2u GetRenderDimension() const;
 
-    DX::ComPtr<ID3D11ShaderResourceView>  m_pSRVRadiance;
-    DX::ComPtr<ID3D11UnorderedAccessView> m_pUAVRadiance;
+    // The backends that have been created, the D3D11 one always is
+    std::array<RenderBackend*, 2> GetRenderers() const { return { m_pRendererD3D11.get(), m_pRendererCPU.get() }; }
 
-    DX::ComPtr<ID3D11ShaderResourceView>  m_pSRVDiffuse;
-    DX::ComPtr<ID3D11ShaderResourceView>  m_pSRVSpecular;
-    DX::ComPtr<ID3D11ShaderResourceView>  m_pSRVNormal;
-    DX::ComPtr<ID3D11ShaderResourceView>  m_pSRVDepth;
-    DX::ComPtr<ID3D11ShaderResourceView>  m_pSRVColorSum;
+    void TextureBlit(DX::ComPtr<ID3D11ShaderResourceView> pSrc, DX::ComPtr<ID3D11RenderTargetView> pDst);
+
+    void CompareWithRendererCPU();
+
+private:
+    static constexpr float InteractionTimeout = 0.15f;
 
-    DX::ComPtr<ID3D11UnorderedAccessView> m_pUAVDiffuse;
-    DX::ComPtr<ID3D11UnorderedAccessView> m_pUAVSpecular;
-    DX::ComPtr<ID3D11UnorderedAccessView> m_pUAVNormal;
-    DX::ComPtr<ID3D11UnorderedAccessView> m_pUAVDepth;
-    DX::ComPtr<ID3D11UnorderedAccessView> m_pUAVColorSum;
+    static constexpr std::array<float, 2> FrameTimeTargets = { 1.0f / 60.0f, 1.0f / 30.0f };
 
-    DX::ComPtr<ID3D11ShaderResourceView>  m_pSRVToneMap;
-    DX::ComPtr<ID3D11UnorderedAccessView> m_pUAVToneMap;
+    static constexpr char const* ProfilerTraceFileName = "VolumeRender.trace.json";
 
-    DX::ComPtr<ID3D11ShaderResourceView>  m_pSRVDispersionTiles;
-    DX::ComPtr<ID3D11UnorderedAccessView> m_pUAVDispersionTiles;
+    enum RendererType : uint32_t {
+        RendererTypeD3D11,
+        RendererTypeCPU
+    };
+
+    // The tone mapped image of the CPU renderer, uploaded every frame
+    DX::ComPtr<ID3D11Texture2D>          m_pTextureImageCPU;
+    DX::ComPtr<ID3D11ShaderResourceView> m_pSRVImageCPU;
 
     DX::GraphicsPSO m_PSODefault = {};
     DX::GraphicsPSO m_PSOBlit = {};
-    DX::GraphicsPSO m_PSODegugTiles = {};
 
-    DX::ComputePSO m_PSOGeneratePrimaryRays = {};
-    DX::ComputePSO m_PSOComputeDiffuseLight = {};
+    DX::ComPtr<ID3D11SamplerState> m_pSamplerLinear;
+    DX::ComPtr<ID3D11Buffer>       m_pConstantBufferFrame;
+
+    TransferFunctionSet m_TransferFunctions;
 
-    DX::ComputePSO  m_PSOAccumulate = {};
-    DX::ComputePSO  m_PSOComputeTiles = {};
-    DX::ComputePSO  m_PSOResetTiles = {};
-    DX::ComputePSO  m_PSOToneMap = {};
-    DX::ComputePSO  m_PSOGenerateMipLevel = {};
-    DX::ComputePSO  m_PSOComputeGradient = {};
+    VolumeData                    m_VolumeData;
+    MajorantGrid                  m_MajorantGrid;
+    EnvironmentMap                m_EnvironmentMap;
+    BlueNoise                     m_BlueNoise;
+    std::unique_ptr<ThreadPool>    m_pThreadPool;
+    std::unique_ptr<RendererD3D11> m_pRendererD3D11;
+    std::unique_ptr<RendererCPU>   m_pRendererCPU;
+    std::unique_ptr<RendererCPU>   m_pRendererReference;
+    RenderBackend*                 m_pRenderer = nullptr;
+    std::string                    m_ComparisonCPU;
+    std::string                    m_ProfilerTrace;
 
-    DX::ComPtr<ID3D11SamplerState>  m_pSamplerPoint;
-    DX::ComPtr<ID3D11SamplerState>  m_pSamplerLinear;
-    DX::ComPtr<ID3D11SamplerState>  m_pSamplerAnisotropic;
+    FrameBuffer m_FrameBuffer = {};
 
-    DX::ComPtr<ID3D11Buffer> m_pConstantBufferFrame;
-    DX::ComPtr<ID3D11Buffer> m_pDispatchIndirectBufferArgs;
-    DX::ComPtr<ID3D11Buffer> m_pDrawInstancedIndirectBufferArgs;
+    AutoExposure::Desc m_AutoExposureDesc = {};
 
-    ColorTransferFunction1D  m_DiffuseTransferFunc;
-    ColorTransferFunction1D  m_SpecularTransferFunc;
-    ColorTransferFunction1D  m_EmissionTransferFunc;
-    ScalarTransferFunction1D m_RoughnessTransferFunc;
-    ScalarTransferFunction1D m_OpacityTransferFunc;
+    ResolutionController m_ResolutionController;
+
+    RenderStatistics m_Statistics;
 
     Hawk::Components::Camera m_Camera = {};
 
-    Hawk::Math::Vec3 m_BoundingBoxMin = Hawk::Math::Vec3(-0.5f, -0.5f, -0.5f);
-    Hawk::Math::Vec3 m_BoundingBoxMax = Hawk::Math::Vec3(+0.5f, +0.5f, +0.5f);
+    std::array<Hawk::Math::Plane, ClipPlaneCountMax> m_ClipPlanes = {};
+    Hawk::Math::Box  m_CropBox = {};
+    Hawk::Math::Vec3 m_CropBoxRotation = Hawk::Math::Vec3(0.0f, 0.0f, 0.0f);
+    Hawk::Math::Vec3 m_CropBoxTranslation = Hawk::Math::Vec3(0.0f, 0.0f, 0.0f);
+    uint32_t         m_ClipPlaneCount = 0;
 
     float    m_DeltaTime = 0.0f;
     float    m_RotateSensitivity = 0.25f;
@@ -147,17 +156,39 @@ private:
     uint32_t m_FrameIndex = 0;
     uint32_t m_SampleDispersion = 8;
     uint32_t m_SamplingCount = 256;
+    uint32_t m_TrackingMode = TrackingModeDelta;
+    uint32_t m_TransmittanceEstimator = TransmittanceEstimatorRatio;
+    uint32_t m_LightSampling = LightSamplingMIS;
+    uint32_t m_SampleSequence = SampleSequenceSobol;
+    uint32_t m_LevelOfDetailDepthBias = 1;
+    uint32_t m_FrameIndexMax = 4096;
+    uint32_t m_ActiveTileCount = 0;
+    uint32_t m_ActiveTilePassCount = 0;
+    uint32_t m_FrameTimeTarget = 1;
+    uint32_t m_RendererType = RendererTypeD3D11;
+    float    m_LevelOfDetailBias = 0.0f;
+    float    m_TileErrorThreshold = 0.15f;
+    float    m_ResolutionScale = 1.0f;
+    float    m_FrameTime = 0.0f;
 
     bool     m_IsReloadShader = false;
     bool     m_IsReloadTransferFunc = false;
     bool     m_IsDrawDebugTiles = false;
+    bool     m_IsAutomaticLevelOfDetail = true;
+    bool     m_IsContentBoundingBox = true;
+    bool     m_IsUpdateClipRegion = true;
+    bool     m_IsConverged = false;
+    bool     m_IsExposureChanged = false;
+    bool     m_IsDynamicResolution = true;
+    bool     m_IsProgressiveRefinement = true;
+    bool     m_IsAutoExposure = false;
+
+    TimePoint m_ConvergenceStart = {};
+    TimePoint m_InteractionTime = {};
+    float     m_ConvergenceTime = 0.0f;
 
     uint16_t m_DimensionX = 0;
     uint16_t m_DimensionY = 0;
     uint16_t m_DimensionZ = 0;
     uint16_t m_DimensionMipLevels = 0;
-
-    std::random_device m_RandomDevice;
-    std::mt19937       m_RandomGenerator;
-    std::uniform_real_distribution<float> m_RandomDistribution;
 };
@@ -0,0 +1,104 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "ThreadPool.h"
+
+#include <Hawk/Common/Defines.hpp>
+#include <Hawk/Math/Functions.hpp>
+
+#include <array>
+#include <span>
+
+// Exposure from a log2 luminance histogram of the accumulated image, binned per tile so a frame only bins the
+// tiles it rendered
+class AutoExposure final : Hawk::NonCopyable {
+public:
+    // The bins split every power of two into BinsPerStop equal parts of the mantissa, so the bin of a
+    // luminance is read from the bits of the float. Keep in step with ComputeHistogram.hlsl.
+    static constexpr uint32_t BinsPerStop = 8;
+    static constexpr uint32_t BinCount = 128;
+    static constexpr int32_t  LogLuminanceMin = -12;
+
+    // The whole image is tone mapped again once the exposure differs by more than this from the last time, the
+    // tiles that are no longer rendered would keep the old exposure otherwise
+    static constexpr F32 ExposureTolerance = 0.01f;
+
+    struct Desc {
+        F32 PercentileLow = 0.5f;
+        F32 PercentileHigh = 0.95f;
+        F32 AdaptationRate = 2.0f;
+        F32 KeyTarget = 0.18f;
+    };
+
+    explicit AutoExposure(ThreadPool& threadPool);
+
+    void SetDesc(Desc const& desc) { m_Desc = desc; }
+
+    // Clears the histograms and the adaptation
+    void Resize(uint32_t tileCount);
+
+    // Bins the pixels [x0, x1) x [y0, y1) as tile tileIndex, replacing what it binned before. Pixels without
+    // samples are left out. Different tiles may be updated at the same time from different threads.
+    void UpdateTile(uint32_t tileIndex, uint32_t threadID, std::span<Hawk::Math::Vec4 const> image, uint32_t width, uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1);
+
+    // Merges the tile updates since the last call and adapts the key towards the one of the image histogram
+    void Update(F32 deltaTime);
+
+    // Adapts the key towards the one of a histogram built elsewhere, e.g. read back from the GPU
+    void Adapt(std::span<uint32_t const> histogram, F32 deltaTime);
+
+    bool IsAdapted() const { return m_IsAdapted; }
+
+    F32 GetKey() const { return std::exp2(m_LogKey); }
+
+    // Exposure of ToneMap that maps the key to KeyTarget
+    F32 GetExposure() const;
+
+    std::span<uint32_t const> GetHistogram() const { return m_Histogram; }
+
+    static uint32_t GetBin(F32 luminance);
+
+    static F32 ComputeLogKey(std::span<uint32_t const> histogram, F32 percentileLow, F32 percentileHigh);
+
+private:
+    struct alignas(64) ThreadHistogram {
+        std::array<int32_t, BinCount> Bins = {};
+    };
+
+    static constexpr uint32_t MergeChunkSize = 16;
+
+private:
+    ThreadPool& m_ThreadPool;
+    Desc        m_Desc = {};
+
+    // BinCount counts per tile, the pixel count of a tile fits in 16 bits
+    std::vector<uint16_t>          m_TileHistograms;
+    std::vector<ThreadHistogram>   m_ThreadHistograms;
+    std::array<uint32_t, BinCount> m_Histogram = {};
+
+    F32  m_LogKey = 0.0f;
+    bool m_IsAdapted = false;
+};
@@ -0,0 +1,47 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <Hawk/Math/Functions.hpp>
+
+#include <vector>
+
+// Tileable blue-noise mask generated with the void-and-cluster method: every value in [0, 1) appears once
+// and the values of neighbouring texels are as far apart as possible. The mask is the per-pixel rotation
+// of the rank-1 sample sequence, the shaders read it from a R32_FLOAT texture.
+class BlueNoise {
+public:
+    static constexpr uint32_t DefaultSize = 64;
+
+    void Initialize(uint32_t size);
+
+    uint32_t GetSize() const { return m_Size; }
+
+    std::vector<F32> const& GetTexels() const { return m_Texels; }
+
+private:
+    std::vector<F32> m_Texels;
+    uint32_t         m_Size = 0;
+};
@@ -30,10 +30,12 @@
 #include <cassert>
 #include <iostream>
 #include <random>
+#include <stdexcept>
 
 #include <dxgi1_6.h>
 #include <d3d11_1.h>
 #include <d3d11on12.h>
+#include <d3dcompiler.h>
 #include <wrl.h>
 
 namespace DX {
@@ -58,6 +60,23 @@ namespace DX {
 
     inline void ThrowIfFailed(HRESULT hr) { if (FAILED(hr))	throw ComException(hr); }
 
+    inline ComPtr<ID3DBlob> CompileShaderFromFile(wchar_t const* fileName, char const* entryPoint, char const* target, D3D_SHADER_MACRO const* pMacros) {
+
+        ComPtr<ID3DBlob> pCodeBlob;
+        ComPtr<ID3DBlob> pErrorBlob;
+
+        uint32_t flags = 0;
+#if defined(_DEBUG)
+        flags |= D3DCOMPILE_DEBUG;
+#else
+        flags |= D3DCOMPILE_OPTIMIZATION_LEVEL3;
+#endif
+
+        if (FAILED(D3DCompileFromFile(fileName, pMacros, D3D_COMPILE_STANDARD_FILE_INCLUDE, entryPoint, target, flags, 0, pCodeBlob.GetAddressOf(), pErrorBlob.GetAddressOf())))
+            throw std::runtime_error(static_cast<const char*>(pErrorBlob->GetBufferPointer()));
+        return pCodeBlob;
+    }
+
     template<typename T>
     ComPtr<ID3D11Buffer> CreateConstantBuffer(ComPtr<ID3D11Device> pDevice) {
 
@@ -87,6 +106,18 @@ namespace DX {
         return pBuffer;
     }
 
+    template<typename T>
+    ComPtr<ID3D11Buffer> CreateStagingBuffer(ComPtr<ID3D11Device> pDevice, uint32_t numElements) {
+
+        ComPtr<ID3D11Buffer> pBuffer;
+        D3D11_BUFFER_DESC desc = {};
+        desc.ByteWidth = sizeof(T) * numElements;
+        desc.Usage = D3D11_USAGE_STAGING;
+        desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+        ThrowIfFailed(pDevice->CreateBuffer(&desc, nullptr, pBuffer.GetAddressOf()));
+        return pBuffer;
+    }
+
     template<typename T>
     ComPtr<ID3D11Buffer> CreateStructuredBuffer(ComPtr<ID3D11Device> pDevice, uint32_t numElements, bool isCPUWritable, bool isGPUWritable, const T* pInitialData = nullptr) {
 
@@ -119,6 +150,27 @@ namespace DX {
         return pBuffer;
     }
 
+    template<typename T>
+    ComPtr<ID3D11ShaderResourceView> CreateTexture1D(ComPtr<ID3D11Device> pDevice, DXGI_FORMAT format, std::vector<T> const& data) {
+
+        D3D11_TEXTURE1D_DESC desc = {};
+        desc.Width = static_cast<uint32_t>(std::size(data));
+        desc.MipLevels = 1;
+        desc.ArraySize = 1;
+        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+        desc.Format = format;
+        desc.Usage = D3D11_USAGE_IMMUTABLE;
+
+        D3D11_SUBRESOURCE_DATA initData = {};
+        initData.pSysMem = std::data(data);
+
+        ComPtr<ID3D11Texture1D> pTexture;
+        ComPtr<ID3D11ShaderResourceView> pSRV;
+        ThrowIfFailed(pDevice->CreateTexture1D(&desc, &initData, pTexture.GetAddressOf()));
+        ThrowIfFailed(pDevice->CreateShaderResourceView(pTexture.Get(), nullptr, pSRV.GetAddressOf()));
+        return pSRV;
+    }
+
     template<typename DataType>
     class MapHelper {
     public:
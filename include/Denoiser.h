@@ -0,0 +1,96 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "ThreadPool.h"
+
+#include <Hawk/Common/Defines.hpp>
+#include <Hawk/Math/Functions.hpp>
+
+#include <array>
+
+// Edge-avoiding a-trous wavelet filter (Dammertz et al. 2010) of the accumulated image. Every iteration
+// applies the 5x5 B3-spline kernel with the taps 2^i pixels apart. The luminance weight is scaled by the
+// standard deviation of the pixel mean, prefiltered with a 3x3 Gaussian, and the filtered variance is carried
+// to the next iteration as in SVGF. The planes are padded so eight neighbouring pixels load as one vector.
+class Denoiser final : Hawk::NonCopyable {
+public:
+    static constexpr uint32_t IterationCountMax = 5;
+
+    struct Desc {
+        uint32_t IterationCount = 4;
+        F32      SigmaLuminance = 4.0f;
+        F32      SigmaNormal = 64.0f;
+        F32      SigmaDepth = 0.02f;
+    };
+
+    explicit Denoiser(ThreadPool& threadPool);
+
+    void SetDesc(Desc const& desc) { m_Desc = desc; }
+
+    void Resize(uint32_t width, uint32_t height);
+
+    // Variance of the pixel mean, the guides are zero normal and unit depth where nothing scatters
+    void SetPixel(uint32_t x, uint32_t y, Hawk::Math::Vec3 const& color, F32 variance, Hawk::Math::Vec3 const& normal, F32 depth);
+
+    void Execute();
+
+    Hawk::Math::Vec3 GetPixel(uint32_t x, uint32_t y) const;
+
+private:
+    enum Plane : uint32_t {
+        PlaneRed,
+        PlaneGreen,
+        PlaneBlue,
+        PlaneVariance,
+        PlaneNormalX,
+        PlaneNormalY,
+        PlaneNormalZ,
+        PlaneDepth,
+        PlaneCount
+    };
+
+    // The widest kernel reaches two taps of 2^(IterationCountMax - 1) pixels beyond the row
+    static constexpr uint32_t Padding = 2u << (IterationCountMax - 1);
+
+    void FilterVariance(uint32_t y);
+
+    void FilterIteration(uint32_t y, uint32_t step);
+
+    size_t Index(uint32_t x, uint32_t y) const { return size_t(y) * m_Stride + Padding + x; }
+
+private:
+    ThreadPool& m_ThreadPool;
+    Desc        m_Desc = {};
+
+    // Color and variance are read from m_Source and written to m_Target, the guides stay in m_Source
+    std::array<std::vector<F32>, PlaneCount>        m_Source;
+    std::array<std::vector<F32>, PlaneVariance + 1> m_Target;
+    std::vector<F32>                                m_VarianceFiltered;
+
+    uint32_t m_Width = 0;
+    uint32_t m_Height = 0;
+    uint32_t m_Stride = 0;
+};
@@ -0,0 +1,78 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <Hawk/Math/Functions.hpp>
+
+#include <string>
+#include <vector>
+
+// CPU copy of the latitude-longitude environment map used by ComputeRadiance.hlsl.
+// Reads DDS files in BC6H, R16G16B16A16_FLOAT and R32G32B32A32_FLOAT formats (first mip only).
+//
+// Directions are importance sampled from an alias table over the texels, built on Initialize with
+// weights proportional to luminance times the solid angle of the texel. The table is uploaded as is for
+// the shaders, entry i also holds the density of texel i.
+class EnvironmentMap {
+public:
+    struct AliasEntry {
+        F32      Probability;
+        uint32_t Alias;
+        F32      Pdf;
+    };
+
+    void LoadFromFile(std::string const& fileName);
+
+    void Initialize(uint32_t width, uint32_t height, std::vector<Hawk::Math::Vec3>&& texels);
+
+    // Bilinear filtering with wrap addressing, texcoord in [0, 1]^2
+    Hawk::Math::Vec3 SampleTexcoord(Hawk::Math::Vec2 const& texcoord) const;
+
+    // Same mapping as GetEnvironment() in ComputeRadiance.hlsl
+    Hawk::Math::Vec3 Sample(Hawk::Math::Vec3 const& direction) const;
+
+    // Direction with its density over the solid angle from four uniform numbers in [0, 1): texel, alias, position in the texel
+    Hawk::Math::Vec3 SampleDirection(F32 u0, F32 u1, F32 u2, F32 u3, F32& pdf) const;
+
+    // Solid angle density of SampleDirection for a unit direction
+    F32 EvaluatePdf(Hawk::Math::Vec3 const& direction) const;
+
+    uint32_t GetWidth() const { return m_Width; }
+
+    uint32_t GetHeight() const { return m_Height; }
+
+    std::vector<Hawk::Math::Vec3> const& GetTexels() const { return m_Texels; }
+
+    std::vector<AliasEntry> const& GetAliasTable() const { return m_AliasTable; }
+
+private:
+    void BuildAliasTable();
+
+private:
+    uint32_t m_Width = 0;
+    uint32_t m_Height = 0;
+    std::vector<Hawk::Math::Vec3> m_Texels;
+    std::vector<AliasEntry>       m_AliasTable;
+};
@@ -173,7 +173,7 @@ namespace Hawk::Math {
 
     template<typename T>
     [[nodiscard]] ILINE constexpr auto Degrees(T radians) noexcept -> T {
-        return  (T(180) * radians) / PI;
+        return  (T(180) * radians) / PI<T>;
     }
 
     template<typename T>
@@ -211,7 +211,7 @@ namespace Hawk::Math {
 
     }
 
-    ILINE constexpr auto Hawk::Math::operator*(Mat4x4 const& lhs, Plane const& rhs) noexcept -> Plane {
+    ILINE constexpr auto operator*(Mat4x4 const& lhs, Plane const& rhs) noexcept -> Plane {
         return Math::Transpose(Math::Inverse(lhs)) * Math::Vec4(rhs.Normal, rhs.Offset);
     }
 
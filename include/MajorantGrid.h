@@ -0,0 +1,102 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "RenderCommon.h"
+#include "TransferFunction.h"
+#include "VolumeData.h"
+
+// Coarse grid of opacity bounds over the volume for delta and ratio tracking. A cell spans about CellSize
+// voxels per axis; its majorant (minorant) is the largest (smallest) value the linearly filtered opacity
+// lookup can return anywhere inside the cell, so the intensity range of every cell includes the one-voxel
+// filter apron. The control of residual ratio tracking is the mean opacity of the voxels of a cell at the base
+// mip level, from an intensity histogram of them, with the bound of the residual around it over the whole cell.
+class MajorantGrid {
+public:
+    static constexpr uint32_t CellSize = 16;
+
+    static constexpr uint32_t HistogramBinCount = 64;
+
+    // Uploaded as R32G32_FLOAT
+    struct Control {
+        F32 Mean = 0.0f;
+        F32 Residual = 0.0f;
+    };
+
+    // Number of coarser mip levels the bounds also hold for, so rays may sample up to MipLevelRange levels above the base
+    static constexpr uint32_t MipLevelRange = 3;
+
+    // Intensity range per cell over mip levels [mipLevel, GetMipLevelMax()], needed once per volume and base mip level
+    void Initialize(VolumeData const& volume, uint32_t mipLevel);
+
+    // Majorants, minorants, controls and content bounds for a new opacity transfer function, over the R8_UNORM table of samplingCount
+    // texels the shaders look it up from. Cells entirely outside the clip region are culled, they get zero bounds and are
+    // left out of the content bounds.
+    void Update(ScalarTransferFunction1D const& opacity, uint32_t samplingCount, Shading::ClipRegion const& clipRegion = {});
+
+    uint32_t GetMipLevel() const { return m_MipLevel; }
+
+    uint32_t GetMipLevelMax() const { return m_MipLevelMax; }
+
+    Hawk::Math::Vec3u GetDimension() const { return m_Dimension; }
+
+    std::vector<F32> const& GetMajorants() const { return m_Majorants; }
+
+    std::vector<F32> const& GetMinorants() const { return m_Minorants; }
+
+    std::vector<Control> const& GetControls() const { return m_Controls; }
+
+    // Normalized texture coordinates bounding the cells with a nonzero majorant, empty when there are none
+    Hawk::Math::Vec3 GetContentMin() const { return m_ContentMin; }
+
+    Hawk::Math::Vec3 GetContentMax() const { return m_ContentMax; }
+
+    F32 GetMajorant(int32_t x, int32_t y, int32_t z) const { return m_Majorants[this->CellIndex(x, y, z)]; }
+
+    F32 GetMinorant(int32_t x, int32_t y, int32_t z) const { return m_Minorants[this->CellIndex(x, y, z)]; }
+
+    Control GetControl(int32_t x, int32_t y, int32_t z) const { return m_Controls[this->CellIndex(x, y, z)]; }
+
+private:
+    size_t CellIndex(int32_t x, int32_t y, int32_t z) const { return (size_t(z) * m_Dimension.y + size_t(y)) * m_Dimension.x + size_t(x); }
+
+private:
+    struct IntensityRange {
+        uint16_t Min;
+        uint16_t Max;
+    };
+
+    std::vector<IntensityRange> m_Ranges;
+    std::vector<uint16_t>       m_Histograms;
+    OpacityIntervalIndex        m_OpacityIndex;
+    std::vector<F32>            m_Majorants;
+    std::vector<F32>            m_Minorants;
+    std::vector<Control>        m_Controls;
+    Hawk::Math::Vec3u           m_Dimension = {};
+    Hawk::Math::Vec3            m_ContentMin = {};
+    Hawk::Math::Vec3            m_ContentMax = {};
+    uint32_t                    m_MipLevel = 0;
+    uint32_t                    m_MipLevelMax = 0;
+};
@@ -0,0 +1,126 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "RenderStatistics.h"
+
+#include <Hawk/Common/Defines.hpp>
+#include <Hawk/Common/NonCopyable.hpp>
+
+#include <chrono>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Hierarchical timings of the passes of a frame. Scopes nest on the CPU timeline as they are begun and ended,
+// the GPU timeline is filled by the backend once its timestamps come back, a few frames late. Every pass keeps a
+// rolling history of its last times, and the events of the last TraceFrameCount frames can be written as a
+// Chrome trace (chrome://tracing, ui.perfetto.dev). Used from the thread that renders the frames.
+class Profiler final : Hawk::NonCopyable {
+public:
+    static constexpr uint32_t TraceFrameCount = 64;
+
+    enum Timeline : uint32_t {
+        TimelineCPU,
+        TimelineGPU
+    };
+
+    // Times in seconds since the profiler was created
+    struct Event {
+        std::string Name;
+        Profiler::Timeline Timeline = TimelineCPU;
+        uint32_t    Depth = 0;
+        uint32_t    FrameIndex = 0;
+        F64         Begin = 0.0;
+        F64         End = 0.0;
+    };
+
+    // The last ValueHistory::Length times of a pass in seconds
+    struct Pass {
+        std::string        Name;
+        Profiler::Timeline Timeline = TimelineCPU;
+        uint32_t           Depth = 0;
+        ValueHistory       Times;
+    };
+
+    class Scope final : Hawk::NonCopyable {
+    public:
+        // Does nothing without a profiler
+        Scope(Profiler* pProfiler, std::string_view name) : m_pProfiler(pProfiler) {
+            if (m_pProfiler)
+                m_pProfiler->BeginScope(name);
+        }
+
+        ~Scope() {
+            if (m_pProfiler)
+                m_pProfiler->EndScope();
+        }
+
+    private:
+        Profiler* m_pProfiler;
+    };
+
+    Profiler();
+
+    // Scopes begun before the first frame, like the loading of the scene, go to frame 0
+    void BeginFrame();
+
+    void BeginScope(std::string_view name);
+
+    void EndScope();
+
+    // Adds an event measured elsewhere, such as a GPU pass, to the history of its pass and to its frame
+    void AddEvent(Event const& event);
+
+    F64 GetTime() const;
+
+    uint32_t GetFrameIndex() const { return m_FrameIndex; }
+
+    uint32_t GetDepth() const { return static_cast<uint32_t>(std::size(m_ScopeStack)); }
+
+    // In the order the passes were first seen
+    std::vector<Pass> const& GetPasses() const { return m_Passes; }
+
+    Pass const* FindPass(std::string_view name, Timeline timeline) const;
+
+    void WriteChromeTrace(std::string const& fileName) const;
+
+private:
+    struct Frame {
+        uint32_t           Index = 0;
+        std::vector<Event> Events;
+    };
+
+    Pass& GetPass(std::string_view name, Timeline timeline, uint32_t depth);
+
+private:
+    std::chrono::high_resolution_clock::time_point m_TimeStart;
+
+    std::vector<Pass>  m_Passes;
+    std::deque<Frame>  m_Frames;
+    std::vector<Event> m_ScopeStack;
+    uint32_t           m_FrameIndex = 0;
+};
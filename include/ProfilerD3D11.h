@@ -0,0 +1,89 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "Common.h"
+#include "Profiler.h"
+
+// GPU timeline of the profiler from D3D11 timestamp queries, read FrameCount frames later without stalling
+class ProfilerD3D11 final : Hawk::NonCopyable {
+public:
+    static constexpr uint32_t FrameCount = 3;
+    static constexpr uint32_t ScopeCountMax = 32;
+
+    class Scope final : Hawk::NonCopyable {
+    public:
+        Scope(ProfilerD3D11& profiler, char const* name) : m_Profiler(profiler) { m_Profiler.BeginScope(name); }
+
+        ~Scope() { m_Profiler.EndScope(); }
+
+    private:
+        ProfilerD3D11& m_Profiler;
+    };
+
+    ProfilerD3D11(DX::ComPtr<ID3D11Device> pDevice, DX::ComPtr<ID3D11DeviceContext> pImmediateContext, DX::ComPtr<ID3DUserDefinedAnnotation> pAnnotation, Profiler& profiler);
+
+    void BeginFrame();
+
+    void EndFrame();
+
+    // The scopes past ScopeCountMax in a frame and outside of a frame are only annotated
+    void BeginScope(char const* name);
+
+    void EndScope();
+
+    Profiler& GetProfiler() const { return m_Profiler; }
+
+private:
+    // Timestamp 0 is the beginning of the frame, the scopes take the pairs after it
+    struct ScopeRecord {
+        std::string Name;
+        uint32_t    Depth = 0;
+        uint32_t    TimestampBegin = 0;
+        uint32_t    TimestampEnd = 0;
+    };
+
+    struct FrameRecord {
+        DX::ComPtr<ID3D11Query>                                     pQueryDisjoint;
+        std::array<DX::ComPtr<ID3D11Query>, 2 * ScopeCountMax + 2> pQueryTimestamps;
+        std::vector<ScopeRecord>                                    Scopes;
+        uint32_t                                                    TimestampCount = 0;
+        uint32_t                                                    FrameIndex = 0;
+        F64                                                         Time = 0.0;
+        bool                                                        IsPending = false;
+    };
+
+    void Resolve();
+
+private:
+    DX::ComPtr<ID3D11DeviceContext>       m_pImmediateContext;
+    DX::ComPtr<ID3DUserDefinedAnnotation> m_pAnnotation;
+    Profiler&                             m_Profiler;
+
+    std::array<FrameRecord, FrameCount> m_Frames;
+    std::vector<uint32_t>               m_ScopeStack;
+    uint32_t                            m_FrameSlot = 0;
+    bool                                m_IsFrameActive = false;
+};
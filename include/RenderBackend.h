@@ -0,0 +1,89 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "AutoExposure.h"
+#include "BlueNoise.h"
+#include "EnvironmentMap.h"
+#include "MajorantGrid.h"
+#include "RenderCommon.h"
+#include "TransferFunction.h"
+#include "VolumeData.h"
+
+#include <vector>
+
+// Path tracer behind the application, fed the scene data it owns and one FrameBuffer per frame. Frames
+// accumulate into the image until FrameIndex goes back to 0. Implementations keep only what they derive from
+// the data (textures, lookup tables), the pointers have to stay valid until they are set again. The transfer
+// functions are set before the volume, the gradient of the volume is computed with the opacity of them.
+class RenderBackend {
+public:
+    virtual ~RenderBackend() = default;
+
+    virtual void Resize(uint32_t width, uint32_t height) = 0;
+
+    virtual void SetVolume(VolumeData const* pVolume) = 0;
+
+    virtual void SetEnvironmentMap(EnvironmentMap const* pEnvironmentMap) = 0;
+
+    virtual void SetBlueNoise(BlueNoise const* pBlueNoise) = 0;
+
+    // Set again after every update of the grid
+    virtual void SetMajorantGrid(MajorantGrid const* pMajorantGrid) = 0;
+
+    virtual void SetTransferFunctions(TransferFunctionSet const& functions, uint32_t samplingCount) = 0;
+
+    virtual void SetSampleDispersion(uint32_t sampleDispersion) = 0;
+
+    virtual void SetAutoExposure(bool isEnabled) = 0;
+
+    virtual void SetAutoExposureDesc(AutoExposure::Desc const& desc) = 0;
+
+    // Exposure the image was tone mapped with in the last frame
+    virtual F32 GetExposure() const = 0;
+
+    virtual AutoExposure const& GetAutoExposure() const = 0;
+
+    virtual void RenderFrame(FrameBuffer const& frame) = 0;
+
+    // Tone maps the accumulated image again with the exposure of the frame, nothing is rendered or accumulated
+    virtual void ToneMapImage(FrameBuffer const& frame) = 0;
+
+    // Tiles rendered in the newest frame whose count is known, UINT32_MAX until then. A GPU knows it a few frames late.
+    virtual uint32_t ReadActiveTileCount() = 0;
+
+    // Passes over the tiles of the frame ReadActiveTileCount last read, the noisiest tiles render more than one
+    virtual uint32_t GetActiveTilePassCount() const = 0;
+
+    // Width and height in pixels of the tiles ReadActiveTileCount counts, a tile pass takes one sample per pixel
+    virtual uint32_t GetTileSize() const = 0;
+
+    // Time of the oldest frame that has not been read yet, with the RenderTargetDim it was rendered at. Every
+    // frame is read once, false while none is known.
+    virtual bool ReadFrameTime(F32& frameTime, Hawk::Math::Vec2u& renderDimension) = 0;
+
+    // Running mean of the radiance, w holds the number of samples of the pixel. Waits for the frames in flight.
+    virtual void ReadColorSum(std::vector<Hawk::Math::Vec4>& colorSum) = 0;
+};
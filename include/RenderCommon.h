@@ -0,0 +1,616 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <Hawk/Math/Functions.hpp>
+#include <Hawk/Math/Geometry.hpp>
+#include <Hawk/Math/Transform.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <span>
+
+enum TrackingMode : uint32_t {
+    TrackingModeRayMarching,
+    TrackingModeDelta
+};
+
+// Estimator of the visibility of radiance rays: a binary hit/miss from the tracking mode, or fractional
+// transmittance from ratio tracking and residual ratio tracking over the majorant grid
+enum TransmittanceEstimator : uint32_t {
+    TransmittanceEstimatorTracking,
+    TransmittanceEstimatorRatio,
+    TransmittanceEstimatorResidualRatio
+};
+
+// Light transport at scatter events: the BSDF-sampled ray alone, or next-event estimation with an extra
+// ray towards an importance-sampled environment direction, both weighted by multiple importance sampling
+enum LightSampling : uint32_t {
+    LightSamplingBSDF,
+    LightSamplingMIS
+};
+
+// Sequence of the sample vectors of every pixel, indexed by frame: hashed white noise, Sobol points with
+// Owen scrambling per pixel, or a rank-1 lattice sequence rotated per pixel by a blue-noise mask
+enum SampleSequence : uint32_t {
+    SampleSequenceRandom,
+    SampleSequenceSobol,
+    SampleSequenceRank1
+};
+
+constexpr uint32_t ClipPlaneCountMax = 6;
+
+struct FrameBuffer {
+
+    Hawk::Math::Mat4x4 ProjectionMatrix;
+    Hawk::Math::Mat4x4 ViewMatrix;
+    Hawk::Math::Mat4x4 WorldMatrix;
+    Hawk::Math::Mat4x4 NormalMatrix;
+
+    Hawk::Math::Mat4x4 InvProjectionMatrix;
+    Hawk::Math::Mat4x4 InvViewMatrix;
+    Hawk::Math::Mat4x4 InvWorldMatrix;
+    Hawk::Math::Mat4x4 InvNormalMatrix;
+
+    Hawk::Math::Mat4x4 ViewProjectionMatrix;
+    Hawk::Math::Mat4x4 NormalViewMatrix;
+    Hawk::Math::Mat4x4 WorldViewProjectionMatrix;
+
+    Hawk::Math::Mat4x4 InvViewProjectionMatrix;
+    Hawk::Math::Mat4x4 InvNormalViewMatrix;
+    Hawk::Math::Mat4x4 InvWorldViewProjectionMatrix;
+
+    uint32_t FrameIndex;
+    float    StepSize;
+    uint32_t SampleSequence;
+    uint32_t BlueNoiseSize;
+
+    Hawk::Math::Vec2 InvRenderTargetDim;
+    Hawk::Math::Vec2 RenderTargetDim;
+
+    float Density;
+    Hawk::Math::Vec3 BoundingBoxMin;
+
+    float Exposure;
+    Hawk::Math::Vec3 BoundingBoxMax;
+
+    Hawk::Math::Vec3u MajorantGridDimension;
+    uint32_t          TrackingMode;
+
+    uint32_t TransmittanceEstimator;
+    uint32_t LevelOfDetail;
+    uint32_t LevelOfDetailDepthBias;
+    uint32_t LevelOfDetailMax;
+
+    Hawk::Math::Vec2u EnvironmentDimension;
+    uint32_t          LightSampling;
+    float             TileErrorThreshold;
+
+    Hawk::Math::Mat4x4 CropBoxMatrix;
+    Hawk::Math::Vec4   ClipPlanes[ClipPlaneCountMax];
+
+    Hawk::Math::Vec3 CropBoxMin;
+    uint32_t         ClipPlaneCount;
+
+    Hawk::Math::Vec3 CropBoxMax;
+    uint32_t         TilePass;
+};
+
+// Scales the unit volume cube by the Manix voxel spacing and turns it z-up
+inline Hawk::Math::Mat4x4 ComputeWorldMatrix(uint32_t dimensionX, uint32_t dimensionY, uint32_t dimensionZ) {
+
+    Hawk::Math::Vec3 scaleVector = { 0.488f * dimensionX, 0.488f * dimensionY, 0.7f * dimensionZ };
+    scaleVector /= (std::max)({ scaleVector.x, scaleVector.y, scaleVector.z });
+    return Hawk::Math::RotateX(Hawk::Math::Radians(-90.0f)) * Hawk::Math::Scale(scaleVector);
+}
+
+// The volume fills this cube of model space, texture coordinates and the majorant grid are relative to it.
+// FrameBuffer::BoundingBoxMin/Max is the part of the cube rays are clipped to.
+inline const Hawk::Math::Vec3 VolumeBoundingBoxMin = Hawk::Math::Vec3(-0.5f, -0.5f, -0.5f);
+inline const Hawk::Math::Vec3 VolumeBoundingBoxMax = Hawk::Math::Vec3(+0.5f, +0.5f, +0.5f);
+
+// Clips rays to [texcoordMin, texcoordMax] of the volume, such as the content bounds of MajorantGrid
+inline void SetFrameBoundingBox(FrameBuffer& frame, Hawk::Math::Vec3 const& texcoordMin, Hawk::Math::Vec3 const& texcoordMax) {
+
+    frame.BoundingBoxMin = VolumeBoundingBoxMin + texcoordMin * (VolumeBoundingBoxMax - VolumeBoundingBoxMin);
+    frame.BoundingBoxMax = VolumeBoundingBoxMin + texcoordMax * (VolumeBoundingBoxMax - VolumeBoundingBoxMin);
+}
+
+// Rays keep the part of the volume on the positive side of every plane, Dot(Normal, p) + Offset >= 0, that also
+// lies inside the crop box. Planes are in model space, the box in its own space that cropBoxTransform maps to model space.
+inline void SetFrameClipRegion(FrameBuffer& frame, std::span<Hawk::Math::Plane const> planes, Hawk::Math::Box const& cropBox, Hawk::Math::Mat4x4 const& cropBoxTransform) {
+
+    assert(std::size(planes) <= ClipPlaneCountMax);
+
+    frame.ClipPlaneCount = static_cast<uint32_t>(std::size(planes));
+    for (uint32_t index = 0; index < frame.ClipPlaneCount; index++)
+        frame.ClipPlanes[index] = Hawk::Math::Vec4(planes[index].Normal.x, planes[index].Normal.y, planes[index].Normal.z, planes[index].Offset);
+
+    frame.CropBoxMatrix = Hawk::Math::Inverse(cropBoxTransform);
+    frame.CropBoxMin = cropBox.Min;
+    frame.CropBoxMax = cropBox.Max;
+}
+
+inline Hawk::Math::Mat4x4 ComputeProjectionMatrix(F32 zoom, uint32_t width, uint32_t height) {
+
+    return Hawk::Math::Orthographic(zoom * (width / static_cast<F32>(height)), zoom, -1.0f, 1.0f);
+}
+
+// Mip level whose largest voxel edge matches the pixel footprint of ComputeProjectionMatrix, which is the
+// same for every primary ray under the orthographic projection
+inline F32 ComputeFootprintLevelOfDetail(Hawk::Math::Mat4x4 const& world, Hawk::Math::Vec3u const& dimension, F32 zoom, uint32_t height) {
+
+    F32 voxelSize = 0.0f;
+    for (uint32_t axis = 0; axis < 3; axis++) {
+        const auto edge = Hawk::Math::Vec3(world(0, axis), world(1, axis), world(2, axis));
+        voxelSize = (std::max)(voxelSize, Hawk::Math::Length(edge) / dimension[axis]);
+    }
+    return std::log2(zoom / height / voxelSize);
+}
+
+// Primary rays sample the footprint level clamped to [minLevel, maxLevel], every further path vertex goes
+// depthBias levels coarser. The step size of frame.StepSize is for minLevel and doubles with every level above.
+inline void SetFrameLevelOfDetail(FrameBuffer& frame, F32 footprintLevel, uint32_t minLevel, uint32_t maxLevel, uint32_t depthBias) {
+
+    const auto level = static_cast<uint32_t>(std::clamp(std::floor(footprintLevel), F32(minLevel), F32(maxLevel)));
+
+    frame.StepSize *= F32(1u << (level - minLevel));
+    frame.LevelOfDetail = level;
+    frame.LevelOfDetailDepthBias = depthBias;
+    frame.LevelOfDetailMax = maxLevel;
+}
+
+inline void SetFrameMatrices(FrameBuffer& frame, Hawk::Math::Mat4x4 const& W, Hawk::Math::Mat4x4 const& V, Hawk::Math::Mat4x4 const& P) {
+
+    Hawk::Math::Mat4x4 N = Hawk::Math::Inverse(Hawk::Math::Transpose(W));
+
+    Hawk::Math::Mat4x4 VP = P * V;
+    Hawk::Math::Mat4x4 NV = V * N;
+    Hawk::Math::Mat4x4 WVP = P * V * W;
+
+    frame.ProjectionMatrix = P;
+    frame.ViewMatrix = V;
+    frame.WorldMatrix = W;
+    frame.NormalMatrix = N;
+
+    frame.InvProjectionMatrix = Hawk::Math::Inverse(P);
+    frame.InvViewMatrix = Hawk::Math::Inverse(V);
+    frame.InvWorldMatrix = Hawk::Math::Inverse(W);
+    frame.InvNormalMatrix = Hawk::Math::Inverse(N);
+
+    frame.ViewProjectionMatrix = VP;
+    frame.NormalViewMatrix = NV;
+    frame.WorldViewProjectionMatrix = WVP;
+
+    frame.InvViewProjectionMatrix = Hawk::Math::Inverse(VP);
+    frame.InvNormalViewMatrix = Hawk::Math::Inverse(NV);
+    frame.InvWorldViewProjectionMatrix = Hawk::Math::Inverse(WVP);
+}
+
+// CPU counterparts of Common.hlsl. Keep them in step with the shader code: the CPU renderer is
+// the reference the GPU output is compared against.
+namespace Shading {
+    using Hawk::Math::Vec2;
+    using Hawk::Math::Vec3;
+    using Hawk::Math::Vec4;
+    using Hawk::Math::Vec2u;
+    using Hawk::Math::Mat4x4;
+
+    struct Ray {
+        Vec3 Origin;
+        Vec3 Direction;
+        F32  Min;
+        F32  Max;
+    };
+
+    struct Intersection {
+        F32 Min;
+        F32 Max;
+    };
+
+    struct AABB {
+        Vec3 Min;
+        Vec3 Max;
+    };
+
+    struct CRNG {
+        uint32_t Seed;
+    };
+
+    inline F32 Max3(F32 a, F32 b, F32 c) { return std::max(std::max(a, b), c); }
+
+    inline F32 Min3(F32 a, F32 b, F32 c) { return std::min(std::min(a, b), c); }
+
+    inline F32 Saturate(F32 x) { return std::clamp(x, 0.0f, 1.0f); }
+
+    inline Vec3 Reflect(Vec3 const& i, Vec3 const& n) { return i - 2.0f * Hawk::Math::Dot(n, i) * n; }
+
+    inline Vec3 Lerp(Vec3 const& a, Vec3 const& b, F32 t) { return a + t * (b - a); }
+
+    // Filmic curve of ToneMap.hlsl, normalized to the white point before the exposure is applied
+    inline F32 ToneMapUncharted2(F32 x, F32 exposure) {
+
+        auto Uncharted2Function = [](F32 A, F32 B, F32 C, F32 D, F32 E, F32 F, F32 x) -> F32 {
+            return ((x * (A * x + C * B) + D * E) / (x * (A * x + B) + D * F)) - E / F;
+        };
+
+        constexpr F32 A = 0.15f;
+        constexpr F32 B = 0.50f;
+        constexpr F32 C = 0.10f;
+        constexpr F32 D = 0.20f;
+        constexpr F32 E = 0.02f;
+        constexpr F32 F = 0.30f;
+        constexpr F32 W = 11.2f;
+
+        return Uncharted2Function(A, B, C, D, E, F, x) * exposure / Uncharted2Function(A, B, C, D, E, F, W);
+    }
+
+    inline Vec2 ScreenSpaceToNDC(Vec2 const& pixel, Vec2 const& invDimension) {
+
+        const auto ndc = 2.0f * (pixel + Vec2(0.5f, 0.5f)) * invDimension - Vec2(1.0f, 1.0f);
+        return Vec2(ndc.x, -ndc.y);
+    }
+
+    inline Intersection IntersectAABB(Ray const& ray, AABB const& aabb) {
+
+        const auto invR = Vec3(1.0f, 1.0f, 1.0f) / ray.Direction;
+        const auto bot = invR * (aabb.Min - ray.Origin);
+        const auto top = invR * (aabb.Max - ray.Origin);
+
+        const auto largestMin = Max3(std::min(top.x, bot.x), std::min(top.y, bot.y), std::min(top.z, bot.z));
+        const auto largestMax = Min3(std::max(top.x, bot.x), std::max(top.y, bot.y), std::max(top.z, bot.z));
+        return Intersection{ largestMin, largestMax };
+    }
+
+    // Clip planes and crop box of a FrameBuffer, the defaults keep the whole volume
+    struct ClipRegion {
+        Vec4     Planes[ClipPlaneCountMax] = {};
+        uint32_t PlaneCount = 0;
+        Mat4x4   CropBoxMatrix = Mat4x4(1.0f);
+        AABB     CropBox = { VolumeBoundingBoxMin, VolumeBoundingBoxMax };
+    };
+
+    inline ClipRegion GetClipRegion(FrameBuffer const& frame) {
+
+        ClipRegion region;
+        std::copy_n(frame.ClipPlanes, frame.ClipPlaneCount, region.Planes);
+        region.PlaneCount = frame.ClipPlaneCount;
+        region.CropBoxMatrix = frame.CropBoxMatrix;
+        region.CropBox = { frame.CropBoxMin, frame.CropBoxMax };
+        return region;
+    }
+
+    // Narrows the interval of a ray to the clip region once, before marching, instead of testing every sample
+    inline Intersection ClipRay(Ray const& ray, Intersection intersect, ClipRegion const& region) {
+
+        for (uint32_t index = 0; index < region.PlaneCount; index++) {
+            const auto normal = Vec3(region.Planes[index].x, region.Planes[index].y, region.Planes[index].z);
+            const F32 distance = Hawk::Math::Dot(normal, ray.Origin) + region.Planes[index].w;
+            const F32 cosine = Hawk::Math::Dot(normal, ray.Direction);
+
+            // Rays parallel to a plane are kept or clipped as a whole
+            if (cosine > 0.0f)
+                intersect.Min = std::max(intersect.Min, -distance / cosine);
+            else if (cosine < 0.0f)
+                intersect.Max = std::min(intersect.Max, -distance / cosine);
+            else if (distance < 0.0f)
+                intersect.Max = -std::numeric_limits<F32>::max();
+        }
+
+        const auto origin = region.CropBoxMatrix * Vec4(ray.Origin.x, ray.Origin.y, ray.Origin.z, 1.0f);
+        const auto direction = region.CropBoxMatrix * Vec4(ray.Direction.x, ray.Direction.y, ray.Direction.z, 0.0f);
+        const Intersection crop = IntersectAABB({ Vec3(origin.x, origin.y, origin.z), Vec3(direction.x, direction.y, direction.z), 0.0f, 0.0f }, region.CropBox);
+        return Intersection{ std::max(intersect.Min, crop.Min), std::min(intersect.Max, crop.Max) };
+    }
+
+    // Conservative, a box reported inside may still be clipped away entirely by the crop box
+    inline bool IsOutsideClipRegion(AABB const& box, ClipRegion const& region) {
+
+        for (uint32_t index = 0; index < region.PlaneCount; index++) {
+            auto const& plane = region.Planes[index];
+            const F32 distance = std::max(box.Min.x * plane.x, box.Max.x * plane.x) + std::max(box.Min.y * plane.y, box.Max.y * plane.y) + std::max(box.Min.z * plane.z, box.Max.z * plane.z) + plane.w;
+            if (distance < 0.0f)
+                return true;
+        }
+
+        Vec3 cropMin = Vec3(+std::numeric_limits<F32>::max());
+        Vec3 cropMax = Vec3(-std::numeric_limits<F32>::max());
+        for (uint32_t corner = 0; corner < 8; corner++) {
+            const auto p = region.CropBoxMatrix * Vec4((corner & 1) ? box.Max.x : box.Min.x, (corner & 2) ? box.Max.y : box.Min.y, (corner & 4) ? box.Max.z : box.Min.z, 1.0f);
+            for (uint32_t axis = 0; axis < 3; axis++) {
+                cropMin[axis] = std::min(cropMin[axis], p[axis]);
+                cropMax[axis] = std::max(cropMax[axis], p[axis]);
+            }
+        }
+        return cropMax.x < region.CropBox.Min.x || cropMax.y < region.CropBox.Min.y || cropMax.z < region.CropBox.Min.z ||
+               cropMin.x > region.CropBox.Max.x || cropMin.y > region.CropBox.Max.y || cropMin.z > region.CropBox.Max.z;
+    }
+
+    inline Ray CreateCameraRay(Vec2u const& id, Vec2 const& offset, Vec2 const& invDimension, Mat4x4 const& invWVP) {
+
+        const auto ncdXY = ScreenSpaceToNDC(Vec2(static_cast<F32>(id.x), static_cast<F32>(id.y)) + offset, invDimension);
+
+        auto rayStart = invWVP * Vec4(ncdXY.x, ncdXY.y, 0.0f, 1.0f);
+        auto rayEnd = invWVP * Vec4(ncdXY.x, ncdXY.y, 1.0f, 1.0f);
+
+        const auto start = Vec3(rayStart.x, rayStart.y, rayStart.z) / rayStart.w;
+        const auto end = Vec3(rayEnd.x, rayEnd.y, rayEnd.z) / rayEnd.w;
+
+        Ray ray;
+        ray.Direction = Hawk::Math::Normalize(end - start);
+        ray.Origin = start;
+        ray.Min = 0.0f;
+        ray.Max = Hawk::Math::Distance(end, start);
+        return ray;
+    }
+
+    inline uint32_t PCGHash(uint32_t seed) {
+
+        const uint32_t state = seed * 747796405u + 2891336453u;
+        const uint32_t word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+        return (word >> 22u) ^ word;
+    }
+
+    inline F32 ToUnitFloat(uint32_t x) {
+
+        return std::bit_cast<F32>(0x3f800000u | (x >> 9)) - 1.0f;
+    }
+
+    inline F32 Rand(CRNG& rng) {
+
+        rng.Seed = PCGHash(rng.Seed);
+        return ToUnitFloat(rng.Seed);
+    }
+
+    inline uint32_t ReverseBits(uint32_t x) {
+
+        x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+        x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+        x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+        x = ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+        return (x >> 16) | (x << 16);
+    }
+
+    inline uint32_t HashCombine(uint32_t seed, uint32_t value) {
+
+        return seed ^ (PCGHash(value) + 0x9E3779B9u + (seed << 6) + (seed >> 2));
+    }
+
+    // Owen scrambling of the bits of x, most significant first (Burley, Practical Hash-based Owen Scrambling)
+    inline uint32_t NestedUniformScramble(uint32_t x, uint32_t seed) {
+
+        x = ReverseBits(x);
+        x += seed;
+        x ^= x * 0x6C50B47Cu;
+        x ^= x * 0xB82F1E52u;
+        x ^= x * 0xC7AFE638u;
+        x ^= x * 0x8D22F6E6u;
+        return ReverseBits(x);
+    }
+
+    // Generator matrices of the first four Sobol dimensions (Joe and Kuo), column i is applied for bit i of the index
+    inline constexpr uint32_t SobolDirections[4][32] = {
+        {
+            0x80000000u, 0x40000000u, 0x20000000u, 0x10000000u, 0x08000000u, 0x04000000u, 0x02000000u, 0x01000000u,
+            0x00800000u, 0x00400000u, 0x00200000u, 0x00100000u, 0x00080000u, 0x00040000u, 0x00020000u, 0x00010000u,
+            0x00008000u, 0x00004000u, 0x00002000u, 0x00001000u, 0x00000800u, 0x00000400u, 0x00000200u, 0x00000100u,
+            0x00000080u, 0x00000040u, 0x00000020u, 0x00000010u, 0x00000008u, 0x00000004u, 0x00000002u, 0x00000001u
+        },
+        {
+            0x80000000u, 0xC0000000u, 0xA0000000u, 0xF0000000u, 0x88000000u, 0xCC000000u, 0xAA000000u, 0xFF000000u,
+            0x80800000u, 0xC0C00000u, 0xA0A00000u, 0xF0F00000u, 0x88880000u, 0xCCCC0000u, 0xAAAA0000u, 0xFFFF0000u,
+            0x80008000u, 0xC000C000u, 0xA000A000u, 0xF000F000u, 0x88008800u, 0xCC00CC00u, 0xAA00AA00u, 0xFF00FF00u,
+            0x80808080u, 0xC0C0C0C0u, 0xA0A0A0A0u, 0xF0F0F0F0u, 0x88888888u, 0xCCCCCCCCu, 0xAAAAAAAAu, 0xFFFFFFFFu
+        },
+        {
+            0x80000000u, 0xC0000000u, 0x60000000u, 0x90000000u, 0xE8000000u, 0x5C000000u, 0x8E000000u, 0xC5000000u,
+            0x68800000u, 0x9CC00000u, 0xEE600000u, 0x55900000u, 0x80680000u, 0xC09C0000u, 0x60EE0000u, 0x90550000u,
+            0xE8808000u, 0x5CC0C000u, 0x8E606000u, 0xC5909000u, 0x6868E800u, 0x9C9C5C00u, 0xEEEE8E00u, 0x5555C500u,
+            0x8000E880u, 0xC0005CC0u, 0x60008E60u, 0x9000C590u, 0xE8006868u, 0x5C009C9Cu, 0x8E00EEEEu, 0xC5005555u
+        },
+        {
+            0x80000000u, 0xC0000000u, 0x20000000u, 0x50000000u, 0xF8000000u, 0x74000000u, 0xA2000000u, 0x93000000u,
+            0xD8800000u, 0x25400000u, 0x59E00000u, 0xE6D00000u, 0x78080000u, 0xB40C0000u, 0x82020000u, 0xC3050000u,
+            0x208F8000u, 0x51474000u, 0xFBEA2000u, 0x75D93000u, 0xA0858800u, 0x914E5400u, 0xDBE79E00u, 0x25DB6D00u,
+            0x58800080u, 0xE54000C0u, 0x79E00020u, 0xB6D00050u, 0x800800F8u, 0xC00C0074u, 0x200200A2u, 0x50050093u
+        }
+    };
+
+    // Generating vector of the base-2 embedded rank-1 lattice sequence, chosen component by component for the
+    // minimum distance of its two-dimensional projections over 2^4 to 2^12 points
+    inline constexpr uint32_t Rank1Generator[32] = {
+        1u, 30941u, 12149u, 27337u, 15471u, 5909u, 23763u, 64141u,
+        64471u, 36319u, 32667u, 56837u, 49533u, 51257u, 37839u, 13465u,
+        52323u, 17729u, 2257u, 48671u, 55975u, 58231u, 23637u, 33199u,
+        54579u, 45017u, 10423u, 863u, 41365u, 53185u, 24499u, 28151u
+    };
+
+    inline uint32_t Sobol(uint32_t index, uint32_t dimension) {
+
+        uint32_t x = 0;
+        for (uint32_t bit = 0; index != 0; index >>= 1, bit++)
+            x ^= (index & 1) ? SobolDirections[dimension][bit] : 0;
+        return x;
+    }
+
+    // Dimensions of the sample vector reserved for every path vertex, the vertex of a pass starts at bounce * SamplerDimensionsPerBounce
+    constexpr uint32_t SamplerDimensionsPerBounce = 16;
+
+    // Sample vector of one pixel, frame and path vertex. Dimensions are indexed relative to the vertex, so
+    // branches that skip a sample do not shift the dimensions of the others.
+    struct CSampler {
+        uint32_t   Sequence;
+        uint32_t   Index;
+        uint32_t   Dimension;
+        uint32_t   Seed;
+        Vec2u      Pixel;
+        F32 const* pBlueNoise;
+        uint32_t   BlueNoiseSize;
+    };
+
+    inline CSampler InitSampler(FrameBuffer const& frame, F32 const* pBlueNoise, Vec2u const& id, uint32_t sampleIndex, uint32_t bounce) {
+
+        return CSampler{ frame.SampleSequence, sampleIndex, bounce * SamplerDimensionsPerBounce, PCGHash((id.x << 16) | id.y), id, pBlueNoise, frame.BlueNoiseSize };
+    }
+
+    inline CSampler InitSampler(FrameBuffer const& frame, F32 const* pBlueNoise, Vec2u const& id, uint32_t bounce) {
+
+        return InitSampler(frame, pBlueNoise, id, frame.FrameIndex, bounce);
+    }
+
+    inline F32 Sample1D(CSampler const& sampler, uint32_t offset) {
+
+        const uint32_t dimension = sampler.Dimension + offset;
+        if (sampler.Sequence == SampleSequenceSobol) {
+            // Dimensions past the fourth reuse the generator matrices with an index shuffled per group of four
+            const uint32_t index = NestedUniformScramble(sampler.Index, HashCombine(sampler.Seed, dimension / 4));
+            return ToUnitFloat(NestedUniformScramble(Sobol(index, dimension % 4), HashCombine(sampler.Seed, dimension)));
+        }
+
+        if (sampler.Sequence == SampleSequenceRank1) {
+            // Every dimension reads the mask at its own toroidal offset, in 32-bit fixed point the lattice wraps exactly
+            const uint32_t size = sampler.BlueNoiseSize;
+            const uint32_t shift = PCGHash(dimension);
+            const uint32_t x = (sampler.Pixel.x + (shift & 0xFFFF)) % size;
+            const uint32_t y = (sampler.Pixel.y + (shift >> 16)) % size;
+            const auto rotation = static_cast<uint32_t>(sampler.pBlueNoise[y * size + x] * 4294967296.0);
+            return ToUnitFloat(ReverseBits(sampler.Index) * Rank1Generator[dimension % 32] + rotation);
+        }
+
+        return ToUnitFloat(PCGHash(HashCombine(HashCombine(sampler.Seed, sampler.Index), dimension)));
+    }
+
+    inline Vec2 Sample2D(CSampler const& sampler, uint32_t offset) {
+
+        return Vec2(Sample1D(sampler, offset), Sample1D(sampler, offset + 1));
+    }
+
+    // Generator for tracking loops, which take an unbounded number of random numbers, seeded from a dimension
+    inline CRNG SampleRNG(CSampler const& sampler, uint32_t offset) {
+
+        return CRNG{ PCGHash(HashCombine(HashCombine(sampler.Seed, sampler.Index), sampler.Dimension + offset) ^ 0x5BD1E995u) };
+    }
+
+    // Subpixel offset of the camera ray in [-0.5, 0.5)^2, the first dimensions of the primary vertex
+    inline Vec2 SamplePixelJitter(CSampler const& sampler) {
+
+        return Sample2D(sampler, 0) - Vec2(0.5f, 0.5f);
+    }
+
+    inline uint32_t GetLevelOfDetail(FrameBuffer const& frame, uint32_t depth) {
+
+        return (std::min)(frame.LevelOfDetail + depth * frame.LevelOfDetailDepthBias, frame.LevelOfDetailMax);
+    }
+
+    inline F32 GetStepSize(FrameBuffer const& frame, uint32_t levelOfDetail) {
+
+        return frame.StepSize * F32(1u << (levelOfDetail - frame.LevelOfDetail));
+    }
+
+    inline Vec3 GetNormalizedTexcoord(Vec3 const& position, AABB const& aabb) {
+
+        return (position - aabb.Min) / (aabb.Max - aabb.Min);
+    }
+
+    inline Vec3 GetWorldPosition(Vec3 const& texcoord, AABB const& aabb) {
+
+        return texcoord * (aabb.Max - aabb.Min) + aabb.Min;
+    }
+
+    // Passes per frame of a tile whose error is above the threshold: one, and one more for every doubling of the
+    // error over the threshold. Every pass takes a sample of each pixel of the tile.
+    constexpr uint32_t TilePassCountMax = 4;
+
+    inline uint32_t GetTilePassCount(F32 error, F32 threshold) {
+
+        if (!(error > threshold))
+            return 0;
+        if (!(threshold > 0.0f))
+            return 1;
+        return 1 + static_cast<uint32_t>((std::min)(std::log2(error / threshold), F32(TilePassCountMax - 1)));
+    }
+
+    // The extra passes are ranked by pass count and fit into the passes of the retired tiles, so a frame costs at most
+    // one pass of every tile. histogram[n - 1] counts the selected tiles with n passes. The pass count where the budget
+    // runs out gets the extra passes that are left for each of its tiles, the lower ones get none.
+    inline uint32_t ApplyTilePassBudget(uint32_t passCount, uint32_t const* histogram, uint32_t tileCount) {
+
+        uint32_t selectedCount = 0;
+        for (uint32_t count = 1; count <= TilePassCountMax; count++)
+            selectedCount += histogram[count - 1];
+
+        uint32_t budget = tileCount - (std::min)(selectedCount, tileCount);
+        for (uint32_t count = TilePassCountMax; count > 1; count--) {
+            const uint32_t extraCount = histogram[count - 1] > 0 ? (std::min)(count - 1, budget / histogram[count - 1]) : count - 1;
+            if (count == passCount)
+                return 1 + extraCount;
+            if (extraCount < count - 1)
+                break;
+            budget -= extraCount * histogram[count - 1];
+        }
+        return (std::min)(passCount, 1u);
+    }
+
+    // 3D-DDA over the cells of a grid spanning the bounding box. Origin and direction are given in
+    // grid coordinates, the ray parameter stays the world space one.
+    struct GridTraversal {
+        Hawk::Math::Vec3i Cell;
+        Hawk::Math::Vec3i Step;
+        Vec3              DeltaT;
+        Vec3              NextT;
+    };
+
+    inline GridTraversal InitGridTraversal(Vec3 const& origin, Vec3 const& direction, F32 t, Hawk::Math::Vec3u const& dimension) {
+
+        const Vec3 position = origin + t * direction;
+
+        GridTraversal grid;
+        for (uint32_t axis = 0; axis < 3; axis++) {
+            grid.Cell[axis] = std::clamp(static_cast<int32_t>(std::floor(position[axis])), 0, static_cast<int32_t>(dimension[axis]) - 1);
+            grid.Step[axis] = direction[axis] >= 0.0f ? 1 : -1;
+
+            const F32 boundary = static_cast<F32>(grid.Cell[axis] + std::max(grid.Step[axis], 0));
+            grid.DeltaT[axis] = direction[axis] != 0.0f ? std::abs(1.0f / direction[axis]) : std::numeric_limits<F32>::max();
+            grid.NextT[axis] = direction[axis] != 0.0f ? t + (boundary - position[axis]) / direction[axis] : std::numeric_limits<F32>::max();
+        }
+        return grid;
+    }
+
+    inline F32 GetGridTraversalExit(GridTraversal const& grid) {
+
+        return Min3(grid.NextT.x, grid.NextT.y, grid.NextT.z);
+    }
+
+    inline bool AdvanceGridTraversal(GridTraversal& grid, Hawk::Math::Vec3u const& dimension) {
+
+        const uint32_t axis = (grid.NextT.x <= grid.NextT.y && grid.NextT.x <= grid.NextT.z) ? 0 : (grid.NextT.y <= grid.NextT.z ? 1 : 2);
+        grid.Cell[axis] += grid.Step[axis];
+        grid.NextT[axis] += grid.DeltaT[axis];
+        return grid.Cell[axis] >= 0 && grid.Cell[axis] < static_cast<int32_t>(dimension[axis]);
+    }
+}
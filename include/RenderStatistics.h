@@ -0,0 +1,103 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <Hawk/Common/Defines.hpp>
+
+#include <array>
+
+// The last Length values of a series in a ring, the oldest value is overwritten once it is full
+class ValueHistory final {
+public:
+    static constexpr uint32_t Length = 256;
+
+    struct Percentiles {
+        F32 P50 = 0.0f;
+        F32 P95 = 0.0f;
+        F32 P99 = 0.0f;
+    };
+
+    void Push(F32 value);
+
+    void Clear();
+
+    uint32_t GetCount() const { return m_Count; }
+
+    // From the oldest value to the newest
+    F32 operator[](uint32_t index) const { return m_Values[(m_Offset + index) % Length]; }
+
+    F32 GetLast() const { return m_Count > 0 ? (*this)[m_Count - 1] : 0.0f; }
+
+    F32 GetAverage() const;
+
+    F32 GetMax() const;
+
+    // Nearest-rank percentiles of the values in the ring
+    Percentiles GetPercentiles() const;
+
+private:
+    std::array<F32, Length> m_Values = {};
+    uint32_t                m_Count = 0;
+    uint32_t                m_Offset = 0;
+};
+
+// Rolling statistics of the rendered frames for the GUI and the headless tools. The frames of an idle,
+// converged image are not added, the history holds the last ValueHistory::Length frames that rendered.
+class RenderStatistics final {
+public:
+    struct Frame {
+        F32      FrameTime = 0.0f;
+        F32      RenderTime = 0.0f;
+        uint64_t SampleCount = 0;
+        uint32_t ActiveTileCount = 0;
+    };
+
+    void AddFrame(Frame const& frame);
+
+    void Clear();
+
+    // Wall time between the frames in seconds, bound by the presentation
+    ValueHistory const& GetFrameTimes() const { return m_FrameTimes; }
+
+    // Time the renderer spent on the frames in seconds, on the GPU for a GPU renderer
+    ValueHistory const& GetRenderTimes() const { return m_RenderTimes; }
+
+    // Samples per second of render time
+    ValueHistory const& GetSampleRates() const { return m_SampleRates; }
+
+    ValueHistory const& GetActiveTileCounts() const { return m_ActiveTileCounts; }
+
+    uint64_t GetFrameCount() const { return m_FrameCount; }
+
+    uint64_t GetSampleCount() const { return m_SampleCount; }
+
+private:
+    ValueHistory m_FrameTimes;
+    ValueHistory m_RenderTimes;
+    ValueHistory m_SampleRates;
+    ValueHistory m_ActiveTileCounts;
+    uint64_t     m_FrameCount = 0;
+    uint64_t     m_SampleCount = 0;
+};
@@ -0,0 +1,317 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "AutoExposure.h"
+#include "BlueNoise.h"
+#include "Denoiser.h"
+#include "EnvironmentMap.h"
+#include "MajorantGrid.h"
+#include "Profiler.h"
+#include "RenderBackend.h"
+#include "RenderCommon.h"
+#include "ThreadPool.h"
+#include "TileScheduler.h"
+#include "TransferFunction.h"
+#include "VolumeData.h"
+#include "VolumeMarcher.h"
+
+#include <chrono>
+
+// Portable reference implementation of the GPU path tracer, the passes of RendererD3D11::RenderFrame over the
+// selected tiles on a thread pool
+class RendererCPU final : public RenderBackend, Hawk::NonCopyable {
+public:
+    static constexpr uint32_t TileSize = 16;
+
+    // Pixels that go through a stage before the next one starts: one tile, a wave of WaveSize, or one pixel
+    enum Schedule : uint32_t {
+        ScheduleTile,
+        ScheduleWavefront,
+        SchedulePixel
+    };
+
+    static constexpr uint32_t WaveSize = 1 << 16;
+    static constexpr uint32_t WaveChunkSize = TileSize * TileSize;
+
+    // A pixel keeps its history when the new sample scatters within the depth tolerance of the pixel it came
+    // from, and where that pixel's normals agree, within acos(ReprojectionNormalTolerance) of them
+    static constexpr F32 ReprojectionDepthTolerance = 0.01f;
+    static constexpr F32 ReprojectionDepthDeviations = 2.0f;
+    static constexpr F32 ReprojectionNormalTolerance = 0.9f;
+
+    // Utilization is the busy time of the threads over the time they spent in the tile loop, SlowestTileTime and
+    // StealCount cover the tile schedules only
+    struct FrameStatistics {
+        uint32_t TileCount = 0;
+        uint64_t SampleCount = 0;
+        F64      FrameTime = 0.0;
+        F64      SlowestTileTime = 0.0;
+        F64      Utilization = 0.0;
+        uint64_t StealCount = 0;
+        F64      DenoiseTime = 0.0;
+        F64      ExposureTime = 0.0;
+        bool     IsCancelled = false;
+    };
+
+    RendererCPU(ThreadPool& threadPool);
+
+    void Resize(uint32_t width, uint32_t height) override;
+
+    void SetVolume(VolumeData const* pVolume) override { m_pVolume = pVolume; }
+
+    void SetEnvironmentMap(EnvironmentMap const* pEnvironmentMap) override { m_pEnvironmentMap = pEnvironmentMap; }
+
+    // Mask of the rank-1 sample sequence, frames give its size in FrameBuffer::BlueNoiseSize
+    void SetBlueNoise(BlueNoise const* pBlueNoise) override { m_pBlueNoise = pBlueNoise; }
+
+    // Required for TrackingModeDelta and ratio tracking frames, built for the same mip levels and opacity table
+    void SetMajorantGrid(MajorantGrid const* pMajorantGrid) override { m_pMajorantGrid = pMajorantGrid; }
+
+    void SetTransferFunctions(TransferFunctionSet const& functions, uint32_t samplingCount) override;
+
+    void SetSampleDispersion(uint32_t sampleDispersion) override { m_SampleDispersion = sampleDispersion; }
+
+    void SetPacketMarching(bool isEnabled) { m_IsPacketMarching = isEnabled; }
+
+    void SetSchedule(Schedule schedule) { m_Schedule = schedule; }
+
+    // Tile schedules hand out the tiles through the TileScheduler, ordered by their cost in the previous frame,
+    // instead of in screen order from a shared counter
+    void SetWorkStealing(bool isEnabled) { m_IsWorkStealing = isEnabled; }
+
+    // Stops the frame in flight from another thread, RenderFrame clears it on entry. The tiles that have not started
+    // are skipped, so the accumulated image is left incomplete and the next frame should restart from FrameIndex 0.
+    void Cancel() { m_TileScheduler.Cancel(); }
+
+    // Frames with FrameIndex 0 reproject the accumulated image of the previous frame instead of clearing it.
+    // Only the camera may change in between, InvalidateHistory has to be called after any other change.
+    void SetReprojection(bool isEnabled) { m_IsReprojection = isEnabled; }
+
+    // Reprojected pixels continue as if they had at most this many samples, so the error of the warp fades out
+    void SetHistoryCountMax(uint32_t countMax) { m_HistoryCountMax = countMax; }
+
+    void InvalidateHistory() { m_IsHistoryValid = false; }
+
+    // The accumulation itself is not filtered, only the image that is tone mapped
+    void SetDenoising(bool isEnabled) { m_IsDenoising = isEnabled; }
+
+    void SetDenoiserDesc(Denoiser::Desc const& desc) { m_Denoiser.SetDesc(desc); }
+
+    // The stages of the frames are reported as scopes of the calling thread, nothing is reported without one
+    void SetProfiler(Profiler* pProfiler) { m_pProfiler = pProfiler; }
+
+    void SetAutoExposure(bool isEnabled) override { m_IsAutoExposure = isEnabled; }
+
+    void SetAutoExposureDesc(AutoExposure::Desc const& desc) override { m_AutoExposure.SetDesc(desc); }
+
+    F32 GetExposure() const override { return m_Exposure; }
+
+    AutoExposure const& GetAutoExposure() const override { return m_AutoExposure; }
+
+    void RenderFrame(FrameBuffer const& frame) override;
+
+    void ToneMapImage(FrameBuffer const& frame) override;
+
+    // Frames are done when RenderFrame returns, nothing is read late
+    uint32_t ReadActiveTileCount() override { return m_ActiveTileCount; }
+
+    uint32_t GetActiveTilePassCount() const override { return m_ActiveTilePassCount; }
+
+    uint32_t GetTileSize() const override { return TileSize; }
+
+    bool ReadFrameTime(F32& frameTime, Hawk::Math::Vec2u& renderDimension) override;
+
+    void ReadColorSum(std::vector<Hawk::Math::Vec4>& colorSum) override { colorSum = m_ColorSum; }
+
+    uint32_t GetWidth() const { return m_Width; }
+
+    uint32_t GetHeight() const { return m_Height; }
+
+    // Running mean of the radiance, w holds the number of samples of the pixel
+    std::vector<Hawk::Math::Vec4> const& GetColorSum() const { return m_ColorSum; }
+
+    // Running mean of the squared luminance, for the variance estimate of the tile selection
+    std::vector<F32> const& GetColorMoment() const { return m_ColorMoment; }
+
+    std::vector<Hawk::Math::Vec4> const& GetToneMap() const { return m_ToneMap; }
+
+    // Output of the Denoiser for denoised frames, w holds the number of samples of the pixel
+    std::vector<Hawk::Math::Vec4> const& GetDenoised() const { return m_Denoised; }
+
+    std::vector<F32> const& GetDepth() const { return m_Depth; }
+
+    std::vector<uint32_t> const& GetTiles() const { return m_Tiles; }
+
+    // Passes of every selected tile in the frame, after the budget of Shading::ApplyTilePassBudget
+    std::vector<uint32_t> const& GetTilePasses() const { return m_TilePasses; }
+
+    FrameStatistics const& GetFrameStatistics() const { return m_FrameStatistics; }
+
+private:
+    // 1D texture with linear filtering and border addressing, as sampled by SamplerLinear
+    template<typename T>
+    struct LookupTable1D {
+        T Sample(F32 u) const {
+
+            const auto count = static_cast<int32_t>(std::size(Texels));
+            const auto x = u * count - 0.5f;
+            const auto x0 = static_cast<int32_t>(std::floor(x));
+            const auto t = x - x0;
+
+            const T v0 = (x0 >= 0 && x0 < count) ? Texels[x0] : T{};
+            const T v1 = (x0 + 1 >= 0 && x0 + 1 < count) ? Texels[x0 + 1] : T{};
+            return v0 + t * (v1 - v0);
+        }
+
+        std::vector<T> Texels;
+    };
+
+    // Running means over the samples of a pixel of the world normal, NDC depth and squared depth of the first
+    // scattering event, the samples that leave the volume add zeros and no coverage
+    struct SurfaceSum {
+        Hawk::Math::Vec3 Normal = Hawk::Math::Vec3(0.0f, 0.0f, 0.0f);
+        F32              Depth = 0.0f;
+        F32              DepthMoment = 0.0f;
+        F32              Coverage = 0.0f;
+    };
+
+    // Primary ray i owns the shadow queue slots [2 * i, 2 * i + 2), the shadow rays generated for a range of
+    // primary rays are compacted to the front of the slots of that range
+    struct RayQueues {
+        RayStream                     Primary;
+        RayStream                     Shadow;
+        std::vector<uint32_t>         PrimaryPixels;
+        std::vector<uint32_t>         ShadowPixels;
+        std::vector<Hawk::Math::Vec3> Throughput;
+        std::vector<size_t>           ShadowCount;
+    };
+
+    void ComputeTiles(FrameBuffer const& frame);
+
+    void RenderWave(FrameBuffer const& frame, VolumeMarcher const& marcherPrimary, VolumeMarcher const& marcherSecondary, RayQueues& queues, size_t first, size_t count, bool isPacketMarching);
+
+    void RenderWavefront(FrameBuffer const& frame, VolumeMarcher const& marcherPrimary, VolumeMarcher const& marcherSecondary);
+
+    void AppendTilePixels(std::vector<uint32_t>& pixels, uint32_t tile) const;
+
+    void ResizeQueues(RayQueues& queues) const;
+
+    void GenerateRays(FrameBuffer const& frame, RayQueues& queues, size_t first, size_t count);
+
+    void EvaluateScattering(FrameBuffer const& frame, RayQueues& queues, size_t first, size_t count);
+
+    size_t GenerateShadowRays(FrameBuffer const& frame, RayQueues& queues, size_t first, size_t count);
+
+    void TraceShadowRays(FrameBuffer const& frame, VolumeMarcher const& marcher, RayQueues& queues, size_t first, size_t count, bool isPacketMarching) const;
+
+    void ResolveShadowRays(FrameBuffer const& frame, RayQueues& queues, size_t first, size_t count);
+
+    void AccumulatePixels(FrameBuffer const& frame, RayQueues& queues, size_t first, size_t count);
+
+    void Accumulate(FrameBuffer const& frame, Hawk::Math::Vec2u const& id);
+
+    bool ReprojectHistory(FrameBuffer const& frame, Hawk::Math::Vec2u const& id, Hawk::Math::Vec4& colorSum, F32& colorMoment, SurfaceSum& surfaceSum) const;
+
+    void Denoise(FrameBuffer const& frame);
+
+    void UpdateExposure(FrameBuffer const& frame);
+
+    void ToneMap(FrameBuffer const& frame, Hawk::Math::Vec2u const& id);
+
+    void March(FrameBuffer const& frame, VolumeMarcher const& marcher, RayStream& stream, size_t first, size_t count, bool isPacketMarching) const;
+
+    size_t PixelIndex(Hawk::Math::Vec2u const& id) const { return size_t(id.y) * m_Width + id.x; }
+
+    // Every pixel walks its own sequence, so the extra passes of a tile take the next samples of its pixels
+    uint32_t SampleIndex(FrameBuffer const& frame, Hawk::Math::Vec2u const& id) const { return frame.FrameIndex == 0 ? 0 : static_cast<uint32_t>(m_ColorSum[PixelIndex(id)].w); }
+
+    size_t TileIndex(uint32_t tile) const { return size_t((tile >> 16) & 0xFFFF) * ((m_Width + TileSize - 1) / TileSize) + (tile & 0xFFFF); }
+
+private:
+    ThreadPool&           m_ThreadPool;
+    VolumeData const*     m_pVolume = nullptr;
+    EnvironmentMap const* m_pEnvironmentMap = nullptr;
+    BlueNoise const*      m_pBlueNoise = nullptr;
+    MajorantGrid const*   m_pMajorantGrid = nullptr;
+    Profiler*             m_pProfiler = nullptr;
+
+    LookupTable1D<Hawk::Math::Vec3> m_DiffuseTF;
+    LookupTable1D<Hawk::Math::Vec3> m_SpecularTF;
+    LookupTable1D<F32>              m_RoughnessTF;
+    LookupTable1D<F32>              m_OpacityTF;
+
+    std::vector<Hawk::Math::Vec3> m_Diffuse;
+    std::vector<Hawk::Math::Vec3> m_Specular;
+    std::vector<Hawk::Math::Vec4> m_Normal;
+    std::vector<F32>              m_Depth;
+    std::vector<Hawk::Math::Vec3> m_Radiance;
+    std::vector<Hawk::Math::Vec4> m_ColorSum;
+    std::vector<F32>              m_ColorMoment;
+    std::vector<Hawk::Math::Vec4> m_ToneMap;
+    std::vector<Hawk::Math::Vec4> m_Denoised;
+    std::vector<uint32_t>         m_Tiles;
+    std::vector<uint32_t>         m_TilePasses;
+
+    std::vector<SurfaceSum>       m_Surface;
+    std::vector<Hawk::Math::Vec4> m_HistoryColorSum;
+    std::vector<F32>              m_HistoryColorMoment;
+    std::vector<SurfaceSum>       m_HistorySurface;
+    Hawk::Math::Mat4x4            m_HistoryWorldViewProjection = Hawk::Math::Mat4x4(1.0f);
+
+    std::vector<RayQueues> m_RayQueues;
+    TileScheduler          m_TileScheduler;
+    Denoiser               m_Denoiser;
+    AutoExposure           m_AutoExposure;
+    std::vector<F32>       m_TileCosts;
+    std::vector<uint32_t>  m_TileSampleCounts;
+    std::vector<F32>       m_SelectedTileCosts;
+    std::vector<F64>       m_ThreadBusyTime;
+    std::vector<F64>       m_ThreadSlowestTile;
+    RayQueues              m_WavefrontQueues;
+    std::vector<uint32_t>  m_WavefrontPixels;
+
+    FrameStatistics m_FrameStatistics = {};
+
+    std::chrono::high_resolution_clock::time_point m_ExposureUpdateTime = {};
+
+    uint32_t m_Width = 0;
+    uint32_t m_Height = 0;
+    uint32_t m_SampleDispersion = 8;
+    uint32_t m_HistoryCountMax = 32;
+    uint32_t m_ActiveTileCount = std::numeric_limits<uint32_t>::max();
+    uint32_t m_ActiveTilePassCount = std::numeric_limits<uint32_t>::max();
+    F32      m_Exposure = 1.0f;
+    F32      m_ExposureToneMapped = 1.0f;
+    Schedule m_Schedule = ScheduleTile;
+    bool     m_IsPacketMarching = true;
+    bool     m_IsWorkStealing = true;
+    bool     m_IsReprojection = false;
+    bool     m_IsHistoryValid = false;
+    bool     m_IsReprojectionFrame = false;
+    bool     m_IsDenoising = false;
+    bool     m_IsAutoExposure = false;
+    bool     m_IsFrameTimeRead = true;
+};
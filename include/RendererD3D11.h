@@ -0,0 +1,205 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "Common.h"
+#include "ProfilerD3D11.h"
+#include "RenderBackend.h"
+
+// The path tracer on D3D11 compute shaders, the selected 8x8 tiles are rendered with indirect dispatches.
+// The tile counters, histograms and timestamps are read back a few frames late without stalling.
+class RendererD3D11 final : public RenderBackend {
+public:
+    static constexpr uint32_t FrameCount = 3;
+
+    RendererD3D11(DX::ComPtr<ID3D11Device> pDevice, DX::ComPtr<ID3D11DeviceContext> pImmediateContext, ProfilerD3D11& profiler, ThreadPool& threadPool);
+
+    void Resize(uint32_t width, uint32_t height) override;
+
+    void SetVolume(VolumeData const* pVolume) override;
+
+    void SetEnvironmentMap(EnvironmentMap const* pEnvironmentMap) override;
+
+    void SetBlueNoise(BlueNoise const* pBlueNoise) override;
+
+    void SetMajorantGrid(MajorantGrid const* pMajorantGrid) override;
+
+    void SetTransferFunctions(TransferFunctionSet const& functions, uint32_t samplingCount) override;
+
+    void SetSampleDispersion(uint32_t sampleDispersion) override { m_SampleDispersion = sampleDispersion; }
+
+    void SetAutoExposure(bool isEnabled) override { m_IsAutoExposure = isEnabled; }
+
+    void SetAutoExposureDesc(AutoExposure::Desc const& desc) override { m_AutoExposure.SetDesc(desc); }
+
+    F32 GetExposure() const override { return m_Exposure; }
+
+    AutoExposure const& GetAutoExposure() const override { return m_AutoExposure; }
+
+    void RenderFrame(FrameBuffer const& frame) override;
+
+    void ToneMapImage(FrameBuffer const& frame) override;
+
+    uint32_t ReadActiveTileCount() override;
+
+    uint32_t GetActiveTilePassCount() const override { return m_ActiveTilePassCount; }
+
+    // The thread groups of the compute passes
+    uint32_t GetTileSize() const override { return 8; }
+
+    bool ReadFrameTime(F32& frameTime, Hawk::Math::Vec2u& renderDimension) override;
+
+    void ReadColorSum(std::vector<Hawk::Math::Vec4>& colorSum) override;
+
+    void ReloadShaders();
+
+    // Outlines the tiles selected in the last frame over the RenderTargetDim corner of the render target
+    void DrawTiles(DX::ComPtr<ID3D11RenderTargetView> pRTV, uint32_t width, uint32_t height);
+
+    // R8G8B8A8_UNORM, the image is in the RenderTargetDim corner of it
+    DX::ComPtr<ID3D11ShaderResourceView> GetToneMap() const { return m_pSRVToneMap; }
+
+private:
+    void InitializeSamplerStates();
+
+    void InitializeBuffers();
+
+    void InitializeRenderTextures();
+
+    void InitializeTileBuffer();
+
+    void InitializeTimestampQueries();
+
+    void UpdateExposure();
+
+private:
+    using D3D11ArrayUnorderedAccessView = std::vector<DX::ComPtr<ID3D11UnorderedAccessView>>;
+    using D3D11ArrayShadeResourceView = std::vector<DX::ComPtr<ID3D11ShaderResourceView>>;
+
+    DX::ComPtr<ID3D11Device>              m_pDevice;
+    DX::ComPtr<ID3D11DeviceContext>       m_pImmediateContext;
+    ProfilerD3D11&                        m_Profiler;
+
+    D3D11ArrayShadeResourceView   m_pSRVVolumeIntensity;
+    D3D11ArrayUnorderedAccessView m_pUAVVolumeIntensity;
+    DX::ComPtr<ID3D11ShaderResourceView> m_pSRVVolumeIntensityMips;
+
+    DX::ComPtr<ID3D11ShaderResourceView>  m_pSRVGradient;
+    DX::ComPtr<ID3D11UnorderedAccessView> m_pUAVGradient;
+
+    DX::ComPtr<ID3D11ShaderResourceView> m_pSRVDiffuseTF;
+    DX::ComPtr<ID3D11ShaderResourceView> m_pSRVSpecularTF;
+    DX::ComPtr<ID3D11ShaderResourceView> m_pSRVRoughnessTF;
+    DX::ComPtr<ID3D11ShaderResourceView> m_pSRVOpacityTF;
+    DX::ComPtr<ID3D11ShaderResourceView> m_pSRVEnvironment;
+    DX::ComPtr<ID3D11ShaderResourceView> m_pSRVMajorant;
+    DX::ComPtr<ID3D11ShaderResourceView> m_pSRVControl;
+    DX::ComPtr<ID3D11ShaderResourceView> m_pSRVEnvironmentAlias;
+    DX::ComPtr<ID3D11ShaderResourceView> m_pSRVBlueNoise;
+
+    DX::ComPtr<ID3D11ShaderResourceView>  m_pSRVRadiance;
+    DX::ComPtr<ID3D11UnorderedAccessView> m_pUAVRadiance;
+
+    DX::ComPtr<ID3D11ShaderResourceView>  m_pSRVDiffuse;
+    DX::ComPtr<ID3D11ShaderResourceView>  m_pSRVSpecular;
+    DX::ComPtr<ID3D11ShaderResourceView>  m_pSRVNormal;
+    DX::ComPtr<ID3D11ShaderResourceView>  m_pSRVDepth;
+    DX::ComPtr<ID3D11ShaderResourceView>  m_pSRVColorSum;
+    DX::ComPtr<ID3D11ShaderResourceView>  m_pSRVColorMoment;
+
+    DX::ComPtr<ID3D11UnorderedAccessView> m_pUAVDiffuse;
+    DX::ComPtr<ID3D11UnorderedAccessView> m_pUAVSpecular;
+    DX::ComPtr<ID3D11UnorderedAccessView> m_pUAVNormal;
+    DX::ComPtr<ID3D11UnorderedAccessView> m_pUAVDepth;
+    DX::ComPtr<ID3D11UnorderedAccessView> m_pUAVColorSum;
+    DX::ComPtr<ID3D11UnorderedAccessView> m_pUAVColorMoment;
+
+    DX::ComPtr<ID3D11ShaderResourceView>  m_pSRVToneMap;
+    DX::ComPtr<ID3D11UnorderedAccessView> m_pUAVToneMap;
+
+    DX::ComPtr<ID3D11ShaderResourceView>  m_pSRVDispersionTiles;
+    DX::ComPtr<ID3D11UnorderedAccessView> m_pUAVDispersionTiles;
+
+    DX::ComPtr<ID3D11Buffer>              m_pBufferTilePasses;
+    DX::ComPtr<ID3D11ShaderResourceView>  m_pSRVTilePasses;
+    DX::ComPtr<ID3D11UnorderedAccessView> m_pUAVTilePasses;
+
+    DX::ComPtr<ID3D11Buffer>              m_pHistogram;
+    DX::ComPtr<ID3D11UnorderedAccessView> m_pUAVHistogram;
+    DX::ComPtr<ID3D11UnorderedAccessView> m_pUAVTileHistograms;
+
+    DX::GraphicsPSO m_PSODefault = {};
+    DX::GraphicsPSO m_PSODegugTiles = {};
+
+    DX::ComputePSO m_PSOGeneratePrimaryRays = {};
+    DX::ComputePSO m_PSOComputeDiffuseLight = {};
+
+    DX::ComputePSO  m_PSOAccumulate = {};
+    DX::ComputePSO  m_PSOComputeTiles = {};
+    DX::ComputePSO  m_PSOResetTiles = {};
+    DX::ComputePSO  m_PSOToneMap = {};
+    DX::ComputePSO  m_PSOToneMapImage = {};
+    DX::ComputePSO  m_PSOComputeHistogram = {};
+    DX::ComputePSO  m_PSOGenerateMipLevel = {};
+    DX::ComputePSO  m_PSOComputeGradient = {};
+
+    DX::ComPtr<ID3D11SamplerState>  m_pSamplerPoint;
+    DX::ComPtr<ID3D11SamplerState>  m_pSamplerLinear;
+    DX::ComPtr<ID3D11SamplerState>  m_pSamplerAnisotropic;
+
+    DX::ComPtr<ID3D11Buffer> m_pConstantBufferFrame;
+    DX::ComPtr<ID3D11Buffer> m_pDispatchIndirectBufferArgs;
+    DX::ComPtr<ID3D11Buffer> m_pDrawInstancedIndirectBufferArgs;
+
+    std::array<DX::ComPtr<ID3D11Buffer>, FrameCount> m_pTileCounterReadback;
+    std::array<uint32_t, FrameCount>                 m_TileCounterFrames = {};
+    std::array<uint32_t, FrameCount>                 m_TileCounterTileCounts = {};
+    uint32_t                                         m_TileCounterIndex = 0;
+
+    std::array<DX::ComPtr<ID3D11Buffer>, FrameCount> m_pHistogramReadback;
+    std::array<uint32_t, FrameCount>                 m_HistogramFrames = {};
+    uint32_t                                         m_HistogramIndex = 0;
+
+    // The dimension a frame was rendered at is kept with its queries, zero once they have been read
+    std::array<DX::ComPtr<ID3D11Query>, FrameCount> m_pQueryDisjoint;
+    std::array<DX::ComPtr<ID3D11Query>, FrameCount> m_pQueryFrameBegin;
+    std::array<DX::ComPtr<ID3D11Query>, FrameCount> m_pQueryFrameEnd;
+    std::array<Hawk::Math::Vec2u, FrameCount>       m_TimestampDimensions = {};
+    uint32_t                                        m_TimestampIndex = 0;
+
+    VolumeData const* m_pVolume = nullptr;
+    AutoExposure      m_AutoExposure;
+
+    std::chrono::high_resolution_clock::time_point m_ExposureUpdateTime = {};
+
+    uint32_t m_Width = 0;
+    uint32_t m_Height = 0;
+    uint32_t m_SampleDispersion = 8;
+    uint32_t m_ActiveTileCount = std::numeric_limits<uint32_t>::max();
+    uint32_t m_ActiveTilePassCount = std::numeric_limits<uint32_t>::max();
+    F32      m_Exposure = 1.0f;
+    F32      m_ExposureToneMapped = 0.0f;
+    bool     m_IsAutoExposure = false;
+};
@@ -0,0 +1,60 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <Hawk/Common/Defines.hpp>
+#include <Hawk/Math/Functions.hpp>
+
+// PI controller of the render resolution scale on the measured frame time, which is taken to grow with the
+// pixel count. The scale moves in steps of ScaleStep.
+class ResolutionController final {
+public:
+    static constexpr F32 ScaleMin = 0.25f;
+    static constexpr F32 ScaleMax = 1.0f;
+    static constexpr F32 ScaleStep = 1.0f / 16.0f;
+
+    struct Desc {
+        F32 FrameTimeTarget = 1.0f / 60.0f;
+        F32 GainProportional = 0.1f;
+        F32 GainIntegral = 0.15f;
+    };
+
+    void SetDesc(Desc const& desc) { m_Desc = desc; }
+
+    void Reset();
+
+    // Frame time in seconds of a frame rendered at frameScale, returns true when the scale changed
+    bool Update(F32 frameTime, F32 frameScale);
+
+    F32 GetScale() const { return m_Scale; }
+
+    static Hawk::Math::Vec2u GetRenderDimension(uint32_t width, uint32_t height, F32 scale);
+
+private:
+    Desc m_Desc = {};
+    F32  m_LogScale = 0.0f;
+    F32  m_Error = 0.0f;
+    F32  m_Scale = 1.0f;
+};
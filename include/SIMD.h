@@ -0,0 +1,209 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <Hawk/Common/Defines.hpp>
+
+#include <cstring>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#else
+    #include <emmintrin.h>
+#endif
+
+// Eight float lanes, as one AVX2 register or a pair of SSE2 registers
+namespace SIMD {
+    constexpr uint32_t LaneCount = 8;
+
+#if defined(__AVX2__)
+    // Wrapped so the operators below don't collide with the compiler's built-in vector arithmetic
+    struct VFloat { __m256 V; };
+    struct VInt { __m256i V; };
+
+    inline VFloat LoadF(F32 const* p) { return { _mm256_load_ps(p) }; }
+    inline void   StoreF(F32* p, VFloat a) { _mm256_store_ps(p, a.V); }
+    inline VFloat LoadUnalignedF(F32 const* p) { return { _mm256_loadu_ps(p) }; }
+    inline void   StoreUnalignedF(F32* p, VFloat a) { _mm256_storeu_ps(p, a.V); }
+    inline VInt   LoadI(int32_t const* p) { return { _mm256_load_si256(reinterpret_cast<__m256i const*>(p)) }; }
+    inline void   StoreI(int32_t* p, VInt a) { _mm256_store_si256(reinterpret_cast<__m256i*>(p), a.V); }
+    inline VFloat SetF(F32 v) { return { _mm256_set1_ps(v) }; }
+    inline VInt   SetI(int32_t v) { return { _mm256_set1_epi32(v) }; }
+
+    inline VFloat operator+(VFloat a, VFloat b) { return { _mm256_add_ps(a.V, b.V) }; }
+    inline VFloat operator-(VFloat a, VFloat b) { return { _mm256_sub_ps(a.V, b.V) }; }
+    inline VFloat operator*(VFloat a, VFloat b) { return { _mm256_mul_ps(a.V, b.V) }; }
+    inline VFloat operator/(VFloat a, VFloat b) { return { _mm256_div_ps(a.V, b.V) }; }
+
+    // Operand order reproduces std::min / std::max for NaN and signed zeros
+    inline VFloat Min(VFloat a, VFloat b) { return { _mm256_min_ps(b.V, a.V) }; }
+    inline VFloat Max(VFloat a, VFloat b) { return { _mm256_max_ps(b.V, a.V) }; }
+    inline VFloat Floor(VFloat a) { return { _mm256_floor_ps(a.V) }; }
+    inline VFloat Sqrt(VFloat a) { return { _mm256_sqrt_ps(a.V) }; }
+
+    inline VFloat Less(VFloat a, VFloat b) { return { _mm256_cmp_ps(a.V, b.V, _CMP_LT_OQ) }; }
+    inline VFloat NotLess(VFloat a, VFloat b) { return { _mm256_cmp_ps(a.V, b.V, _CMP_NLT_UQ) }; }
+    inline VFloat GreaterEqual(VFloat a, VFloat b) { return { _mm256_cmp_ps(a.V, b.V, _CMP_GE_OQ) }; }
+    inline VFloat And(VFloat a, VFloat b) { return { _mm256_and_ps(a.V, b.V) }; }
+    inline VFloat AndNot(VFloat mask, VFloat a) { return { _mm256_andnot_ps(mask.V, a.V) }; }
+    inline VFloat Or(VFloat a, VFloat b) { return { _mm256_or_ps(a.V, b.V) }; }
+    inline VFloat Select(VFloat mask, VFloat a, VFloat b) { return { _mm256_blendv_ps(b.V, a.V, mask.V) }; }
+    inline uint32_t MoveMask(VFloat mask) { return static_cast<uint32_t>(_mm256_movemask_ps(mask.V)); }
+
+    inline VInt   ToInt(VFloat a) { return { _mm256_cvttps_epi32(a.V) }; }
+    inline VFloat ToFloat(VInt a) { return { _mm256_cvtepi32_ps(a.V) }; }
+    inline VFloat AsFloat(VInt a) { return { _mm256_castsi256_ps(a.V) }; }
+    inline VInt   AsInt(VFloat a) { return { _mm256_castps_si256(a.V) }; }
+
+    inline VInt operator+(VInt a, VInt b) { return { _mm256_add_epi32(a.V, b.V) }; }
+    inline VInt operator*(VInt a, VInt b) { return { _mm256_mullo_epi32(a.V, b.V) }; }
+    inline VInt operator&(VInt a, VInt b) { return { _mm256_and_si256(a.V, b.V) }; }
+    inline VInt ShiftRight16(VInt a) { return { _mm256_srli_epi32(a.V, 16) }; }
+    inline VInt ShiftLeft23(VInt a) { return { _mm256_slli_epi32(a.V, 23) }; }
+    inline VInt Greater(VInt a, VInt b) { return { _mm256_cmpgt_epi32(a.V, b.V) }; }
+    inline VInt AndNot(VInt mask, VInt a) { return { _mm256_andnot_si256(mask.V, a.V) }; }
+    inline VInt Select(VInt mask, VInt a, VInt b) { return { _mm256_blendv_epi8(b.V, a.V, mask.V) }; }
+
+    // 32-bit gather of two neighbouring 16-bit texels, masked lanes return zero
+    inline VInt GatherPair(uint16_t const* pBase, VInt index, VInt mask) {
+
+        return { _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), reinterpret_cast<int const*>(pBase), index.V, mask.V, 2) };
+    }
+
+    inline VFloat Gather(F32 const* pBase, VInt index, VInt mask) {
+
+        return { _mm256_mask_i32gather_ps(_mm256_setzero_ps(), pBase, index.V, _mm256_castsi256_ps(mask.V), 4) };
+    }
+#else
+    struct VFloat { __m128 Lo, Hi; };
+    struct VInt { __m128i Lo, Hi; };
+
+    inline VFloat LoadF(F32 const* p) { return { _mm_load_ps(p), _mm_load_ps(p + 4) }; }
+    inline void   StoreF(F32* p, VFloat a) { _mm_store_ps(p, a.Lo); _mm_store_ps(p + 4, a.Hi); }
+    inline VFloat LoadUnalignedF(F32 const* p) { return { _mm_loadu_ps(p), _mm_loadu_ps(p + 4) }; }
+    inline void   StoreUnalignedF(F32* p, VFloat a) { _mm_storeu_ps(p, a.Lo); _mm_storeu_ps(p + 4, a.Hi); }
+    inline VInt   LoadI(int32_t const* p) { return { _mm_load_si128(reinterpret_cast<__m128i const*>(p)), _mm_load_si128(reinterpret_cast<__m128i const*>(p + 4)) }; }
+    inline void   StoreI(int32_t* p, VInt a) { _mm_store_si128(reinterpret_cast<__m128i*>(p), a.Lo); _mm_store_si128(reinterpret_cast<__m128i*>(p + 4), a.Hi); }
+    inline VFloat SetF(F32 v) { return { _mm_set1_ps(v), _mm_set1_ps(v) }; }
+    inline VInt   SetI(int32_t v) { return { _mm_set1_epi32(v), _mm_set1_epi32(v) }; }
+
+    inline VFloat operator+(VFloat a, VFloat b) { return { _mm_add_ps(a.Lo, b.Lo), _mm_add_ps(a.Hi, b.Hi) }; }
+    inline VFloat operator-(VFloat a, VFloat b) { return { _mm_sub_ps(a.Lo, b.Lo), _mm_sub_ps(a.Hi, b.Hi) }; }
+    inline VFloat operator*(VFloat a, VFloat b) { return { _mm_mul_ps(a.Lo, b.Lo), _mm_mul_ps(a.Hi, b.Hi) }; }
+    inline VFloat operator/(VFloat a, VFloat b) { return { _mm_div_ps(a.Lo, b.Lo), _mm_div_ps(a.Hi, b.Hi) }; }
+
+    inline VFloat Min(VFloat a, VFloat b) { return { _mm_min_ps(b.Lo, a.Lo), _mm_min_ps(b.Hi, a.Hi) }; }
+    inline VFloat Max(VFloat a, VFloat b) { return { _mm_max_ps(b.Lo, a.Lo), _mm_max_ps(b.Hi, a.Hi) }; }
+    inline VFloat Sqrt(VFloat a) { return { _mm_sqrt_ps(a.Lo), _mm_sqrt_ps(a.Hi) }; }
+
+    inline VFloat Less(VFloat a, VFloat b) { return { _mm_cmplt_ps(a.Lo, b.Lo), _mm_cmplt_ps(a.Hi, b.Hi) }; }
+    inline VFloat NotLess(VFloat a, VFloat b) { return { _mm_cmpnlt_ps(a.Lo, b.Lo), _mm_cmpnlt_ps(a.Hi, b.Hi) }; }
+    inline VFloat GreaterEqual(VFloat a, VFloat b) { return { _mm_cmpge_ps(a.Lo, b.Lo), _mm_cmpge_ps(a.Hi, b.Hi) }; }
+    inline VFloat And(VFloat a, VFloat b) { return { _mm_and_ps(a.Lo, b.Lo), _mm_and_ps(a.Hi, b.Hi) }; }
+    inline VFloat AndNot(VFloat mask, VFloat a) { return { _mm_andnot_ps(mask.Lo, a.Lo), _mm_andnot_ps(mask.Hi, a.Hi) }; }
+    inline VFloat Or(VFloat a, VFloat b) { return { _mm_or_ps(a.Lo, b.Lo), _mm_or_ps(a.Hi, b.Hi) }; }
+    inline VFloat Select(VFloat mask, VFloat a, VFloat b) { return Or(And(mask, a), AndNot(mask, b)); }
+    inline uint32_t MoveMask(VFloat mask) { return static_cast<uint32_t>(_mm_movemask_ps(mask.Lo) | (_mm_movemask_ps(mask.Hi) << 4)); }
+
+    inline VInt   ToInt(VFloat a) { return { _mm_cvttps_epi32(a.Lo), _mm_cvttps_epi32(a.Hi) }; }
+    inline VFloat ToFloat(VInt a) { return { _mm_cvtepi32_ps(a.Lo), _mm_cvtepi32_ps(a.Hi) }; }
+    inline VFloat AsFloat(VInt a) { return { _mm_castsi128_ps(a.Lo), _mm_castsi128_ps(a.Hi) }; }
+    inline VInt   AsInt(VFloat a) { return { _mm_castps_si128(a.Lo), _mm_castps_si128(a.Hi) }; }
+
+    // Truncation rounds towards zero, step down where it rounded up
+    inline VFloat Floor(VFloat a) {
+
+        const VFloat t = ToFloat(ToInt(a));
+        return t - And(Less(a, t), SetF(1.0f));
+    }
+
+    // SSE2 has no 32-bit mullo, multiply even and odd lanes separately
+    inline __m128i MulLo(__m128i a, __m128i b) {
+
+        const __m128i even = _mm_mul_epu32(a, b);
+        const __m128i odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+        return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+    }
+
+    inline VInt operator+(VInt a, VInt b) { return { _mm_add_epi32(a.Lo, b.Lo), _mm_add_epi32(a.Hi, b.Hi) }; }
+    inline VInt operator*(VInt a, VInt b) { return { MulLo(a.Lo, b.Lo), MulLo(a.Hi, b.Hi) }; }
+    inline VInt operator&(VInt a, VInt b) { return { _mm_and_si128(a.Lo, b.Lo), _mm_and_si128(a.Hi, b.Hi) }; }
+    inline VInt ShiftRight16(VInt a) { return { _mm_srli_epi32(a.Lo, 16), _mm_srli_epi32(a.Hi, 16) }; }
+    inline VInt ShiftLeft23(VInt a) { return { _mm_slli_epi32(a.Lo, 23), _mm_slli_epi32(a.Hi, 23) }; }
+    inline VInt Greater(VInt a, VInt b) { return { _mm_cmpgt_epi32(a.Lo, b.Lo), _mm_cmpgt_epi32(a.Hi, b.Hi) }; }
+    inline VInt AndNot(VInt mask, VInt a) { return { _mm_andnot_si128(mask.Lo, a.Lo), _mm_andnot_si128(mask.Hi, a.Hi) }; }
+    inline VInt Select(VInt mask, VInt a, VInt b) { return { _mm_or_si128(_mm_and_si128(mask.Lo, a.Lo), _mm_andnot_si128(mask.Lo, b.Lo)), _mm_or_si128(_mm_and_si128(mask.Hi, a.Hi), _mm_andnot_si128(mask.Hi, b.Hi)) }; }
+
+    // No gather instructions before AVX2, emulate them lane by lane
+    inline VInt GatherPair(uint16_t const* pBase, VInt index, VInt mask) {
+
+        alignas(32) int32_t indices[LaneCount];
+        alignas(32) int32_t masks[LaneCount];
+        alignas(32) int32_t values[LaneCount];
+        StoreI(indices, index);
+        StoreI(masks, mask);
+        for (uint32_t lane = 0; lane < LaneCount; lane++) {
+            values[lane] = 0;
+            if (masks[lane])
+                std::memcpy(&values[lane], pBase + indices[lane], sizeof(int32_t));
+        }
+        return LoadI(values);
+    }
+
+    inline VFloat Gather(F32 const* pBase, VInt index, VInt mask) {
+
+        alignas(32) int32_t indices[LaneCount];
+        alignas(32) int32_t masks[LaneCount];
+        alignas(32) F32     values[LaneCount];
+        StoreI(indices, index);
+        StoreI(masks, mask);
+        for (uint32_t lane = 0; lane < LaneCount; lane++)
+            values[lane] = masks[lane] ? pBase[indices[lane]] : 0.0f;
+        return LoadF(values);
+    }
+#endif
+
+    inline VFloat Lerp(VFloat a, VFloat b, VFloat t) { return a + t * (b - a); }
+
+    inline VInt InRange(VInt x, VInt count) { return AndNot(Greater(SetI(0), x), Greater(count, x)); }
+
+    inline VFloat Abs(VFloat a) { return AndNot(SetF(-0.0f), a); }
+
+    // 2^(x log2(e)) with a degree 5 polynomial for the fraction, relative error below 1e-6 over [-87, 0]
+    inline VFloat Exp(VFloat x) {
+
+        const VFloat t = Max(x, SetF(-87.0f)) * SetF(1.44269504f);
+        const VFloat i = Floor(t);
+        const VFloat f = t - i;
+
+        VFloat p = SetF(1.87757667e-3f);
+        p = p * f + SetF(8.98934009e-3f);
+        p = p * f + SetF(5.58263180e-2f);
+        p = p * f + SetF(2.40153617e-1f);
+        p = p * f + SetF(6.93153073e-1f);
+        p = p * f + SetF(1.0f);
+        return AsFloat(AsInt(p) + ShiftLeft23(ToInt(i)));
+    }
+}
@@ -0,0 +1,67 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <Hawk/Common/NonCopyable.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool final : Hawk::NonCopyable {
+public:
+    using Task = std::function<void(uint32_t index, uint32_t threadID)>;
+
+    explicit ThreadPool(uint32_t threadCount = std::thread::hardware_concurrency());
+
+    ~ThreadPool();
+
+    // Calls task for every index in [0, count) and returns once all of them are done.
+    // The calling thread takes part in the work with threadID == 0.
+    void ParallelFor(uint32_t count, Task const& task);
+
+    uint32_t GetThreadCount() const { return static_cast<uint32_t>(std::size(m_Workers)) + 1; }
+
+private:
+    void WorkerLoop(uint32_t threadID);
+
+    void Execute(uint32_t threadID);
+
+private:
+    std::vector<std::thread> m_Workers;
+    std::mutex               m_Mutex;
+    std::condition_variable  m_ConditionStart;
+    std::condition_variable  m_ConditionFinish;
+
+    Task const*           m_pTask = nullptr;
+    uint32_t              m_TaskCount = 0;
+    std::atomic<uint32_t> m_TaskIndex = 0;
+    uint32_t              m_Generation = 0;
+    uint32_t              m_ActiveWorkers = 0;
+    bool                  m_IsStopped = false;
+};
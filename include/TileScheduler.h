@@ -0,0 +1,83 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "ThreadPool.h"
+
+#include <Hawk/Common/Defines.hpp>
+
+#include <memory>
+#include <span>
+
+// Chase-Lev deque of item indices with a fixed capacity. The owning thread pushes and pops at the bottom,
+// any other thread steals from the top. Items are only pushed while no thread pops or steals.
+class WorkStealingDeque final : Hawk::NonCopyable {
+public:
+    static constexpr uint32_t Empty = ~0u;
+
+    void Reset(uint32_t capacity);
+
+    void Push(uint32_t item);
+
+    uint32_t Pop();
+
+    // Empty when the deque is empty or another thread took the same item first
+    uint32_t Steal();
+
+    bool IsEmpty() const { return m_Top.load(std::memory_order_acquire) >= m_Bottom.load(std::memory_order_acquire); }
+
+private:
+    std::vector<std::atomic<uint32_t>> m_Items;
+    std::atomic<int64_t>               m_Top = 0;
+    std::atomic<int64_t>               m_Bottom = 0;
+    int64_t                            m_Mask = 0;
+};
+
+// Runs the tiles of a frame over one work-stealing deque per thread of the pool. The tiles are dealt
+// round-robin in order of their cost, so every deque gets a similar share of the expensive ones, and
+// pushed cheapest first: owners start with their most expensive tiles while thieves take the cheapest
+// tiles of the others. A cancelled run stops handing out tiles, the tiles already started finish.
+class TileScheduler final : Hawk::NonCopyable {
+public:
+    using Task = std::function<void(uint32_t index, uint32_t threadID)>;
+
+    explicit TileScheduler(ThreadPool& threadPool);
+
+    // Calls task for every index in [0, std::size(costs)) unless cancelled, returns the number of stolen items
+    uint64_t Run(std::span<F32 const> costs, Task const& task);
+
+    // Safe to call from any thread while Run is in progress
+    void Cancel() { m_IsCancelled.store(true, std::memory_order_relaxed); }
+
+    void ResetCancel() { m_IsCancelled.store(false, std::memory_order_relaxed); }
+
+    bool IsCancelled() const { return m_IsCancelled.load(std::memory_order_relaxed); }
+
+private:
+    ThreadPool&                                     m_ThreadPool;
+    std::vector<std::unique_ptr<WorkStealingDeque>> m_Deques;
+    std::vector<uint32_t>                           m_Order;
+    std::atomic<bool>                               m_IsCancelled = false;
+};
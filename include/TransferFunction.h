@@ -24,11 +24,14 @@
 
 #pragma once
 
-#include "Common.h"
-
 #include <Hawk/Math/Functions.hpp>
 #include <Hawk/Math/Converters.hpp>
 
+#include <algorithm>
+#include <array>
+#include <string>
+#include <vector>
+
 template<uint32_t N>
 struct PiecewiseFunction {
     F32                RangeMin = -1024.0f;
@@ -83,29 +86,13 @@ public:
 
     F32 Evaluate(F32 intensity) const { return this->PLF.Evaluate(intensity); }
 
-    DX::ComPtr<ID3D11ShaderResourceView> GenerateTexture(DX::ComPtr<ID3D11Device> pDevice, uint32_t sampling = 64) const {
+    // Texel data of the R8_UNORM lookup texture sampled by the shaders
+    std::vector<uint8_t> GenerateTable(uint32_t sampling = 64) const {
 
         std::vector<uint8_t> data(sampling);
         for (auto index = 0u; index < sampling; index++)
             data[index] = static_cast<uint8_t>(std::round(255.0f * this->Evaluate(index / static_cast<F32>(sampling - 1))));
-       
-        D3D11_TEXTURE1D_DESC desc = {};
-        desc.Width = sampling;
-        desc.MipLevels = 1;
-        desc.ArraySize = 1;
-        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-        desc.Format = DXGI_FORMAT_R8_UNORM;
-        desc.Usage = D3D11_USAGE_IMMUTABLE;
-
-        D3D11_SUBRESOURCE_DATA initData = {};
-        initData.pSysMem = std::data(data);
-
-        DX::ComPtr<ID3D11Texture1D> pTexture;
-        DX::ComPtr<ID3D11ShaderResourceView> pSRV;
-        DX::ThrowIfFailed(pDevice->CreateTexture1D(&desc, &initData, pTexture.GetAddressOf()));
-        DX::ThrowIfFailed(pDevice->CreateShaderResourceView(pTexture.Get(), nullptr, pSRV.GetAddressOf()));
-
-        return pSRV;
+        return data;
     }
 
     void Clear() { this->PLF.Clear(); }
@@ -127,7 +114,8 @@ public:
         return Hawk::Math::Vec3{ this->PLF[0].Evaluate(intensity), this->PLF[1].Evaluate(intensity), this->PLF[2].Evaluate(intensity) };
     }
 
-    DX::ComPtr<ID3D11ShaderResourceView> GenerateTexture(DX::ComPtr<ID3D11Device> pDevice, uint32_t sampling = 64) {
+    // Texel data of the R8G8B8A8_UNORM lookup texture sampled by the shaders
+    std::vector<Hawk::Math::Vector<uint8_t, 4>> GenerateTable(uint32_t sampling = 64) const {
 
         std::vector<Hawk::Math::Vector<uint8_t, 4>> data(sampling);
         for (size_t index = 0; index < sampling; index++) {
@@ -137,24 +125,7 @@ public:
             const auto z = static_cast<uint8_t>(std::round(255.0f * v.z));
             data[index] = Hawk::Math::Vector<uint8_t, 4>(x, y, z, static_cast<uint8_t>(0));
         }
-
-        D3D11_TEXTURE1D_DESC desc = {};
-        desc.Width = sampling;
-        desc.MipLevels = 1;
-        desc.ArraySize = 1;
-        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-        desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-        desc.Usage = D3D11_USAGE_IMMUTABLE;
-
-        D3D11_SUBRESOURCE_DATA initData = {};
-        initData.pSysMem = std::data(data);
-
-        DX::ComPtr<ID3D11Texture1D> pTexture;
-        DX::ComPtr<ID3D11ShaderResourceView> pSRV;
-        DX::ThrowIfFailed(pDevice->CreateTexture1D(&desc, &initData, pTexture.GetAddressOf()));
-        DX::ThrowIfFailed(pDevice->CreateShaderResourceView(pTexture.Get(), nullptr, pSRV.GetAddressOf()));
-
-        return pSRV;
+        return data;
     }
 
     void Clear() {
@@ -166,3 +137,139 @@ public:
 
     std::array<PiecewiseLinearFunction<>, 3> PLF;
 };
+
+struct TransferFunctionSet {
+    void LoadFromFile(std::string const& fileName);
+
+    ColorTransferFunction1D  Diffuse;
+    ColorTransferFunction1D  Specular;
+    ColorTransferFunction1D  Emission;
+    ScalarTransferFunction1D Roughness;
+    ScalarTransferFunction1D Opacity;
+};
+
+// Sorted, disjoint intensity ranges where a piecewise linear opacity function is above epsilon.
+// Positions are expressed in normalized intensity [0, 1], the same domain as Evaluate() and the
+// transfer function textures, so voxel min/max values can be queried directly.
+class OpacityIntervalIndex {
+public:
+    struct Interval {
+        F32 Begin = 0.0f;
+        F32 End = 0.0f;
+        F32 OpacityBegin = 0.0f;
+        F32 OpacityEnd = 0.0f;
+    };
+
+    struct QueryResult {
+        bool IsVisible = false;
+        F32  MaxOpacity = 0.0f;
+    };
+
+    // Values below half of an R8_UNORM step are rounded to zero by GenerateTable
+    static constexpr F32 DefaultEpsilon = 0.5f / 255.0f;
+
+    template<uint32_t N>
+    void Build(PiecewiseLinearFunction<N> const& function, F32 epsilon = DefaultEpsilon) {
+
+        m_Intervals.clear();
+
+        const auto range = function.RangeMax - function.RangeMin;
+        for (uint32_t index = 1; index < function.Count; index++) {
+            auto p0 = (function.Position[index - 1] - function.RangeMin) / range;
+            auto p1 = (function.Position[index - 0] - function.RangeMin) / range;
+            auto v0 = function.Value[index - 1];
+            auto v1 = function.Value[index - 0];
+
+            if (!(p1 > p0) || (v0 <= epsilon && v1 <= epsilon))
+                continue;
+
+            // Clip the linear segment to the part where it rises above epsilon
+            const auto slope = (v1 - v0) / (p1 - p0);
+            if (v0 <= epsilon) {
+                p0 = p0 + (epsilon - v0) / slope;
+                v0 = epsilon;
+            }
+
+            if (v1 <= epsilon) {
+                p1 = p0 + (epsilon - v0) / slope;
+                v1 = epsilon;
+            }
+            m_Intervals.push_back(Interval{ p0, p1, v0, v1 });
+        }
+        this->BuildSparseTable();
+    }
+
+    // Returns whether [intensityMin, intensityMax] intersects visible space and the exact maximum
+    // opacity over the intersection. Binary search for the boundary intervals, O(1) range maximum
+    // for the ones in between.
+    QueryResult Query(F32 intensityMin, F32 intensityMax) const {
+
+        assert(intensityMin <= intensityMax);
+
+        auto const first = std::upper_bound(m_Intervals.begin(), m_Intervals.end(), intensityMin, [](F32 value, Interval const& e) { return value < e.End; });
+        auto const last = std::upper_bound(m_Intervals.begin(), m_Intervals.end(), intensityMax, [](F32 value, Interval const& e) { return value < e.Begin; });
+
+        if (first >= last)
+            return QueryResult{};
+
+        auto EvaluateClipped = [](Interval const& e, F32 a, F32 b) -> F32 {
+            auto Evaluate = [&](F32 x) -> F32 {
+                const auto t = e.End > e.Begin ? (x - e.Begin) / (e.End - e.Begin) : 0.0f;
+                return e.OpacityBegin + t * (e.OpacityEnd - e.OpacityBegin);
+            };
+            return std::max(Evaluate(std::max(a, e.Begin)), Evaluate(std::min(b, e.End)));
+        };
+
+        const auto indexFirst = static_cast<uint32_t>(first - m_Intervals.begin());
+        const auto indexLast = static_cast<uint32_t>(last - m_Intervals.begin()) - 1;
+
+        auto maxOpacity = EvaluateClipped(*first, intensityMin, intensityMax);
+        if (indexLast != indexFirst)
+            maxOpacity = std::max(maxOpacity, EvaluateClipped(m_Intervals[indexLast], intensityMin, intensityMax));
+        if (indexLast > indexFirst + 1)
+            maxOpacity = std::max(maxOpacity, this->RangeMaximum(indexFirst + 1, indexLast - 1));
+
+        return QueryResult{ true, maxOpacity };
+    }
+
+    bool IsVisible(F32 intensityMin, F32 intensityMax) const { return this->Query(intensityMin, intensityMax).IsVisible; }
+
+    F32 MaxOpacity(F32 intensityMin, F32 intensityMax) const { return this->Query(intensityMin, intensityMax).MaxOpacity; }
+
+    std::vector<Interval> const& Intervals() const { return m_Intervals; }
+
+private:
+    void BuildSparseTable() {
+
+        const auto count = static_cast<uint32_t>(std::size(m_Intervals));
+        m_SparseTableLevels = 1;
+        while ((1u << m_SparseTableLevels) <= count)
+            m_SparseTableLevels++;
+
+        m_SparseTable.resize(size_t(m_SparseTableLevels) * count);
+        for (uint32_t index = 0; index < count; index++)
+            m_SparseTable[index] = std::max(m_Intervals[index].OpacityBegin, m_Intervals[index].OpacityEnd);
+
+        for (uint32_t level = 1; level < m_SparseTableLevels; level++) {
+            const auto pSrc = &m_SparseTable[size_t(level - 1) * count];
+            const auto pDst = &m_SparseTable[size_t(level) * count];
+            for (uint32_t index = 0; index + (1u << level) <= count; index++)
+                pDst[index] = std::max(pSrc[index], pSrc[index + (1u << (level - 1))]);
+        }
+    }
+
+    F32 RangeMaximum(uint32_t first, uint32_t last) const {
+
+        const auto count = static_cast<uint32_t>(std::size(m_Intervals));
+        uint32_t level = 0;
+        while ((2u << level) <= last - first + 1)
+            level++;
+        const auto pLevel = &m_SparseTable[size_t(level) * count];
+        return std::max(pLevel[first], pLevel[last + 1 - (1u << level)]);
+    }
+
+private:
+    std::vector<Interval> m_Intervals;
+    std::vector<F32>      m_SparseTable;
+    uint32_t              m_SparseTableLevels = 0;
+};
@@ -0,0 +1,104 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <Hawk/Math/Functions.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <string>
+#include <vector>
+
+// CPU copy of the intensity volume with the same mip chain and filtering the GPU textures use.
+// Sampling follows D3D11 linear filtering with border addressing (border color is zero).
+class VolumeData {
+public:
+    void LoadFromFile(std::string const& fileName);
+
+    void Initialize(uint32_t dimensionX, uint32_t dimensionY, uint32_t dimensionZ, std::vector<uint16_t>&& intensity);
+
+    void GenerateMipLevels();
+
+    uint32_t GetMipLevelCount() const { return static_cast<uint32_t>(std::size(m_MipLevels)); }
+
+    Hawk::Math::Vec3u GetDimension(uint32_t mipLevel = 0) const { return m_MipLevels[mipLevel].Dimension; }
+
+    std::vector<uint16_t> const& GetIntensity(uint32_t mipLevel = 0) const { return m_MipLevels[mipLevel].Intensity; }
+
+    F32 LoadIntensity(int32_t x, int32_t y, int32_t z, uint32_t mipLevel = 0) const {
+
+        auto const& level = m_MipLevels[mipLevel];
+        const auto index = (size_t(z) * level.Dimension.y + size_t(y)) * level.Dimension.x + size_t(x);
+        return level.Intensity[index] * (1.0f / 65535.0f);
+    }
+
+    F32 SampleIntensity(Hawk::Math::Vec3 const& texcoord, uint32_t mipLevel = 0) const;
+
+    // Sobel gradient of mip 0 (ComputeGradient.hlsl) filtered like the R16G16B16A16 gradient texture
+    Hawk::Math::Vec3 SampleGradient(Hawk::Math::Vec3 const& texcoord) const;
+
+    Hawk::Math::Vec3 ComputeGradient(int32_t x, int32_t y, int32_t z) const;
+
+    // Trilinear filter over fetch(x, y, z) for texels inside the dimension, shared with VolumeBuffer
+    template<typename T, typename Fetch>
+    static T SampleLinear(Hawk::Math::Vec3u const& dimension, Hawk::Math::Vec3 const& texcoord, Fetch&& fetch) {
+
+        const auto u = texcoord.x * dimension.x - 0.5f;
+        const auto v = texcoord.y * dimension.y - 0.5f;
+        const auto w = texcoord.z * dimension.z - 0.5f;
+
+        const auto x0 = static_cast<int32_t>(std::floor(u));
+        const auto y0 = static_cast<int32_t>(std::floor(v));
+        const auto z0 = static_cast<int32_t>(std::floor(w));
+
+        const auto fx = u - x0;
+        const auto fy = v - y0;
+        const auto fz = w - z0;
+
+        auto Load = [&](int32_t x, int32_t y, int32_t z) -> T {
+            if (x < 0 || y < 0 || z < 0 || x >= int32_t(dimension.x) || y >= int32_t(dimension.y) || z >= int32_t(dimension.z))
+                return T{};
+            return fetch(x, y, z);
+        };
+
+        auto Lerp = [](T const& a, T const& b, F32 t) -> T { return a + t * (b - a); };
+
+        const auto c00 = Lerp(Load(x0, y0 + 0, z0 + 0), Load(x0 + 1, y0 + 0, z0 + 0), fx);
+        const auto c10 = Lerp(Load(x0, y0 + 1, z0 + 0), Load(x0 + 1, y0 + 1, z0 + 0), fx);
+        const auto c01 = Lerp(Load(x0, y0 + 0, z0 + 1), Load(x0 + 1, y0 + 0, z0 + 1), fx);
+        const auto c11 = Lerp(Load(x0, y0 + 1, z0 + 1), Load(x0 + 1, y0 + 1, z0 + 1), fx);
+        return Lerp(Lerp(c00, c10, fy), Lerp(c01, c11, fy), fz);
+    }
+
+private:
+    // Intensity has one trailing element of padding so 32-bit gathers of the last voxel stay in bounds
+    struct MipLevel {
+        Hawk::Math::Vec3u     Dimension;
+        std::vector<uint16_t> Intensity;
+    };
+
+    std::vector<MipLevel> m_MipLevels;
+};
@@ -0,0 +1,167 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "VolumeData.h"
+
+#include <bit>
+#include <new>
+
+// Voxel orderings for CPU copies of the volume. A layout maps (x, y, z) to an element of a buffer of
+// GetElementCount() voxels; VolumeBuffer stores one mip level in that order, so its trilinear sampler
+// is compiled once per layout.
+class VolumeLayoutLinear {
+public:
+    static constexpr const char* Name = "linear";
+
+    VolumeLayoutLinear(Hawk::Math::Vec3u const& dimension)
+        : m_Dimension(dimension) {}
+
+    size_t GetElementCount() const { return size_t(m_Dimension.x) * m_Dimension.y * m_Dimension.z; }
+
+    size_t GetIndex(uint32_t x, uint32_t y, uint32_t z) const { return (size_t(z) * m_Dimension.y + y) * m_Dimension.x + x; }
+
+private:
+    Hawk::Math::Vec3u m_Dimension;
+};
+
+// Z-order curve over the volume padded to a power of two cube, up to 2^21 voxels per axis. The
+// coordinates are interleaved through a table of spread bits, so the eight taps of a trilinear
+// sample cost three loads each instead of the bit twiddling.
+class VolumeLayoutMorton {
+public:
+    static constexpr const char* Name = "morton";
+
+    VolumeLayoutMorton(Hawk::Math::Vec3u const& dimension)
+        : m_Size(std::bit_ceil((std::max)({ dimension.x, dimension.y, dimension.z }))) {
+
+        m_SpreadBits.resize(m_Size);
+        for (uint32_t value = 0; value < m_Size; value++)
+            m_SpreadBits[value] = SpreadBits(value);
+    }
+
+    size_t GetElementCount() const { return size_t(m_Size) * m_Size * m_Size; }
+
+    size_t GetIndex(uint32_t x, uint32_t y, uint32_t z) const { return m_SpreadBits[x] | (m_SpreadBits[y] << 1) | (m_SpreadBits[z] << 2); }
+
+private:
+    static uint64_t SpreadBits(uint32_t value) {
+
+        uint64_t v = value & 0x1FFFFF;
+        v = (v | (v << 32)) & 0x1F00000000FFFFull;
+        v = (v | (v << 16)) & 0x1F0000FF0000FFull;
+        v = (v | (v << 8)) & 0x100F00F00F00F00Full;
+        v = (v | (v << 4)) & 0x10C30C30C30C30C3ull;
+        v = (v | (v << 2)) & 0x1249249249249249ull;
+        return v;
+    }
+
+private:
+    uint32_t              m_Size;
+    std::vector<uint64_t> m_SpreadBits;
+};
+
+// TileSize^3 bricks stored one after another, x-fastest both inside a brick and between bricks. With the
+// page-aligned storage of VolumeBuffer, a brick of 16-bit voxels never straddles a page.
+template<uint32_t TileSize = 8>
+class VolumeLayoutTiled {
+public:
+    static_assert(std::has_single_bit(TileSize), "Tile size must be a power of two");
+
+    static constexpr const char* Name = "tiled";
+
+    VolumeLayoutTiled(Hawk::Math::Vec3u const& dimension)
+        : m_TileCount((dimension.x + TileSize - 1) / TileSize, (dimension.y + TileSize - 1) / TileSize, (dimension.z + TileSize - 1) / TileSize) {}
+
+    size_t GetElementCount() const { return size_t(m_TileCount.x) * m_TileCount.y * m_TileCount.z * TileVoxelCount; }
+
+    size_t GetIndex(uint32_t x, uint32_t y, uint32_t z) const {
+
+        const size_t tile = (size_t(z / TileSize) * m_TileCount.y + y / TileSize) * m_TileCount.x + x / TileSize;
+        const size_t voxel = ((z % TileSize) * TileSize + (y % TileSize)) * TileSize + (x % TileSize);
+        return tile * TileVoxelCount + voxel;
+    }
+
+private:
+    static constexpr size_t TileVoxelCount = size_t(TileSize) * TileSize * TileSize;
+
+    Hawk::Math::Vec3u m_TileCount;
+};
+
+template<typename T>
+struct PageAlignedAllocator {
+    using value_type = T;
+
+    static constexpr size_t PageSize = 4096;
+
+    PageAlignedAllocator() = default;
+
+    template<typename U>
+    PageAlignedAllocator(PageAlignedAllocator<U> const&) {}
+
+    T* allocate(size_t count) { return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(PageSize))); }
+
+    void deallocate(T* pointer, size_t) { ::operator delete(pointer, std::align_val_t(PageSize)); }
+
+    template<typename U>
+    bool operator==(PageAlignedAllocator<U> const&) const { return true; }
+};
+
+// One mip level of VolumeData reordered into Layout, sampled the same way as VolumeData::SampleIntensity
+template<typename Layout>
+class VolumeBuffer {
+public:
+    VolumeBuffer(VolumeData const& volume, uint32_t mipLevel = 0)
+        : m_Layout(volume.GetDimension(mipLevel))
+        , m_Dimension(volume.GetDimension(mipLevel)) {
+
+        auto const& intensity = volume.GetIntensity(mipLevel);
+
+        m_Intensity.assign(m_Layout.GetElementCount(), 0);
+        for (uint32_t z = 0; z < m_Dimension.z; z++)
+            for (uint32_t y = 0; y < m_Dimension.y; y++)
+                for (uint32_t x = 0; x < m_Dimension.x; x++)
+                    m_Intensity[m_Layout.GetIndex(x, y, z)] = intensity[(size_t(z) * m_Dimension.y + y) * m_Dimension.x + x];
+    }
+
+    Hawk::Math::Vec3u GetDimension() const { return m_Dimension; }
+
+    size_t GetMemorySize() const { return sizeof(uint16_t) * std::size(m_Intensity); }
+
+    F32 LoadIntensity(int32_t x, int32_t y, int32_t z) const { return m_Intensity[m_Layout.GetIndex(x, y, z)] * (1.0f / 65535.0f); }
+
+    F32 SampleIntensity(Hawk::Math::Vec3 const& texcoord) const {
+
+        return VolumeData::SampleLinear<F32>(m_Dimension, texcoord, [&](int32_t x, int32_t y, int32_t z) {
+            return this->LoadIntensity(x, y, z);
+        });
+    }
+
+private:
+    Layout            m_Layout;
+    Hawk::Math::Vec3u m_Dimension;
+
+    std::vector<uint16_t, PageAlignedAllocator<uint16_t>> m_Intensity;
+};
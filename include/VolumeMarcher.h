@@ -0,0 +1,113 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "MajorantGrid.h"
+#include "RenderCommon.h"
+#include "VolumeData.h"
+
+#include <vector>
+
+// Rays in SoA layout. The caller fills the inputs, the marcher writes the scatter positions.
+struct RayStream {
+    void Resize(size_t count) {
+
+        for (auto pArray : { &OriginX, &OriginY, &OriginZ, &DirectionX, &DirectionY, &DirectionZ, &Min, &Max, &Threshold, &Jitter, &PositionX, &PositionY, &PositionZ })
+            pArray->resize(count);
+        IsScattered.resize(count);
+        Seed.resize(count);
+        Transmittance.resize(count);
+    }
+
+    size_t Size() const { return std::size(OriginX); }
+
+    std::vector<F32> OriginX;
+    std::vector<F32> OriginY;
+    std::vector<F32> OriginZ;
+    std::vector<F32> DirectionX;
+    std::vector<F32> DirectionY;
+    std::vector<F32> DirectionZ;
+    std::vector<F32> Min;
+    std::vector<F32> Max;
+
+    // Optical depth at which the ray scatters and offset of the first sample in steps
+    std::vector<F32> Threshold;
+    std::vector<F32> Jitter;
+
+    // Random number state of the ray, consumed and advanced by delta tracking
+    std::vector<uint32_t> Seed;
+
+    std::vector<F32>     PositionX;
+    std::vector<F32>     PositionY;
+    std::vector<F32>     PositionZ;
+    std::vector<uint8_t> IsScattered;
+
+    // Fractional visibility written by ratio tracking
+    std::vector<F32> Transmittance;
+};
+
+// The RayMarching loop of ComputePrimaryRays.hlsl and ComputeRadiance.hlsl: fixed steps through the
+// bounding box, accumulating opacity until the ray threshold is reached. MarchScalar traces one ray at
+// a time, MarchPacket traces 8 rays per packet (AVX2, or two SSE2 halves when AVX2 is not enabled) and
+// refills terminated lanes from the stream once occupancy drops. TrackDelta samples free-flight
+// distances against the majorant grid instead (delta tracking), which is unbiased and takes fewer
+// lookups where the majorants are low. TrackRatio is the RatioTracking estimator of ComputeRadiance.hlsl
+// and returns transmittance rather than a scatter event.
+class VolumeMarcher {
+public:
+    struct Desc {
+        VolumeData const*   pVolume = nullptr;
+        MajorantGrid const* pMajorantGrid = nullptr;
+        uint32_t            MipLevel = 0;
+        F32 const*          pOpacityTable = nullptr;
+        uint32_t            OpacityTableSize = 0;
+        Hawk::Math::Vec3    BoundingBoxMin; // Box rays are clipped to, inside VolumeBoundingBoxMin/Max
+        Hawk::Math::Vec3    BoundingBoxMax;
+        Shading::ClipRegion ClipRegion;
+        F32                 StepSize = 0.0f;
+        F32                 Density = 0.0f;
+    };
+
+    // Lanes are refilled when fewer than this many are still marching
+    static constexpr uint32_t RefillThreshold = 6;
+
+    VolumeMarcher(Desc const& desc);
+
+    void MarchScalar(RayStream& stream, size_t first, size_t count) const;
+
+    void MarchPacket(RayStream& stream, size_t first, size_t count) const;
+
+    void TrackDelta(RayStream& stream, size_t first, size_t count) const;
+
+    void TrackRatio(RayStream& stream, size_t first, size_t count, bool isResidual) const;
+
+    static const char* GetInstructionSet();
+
+private:
+    F32 SampleOpacity(Hawk::Math::Vec3 const& position) const;
+
+private:
+    Desc m_Desc;
+};
@@ -97,10 +97,29 @@ void Application::Run() {
     glfwSetScrollCallback(m_pWindow, GLFW_WindowCallbacks::MouseScrollCallback);
     glfwSetWindowSizeCallback(m_pWindow, GLFW_WindowCallbacks::ResizeWindowCallback);
 
+    uint32_t idleFrameIndex = 0;
     while (!glfwWindowShouldClose(m_pWindow)) {
-        glfwPollEvents();
+        if (!this->IsConverged()) {
+            idleFrameIndex = 0;
+            glfwPollEvents();
+        } else if (idleFrameIndex < IdleFrameCount) {
+            idleFrameIndex++;
+            glfwPollEvents();
+        } else {
+            // The wait does not count as frame time, camera motion scales with it
+            glfwWaitEvents();
+            idleFrameIndex = 0;
+            m_LastFrame = std::chrono::high_resolution_clock::now();
+        }
+
+        m_pProfiler->BeginFrame();
+        m_pProfilerD3D11->BeginFrame();
+        m_pProfiler->BeginScope("Frame");
 
-        this->Update(this->CalculateFrameTime());
+        {
+            Profiler::Scope scope(m_pProfiler.get(), "Update");
+            this->Update(this->CalculateFrameTime());
+        }
 
         ImGui_ImplDX11_NewFrame();
         ImGui_ImplGlfw_NewFrame();
@@ -116,15 +135,20 @@ void Application::Run() {
         this->RenderGUI(m_pRTV[frameIndex]);
         ImGui::Render();
 
-        m_pAnnotation->BeginEvent(L"Render pass: ImGui");
+        m_pProfilerD3D11->BeginScope("ImGui");
         m_pImmediateContext->OMSetRenderTargets(1, m_pRTV[frameIndex].GetAddressOf(), nullptr);
         ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
         m_pImmediateContext->OMSetRenderTargets(0, nullptr, nullptr);
-        m_pAnnotation->EndEvent();
+        m_pProfilerD3D11->EndScope();
+        m_pProfilerD3D11->EndFrame();
         m_pD3D11On12Device->ReleaseWrappedResources(m_pD3D11BackBuffers[frameIndex].GetAddressOf(), 1);
         m_pImmediateContext->Flush();
 
-        m_pSwapChain->Present(m_ApplicationDesc.IsVSync ? 1 : 0, 0);
+        {
+            Profiler::Scope scope(m_pProfiler.get(), "Present");
+            m_pSwapChain->Present(m_ApplicationDesc.IsVSync ? 1 : 0, 0);
+        }
+        m_pProfiler->EndScope();
     }
 
     this->WaitForGPU();
@@ -225,6 +249,9 @@ void Application::InitializeD3D11() {
         DX::ThrowIfFailed(m_pDevice.As(&m_pD3D11On12Device));
         DX::ThrowIfFailed(m_pImmediateContext.As(&m_pAnnotation));
 
+        m_pProfiler = std::make_unique<Profiler>();
+        m_pProfilerD3D11 = std::make_unique<ProfilerD3D11>(m_pDevice, m_pImmediateContext, m_pAnnotation, *m_pProfiler);
+
         for (uint32_t frameID = 0; frameID < FrameCount; frameID++) {
             DX::ThrowIfFailed(m_pSwapChain->GetBuffer(frameID, IID_PPV_ARGS(&m_pD3D12BackBuffers[frameID])));
 
@@ -23,97 +23,33 @@
  */
 
 #include "ApplicationVolumeRender.h"
-#include <directx-tex/DDSTextureLoader.h>
 #include <imgui/imgui.h>
 #include <implot/implot.h>
-#include <nlohmann/json.hpp>
 #include <fmt/format.h>
-#include <d3dcompiler.h>
-#include <fstream>
 #include <iostream>
 #include <random>
 
-struct FrameBuffer {
-
-    Hawk::Math::Mat4x4 ProjectionMatrix;
-    Hawk::Math::Mat4x4 ViewMatrix;
-    Hawk::Math::Mat4x4 WorldMatrix;
-    Hawk::Math::Mat4x4 NormalMatrix;
-
-    Hawk::Math::Mat4x4 InvProjectionMatrix;
-    Hawk::Math::Mat4x4 InvViewMatrix;
-    Hawk::Math::Mat4x4 InvWorldMatrix;
-    Hawk::Math::Mat4x4 InvNormalMatrix;
-
-    Hawk::Math::Mat4x4 ViewProjectionMatrix;
-    Hawk::Math::Mat4x4 NormalViewMatrix;
-    Hawk::Math::Mat4x4 WorldViewProjectionMatrix;
-
-    Hawk::Math::Mat4x4 InvViewProjectionMatrix;
-    Hawk::Math::Mat4x4 InvNormalViewMatrix;
-    Hawk::Math::Mat4x4 InvWorldViewProjectionMatrix;
-
-    uint32_t         FrameIndex;
-    float            StepSize;
-    Hawk::Math::Vec2 FrameOffset;
-
-    Hawk::Math::Vec2 InvRenderTargetDim;
-    Hawk::Math::Vec2 RenderTargetDim;
-
-    float Density;
-    Hawk::Math::Vec3 BoundingBoxMin;
-
-    float Exposure;
-    Hawk::Math::Vec3 BoundingBoxMax;
-};
-
-struct DispatchIndirectBuffer {
-    uint32_t ThreadGroupX;
-    uint32_t ThreadGroupY;
-    uint32_t ThreadGroupZ;
-};
-
-struct DrawInstancedIndirectBuffer {
-    uint32_t VertexCount;
-    uint32_t InstanceCount;
-    uint32_t VertexOffset;
-    uint32_t InstanceOffset;
-};
-
 ApplicationVolumeRender::ApplicationVolumeRender(ApplicationDesc const& desc)
-    : Application(desc)
-    , m_RandomGenerator(m_RandomDevice())
-    , m_RandomDistribution(-0.5f, +0.5f) {
+    : Application(desc) {
+
+    m_pThreadPool = std::make_unique<ThreadPool>();
+    m_pRendererD3D11 = std::make_unique<RendererD3D11>(m_pDevice, m_pImmediateContext, *m_pProfilerD3D11, *m_pThreadPool);
+    m_pRendererD3D11->Resize(m_ApplicationDesc.Width, m_ApplicationDesc.Height);
+    m_pRenderer = m_pRendererD3D11.get();
 
     this->InitializeShaders();
-    this->InitializeTransferFunction();
     this->InitializeSamplerStates();
-    this->InitializeRenderTextures();
-    this->InitializeTileBuffer();
     this->InitializeBuffers();
-    this->InitializeVolumeTexture();
+    this->InitializeRenderTextures();
+    this->InitializeTransferFunction();
+    this->InitializeVolume();
     this->InitializeEnvironmentMap();
+    this->InitializeBlueNoise();
 }
 
 void ApplicationVolumeRender::InitializeShaders() {
 
-    auto compileShader = [](auto fileName, auto entryPoint, auto target, auto macros) -> DX::ComPtr<ID3DBlob> {
-        DX::ComPtr<ID3DBlob> pCodeBlob;
-        DX::ComPtr<ID3DBlob> pErrorBlob;
-
-        uint32_t flags = 0;
-#if defined(_DEBUG)
-        flags |= D3DCOMPILE_DEBUG;
-#else
-        flags |= D3DCOMPILE_OPTIMIZATION_LEVEL3;
-#endif
-
-        if (FAILED(D3DCompileFromFile(fileName, macros, D3D_COMPILE_STANDARD_FILE_INCLUDE, entryPoint, target, flags, 0, pCodeBlob.GetAddressOf(), pErrorBlob.GetAddressOf())))
-            throw std::runtime_error(static_cast<const char*>(pErrorBlob->GetBufferPointer()));
-        return pCodeBlob;
-    };
-
-    //TODO AMD 8x8x1 NV 8x4x1
+    // Common.hlsl is shared with the compute shaders of the D3D11 renderer
     const auto threadSizeX = std::to_string(8);
     const auto threadSizeY = std::to_string(8);
 
@@ -123,406 +59,127 @@ void ApplicationVolumeRender::InitializeShaders() {
         { nullptr, nullptr}
     };
 
-    auto pBlobCSGeneratePrimaryRays = compileShader(L"content/Shaders/ComputePrimaryRays.hlsl", "GenerateRays", "cs_5_0", macros);
-    auto pBlobCSComputeDiffuseLight = compileShader(L"content/Shaders/ComputeRadiance.hlsl", "ComputeRadiance", "cs_5_0", macros);
-    auto pBlobCSAccumulate = compileShader(L"content/Shaders/Accumulation.hlsl", "Accumulate", "cs_5_0", macros);
-    auto pBlobCSComputeTiles = compileShader(L"content/Shaders/ComputeTiles.hlsl", "ComputeTiles", "cs_5_0", macros);
-    auto pBlobCSToneMap = compileShader(L"content/Shaders/ToneMap.hlsl", "ToneMap", "cs_5_0", macros);
-    auto pBlobCSComputeGradient = compileShader(L"content/Shaders/ComputeGradient.hlsl", "ComputeGradient", "cs_5_0", macros);
-    auto pBlobCSGenerateMipLevel = compileShader(L"content/Shaders/ComputeLevelOfDetail.hlsl", "GenerateMipLevel", "cs_5_0", macros);
-    auto pBlobCSResetTiles = compileShader(L"content/Shaders/ComputeTiles.hlsl", "ResetTiles", "cs_5_0", macros);
-    auto pBlobVSTextureBlit = compileShader(L"content/Shaders/TextureBlit.hlsl", "BlitVS", "vs_5_0", macros);
-    auto pBlobPSTextureBlit = compileShader(L"content/Shaders/TextureBlit.hlsl", "BlitPS", "ps_5_0", macros);
-    auto pBlobVSDebugTiles = compileShader(L"content/Shaders/DebugTiles.hlsl", "DebugTilesVS", "vs_5_0", macros);
-    auto pBlobGSDebugTiles = compileShader(L"content/Shaders/DebugTiles.hlsl", "DebugTilesGS", "gs_5_0", macros);
-    auto pBlobPSDegugTiles = compileShader(L"content/Shaders/DebugTiles.hlsl", "DebugTilesPS", "ps_5_0", macros);
-
-
-    DX::ThrowIfFailed(m_pDevice->CreateComputeShader(pBlobCSGeneratePrimaryRays->GetBufferPointer(), pBlobCSGeneratePrimaryRays->GetBufferSize(), nullptr, m_PSOGeneratePrimaryRays.pCS.ReleaseAndGetAddressOf()));
-    DX::ThrowIfFailed(m_pDevice->CreateComputeShader(pBlobCSComputeDiffuseLight->GetBufferPointer(), pBlobCSComputeDiffuseLight->GetBufferSize(), nullptr, m_PSOComputeDiffuseLight.pCS.ReleaseAndGetAddressOf()));
-    DX::ThrowIfFailed(m_pDevice->CreateComputeShader(pBlobCSAccumulate->GetBufferPointer(), pBlobCSAccumulate->GetBufferSize(), nullptr, m_PSOAccumulate.pCS.ReleaseAndGetAddressOf()));
-    DX::ThrowIfFailed(m_pDevice->CreateComputeShader(pBlobCSComputeTiles->GetBufferPointer(), pBlobCSComputeTiles->GetBufferSize(), nullptr, m_PSOComputeTiles.pCS.ReleaseAndGetAddressOf()));
-    DX::ThrowIfFailed(m_pDevice->CreateComputeShader(pBlobCSToneMap->GetBufferPointer(), pBlobCSToneMap->GetBufferSize(), nullptr, m_PSOToneMap.pCS.ReleaseAndGetAddressOf()));
-    DX::ThrowIfFailed(m_pDevice->CreateComputeShader(pBlobCSGenerateMipLevel->GetBufferPointer(), pBlobCSGenerateMipLevel->GetBufferSize(), nullptr, m_PSOGenerateMipLevel.pCS.ReleaseAndGetAddressOf()));
-    DX::ThrowIfFailed(m_pDevice->CreateComputeShader(pBlobCSComputeGradient->GetBufferPointer(), pBlobCSComputeGradient->GetBufferSize(), nullptr, m_PSOComputeGradient.pCS.ReleaseAndGetAddressOf()));
-    DX::ThrowIfFailed(m_pDevice->CreateComputeShader(pBlobCSResetTiles->GetBufferPointer(), pBlobCSResetTiles->GetBufferSize(), nullptr, m_PSOResetTiles.pCS.ReleaseAndGetAddressOf()));
+    auto pBlobVSTextureBlit = DX::CompileShaderFromFile(L"content/Shaders/TextureBlit.hlsl", "BlitVS", "vs_5_0", macros);
+    auto pBlobPSTextureBlit = DX::CompileShaderFromFile(L"content/Shaders/TextureBlit.hlsl", "BlitPS", "ps_5_0", macros);
 
     DX::ThrowIfFailed(m_pDevice->CreateVertexShader(pBlobVSTextureBlit->GetBufferPointer(), pBlobVSTextureBlit->GetBufferSize(), nullptr, m_PSOBlit.pVS.ReleaseAndGetAddressOf()));
     DX::ThrowIfFailed(m_pDevice->CreatePixelShader(pBlobPSTextureBlit->GetBufferPointer(), pBlobPSTextureBlit->GetBufferSize(), nullptr, m_PSOBlit.pPS.ReleaseAndGetAddressOf()));
     m_PSOBlit.PrimitiveTopology = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-
-    DX::ThrowIfFailed(m_pDevice->CreateVertexShader(pBlobVSDebugTiles->GetBufferPointer(), pBlobVSDebugTiles->GetBufferSize(), nullptr, m_PSODegugTiles.pVS.ReleaseAndGetAddressOf()));
-    DX::ThrowIfFailed(m_pDevice->CreateGeometryShader(pBlobGSDebugTiles->GetBufferPointer(), pBlobGSDebugTiles->GetBufferSize(), nullptr, m_PSODegugTiles.pGS.ReleaseAndGetAddressOf()));
-    DX::ThrowIfFailed(m_pDevice->CreatePixelShader(pBlobPSDegugTiles->GetBufferPointer(), pBlobPSDegugTiles->GetBufferSize(), nullptr, m_PSODegugTiles.pPS.ReleaseAndGetAddressOf()));
-    m_PSODegugTiles.PrimitiveTopology = D3D11_PRIMITIVE_TOPOLOGY_POINTLIST;
 }
 
-void ApplicationVolumeRender::InitializeVolumeTexture() {
+void ApplicationVolumeRender::InitializeVolume() {
 
-    std::unique_ptr<FILE, decltype(&fclose)> pFile(fopen("content/Textures/manix.dat", "rb"), fclose);
-    if (!pFile)
-        throw std::runtime_error("Failed to open file: " + std::string("Data/Textures/manix.dat"));
+    m_VolumeData.LoadFromFile("content/Textures/manix.dat");
 
-    fread(&m_DimensionX, sizeof(uint16_t), 1, pFile.get());
-    fread(&m_DimensionY, sizeof(uint16_t), 1, pFile.get());
-    fread(&m_DimensionZ, sizeof(uint16_t), 1, pFile.get());
+    const auto dimension = m_VolumeData.GetDimension();
+    m_DimensionX = static_cast<uint16_t>(dimension.x);
+    m_DimensionY = static_cast<uint16_t>(dimension.y);
+    m_DimensionZ = static_cast<uint16_t>(dimension.z);
+    m_DimensionMipLevels = static_cast<uint16_t>(m_VolumeData.GetMipLevelCount());
 
-    std::vector<uint16_t> intensity(size_t(m_DimensionX) * size_t(m_DimensionY) * size_t(m_DimensionZ));
-    fread(intensity.data(), sizeof(uint16_t), m_DimensionX * m_DimensionY * m_DimensionZ, pFile.get());
-    m_DimensionMipLevels = static_cast<uint16_t>(std::ceil(std::log2(std::max(std::max(m_DimensionX, m_DimensionY), m_DimensionZ)))) + 1;
-
-    auto NormalizeIntensity = [](uint16_t intensity, uint16_t min, uint16_t max) -> uint16_t {
-        return static_cast<uint16_t>(std::round(std::numeric_limits<uint16_t>::max() * ((intensity - min) / static_cast<F32>(max - min))));
-    };
-
-    uint16_t tmin = 0 << 12; // Min HU [0, 4096]
-    uint16_t tmax = 1 << 12; // Max HU [0, 4096]
-    for (size_t index = 0u; index < std::size(intensity); index++)
-        intensity[index] = NormalizeIntensity(intensity[index], tmin, tmax);
-
-    {
-        DX::ComPtr<ID3D11Texture3D> pTextureIntensity;
-        D3D11_TEXTURE3D_DESC desc = {};
-        desc.Width = m_DimensionX;
-        desc.Height = m_DimensionY;
-        desc.Depth = m_DimensionZ;
-        desc.Format = DXGI_FORMAT_R16_UNORM;
-        desc.MipLevels = m_DimensionMipLevels;
-        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
-        desc.Usage = D3D11_USAGE_DEFAULT;;
-        DX::ThrowIfFailed(m_pDevice->CreateTexture3D(&desc, nullptr, pTextureIntensity.GetAddressOf()));
-
-        for (uint32_t mipLevelID = 0; mipLevelID < desc.MipLevels; mipLevelID++) {
-            D3D11_SHADER_RESOURCE_VIEW_DESC descSRV = {};
-            descSRV.Format = DXGI_FORMAT_R16_UNORM;
-            descSRV.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE3D;
-            descSRV.Texture3D.MipLevels = 1;
-            descSRV.Texture3D.MostDetailedMip = mipLevelID;
-
-            DX::ComPtr<ID3D11ShaderResourceView> pSRVVolumeIntensity;
-            DX::ThrowIfFailed(m_pDevice->CreateShaderResourceView(pTextureIntensity.Get(), &descSRV, pSRVVolumeIntensity.GetAddressOf()));
-            m_pSRVVolumeIntensity.push_back(pSRVVolumeIntensity);
-        }
-
-        for (uint32_t mipLevelID = 0; mipLevelID < desc.MipLevels; mipLevelID++) {
-            D3D11_UNORDERED_ACCESS_VIEW_DESC descUAV = {};
-            descUAV.Format = DXGI_FORMAT_R16_UNORM;
-            descUAV.ViewDimension = D3D11_UAV_DIMENSION_TEXTURE3D;
-            descUAV.Texture3D.MipSlice = mipLevelID;
-            descUAV.Texture3D.FirstWSlice = 0;
-            descUAV.Texture3D.WSize = std::max(m_DimensionZ >> mipLevelID, 1);
-
-            DX::ComPtr<ID3D11UnorderedAccessView> pUAVVolumeIntensity;
-            DX::ThrowIfFailed(m_pDevice->CreateUnorderedAccessView(pTextureIntensity.Get(), &descUAV, pUAVVolumeIntensity.GetAddressOf()));
-            m_pUAVVolumeIntensity.push_back(pUAVVolumeIntensity);
-        }
-
-        D3D11_BOX box = { 0, 0, 0,  desc.Width, desc.Height,  desc.Depth };
-        m_pImmediateContext->UpdateSubresource(pTextureIntensity.Get(), 0, &box, std::data(intensity), sizeof(uint16_t) * desc.Width, sizeof(uint16_t) * desc.Height * desc.Width);
-
-        for (uint32_t mipLevelID = 1; mipLevelID < desc.MipLevels - 1; mipLevelID++) {
-            uint32_t threadGroupX = std::max(static_cast<uint32_t>(std::ceil((m_DimensionX >> mipLevelID) / 4.0f)), 1u);
-            uint32_t threadGroupY = std::max(static_cast<uint32_t>(std::ceil((m_DimensionY >> mipLevelID) / 4.0f)), 1u);
-            uint32_t threadGroupZ = std::max(static_cast<uint32_t>(std::ceil((m_DimensionZ >> mipLevelID) / 4.0f)), 1u);
-
-            ID3D11ShaderResourceView* ppSRVTextures[] = { m_pSRVVolumeIntensity[mipLevelID - 1].Get() };
-            ID3D11UnorderedAccessView* ppUAVTextures[] = { m_pUAVVolumeIntensity[mipLevelID + 0].Get() };
-            ID3D11SamplerState* ppSamplers[] = { m_pSamplerLinear.Get() };
-
-            ID3D11UnorderedAccessView* ppUAVClear[] = { nullptr };
-            ID3D11ShaderResourceView* ppSRVClear[] = { nullptr };
-            ID3D11SamplerState* ppSamplerClear[] = { nullptr };
-
-            auto renderPassName = std::format(L"Render Pass: Compute Mip Map [{}] ", mipLevelID);
-            m_pAnnotation->BeginEvent(renderPassName.c_str());
-            m_PSOGenerateMipLevel.Apply(m_pImmediateContext);
-            m_pImmediateContext->CSSetShaderResources(0, _countof(ppSRVTextures), ppSRVTextures);
-            m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVTextures), ppUAVTextures, nullptr);
-            m_pImmediateContext->CSSetSamplers(0, _countof(ppSamplers), ppSamplers);
-            m_pImmediateContext->Dispatch(threadGroupX, threadGroupY, threadGroupZ);
-
-            m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVClear), ppUAVClear, nullptr);
-            m_pImmediateContext->CSSetShaderResources(0, _countof(ppSRVClear), ppSRVClear);
-            m_pImmediateContext->CSSetSamplers(0, _countof(ppSamplerClear), ppSamplerClear);
-            m_pAnnotation->EndEvent();
-        }
-        m_pImmediateContext->Flush();
-    }
-
-    {
-        DX::ComPtr<ID3D11Texture3D> pTextureGradient;
-        D3D11_TEXTURE3D_DESC desc = {};
-        desc.Width = m_DimensionX;
-        desc.Height = m_DimensionY;
-        desc.Depth = m_DimensionZ;
-        desc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
-        desc.MipLevels = 1;
-        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
-        desc.Usage = D3D11_USAGE_DEFAULT;
-        DX::ThrowIfFailed(m_pDevice->CreateTexture3D(&desc, nullptr, pTextureGradient.ReleaseAndGetAddressOf()));
-        DX::ThrowIfFailed(m_pDevice->CreateShaderResourceView(pTextureGradient.Get(), nullptr, m_pSRVGradient.ReleaseAndGetAddressOf()));
-        DX::ThrowIfFailed(m_pDevice->CreateUnorderedAccessView(pTextureGradient.Get(), nullptr, m_pUAVGradient.ReleaseAndGetAddressOf()));
-        {
-            const auto threadGroupX = static_cast<uint32_t>(std::ceil(m_DimensionX / 4.0f));
-            const auto threadGroupY = static_cast<uint32_t>(std::ceil(m_DimensionY / 4.0f));
-            const auto threadGroupZ = static_cast<uint32_t>(std::ceil(m_DimensionZ / 4.0f));
-
-            ID3D11ShaderResourceView* ppSRVTextures[] = { m_pSRVVolumeIntensity[0].Get(), m_pSRVOpacityTF.Get() };
-            ID3D11UnorderedAccessView* ppUAVTextures[] = { m_pUAVGradient.Get() };
-            ID3D11SamplerState* ppSamplers[] = { m_pSamplerPoint.Get(), m_pSamplerLinear.Get() };
-
-            ID3D11UnorderedAccessView* ppUAVClear[] = { nullptr };
-            ID3D11ShaderResourceView* ppSRVClear[] = { nullptr, nullptr };
-            ID3D11SamplerState* ppSamplerClear[] = { nullptr, nullptr };
-
-            m_pAnnotation->BeginEvent(L"Render Pass: Compute Gradient");
-            m_PSOComputeGradient.Apply(m_pImmediateContext);
-            m_pImmediateContext->CSSetShaderResources(0, _countof(ppSRVTextures), ppSRVTextures);
-            m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVTextures), ppUAVTextures, nullptr);
-            m_pImmediateContext->Dispatch(threadGroupX, threadGroupY, threadGroupZ);
-
-            m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVClear), ppUAVClear, nullptr);
-            m_pImmediateContext->CSSetShaderResources(0, _countof(ppSRVClear), ppSRVClear);
-            m_pImmediateContext->CSSetSamplers(0, _countof(ppSamplerClear), ppSamplerClear);
-            m_pAnnotation->EndEvent();
-        }
-        m_pImmediateContext->Flush();
-    }
+    for (auto pRenderer : this->GetRenderers())
+        if (pRenderer)
+            pRenderer->SetVolume(&m_VolumeData);
+    this->InitializeMajorantGrid();
 }
 
 void ApplicationVolumeRender::InitializeTransferFunction() {
 
-    nlohmann::json root;
-    std::ifstream file("content/TransferFunctions/ManixTransferFunction.json");
-    file >> root;
-
-    m_OpacityTransferFunc.Clear();
-    m_DiffuseTransferFunc.Clear();
-    m_SpecularTransferFunc.Clear();
-    m_EmissionTransferFunc.Clear();
-    m_RoughnessTransferFunc.Clear();
-
-    auto ExtractVec3FromJson = [](auto const& tree, auto const& key) -> Hawk::Math::Vec3 {
-        Hawk::Math::Vec3 v{};
-        uint32_t index = 0;
-        for (auto& e : tree[key]) {
-            v[index] = e.template get<float>();
-            index++;
-        }
-        return v;
-    };
+    m_TransferFunctions.LoadFromFile("content/TransferFunctions/ManixTransferFunction.json");
 
-    for (auto const& e : root["NodesColor"]) {
-        const auto intensity = e["Intensity"].get<float>();
-        const auto diffuse = ExtractVec3FromJson(e, "Diffuse");
-        const auto specular = ExtractVec3FromJson(e, "Specular");
-        const auto roughness = e["Roughness"].get<float>();
+    for (auto pRenderer : this->GetRenderers())
+        if (pRenderer)
+            pRenderer->SetTransferFunctions(m_TransferFunctions, m_SamplingCount);
 
-        m_DiffuseTransferFunc.AddNode(intensity, diffuse);
-        m_SpecularTransferFunc.AddNode(intensity, specular);
-        m_RoughnessTransferFunc.AddNode(intensity, roughness);
-    }
+    // The volume is loaded after the first transfer function
+    if (m_VolumeData.GetMipLevelCount() > 0)
+        this->InitializeMajorantGrid();
+}
+
+void ApplicationVolumeRender::InitializeMajorantGrid() {
 
-    for (auto const& e : root["NodesOpacity"])
-        m_OpacityTransferFunc.AddNode(e["Intensity"].get<F32>(), e["Opacity"].get<F32>());
+    if (m_MajorantGrid.GetMajorants().empty() || m_MajorantGrid.GetMipLevel() != m_MipLevel)
+        m_MajorantGrid.Initialize(m_VolumeData, m_MipLevel);
+    m_MajorantGrid.Update(m_TransferFunctions.Opacity, m_SamplingCount, Shading::GetClipRegion(m_FrameBuffer));
 
-    m_pSRVOpacityTF = m_OpacityTransferFunc.GenerateTexture(m_pDevice, m_SamplingCount);
-    m_pSRVDiffuseTF = m_DiffuseTransferFunc.GenerateTexture(m_pDevice, m_SamplingCount);
-    m_pSRVSpecularTF = m_SpecularTransferFunc.GenerateTexture(m_pDevice, m_SamplingCount);
-    m_pSRVRoughnessTF = m_RoughnessTransferFunc.GenerateTexture(m_pDevice, m_SamplingCount);
+    for (auto pRenderer : this->GetRenderers())
+        if (pRenderer)
+            pRenderer->SetMajorantGrid(&m_MajorantGrid);
 }
 
 void ApplicationVolumeRender::InitializeSamplerStates() {
 
-    auto createSamplerState = [this](auto filter, auto addressMode) -> DX::ComPtr<ID3D11SamplerState> {
-        D3D11_SAMPLER_DESC desc = {};
-        desc.Filter = filter;
-        desc.AddressU = addressMode;
-        desc.AddressV = addressMode;
-        desc.AddressW = addressMode;
-        desc.MaxAnisotropy = D3D11_MAX_MAXANISOTROPY;
-        desc.MaxLOD = FLT_MAX;
-        desc.ComparisonFunc = D3D11_COMPARISON_NEVER;
-
-        DX::ComPtr<ID3D11SamplerState> pSamplerState;
-        DX::ThrowIfFailed(m_pDevice->CreateSamplerState(&desc, pSamplerState.GetAddressOf()));
-        return pSamplerState;
-    };
-
-    m_pSamplerPoint = createSamplerState(D3D11_FILTER_MIN_MAG_MIP_POINT, D3D11_TEXTURE_ADDRESS_BORDER);
-    m_pSamplerLinear = createSamplerState(D3D11_FILTER_MIN_MAG_LINEAR_MIP_POINT, D3D11_TEXTURE_ADDRESS_BORDER);
-    m_pSamplerAnisotropic = createSamplerState(D3D11_FILTER_ANISOTROPIC, D3D11_TEXTURE_ADDRESS_WRAP);
+    D3D11_SAMPLER_DESC desc = {};
+    desc.Filter = D3D11_FILTER_MIN_MAG_LINEAR_MIP_POINT;
+    desc.AddressU = D3D11_TEXTURE_ADDRESS_BORDER;
+    desc.AddressV = D3D11_TEXTURE_ADDRESS_BORDER;
+    desc.AddressW = D3D11_TEXTURE_ADDRESS_BORDER;
+    desc.MaxAnisotropy = D3D11_MAX_MAXANISOTROPY;
+    desc.MaxLOD = FLT_MAX;
+    desc.ComparisonFunc = D3D11_COMPARISON_NEVER;
+    DX::ThrowIfFailed(m_pDevice->CreateSamplerState(&desc, m_pSamplerLinear.ReleaseAndGetAddressOf()));
 }
 
 void ApplicationVolumeRender::InitializeRenderTextures() {
 
-    {
-        D3D11_TEXTURE2D_DESC desc = {};
-        desc.ArraySize = 1;
-        desc.MipLevels = 1;
-        desc.Format = DXGI_FORMAT_R11G11B10_FLOAT;
-        desc.Width = m_ApplicationDesc.Width;
-        desc.Height = m_ApplicationDesc.Height;
-        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
-        desc.SampleDesc.Count = 1;
-        desc.SampleDesc.Quality = 0;
-
-        DX::ComPtr<ID3D11Texture2D> pTextureDiffuse;
-        DX::ThrowIfFailed(m_pDevice->CreateTexture2D(&desc, nullptr, pTextureDiffuse.ReleaseAndGetAddressOf()));
-        DX::ThrowIfFailed(m_pDevice->CreateShaderResourceView(pTextureDiffuse.Get(), nullptr, m_pSRVDiffuse.ReleaseAndGetAddressOf()));
-        DX::ThrowIfFailed(m_pDevice->CreateUnorderedAccessView(pTextureDiffuse.Get(), nullptr, m_pUAVDiffuse.ReleaseAndGetAddressOf()));
-    }
-
-    {
-        D3D11_TEXTURE2D_DESC desc = {};
-        desc.ArraySize = 1;
-        desc.MipLevels = 1;
-        desc.Format = DXGI_FORMAT_R11G11B10_FLOAT;
-        desc.Width = m_ApplicationDesc.Width;
-        desc.Height = m_ApplicationDesc.Height;
-        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
-        desc.SampleDesc.Count = 1;
-        desc.SampleDesc.Quality = 0;
-
-        DX::ComPtr<ID3D11Texture2D> pTextureSpecular;
-        DX::ThrowIfFailed(m_pDevice->CreateTexture2D(&desc, nullptr, pTextureSpecular.ReleaseAndGetAddressOf()));
-        DX::ThrowIfFailed(m_pDevice->CreateShaderResourceView(pTextureSpecular.Get(), nullptr, m_pSRVSpecular.ReleaseAndGetAddressOf()));
-        DX::ThrowIfFailed(m_pDevice->CreateUnorderedAccessView(pTextureSpecular.Get(), nullptr, m_pUAVSpecular.ReleaseAndGetAddressOf()));
-    }
-
-    {
-        D3D11_TEXTURE2D_DESC desc = {};
-        desc.ArraySize = 1;
-        desc.MipLevels = 1;
-        desc.Format = DXGI_FORMAT_R11G11B10_FLOAT;
-        desc.Width = m_ApplicationDesc.Width;
-        desc.Height = m_ApplicationDesc.Height;
-        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
-        desc.SampleDesc.Count = 1;
-        desc.SampleDesc.Quality = 0;
-
-        DX::ComPtr<ID3D11Texture2D> pTextureDiffuseLight;
-        DX::ThrowIfFailed(m_pDevice->CreateTexture2D(&desc, nullptr, pTextureDiffuseLight.ReleaseAndGetAddressOf()));
-        DX::ThrowIfFailed(m_pDevice->CreateShaderResourceView(pTextureDiffuseLight.Get(), nullptr, m_pSRVRadiance.ReleaseAndGetAddressOf()));
-        DX::ThrowIfFailed(m_pDevice->CreateUnorderedAccessView(pTextureDiffuseLight.Get(), nullptr, m_pUAVRadiance.ReleaseAndGetAddressOf()));
-    }
-
-    {
-        D3D11_TEXTURE2D_DESC desc = {};
-        desc.ArraySize = 1;
-        desc.MipLevels = 1;
-        desc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
-        desc.Width = m_ApplicationDesc.Width;
-        desc.Height = m_ApplicationDesc.Height;
-        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
-        desc.SampleDesc.Count = 1;
-        desc.SampleDesc.Quality = 0;
-
-        DX::ComPtr<ID3D11Texture2D> pTextureNormal;
-        DX::ThrowIfFailed(m_pDevice->CreateTexture2D(&desc, nullptr, pTextureNormal.ReleaseAndGetAddressOf()));
-        DX::ThrowIfFailed(m_pDevice->CreateShaderResourceView(pTextureNormal.Get(), nullptr, m_pSRVNormal.ReleaseAndGetAddressOf()));
-        DX::ThrowIfFailed(m_pDevice->CreateUnorderedAccessView(pTextureNormal.Get(), nullptr, m_pUAVNormal.ReleaseAndGetAddressOf()));
-    }
-
-    {
-        D3D11_TEXTURE2D_DESC desc = {};
-        desc.ArraySize = 1;
-        desc.MipLevels = 1;
-        desc.Format = DXGI_FORMAT_R32_FLOAT;
-        desc.Width = m_ApplicationDesc.Width;
-        desc.Height = m_ApplicationDesc.Height;
-        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
-        desc.SampleDesc.Count = 1;
-        desc.SampleDesc.Quality = 0;
-
-        DX::ComPtr<ID3D11Texture2D> pTextureDepth;
-        DX::ThrowIfFailed(m_pDevice->CreateTexture2D(&desc, nullptr, pTextureDepth.ReleaseAndGetAddressOf()));
-        DX::ThrowIfFailed(m_pDevice->CreateShaderResourceView(pTextureDepth.Get(), nullptr, m_pSRVDepth.ReleaseAndGetAddressOf()));
-        DX::ThrowIfFailed(m_pDevice->CreateUnorderedAccessView(pTextureDepth.Get(), nullptr, m_pUAVDepth.ReleaseAndGetAddressOf()));
-    }
-
-    {
-        D3D11_TEXTURE2D_DESC desc = {};
-        desc.ArraySize = 1;
-        desc.MipLevels = 1;
-        desc.Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
-        desc.Width = m_ApplicationDesc.Width;
-        desc.Height = m_ApplicationDesc.Height;
-        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
-        desc.SampleDesc.Count = 1;
-        desc.SampleDesc.Quality = 0;
-
-        DX::ComPtr<ID3D11Texture2D> pTextureColorSum;
-        DX::ThrowIfFailed(m_pDevice->CreateTexture2D(&desc, nullptr, pTextureColorSum.ReleaseAndGetAddressOf()));
-        DX::ThrowIfFailed(m_pDevice->CreateShaderResourceView(pTextureColorSum.Get(), nullptr, m_pSRVColorSum.ReleaseAndGetAddressOf()));
-        DX::ThrowIfFailed(m_pDevice->CreateUnorderedAccessView(pTextureColorSum.Get(), nullptr, m_pUAVColorSum.ReleaseAndGetAddressOf()));
-    }
-
-    {
-        D3D11_TEXTURE2D_DESC desc = {};
-        desc.ArraySize = 1;
-        desc.MipLevels = 1;
-        desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-        desc.Width = m_ApplicationDesc.Width;
-        desc.Height = m_ApplicationDesc.Height;
-        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
-        desc.SampleDesc.Count = 1;
-        desc.SampleDesc.Quality = 0;
-
-        DX::ComPtr<ID3D11Texture2D> pTextureToneMap;
-        DX::ThrowIfFailed(m_pDevice->CreateTexture2D(&desc, nullptr, pTextureToneMap.GetAddressOf()));
-        DX::ThrowIfFailed(m_pDevice->CreateShaderResourceView(pTextureToneMap.Get(), nullptr, m_pSRVToneMap.GetAddressOf()));
-        DX::ThrowIfFailed(m_pDevice->CreateUnorderedAccessView(pTextureToneMap.Get(), nullptr, m_pUAVToneMap.GetAddressOf()));
-    }
+    D3D11_TEXTURE2D_DESC desc = {};
+    desc.ArraySize = 1;
+    desc.MipLevels = 1;
+    desc.Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+    desc.Width = m_ApplicationDesc.Width;
+    desc.Height = m_ApplicationDesc.Height;
+    desc.SampleDesc.Count = 1;
+    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    desc.Usage = D3D11_USAGE_DEFAULT;
+    DX::ThrowIfFailed(m_pDevice->CreateTexture2D(&desc, nullptr, m_pTextureImageCPU.ReleaseAndGetAddressOf()));
+    DX::ThrowIfFailed(m_pDevice->CreateShaderResourceView(m_pTextureImageCPU.Get(), nullptr, m_pSRVImageCPU.ReleaseAndGetAddressOf()));
 }
 
 void ApplicationVolumeRender::InitializeBuffers() {
 
     m_pConstantBufferFrame = DX::CreateConstantBuffer<FrameBuffer>(m_pDevice);
-    m_pDispatchIndirectBufferArgs = DX::CreateIndirectBuffer<DispatchIndirectBuffer>(m_pDevice, DispatchIndirectBuffer{ 1, 1, 1 });
-    m_pDrawInstancedIndirectBufferArgs = DX::CreateIndirectBuffer<DrawInstancedIndirectBuffer>(m_pDevice, DrawInstancedIndirectBuffer{ 0, 1, 0, 0 });
 }
 
-void ApplicationVolumeRender::InitializeTileBuffer() {
+void ApplicationVolumeRender::InitializeEnvironmentMap() {
 
-    const auto threadGroupsX = static_cast<uint32_t>(std::ceil(m_ApplicationDesc.Width / 8));
-    const auto threadGroupsY = static_cast<uint32_t>(std::ceil(m_ApplicationDesc.Height / 8));
+    m_EnvironmentMap.LoadFromFile("content/Textures/qwantani_2k.dds");
+    for (auto pRenderer : this->GetRenderers())
+        if (pRenderer)
+            pRenderer->SetEnvironmentMap(&m_EnvironmentMap);
+}
 
-    DX::ComPtr<ID3D11Buffer> pBuffer = DX::CreateStructuredBuffer<uint32_t>(m_pDevice, threadGroupsX * threadGroupsY, false, true, nullptr);
-    {
-        D3D11_SHADER_RESOURCE_VIEW_DESC desc = {};
-        desc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
-        desc.BufferEx.FirstElement = 0;
-        desc.BufferEx.NumElements = threadGroupsX * threadGroupsY;
-        DX::ThrowIfFailed(m_pDevice->CreateShaderResourceView(pBuffer.Get(), &desc, m_pSRVDispersionTiles.ReleaseAndGetAddressOf()));
-    }
+void ApplicationVolumeRender::InitializeBlueNoise() {
 
-    {
-        D3D11_UNORDERED_ACCESS_VIEW_DESC desc = {};
-        desc.ViewDimension = D3D11_UAV_DIMENSION_BUFFER;
-        desc.Buffer.FirstElement = 0;
-        desc.Buffer.NumElements = threadGroupsX * threadGroupsY;
-        desc.Buffer.Flags = D3D11_BUFFER_UAV_FLAG_APPEND;
-        DX::ThrowIfFailed(m_pDevice->CreateUnorderedAccessView(pBuffer.Get(), &desc, m_pUAVDispersionTiles.ReleaseAndGetAddressOf()));
-    }
+    m_BlueNoise.Initialize(BlueNoise::DefaultSize);
+    for (auto pRenderer : this->GetRenderers())
+        if (pRenderer)
+            pRenderer->SetBlueNoise(&m_BlueNoise);
 }
 
-void ApplicationVolumeRender::InitializeEnvironmentMap() {
+std::unique_ptr<RendererCPU> ApplicationVolumeRender::CreateRendererCPU() const {
 
-    DX::ThrowIfFailed(DirectX::CreateDDSTextureFromFile(m_pDevice.Get(), L"content/Textures/qwantani_2k.dds", nullptr, m_pSRVEnvironment.GetAddressOf()));
+    // The transfer functions go first, the gradient is computed with the opacity
+    auto pRenderer = std::make_unique<RendererCPU>(*m_pThreadPool);
+    pRenderer->SetTransferFunctions(m_TransferFunctions, m_SamplingCount);
+    pRenderer->SetVolume(&m_VolumeData);
+    pRenderer->SetEnvironmentMap(&m_EnvironmentMap);
+    pRenderer->SetMajorantGrid(&m_MajorantGrid);
+    pRenderer->SetBlueNoise(&m_BlueNoise);
+    return pRenderer;
 }
 
 void ApplicationVolumeRender::Resize(int32_t width, int32_t height)
 {
     Base::Resize(width, height);
     InitializeRenderTextures();
-    InitializeTileBuffer();
+    m_pRendererD3D11->Resize(width, height);
     m_FrameIndex = 0;
 }
 
 void ApplicationVolumeRender::EventMouseWheel(float delta) {
 
     m_Zoom -= m_ZoomSensitivity * m_DeltaTime * delta;
+    m_InteractionTime = std::chrono::high_resolution_clock::now();
     m_FrameIndex = 0;
 }
 
@@ -530,16 +187,111 @@ void ApplicationVolumeRender::EventMouseMove(float x, float y) {
 
     m_Camera.Rotate(Hawk::Components::Camera::LocalUp, m_DeltaTime * -m_RotateSensitivity * x);
     m_Camera.Rotate(m_Camera.Right(), m_DeltaTime * -m_RotateSensitivity * y);
+    m_InteractionTime = std::chrono::high_resolution_clock::now();
     m_FrameIndex = 0;
 }
 
+void ApplicationVolumeRender::UpdateResolutionScale() {
+
+    // The time of the frames comes back a few frames late from a GPU, the wall time would be bound by the VSync
+    ResolutionController::Desc desc = {};
+    desc.FrameTimeTarget = FrameTimeTargets[m_FrameTimeTarget];
+    m_ResolutionController.SetDesc(desc);
+
+    F32 frameTime = 0.0f;
+    Hawk::Math::Vec2u frameDimension = {};
+    while (m_pRenderer->ReadFrameTime(frameTime, frameDimension)) {
+        m_FrameTime = frameTime;
+        m_ResolutionController.Update(frameTime, F32(frameDimension.x) / F32(m_ApplicationDesc.Width));
+    }
+
+    // The controller holds the frame time target at any volume. With progressive refinement the frames accumulate
+    // at full resolution once the input stops, only the frames of a moving camera are scaled.
+    const bool isInteraction = std::chrono::duration<float>(std::chrono::high_resolution_clock::now() - m_InteractionTime).count() < InteractionTimeout;
+    const float scale = m_IsDynamicResolution && (isInteraction || !m_IsProgressiveRefinement) ? m_ResolutionController.GetScale() : 1.0f;
+
+    if (scale != m_ResolutionScale) {
+        m_ResolutionScale = scale;
+        m_FrameIndex = 0;
+    }
+}
+
+Hawk::Math::Vec2u ApplicationVolumeRender::GetRenderDimension() const {
+
+    return ResolutionController::GetRenderDimension(m_ApplicationDesc.Width, m_ApplicationDesc.Height, m_ResolutionScale);
+}
+
+void ApplicationVolumeRender::UpdateConvergence() {
+
+    if (m_FrameIndex == 0) {
+        m_IsConverged = false;
+        m_ActiveTileCount = std::numeric_limits<uint32_t>::max();
+        m_ActiveTilePassCount = std::numeric_limits<uint32_t>::max();
+        m_ConvergenceStart = std::chrono::high_resolution_clock::now();
+        return;
+    }
+
+    m_ActiveTileCount = m_pRenderer->ReadActiveTileCount();
+    m_ActiveTilePassCount = m_pRenderer->GetActiveTilePassCount();
+
+    // Every tile is selected during the dispersion frames, so no active tiles means every tile met the error threshold
+    const bool isFrameLimit = m_FrameIndexMax > 0 && m_FrameIndex >= m_FrameIndexMax;
+    if (!m_IsConverged && (isFrameLimit || m_ActiveTileCount == 0)) {
+        m_IsConverged = true;
+        m_ConvergenceTime = std::chrono::duration<float>(std::chrono::high_resolution_clock::now() - m_ConvergenceStart).count();
+    }
+}
+
+void ApplicationVolumeRender::UpdateStatistics() {
+
+    // The count of frame 0 is not known yet, every tile of it is rendered. The count and the render time
+    // of a GPU come back late and a frame or two apart, the samples per second hold on average.
+    // The edge tiles are clipped to the image, the GPU does not report which tiles ran, so its
+    // tile passes are assumed to cover the image evenly. The CPU counts the samples it took.
+    const uint32_t tileSize = m_pRenderer->GetTileSize();
+    const Hawk::Math::Vec2u renderDimension = this->GetRenderDimension();
+    const uint32_t tileCountMax = ((renderDimension.x + tileSize - 1) / tileSize) * ((renderDimension.y + tileSize - 1) / tileSize);
+    const uint32_t tileCount = m_ActiveTileCount != std::numeric_limits<uint32_t>::max() ? m_ActiveTileCount : tileCountMax;
+    const uint32_t tilePassCount = m_ActiveTilePassCount != std::numeric_limits<uint32_t>::max() ? m_ActiveTilePassCount : tileCount;
+    const uint64_t pixelCount = uint64_t(renderDimension.x) * renderDimension.y;
+
+    RenderStatistics::Frame frame = {};
+    frame.FrameTime = m_DeltaTime;
+    frame.RenderTime = m_FrameTime;
+    frame.SampleCount = tileCountMax > 0 ? pixelCount * tilePassCount / tileCountMax : 0;
+    frame.ActiveTileCount = tileCount;
+    if (m_RendererType == RendererTypeCPU && m_pRendererCPU->GetFrameStatistics().FrameTime > 0.0) {
+        frame.SampleCount = m_pRendererCPU->GetFrameStatistics().SampleCount;
+        frame.ActiveTileCount = m_pRendererCPU->GetFrameStatistics().TileCount;
+    }
+    m_Statistics.AddFrame(frame);
+}
+
 void ApplicationVolumeRender::Update(float deltaTime) {
 
     m_DeltaTime = deltaTime;
+    this->UpdateResolutionScale();
+    this->UpdateConvergence();
+
+    // Nothing is rendered once the image has converged
+    if (!m_IsConverged)
+        this->UpdateStatistics();
+
+    // The backend overrides the exposure of the frame while it adapts, the slider starts from the last one
+    for (auto pRenderer : this->GetRenderers()) {
+        if (pRenderer) {
+            pRenderer->SetAutoExposure(m_IsAutoExposure);
+            pRenderer->SetAutoExposureDesc(m_AutoExposureDesc);
+            pRenderer->SetSampleDispersion(m_SampleDispersion);
+        }
+    }
+    if (m_IsAutoExposure && m_pRenderer->GetAutoExposure().IsAdapted())
+        m_Exposure = m_pRenderer->GetExposure();
 
     try {
         if (m_IsReloadShader) {
             InitializeShaders();
+            m_pRendererD3D11->ReloadShaders();
             m_IsReloadShader = false;
         }
 
@@ -548,55 +300,64 @@ void ApplicationVolumeRender::Update(float deltaTime) {
             m_IsReloadTransferFunc = false;
         }
 
+        if (m_MajorantGrid.GetMipLevel() != m_MipLevel)
+            InitializeMajorantGrid();
+
+        // Culls the macrocells outside of the new region, the clipping itself is done per ray
+        if (m_IsUpdateClipRegion) {
+            const auto cropBoxTransform = Hawk::Math::Translate(m_CropBoxTranslation) *
+                Hawk::Math::RotateZ(Hawk::Math::Radians(m_CropBoxRotation.z)) *
+                Hawk::Math::RotateY(Hawk::Math::Radians(m_CropBoxRotation.y)) *
+                Hawk::Math::RotateX(Hawk::Math::Radians(m_CropBoxRotation.x));
+            SetFrameClipRegion(m_FrameBuffer, std::span(std::data(m_ClipPlanes), m_ClipPlaneCount), m_CropBox, cropBoxTransform);
+            InitializeMajorantGrid();
+            m_IsUpdateClipRegion = false;
+        }
+
     } catch (std::exception const& e) {
         std::cout << e.what() << std::endl;
     }
 
-    Hawk::Math::Vec3 scaleVector = { 0.488f * m_DimensionX, 0.488f * m_DimensionY, 0.7f * m_DimensionZ };
-    scaleVector /= (std::max)({ scaleVector.x, scaleVector.y, scaleVector.z });
+    // Reduced resolution frames render into the top left corner of the render textures, the blit stretches it
+    const auto renderDimension = this->GetRenderDimension();
 
     Hawk::Math::Mat4x4 V = m_Camera.ToMatrix();
-    Hawk::Math::Mat4x4 P = Hawk::Math::Orthographic(m_Zoom * (m_ApplicationDesc.Width / static_cast<F32>(m_ApplicationDesc.Height)), m_Zoom, -1.0f, 1.0f);
-    Hawk::Math::Mat4x4 W = Hawk::Math::RotateX(Hawk::Math::Radians(-90.0f)) * Hawk::Math::Scale(scaleVector);
-    Hawk::Math::Mat4x4 N = Hawk::Math::Inverse(Hawk::Math::Transpose(W));
-
-    Hawk::Math::Mat4x4 VP = P * V;
-    Hawk::Math::Mat4x4 NV = V * N;
-    Hawk::Math::Mat4x4 WVP = P * V * W;
-
-    {
-        DX::MapHelper<FrameBuffer> map(m_pImmediateContext, m_pConstantBufferFrame, D3D11_MAP_WRITE_DISCARD, 0);
-
-        map->ProjectionMatrix = P;
-        map->ViewMatrix = V;
-        map->WorldMatrix = W;
-        map->NormalMatrix = N;
-
-        map->InvProjectionMatrix = Hawk::Math::Inverse(P);
-        map->InvViewMatrix = Hawk::Math::Inverse(V);
-        map->InvWorldMatrix = Hawk::Math::Inverse(W);
-        map->InvNormalMatrix = Hawk::Math::Inverse(N);
+    Hawk::Math::Mat4x4 P = ComputeProjectionMatrix(m_Zoom, renderDimension.x, renderDimension.y);
+    Hawk::Math::Mat4x4 W = ComputeWorldMatrix(m_DimensionX, m_DimensionY, m_DimensionZ);
+    SetFrameMatrices(m_FrameBuffer, W, V, P);
 
-        map->ViewProjectionMatrix = VP;
-        map->NormalViewMatrix = NV;
-        map->WorldViewProjectionMatrix = WVP;
+    if (m_IsContentBoundingBox)
+        SetFrameBoundingBox(m_FrameBuffer, m_MajorantGrid.GetContentMin(), m_MajorantGrid.GetContentMax());
+    else
+        SetFrameBoundingBox(m_FrameBuffer, Hawk::Math::Vec3(0.0f, 0.0f, 0.0f), Hawk::Math::Vec3(1.0f, 1.0f, 1.0f));
 
-        map->InvViewProjectionMatrix = Hawk::Math::Inverse(VP);
-        map->InvNormalViewMatrix = Hawk::Math::Inverse(NV);
-        map->InvWorldViewProjectionMatrix = Hawk::Math::Inverse(WVP);
+    m_FrameBuffer.StepSize = Hawk::Math::Distance(VolumeBoundingBoxMin, VolumeBoundingBoxMax) / m_StepCount;
 
-        map->BoundingBoxMin = m_BoundingBoxMin;
-        map->BoundingBoxMax = m_BoundingBoxMax;
-
-        map->StepSize = Hawk::Math::Distance(map->BoundingBoxMin, map->BoundingBoxMax) / m_StepCount;
+    if (m_IsAutomaticLevelOfDetail) {
+        const F32 footprintLevel = ComputeFootprintLevelOfDetail(W, Hawk::Math::Vec3u(m_DimensionX, m_DimensionY, m_DimensionZ), m_Zoom, renderDimension.y);
+        SetFrameLevelOfDetail(m_FrameBuffer, footprintLevel + m_LevelOfDetailBias, m_MipLevel, m_MajorantGrid.GetMipLevelMax(), m_LevelOfDetailDepthBias);
+    } else {
+        SetFrameLevelOfDetail(m_FrameBuffer, F32(m_MipLevel), m_MipLevel, m_MipLevel, 0);
+    }
 
-        map->Density = m_Density;
-        map->FrameIndex = m_FrameIndex;
-        map->Exposure = m_Exposure;
+    m_FrameBuffer.Density = m_Density;
+    m_FrameBuffer.FrameIndex = m_FrameIndex;
+    m_FrameBuffer.Exposure = m_Exposure;
+    m_FrameBuffer.TrackingMode = m_TrackingMode;
+    m_FrameBuffer.TransmittanceEstimator = m_TransmittanceEstimator;
+    m_FrameBuffer.LightSampling = m_LightSampling;
+    m_FrameBuffer.SampleSequence = m_SampleSequence;
+    m_FrameBuffer.TileErrorThreshold = m_TileErrorThreshold;
+    m_FrameBuffer.BlueNoiseSize = m_BlueNoise.GetSize();
+    m_FrameBuffer.EnvironmentDimension = Hawk::Math::Vec2u(m_EnvironmentMap.GetWidth(), m_EnvironmentMap.GetHeight());
+    m_FrameBuffer.MajorantGridDimension = m_MajorantGrid.GetDimension();
+
+    m_FrameBuffer.RenderTargetDim = Hawk::Math::Vec2(static_cast<F32>(renderDimension.x), static_cast<F32>(renderDimension.y));
+    m_FrameBuffer.InvRenderTargetDim = Hawk::Math::Vec2(1.0f, 1.0f) / m_FrameBuffer.RenderTargetDim;
 
-        map->FrameOffset = Hawk::Math::Vec2(m_RandomDistribution(m_RandomGenerator), m_RandomDistribution(m_RandomGenerator));
-        map->RenderTargetDim = Hawk::Math::Vec2(static_cast<F32>(m_ApplicationDesc.Width), static_cast<F32>(m_ApplicationDesc.Height));
-        map->InvRenderTargetDim = Hawk::Math::Vec2(1.0f, 1.0f) / map->RenderTargetDim;
+    {
+        DX::MapHelper<FrameBuffer> map(m_pImmediateContext, m_pConstantBufferFrame, D3D11_MAP_WRITE_DISCARD, 0);
+        *map = m_FrameBuffer;
     }
 }
 
@@ -613,7 +374,7 @@ void ApplicationVolumeRender::TextureBlit(DX::ComPtr<ID3D11ShaderResourceView> p
     // Bind PSO and Resources
     m_PSOBlit.Apply(m_pImmediateContext);
     m_pImmediateContext->PSSetShaderResources(0, 1, pSrc.GetAddressOf());
-    m_pImmediateContext->PSSetSamplers(0, 1, m_pSamplerPoint.GetAddressOf());
+    m_pImmediateContext->PSSetSamplers(0, 1, m_pSamplerLinear.GetAddressOf());
 
     // Execute
     m_pImmediateContext->Draw(6, 0);
@@ -629,176 +390,94 @@ void ApplicationVolumeRender::TextureBlit(DX::ComPtr<ID3D11ShaderResourceView> p
     m_pImmediateContext->PSSetShaderResources(0, _countof(ppSRVClear), ppSRVClear);
 }
 
-void ApplicationVolumeRender::RenderFrame(DX::ComPtr<ID3D11RenderTargetView> pRTV) {
-
-    ID3D11UnorderedAccessView* ppUAVClear[] = { nullptr, nullptr, nullptr, nullptr };
-    ID3D11ShaderResourceView* ppSRVClear[] = { nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr };
+void ApplicationVolumeRender::CompareWithRendererCPU() {
 
-    const auto threadGroupsX = static_cast<uint32_t>(std::ceil(m_ApplicationDesc.Width / 8.0f));
-    const auto threadGroupsY = static_cast<uint32_t>(std::ceil(m_ApplicationDesc.Height / 8.0f));
+    const uint32_t frameCount = m_FrameIndex;
+    if (frameCount == 0)
+        return;
 
-    m_pImmediateContext->VSSetConstantBuffers(0, 1, m_pConstantBufferFrame.GetAddressOf());
-    m_pImmediateContext->GSSetConstantBuffers(0, 1, m_pConstantBufferFrame.GetAddressOf());
-    m_pImmediateContext->PSSetConstantBuffers(0, 1, m_pConstantBufferFrame.GetAddressOf());
-    m_pImmediateContext->CSSetConstantBuffers(0, 1, m_pConstantBufferFrame.GetAddressOf());
-
-    if (m_FrameIndex < m_SampleDispersion) {
-        ID3D11UnorderedAccessView* ppUAVResources[] = { m_pUAVDispersionTiles.Get() };
-        constexpr uint32_t pCounters[] = { 0 };
-
-        m_pAnnotation->BeginEvent(L"Render Pass: Reset computed tiles");
-        m_PSOResetTiles.Apply(m_pImmediateContext);
-        m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVResources), ppUAVResources, pCounters);
-        m_pImmediateContext->Dispatch(threadGroupsX, threadGroupsY, 1);
-        m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVClear), ppUAVClear, nullptr);
-        m_pAnnotation->EndEvent();
-    } else {
-        ID3D11ShaderResourceView* ppSRVResources[] = { m_pSRVToneMap.Get(), m_pSRVDepth.Get() };
-        ID3D11UnorderedAccessView* ppUAVResources[] = { m_pUAVDispersionTiles.Get() };
-        constexpr uint32_t pCounters[] = { 0 };
-
-        m_pAnnotation->BeginEvent(L"Render Pass: Generate computed tiles");
-        m_PSOComputeTiles.Apply(m_pImmediateContext);
-        m_pImmediateContext->CSSetShaderResources(0, _countof(ppSRVResources), ppSRVResources);
-        m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVResources), ppUAVResources, pCounters);
-        m_pImmediateContext->Dispatch(threadGroupsX, threadGroupsY, 1);
-        m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVClear), ppUAVClear, nullptr);
-        m_pImmediateContext->CSSetShaderResources(0, _countof(ppSRVClear), ppSRVClear);
-        m_pAnnotation->EndEvent();
-    }
+    if (!m_pRendererReference)
+        m_pRendererReference = this->CreateRendererCPU();
 
-    constexpr float clearColor[] = { 0.0f, 0.0f, 0.0f, 0.0f };
-    m_pAnnotation->BeginEvent(L"Render Pass: Clear buffers [Color, Normal, Depth]");
-    m_pImmediateContext->ClearUnorderedAccessViewFloat(m_pUAVDiffuse.Get(), clearColor);
-    m_pImmediateContext->ClearUnorderedAccessViewFloat(m_pUAVNormal.Get(), clearColor);
-    m_pImmediateContext->ClearUnorderedAccessViewFloat(m_pUAVDepth.Get(), clearColor);
-    m_pImmediateContext->ClearUnorderedAccessViewFloat(m_pUAVRadiance.Get(), clearColor);
-    m_pAnnotation->EndEvent();
+    // The backend has accumulated frames [0, frameCount) with the current camera, the reference replays the same sequence
+    const auto renderDimension = this->GetRenderDimension();
+    m_pRendererReference->Resize(renderDimension.x, renderDimension.y);
+    m_pRendererReference->SetSampleDispersion(m_SampleDispersion);
 
-    m_pAnnotation->BeginEvent(L"Render Pass: Copy counters of tiles");
-    m_pImmediateContext->CopyStructureCount(m_pDispatchIndirectBufferArgs.Get(), 0, m_pUAVDispersionTiles.Get());
-    m_pImmediateContext->CopyStructureCount(m_pDrawInstancedIndirectBufferArgs.Get(), 0, m_pUAVDispersionTiles.Get());
-    m_pAnnotation->EndEvent();
-
-    {
-        ID3D11SamplerState* ppSamplers[] = {
-            m_pSamplerPoint.Get(),
-            m_pSamplerLinear.Get(),
-            m_pSamplerAnisotropic.Get()
-        };
-
-        ID3D11ShaderResourceView* ppSRVResources[] = {
-            m_pSRVVolumeIntensity[m_MipLevel].Get(),
-            m_pSRVGradient.Get(),
-            m_pSRVDiffuseTF.Get(),
-            m_pSRVSpecularTF.Get(),
-            m_pSRVRoughnessTF.Get(),
-            m_pSRVOpacityTF.Get(),
-            m_pSRVDispersionTiles.Get()
-        };
-
-        ID3D11UnorderedAccessView* ppUAVResources[] = {
-            m_pUAVDiffuse.Get(),
-            m_pUAVSpecular.Get(),
-            m_pUAVNormal.Get(),
-            m_pUAVDepth.Get()
-        };
-
-        m_pAnnotation->BeginEvent(L"Render pass: Generate Rays");
-        m_PSOGeneratePrimaryRays.Apply(m_pImmediateContext);
-        m_pImmediateContext->CSSetSamplers(0, _countof(ppSamplers), ppSamplers);
-        m_pImmediateContext->CSSetShaderResources(0, _countof(ppSRVResources), ppSRVResources);
-        m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVResources), ppUAVResources, nullptr);
-        m_pImmediateContext->DispatchIndirect(m_pDispatchIndirectBufferArgs.Get(), 0);
-        m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVClear), ppUAVClear, nullptr);
-        m_pImmediateContext->CSSetShaderResources(0, _countof(ppSRVClear), ppSRVClear);
-        m_pAnnotation->EndEvent();
+    FrameBuffer frame = m_FrameBuffer;
+    for (uint32_t frameIndex = 0; frameIndex < frameCount; frameIndex++) {
+        frame.FrameIndex = frameIndex;
+        m_pRendererReference->RenderFrame(frame);
     }
 
-    {
-        ID3D11SamplerState* ppSamplers[] = {
-            m_pSamplerPoint.Get(),
-            m_pSamplerLinear.Get(),
-            m_pSamplerAnisotropic.Get()
-        };
-
-        ID3D11ShaderResourceView* ppSRVResources[] = {
-            m_pSRVVolumeIntensity[m_MipLevel].Get(),
-            m_pSRVOpacityTF.Get(),
-            m_pSRVDiffuse.Get(),
-            m_pSRVSpecular.Get(),
-            m_pSRVNormal.Get(),
-            m_pSRVDepth.Get(),
-            m_pSRVEnvironment.Get(),
-            m_pSRVDispersionTiles.Get()
-        };
-
-        ID3D11UnorderedAccessView* ppUAVResources[] = {
-            m_pUAVRadiance.Get()
-        };
-
-        m_pAnnotation->BeginEvent(L"Render pass: Compute Radiance");
-        m_PSOComputeDiffuseLight.Apply(m_pImmediateContext);
-        m_pImmediateContext->CSSetSamplers(0, _countof(ppSamplers), ppSamplers);
-        m_pImmediateContext->CSSetShaderResources(0, _countof(ppSRVResources), ppSRVResources);
-        m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVResources), ppUAVResources, nullptr);
-        m_pImmediateContext->DispatchIndirect(m_pDispatchIndirectBufferArgs.Get(), 0);
-        m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVClear), ppUAVClear, nullptr);
-        m_pImmediateContext->CSSetShaderResources(0, _countof(ppSRVClear), ppSRVClear);
-        m_pAnnotation->EndEvent();
+    // The D3D11 backend renders into the corner of textures of the window size
+    std::vector<Hawk::Math::Vec4> colorSum;
+    m_pRenderer->ReadColorSum(colorSum);
+    const uint32_t width = renderDimension.x;
+    const uint32_t height = renderDimension.y;
+    const uint32_t pitch = m_RendererType == RendererTypeCPU ? m_pRendererCPU->GetWidth() : m_ApplicationDesc.Width;
+    if (pitch < width || std::size(colorSum) < size_t(pitch) * height)
+        return;
+
+    F64 sumSquaredError = 0.0;
+    F64 sumGPU = 0.0;
+    F64 sumCPU = 0.0;
+    uint64_t mismatchCount = 0;
+
+    auto const& colorSumCPU = m_pRendererReference->GetColorSum();
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            auto const& colorGPU = colorSum[size_t(y) * pitch + x];
+            auto const& colorCPU = colorSumCPU[size_t(y) * width + x];
+
+            F64 pixelError = 0.0;
+            for (uint32_t channel = 0; channel < 3; channel++) {
+                const F64 delta = F64(colorGPU[channel]) - F64(colorCPU[channel]);
+                pixelError += delta * delta;
+                sumGPU += colorGPU[channel];
+                sumCPU += colorCPU[channel];
+            }
+            sumSquaredError += pixelError;
+            mismatchCount += pixelError > 1.0e-4 ? 1 : 0;
+        }
     }
 
-    {
-        ID3D11ShaderResourceView* ppSRVResources[] = { m_pSRVRadiance.Get(),  m_pSRVDispersionTiles.Get() };
-        ID3D11UnorderedAccessView* ppUAVResources[] = { m_pUAVColorSum.Get() };
-
-        m_pAnnotation->BeginEvent(L"Render Pass: Accumulate");
-        m_PSOAccumulate.Apply(m_pImmediateContext);
-        m_pImmediateContext->CSSetShaderResources(0, _countof(ppSRVResources), ppSRVResources);
-        m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVResources), ppUAVResources, nullptr);
-        m_pImmediateContext->DispatchIndirect(m_pDispatchIndirectBufferArgs.Get(), 0);
-        m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVClear), ppUAVClear, nullptr);
-        m_pImmediateContext->CSSetShaderResources(0, _countof(ppSRVClear), ppSRVClear);
-        m_pAnnotation->EndEvent();
-    }
+    const F64 valueCount = 3.0 * width * height;
+    m_ComparisonCPU = fmt::format("Frames: {}\nRMSE: {:.6f}\nMean backend/CPU: {:.6f} / {:.6f}\nMismatched pixels: {:.3f}%",
+        frameCount, std::sqrt(sumSquaredError / valueCount), sumGPU / valueCount, sumCPU / valueCount, 100.0 * mismatchCount / (width * height));
+    std::cout << m_ComparisonCPU << std::endl;
+}
 
-    {
-        ID3D11ShaderResourceView* ppSRVResources[] = { m_pSRVColorSum.Get(), m_pSRVDispersionTiles.Get() };
-        ID3D11UnorderedAccessView* ppUAVResources[] = { m_pUAVToneMap.Get() };
-
-        m_pAnnotation->BeginEvent(L"Render Pass: Tone Map");
-        m_PSOToneMap.Apply(m_pImmediateContext);
-        m_pImmediateContext->CSSetShaderResources(0, _countof(ppSRVResources), ppSRVResources);
-        m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVResources), ppUAVResources, nullptr);
-        m_pImmediateContext->DispatchIndirect(m_pDispatchIndirectBufferArgs.Get(), 0);
-        m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVClear), ppUAVClear, nullptr);
-        m_pImmediateContext->CSSetShaderResources(0, _countof(ppSRVClear), ppSRVClear);
-        m_pAnnotation->EndEvent();
-    }
+void ApplicationVolumeRender::RenderFrame(DX::ComPtr<ID3D11RenderTargetView> pRTV) {
 
-    m_pAnnotation->BeginEvent(L"Render Pass: TextureBlit [Tone Map] -> [Back Buffer]");
-    this->TextureBlit(m_pSRVToneMap, pRTV);
-    m_pAnnotation->EndEvent();
+    m_pImmediateContext->PSSetConstantBuffers(0, 1, m_pConstantBufferFrame.GetAddressOf());
 
-    if (m_IsDrawDebugTiles) {
-        ID3D11ShaderResourceView* ppSRVResources[] = { m_pSRVDispersionTiles.Get() };
-        D3D11_VIEWPORT viewport = { 0.0f, 0.0f, static_cast<float>(m_ApplicationDesc.Width), static_cast<float>(m_ApplicationDesc.Height), 0.0f, 1.0f };
+    // The accumulated image does not change any more, it is only presented again. A new exposure tone maps it
+    // again without rendering, the frames before convergence pick it up themselves.
+    if (!m_IsConverged) {
+        if (m_RendererType == RendererTypeCPU) {
+            const auto renderDimension = this->GetRenderDimension();
+            if (m_pRendererCPU->GetWidth() != renderDimension.x || m_pRendererCPU->GetHeight() != renderDimension.y)
+                m_pRendererCPU->Resize(renderDimension.x, renderDimension.y);
+        }
+        m_pRenderer->RenderFrame(m_FrameBuffer);
+        m_FrameIndex++;
+    } else if (m_IsExposureChanged) {
+        m_pRenderer->ToneMapImage(m_FrameBuffer);
+    }
+    m_IsExposureChanged = false;
 
-        m_pAnnotation->BeginEvent(L"Render Pass: Debug -> [Generated tiles]");
-        m_pImmediateContext->OMSetRenderTargets(1, pRTV.GetAddressOf(), nullptr);
-        m_pImmediateContext->RSSetViewports(1, &viewport);
+    m_pProfilerD3D11->BeginScope("Blit");
+    if (m_RendererType == RendererTypeCPU) {
+        const D3D11_BOX box = { 0, 0, 0, m_pRendererCPU->GetWidth(), m_pRendererCPU->GetHeight(), 1 };
+        m_pImmediateContext->UpdateSubresource(m_pTextureImageCPU.Get(), 0, &box, std::data(m_pRendererCPU->GetToneMap()), sizeof(Hawk::Math::Vec4) * m_pRendererCPU->GetWidth(), 0);
+    }
 
-        m_PSODegugTiles.Apply(m_pImmediateContext);
-        m_pImmediateContext->VSSetShaderResources(0, _countof(ppSRVResources), ppSRVResources);
-        m_pImmediateContext->DrawInstancedIndirect(m_pDrawInstancedIndirectBufferArgs.Get(), 0);
+    this->TextureBlit(m_RendererType == RendererTypeCPU ? m_pSRVImageCPU : m_pRendererD3D11->GetToneMap(), pRTV);
+    m_pProfilerD3D11->EndScope();
 
-        m_pImmediateContext->VSSetShaderResources(0, _countof(ppSRVClear), ppSRVClear);
-        m_PSODefault.Apply(m_pImmediateContext);
-        m_pImmediateContext->RSSetViewports(0, nullptr);
-        m_pImmediateContext->OMSetRenderTargets(0, nullptr, nullptr);
-        m_pAnnotation->EndEvent();
-    }
-    m_FrameIndex++;
+    if (m_IsDrawDebugTiles && m_RendererType == RendererTypeD3D11)
+        m_pRendererD3D11->DrawTiles(pRTV, m_ApplicationDesc.Width, m_ApplicationDesc.Height);
 }
 
 void ApplicationVolumeRender::RenderGUI(DX::ComPtr<ID3D11RenderTargetView> pRTV) {
@@ -809,10 +488,14 @@ void ApplicationVolumeRender::RenderGUI(DX::ComPtr<ID3D11RenderTargetView> pRTV)
 
     static bool isShowAppMetrics = false;
     static bool isShowAppAbout = false;
+    static bool isShowAppPerformance = false;
 
     if (isShowAppMetrics)
         ImGui::ShowMetricsWindow(&isShowAppMetrics);
 
+    if (isShowAppPerformance)
+        this->RenderGUIPerformance(&isShowAppPerformance);
+
     if (isShowAppAbout)
         ImGui::ShowAboutWindow(&isShowAppAbout);
 
@@ -824,8 +507,8 @@ void ApplicationVolumeRender::RenderGUI(DX::ComPtr<ID3D11RenderTargetView> pRTV)
 
         for (uint32_t index = 0; index < m_SamplingCount; index++) {
             const float x = (index / static_cast<float>(m_SamplingCount - 1));
-            const float y = m_OpacityTransferFunc.Evaluate(x);
-            opacity[index] = ImVec2(x * (m_OpacityTransferFunc.PLF.RangeMax - m_OpacityTransferFunc.PLF.RangeMin) + m_OpacityTransferFunc.PLF.RangeMin, y);
+            const float y = m_TransferFunctions.Opacity.Evaluate(x);
+            opacity[index] = ImVec2(x * (m_TransferFunctions.Opacity.PLF.RangeMax - m_TransferFunctions.Opacity.PLF.RangeMin) + m_TransferFunctions.Opacity.PLF.RangeMin, y);
         }
         ImPlot::PushStyleVar(ImPlotStyleVar_FillAlpha, 0.25f);
         ImPlot::PlotShaded("Opacity", &opacity[0].x, &opacity[0].y, std::size(opacity), 0, 0, sizeof(ImVec2));
@@ -837,25 +520,167 @@ void ApplicationVolumeRender::RenderGUI(DX::ComPtr<ID3D11RenderTargetView> pRTV)
     ImGui::End();
     */
 
+    if (ImGui::Combo("Renderer", reinterpret_cast<int32_t*>(&m_RendererType), "D3D11\0CPU\0")) {
+        if (m_RendererType == RendererTypeCPU && !m_pRendererCPU) {
+            m_pRendererCPU = this->CreateRendererCPU();
+            m_pRendererCPU->SetProfiler(m_pProfiler.get());
+        }
+        m_pRenderer = m_RendererType == RendererTypeCPU ? static_cast<RenderBackend*>(m_pRendererCPU.get()) : m_pRendererD3D11.get();
+        m_Statistics.Clear();
+        m_FrameIndex = 0;
+    }
+
     if (ImGui::CollapsingHeader("Camera")) {
         ImGui::SliderFloat("Rotate sensitivity", &m_RotateSensitivity, 0.1f, 10.0f);
         ImGui::SliderFloat("Zoom sensitivity", &m_ZoomSensitivity, 0.1f, 10.0f);
+        ImGui::Checkbox("Dynamic resolution", &m_IsDynamicResolution);
+        if (m_IsDynamicResolution) {
+            ImGui::Combo("Frame time target", reinterpret_cast<int32_t*>(&m_FrameTimeTarget), "16 ms\0" "33 ms\0");
+            ImGui::Checkbox("Progressive refinement", &m_IsProgressiveRefinement);
+        }
     }
 
     if (ImGui::CollapsingHeader("Volume")) {
-        ImGui::SliderFloat("Density", &m_Density, 0.1f, 100.0f);
-        ImGui::SliderInt("Step count", reinterpret_cast<int32_t*>(&m_StepCount), 1, 512);
+        m_FrameIndex = ImGui::SliderFloat("Density", &m_Density, 0.1f, 100.0f) ? 0 : m_FrameIndex;
+        m_FrameIndex = ImGui::Combo("Tracking", reinterpret_cast<int32_t*>(&m_TrackingMode), "Ray marching\0Delta tracking\0") ? 0 : m_FrameIndex;
+        if (m_TrackingMode == TrackingModeRayMarching)
+            m_FrameIndex = ImGui::SliderInt("Step count", reinterpret_cast<int32_t*>(&m_StepCount), 1, 512) ? 0 : m_FrameIndex;
+        m_FrameIndex = ImGui::Checkbox("Clip to content", &m_IsContentBoundingBox) ? 0 : m_FrameIndex;
+        m_FrameIndex = ImGui::Combo("Transmittance", reinterpret_cast<int32_t*>(&m_TransmittanceEstimator), "Tracking\0Ratio tracking\0Residual ratio tracking\0") ? 0 : m_FrameIndex;
+        m_FrameIndex = ImGui::Combo("Light sampling", reinterpret_cast<int32_t*>(&m_LightSampling), "BSDF\0Next-event MIS\0") ? 0 : m_FrameIndex;
+        m_FrameIndex = ImGui::Combo("Sample sequence", reinterpret_cast<int32_t*>(&m_SampleSequence), "Random\0Sobol (Owen)\0Rank-1 blue noise\0") ? 0 : m_FrameIndex;
+        m_FrameIndex = ImGui::SliderFloat("Tile error threshold", &m_TileErrorThreshold, 0.0f, 1.0f) ? 0 : m_FrameIndex;
         m_FrameIndex = ImGui::SliderInt("Mip Level", reinterpret_cast<int32_t*>(&m_MipLevel), 0, m_DimensionMipLevels - 1) ? 0 : m_FrameIndex;
+        m_FrameIndex = ImGui::Checkbox("Automatic LOD", &m_IsAutomaticLevelOfDetail) ? 0 : m_FrameIndex;
+        if (m_IsAutomaticLevelOfDetail) {
+            m_FrameIndex = ImGui::SliderFloat("LOD bias", &m_LevelOfDetailBias, -2.0f, 2.0f) ? 0 : m_FrameIndex;
+            m_FrameIndex = ImGui::SliderInt("LOD depth bias", reinterpret_cast<int32_t*>(&m_LevelOfDetailDepthBias), 0, 3) ? 0 : m_FrameIndex;
+            ImGui::Text("LOD: %u (secondary %u)", m_FrameBuffer.LevelOfDetail, std::min(m_FrameBuffer.LevelOfDetail + m_FrameBuffer.LevelOfDetailDepthBias, m_FrameBuffer.LevelOfDetailMax));
+        }
     }
 
-    if (ImGui::CollapsingHeader("Post-Processing"))
-        ImGui::SliderFloat("Exposure", &m_Exposure, 4.0f, 100.0f);
+    if (ImGui::CollapsingHeader("Clipping")) {
+        bool isChanged = ImGui::SliderInt("Clip planes", reinterpret_cast<int32_t*>(&m_ClipPlaneCount), 0, ClipPlaneCountMax);
+        for (uint32_t index = 0; index < m_ClipPlaneCount; index++) {
+            ImGui::PushID(index);
+            isChanged |= ImGui::SliderFloat3("Plane normal", &m_ClipPlanes[index].Normal.x, -1.0f, 1.0f);
+            isChanged |= ImGui::SliderFloat("Plane offset", &m_ClipPlanes[index].Offset, -1.0f, 1.0f);
+            ImGui::PopID();
+        }
+        isChanged |= ImGui::SliderFloat3("Crop box min", &m_CropBox.Min.x, -0.5f, 0.5f);
+        isChanged |= ImGui::SliderFloat3("Crop box max", &m_CropBox.Max.x, -0.5f, 0.5f);
+        isChanged |= ImGui::SliderFloat3("Crop box rotation", &m_CropBoxRotation.x, -180.0f, 180.0f);
+        isChanged |= ImGui::SliderFloat3("Crop box translation", &m_CropBoxTranslation.x, -0.5f, 0.5f);
+        if (isChanged) {
+            m_IsUpdateClipRegion = true;
+            m_FrameIndex = 0;
+        }
+    }
+
+    if (ImGui::CollapsingHeader("Post-Processing")) {
+        // The auto exposure adapts over the frames that render, a fixed one only has to tone map the image again
+        m_FrameIndex = ImGui::Checkbox("Auto exposure", &m_IsAutoExposure) ? 0 : m_FrameIndex;
+        if (m_IsAutoExposure) {
+            m_FrameIndex = ImGui::SliderFloat("Key target", &m_AutoExposureDesc.KeyTarget, 0.05f, 0.5f) ? 0 : m_FrameIndex;
+            m_FrameIndex = ImGui::SliderFloat("Adaptation rate", &m_AutoExposureDesc.AdaptationRate, 0.1f, 10.0f) ? 0 : m_FrameIndex;
+            ImGui::Text("Exposure: %.2f (key %.4f)", m_Exposure, m_pRenderer->GetAutoExposure().GetKey());
+        } else {
+            m_IsExposureChanged |= ImGui::SliderFloat("Exposure", &m_Exposure, 4.0f, 100.0f);
+        }
+    }
+
+    if (ImGui::CollapsingHeader("Statistics")) {
+        ImGui::Text("Frame: %u", m_FrameIndex);
+        ImGui::Text("Resolution: %.0f%% (%.2f ms)", 100.0f * m_ResolutionScale, 1000.0f * m_FrameTime);
+        if (m_ActiveTileCount != std::numeric_limits<uint32_t>::max())
+            ImGui::Text("Active tiles: %u", m_ActiveTileCount);
+        if (m_IsConverged)
+            ImGui::Text("Converged in %.2f s, idle", m_ConvergenceTime);
+        else
+            ImGui::Text("Rendering for %.2f s", std::chrono::duration<float>(std::chrono::high_resolution_clock::now() - m_ConvergenceStart).count());
+
+        // Raising the limit keeps accumulating into the same image
+        if (ImGui::SliderInt("Frame limit", reinterpret_cast<int32_t*>(&m_FrameIndexMax), 0, 16384, m_FrameIndexMax > 0 ? "%d" : "None"))
+            m_IsConverged = false;
+    }
 
-    if (ImGui::CollapsingHeader("Debug"))
-        ImGui::Checkbox("Show computed tiles", &m_IsDrawDebugTiles);
+    if (ImGui::CollapsingHeader("Profiler")) {
+        // Average and maximum over the history of every pass, the GPU times come back a few frames late
+        for (auto const& pass : m_pProfiler->GetPasses())
+            ImGui::Text("%s %*s%s: %.3f ms (max %.3f ms)", pass.Timeline == Profiler::TimelineCPU ? "CPU" : "GPU", 2 * pass.Depth, "", pass.Name.c_str(), 1000.0f * pass.Times.GetAverage(), 1000.0f * pass.Times.GetMax());
+
+        if (ImGui::Button("Export Chrome trace")) {
+            try {
+                m_pProfiler->WriteChromeTrace(ProfilerTraceFileName);
+                m_ProfilerTrace = fmt::format("Last {} frames written to {}", Profiler::TraceFrameCount, ProfilerTraceFileName);
+            } catch (std::exception const& e) {
+                m_ProfilerTrace = e.what();
+            }
+        }
+        if (!m_ProfilerTrace.empty())
+            ImGui::TextUnformatted(m_ProfilerTrace.c_str());
+    }
+
+    if (ImGui::CollapsingHeader("Debug")) {
+        if (m_RendererType == RendererTypeD3D11)
+            ImGui::Checkbox("Show computed tiles", &m_IsDrawDebugTiles);
+        if (ImGui::Button("Compare with CPU reference"))
+            this->CompareWithRendererCPU();
+        if (!m_ComparisonCPU.empty())
+            ImGui::TextUnformatted(m_ComparisonCPU.c_str());
+    }
 
+    ImGui::Checkbox("Show performance", &isShowAppPerformance);
     ImGui::Checkbox("Show metrics", &isShowAppMetrics);
     ImGui::Checkbox("Show about", &isShowAppAbout);
 
     ImGui::End();
 }
+
+void ApplicationVolumeRender::RenderGUIPerformance(bool* pIsOpen) {
+
+    if (!ImGui::Begin("Performance", pIsOpen)) {
+        ImGui::End();
+        return;
+    }
+
+    auto TextPercentiles = [](char const* label, ValueHistory const& history, float scale) {
+        const auto percentiles = history.GetPercentiles();
+        ImGui::Text("%s: p50 %.2f, p95 %.2f, p99 %.2f", label, scale * percentiles.P50, scale * percentiles.P95, scale * percentiles.P99);
+    };
+
+    // The ring is copied from the oldest value on, the offset argument of the plots differs between ImPlot versions
+    auto PlotHistory = [](char const* label, ValueHistory const& history, float scale) {
+        std::array<float, ValueHistory::Length> values = {};
+        for (uint32_t index = 0; index < history.GetCount(); index++)
+            values[index] = scale * history[index];
+        ImPlot::PlotLine(label, values.data(), history.GetCount());
+    };
+
+    ImGui::Text("Last %u of %llu frames", m_Statistics.GetFrameTimes().GetCount(), static_cast<unsigned long long>(m_Statistics.GetFrameCount()));
+    TextPercentiles("Frame time, ms", m_Statistics.GetFrameTimes(), 1000.0f);
+    TextPercentiles("Render time, ms", m_Statistics.GetRenderTimes(), 1000.0f);
+    TextPercentiles("Msamples/s", m_Statistics.GetSampleRates(), 1.0e-6f);
+    TextPercentiles("Active tiles", m_Statistics.GetActiveTileCounts(), 1.0f);
+
+    if (ImPlot::BeginPlot("Time", 0, "ms", ImVec2(-1, 175), 0, ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit)) {
+        PlotHistory("Frame", m_Statistics.GetFrameTimes(), 1000.0f);
+        PlotHistory("Render", m_Statistics.GetRenderTimes(), 1000.0f);
+        ImPlot::EndPlot();
+    }
+
+    if (ImPlot::BeginPlot("Throughput", 0, 0, ImVec2(-1, 175), 0, ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit)) {
+        PlotHistory("Msamples/s", m_Statistics.GetSampleRates(), 1.0e-6f);
+        PlotHistory("Active tiles", m_Statistics.GetActiveTileCounts(), 1.0f);
+        ImPlot::EndPlot();
+    }
+
+    if (ImGui::CollapsingHeader("Passes, ms")) {
+        for (auto const& pass : m_pProfiler->GetPasses()) {
+            const auto percentiles = pass.Times.GetPercentiles();
+            ImGui::Text("%s %*s%s: p50 %.3f, p95 %.3f, p99 %.3f", pass.Timeline == Profiler::TimelineCPU ? "CPU" : "GPU", 2 * pass.Depth, "", pass.Name.c_str(), 1000.0f * percentiles.P50, 1000.0f * percentiles.P95, 1000.0f * percentiles.P99);
+        }
+    }
+
+    ImGui::End();
+}
@@ -0,0 +1,154 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "AutoExposure.h"
+#include "RenderCommon.h"
+
+#include <bit>
+#include <numeric>
+
+using namespace Hawk::Math;
+
+namespace {
+    constexpr int32_t MantissaShift = 23 - (std::bit_width(AutoExposure::BinsPerStop) - 1);
+    constexpr int32_t BinOffset = (127 + AutoExposure::LogLuminanceMin) * int32_t(AutoExposure::BinsPerStop);
+
+    const F32 LuminanceMin = std::exp2(F32(AutoExposure::LogLuminanceMin));
+
+    static_assert(std::has_single_bit(AutoExposure::BinsPerStop));
+
+    F32 Luminance(Vec4 const& color) {
+
+        return 0.2126f * color.x + 0.7152f * color.y + 0.0722f * color.z;
+    }
+
+    // Log2 of the luminance in the middle of the mantissa range of a bin
+    const auto BinLogLuminance = [] {
+        std::array<F32, AutoExposure::BinCount> values = {};
+        for (uint32_t bin = 0; bin < AutoExposure::BinCount; bin++) {
+            const F32 mantissa = 1.0f + ((bin % AutoExposure::BinsPerStop) + 0.5f) / AutoExposure::BinsPerStop;
+            values[bin] = F32(AutoExposure::LogLuminanceMin + int32_t(bin / AutoExposure::BinsPerStop)) + std::log2(mantissa);
+        }
+        return values;
+    }();
+}
+
+AutoExposure::AutoExposure(ThreadPool& threadPool)
+    : m_ThreadPool(threadPool) {
+
+    m_ThreadHistograms.resize(threadPool.GetThreadCount());
+}
+
+void AutoExposure::Resize(uint32_t tileCount) {
+
+    m_TileHistograms.assign(size_t(tileCount) * BinCount, 0);
+    for (auto& histogram : m_ThreadHistograms)
+        histogram.Bins.fill(0);
+    m_Histogram.fill(0);
+    m_IsAdapted = false;
+}
+
+uint32_t AutoExposure::GetBin(F32 luminance) {
+
+    // The exponent and the top bits of the mantissa of a positive float, counted from 2^LogLuminanceMin
+    const int32_t bin = (std::bit_cast<int32_t>(std::max(luminance, 0.0f)) >> MantissaShift) - BinOffset;
+    return static_cast<uint32_t>(std::clamp(bin, 0, int32_t(BinCount) - 1));
+}
+
+void AutoExposure::UpdateTile(uint32_t tileIndex, uint32_t threadID, std::span<Vec4 const> image, uint32_t width, uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1) {
+
+    std::array<uint16_t, BinCount> bins = {};
+    for (uint32_t y = y0; y < y1; y++) {
+        for (uint32_t x = x0; x < x1; x++) {
+            const Vec4& color = image[size_t(y) * width + x];
+            const F32 luminance = Luminance(color);
+            if (color.w > 0.0f && luminance >= LuminanceMin)
+                bins[GetBin(luminance)]++;
+        }
+    }
+
+    uint16_t* pTileBins = std::data(m_TileHistograms) + size_t(tileIndex) * BinCount;
+    auto& threadBins = m_ThreadHistograms[threadID].Bins;
+    for (uint32_t bin = 0; bin < BinCount; bin++) {
+        threadBins[bin] += int32_t(bins[bin]) - int32_t(pTileBins[bin]);
+        pTileBins[bin] = bins[bin];
+    }
+}
+
+void AutoExposure::Update(F32 deltaTime) {
+
+    m_ThreadPool.ParallelFor(BinCount / MergeChunkSize, [&](uint32_t chunk, uint32_t threadID) {
+        for (uint32_t bin = chunk * MergeChunkSize; bin < (chunk + 1) * MergeChunkSize; bin++) {
+            int32_t delta = 0;
+            for (auto& histogram : m_ThreadHistograms) {
+                delta += histogram.Bins[bin];
+                histogram.Bins[bin] = 0;
+            }
+            m_Histogram[bin] += delta;
+        }
+    });
+
+    this->Adapt(m_Histogram, deltaTime);
+}
+
+void AutoExposure::Adapt(std::span<uint32_t const> histogram, F32 deltaTime) {
+
+    assert(std::size(histogram) == BinCount);
+    if (std::accumulate(histogram.begin(), histogram.end(), uint64_t(0)) == 0)
+        return;
+
+    const F32 logKey = ComputeLogKey(histogram, m_Desc.PercentileLow, m_Desc.PercentileHigh);
+    if (m_IsAdapted) {
+        m_LogKey += (logKey - m_LogKey) * (1.0f - std::exp(-deltaTime * m_Desc.AdaptationRate));
+    } else {
+        m_LogKey = logKey;
+        m_IsAdapted = true;
+    }
+}
+
+F32 AutoExposure::GetExposure() const {
+
+    return m_Desc.KeyTarget / Shading::ToneMapUncharted2(this->GetKey(), 1.0f);
+}
+
+F32 AutoExposure::ComputeLogKey(std::span<uint32_t const> histogram, F32 percentileLow, F32 percentileHigh) {
+
+    // The pixels between the percentiles are the overlap of [low, high) with the cumulative count range of every bin
+    const auto total = static_cast<F64>(std::accumulate(histogram.begin(), histogram.end(), uint64_t(0)));
+    const F64 low = std::min<F64>(percentileLow * total, total - 1.0);
+    const F64 high = std::max<F64>(percentileHigh * total, low + 1.0);
+
+    F64 cumulative = 0.0;
+    F64 logSum = 0.0;
+    F64 weightSum = 0.0;
+    for (uint32_t bin = 0; bin < std::size(histogram) && cumulative < high; bin++) {
+        const F64 overlap = std::min(cumulative + histogram[bin], high) - std::max(cumulative, low);
+        if (overlap > 0.0) {
+            logSum += overlap * BinLogLuminance[bin];
+            weightSum += overlap;
+        }
+        cumulative += histogram[bin];
+    }
+    return static_cast<F32>(logSum / weightSum);
+}
@@ -0,0 +1,124 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "BlueNoise.h"
+#include "RenderCommon.h"
+
+#include <algorithm>
+#include <cmath>
+
+void BlueNoise::Initialize(uint32_t size) {
+
+    constexpr F32 Sigma = 1.5f;
+
+    const size_t count = size_t(size) * size;
+
+    // Gaussian energy of a point at every toroidal offset, the energy of a texel is the sum over the points of the pattern
+    std::vector<F32> kernel(count);
+    for (uint32_t y = 0; y < size; y++) {
+        for (uint32_t x = 0; x < size; x++) {
+            const F32 dx = F32(std::min(x, size - x));
+            const F32 dy = F32(std::min(y, size - y));
+            kernel[size_t(y) * size + x] = std::exp(-(dx * dx + dy * dy) / (2.0f * Sigma * Sigma));
+        }
+    }
+
+    std::vector<uint8_t> pattern(count);
+    std::vector<F32> energy(count);
+
+    auto Splat = [&](std::vector<F32>& target, size_t index, F32 sign) {
+        const uint32_t px = uint32_t(index % size);
+        const uint32_t py = uint32_t(index / size);
+        for (uint32_t y = 0; y < size; y++) {
+            const size_t row = size_t((y + size - py) % size) * size;
+            for (uint32_t x = 0; x < size; x++)
+                target[size_t(y) * size + x] += sign * kernel[row + (x + size - px) % size];
+        }
+    };
+
+    // Tightest cluster is the point with the highest energy, largest void the empty texel with the lowest
+    auto FindExtremum = [&](std::vector<uint8_t> const& points, std::vector<F32> const& values, bool isCluster) {
+        size_t result = 0;
+        F32 best = isCluster ? -std::numeric_limits<F32>::max() : std::numeric_limits<F32>::max();
+        for (size_t index = 0; index < count; index++) {
+            if (points[index] != uint8_t(isCluster))
+                continue;
+            if (isCluster ? values[index] > best : values[index] < best) {
+                best = values[index];
+                result = index;
+            }
+        }
+        return result;
+    };
+
+    // Initial pattern of a tenth of the texels, relaxed until the tightest cluster is also the largest void
+    const size_t initialCount = std::max<size_t>(count / 10, 1);
+    for (size_t pointCount = 0, seed = 0; pointCount < initialCount; seed++) {
+        const size_t index = Shading::PCGHash(uint32_t(seed)) % count;
+        if (!pattern[index]) {
+            pattern[index] = 1;
+            Splat(energy, index, 1.0f);
+            pointCount++;
+        }
+    }
+
+    for (;;) {
+        const size_t cluster = FindExtremum(pattern, energy, true);
+        pattern[cluster] = 0;
+        Splat(energy, cluster, -1.0f);
+
+        const size_t hole = FindExtremum(pattern, energy, false);
+        pattern[hole] = 1;
+        Splat(energy, hole, 1.0f);
+        if (hole == cluster)
+            break;
+    }
+
+    std::vector<uint32_t> rank(count);
+
+    // Points of the initial pattern are ranked by removing the tightest cluster first
+    {
+        auto points = pattern;
+        auto values = energy;
+        for (size_t remaining = initialCount; remaining > 0; remaining--) {
+            const size_t cluster = FindExtremum(points, values, true);
+            points[cluster] = 0;
+            Splat(values, cluster, -1.0f);
+            rank[cluster] = uint32_t(remaining - 1);
+        }
+    }
+
+    // The others by filling the largest void, which past half of the texels is the tightest cluster of empty texels
+    for (size_t filled = initialCount; filled < count; filled++) {
+        const size_t hole = FindExtremum(pattern, energy, false);
+        pattern[hole] = 1;
+        Splat(energy, hole, 1.0f);
+        rank[hole] = uint32_t(filled);
+    }
+
+    m_Size = size;
+    m_Texels.resize(count);
+    for (size_t index = 0; index < count; index++)
+        m_Texels[index] = (F32(rank[index]) + 0.5f) / F32(count);
+}
@@ -0,0 +1,200 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "BrickPool.h"
+
+#include <stdexcept>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#endif
+
+namespace {
+    // x / CellCount as (x * DivideMagic) >> 16, exact for x <= MaxDimension
+    constexpr uint32_t DivideMagic = (1u << 16) / BrickPool::CellCount + 1;
+    constexpr uint32_t MaxDimension = 4096;
+
+    constexpr int32_t BrickShift = std::countr_zero(BrickPool::BrickSize);
+    constexpr int32_t BrickVoxelShift = 3 * BrickShift;
+
+    static_assert(std::has_single_bit(BrickPool::BrickSize), "Brick size must be a power of two");
+
+    inline int32_t LerpFixed(int32_t a, int32_t b, int32_t weight) {
+
+        return a + (((b - a) * weight) >> 8);
+    }
+}
+
+void BrickPool::Initialize(VolumeData const& volume, uint32_t mipLevel) {
+
+    m_Dimension = volume.GetDimension(mipLevel);
+    if ((std::max)({ m_Dimension.x, m_Dimension.y, m_Dimension.z }) > MaxDimension)
+        throw std::runtime_error("Volume dimension exceeds the brick pool addressing range");
+
+    // Cells are addressed by their first texel plus one, from the border texel -1 to dimension - 1
+    m_BrickDimension = Hawk::Math::Vec3u(m_Dimension.x / CellCount + 1, m_Dimension.y / CellCount + 1, m_Dimension.z / CellCount + 1);
+    m_BrickTable.assign(size_t(m_BrickDimension.x) * m_BrickDimension.y * m_BrickDimension.z, 0);
+    m_Pool.assign(BrickVoxelCount, 0);
+
+    auto const& intensity = volume.GetIntensity(mipLevel);
+
+    std::vector<uint16_t> brick(BrickVoxelCount);
+    for (uint32_t brickZ = 0; brickZ < m_BrickDimension.z; brickZ++) {
+        for (uint32_t brickY = 0; brickY < m_BrickDimension.y; brickY++) {
+            for (uint32_t brickX = 0; brickX < m_BrickDimension.x; brickX++) {
+                bool isEmpty = true;
+                for (uint32_t z = 0; z < BrickSize; z++) {
+                    for (uint32_t y = 0; y < BrickSize; y++) {
+                        for (uint32_t x = 0; x < BrickSize; x++) {
+                            const int32_t voxelX = int32_t(brickX * CellCount + x) - 1;
+                            const int32_t voxelY = int32_t(brickY * CellCount + y) - 1;
+                            const int32_t voxelZ = int32_t(brickZ * CellCount + z) - 1;
+
+                            const bool isInside = voxelX >= 0 && voxelY >= 0 && voxelZ >= 0 && voxelX < int32_t(m_Dimension.x) && voxelY < int32_t(m_Dimension.y) && voxelZ < int32_t(m_Dimension.z);
+                            const uint16_t value = isInside ? intensity[(size_t(voxelZ) * m_Dimension.y + voxelY) * m_Dimension.x + voxelX] : 0;
+
+                            brick[(z * BrickSize + y) * BrickSize + x] = value;
+                            isEmpty &= value == 0;
+                        }
+                    }
+                }
+
+                if (!isEmpty) {
+                    m_BrickTable[(size_t(brickZ) * m_BrickDimension.y + brickY) * m_BrickDimension.x + brickX] = this->GetBrickCount();
+                    m_Pool.insert(std::end(m_Pool), std::begin(brick), std::end(brick));
+                }
+            }
+        }
+    }
+
+    // Gathers address the pool with signed 32-bit voxel offsets
+    if (std::size(m_Pool) > size_t(INT32_MAX))
+        throw std::runtime_error("Brick pool exceeds the 32-bit gather range");
+}
+
+F32 BrickPool::SampleIntensity(Hawk::Math::Vec3 const& texcoord) const {
+
+    const auto u = texcoord.x * m_Dimension.x - 0.5f;
+    const auto v = texcoord.y * m_Dimension.y - 0.5f;
+    const auto w = texcoord.z * m_Dimension.z - 0.5f;
+
+    const auto floorU = std::floor(u);
+    const auto floorV = std::floor(v);
+    const auto floorW = std::floor(w);
+
+    const auto x = static_cast<int32_t>(floorU) + 1;
+    const auto y = static_cast<int32_t>(floorV) + 1;
+    const auto z = static_cast<int32_t>(floorW) + 1;
+
+    // Cells outside [0, dimension] only touch border texels
+    if (uint32_t(x) > m_Dimension.x || uint32_t(y) > m_Dimension.y || uint32_t(z) > m_Dimension.z)
+        return 0.0f;
+
+    const uint32_t brickX = x / CellCount;
+    const uint32_t brickY = y / CellCount;
+    const uint32_t brickZ = z / CellCount;
+
+    const auto slot = m_BrickTable[(size_t(brickZ) * m_BrickDimension.y + brickY) * m_BrickDimension.x + brickX];
+    const auto cell = ((z - brickZ * CellCount) * BrickSize + (y - brickY * CellCount)) * BrickSize + (x - brickX * CellCount);
+    const auto pVoxel = std::data(m_Pool) + (size_t(slot) << BrickVoxelShift) + cell;
+
+    const auto weightX = static_cast<int32_t>((u - floorU) * 256.0f);
+    const auto weightY = static_cast<int32_t>((v - floorV) * 256.0f);
+    const auto weightZ = static_cast<int32_t>((w - floorW) * 256.0f);
+
+    constexpr uint32_t StrideY = BrickSize;
+    constexpr uint32_t StrideZ = BrickSize * BrickSize;
+
+    const auto c00 = LerpFixed(pVoxel[0], pVoxel[1], weightX);
+    const auto c10 = LerpFixed(pVoxel[StrideY], pVoxel[StrideY + 1], weightX);
+    const auto c01 = LerpFixed(pVoxel[StrideZ], pVoxel[StrideZ + 1], weightX);
+    const auto c11 = LerpFixed(pVoxel[StrideZ + StrideY], pVoxel[StrideZ + StrideY + 1], weightX);
+    return LerpFixed(LerpFixed(c00, c10, weightY), LerpFixed(c01, c11, weightY), weightZ) * (1.0f / 65535.0f);
+}
+
+#if defined(__AVX2__)
+void BrickPool::SampleIntensity8(F32 const* pX, F32 const* pY, F32 const* pZ, F32* pIntensity) const {
+
+    struct Axis {
+        __m256i Brick;
+        __m256i Cell;
+        __m256i Weight;
+        __m256i Mask;
+    };
+
+    auto ComputeAxis = [](F32 const* pTexcoord, uint32_t dimension) -> Axis {
+
+        const __m256 u = _mm256_sub_ps(_mm256_mul_ps(_mm256_load_ps(pTexcoord), _mm256_set1_ps(F32(dimension))), _mm256_set1_ps(0.5f));
+        const __m256 floorU = _mm256_floor_ps(u);
+        const __m256i x = _mm256_add_epi32(_mm256_cvttps_epi32(floorU), _mm256_set1_epi32(1));
+
+        // Lanes outside the range read cell 0 of brick 0 and are masked out of the gathers
+        const __m256i mask = _mm256_andnot_si256(_mm256_cmpgt_epi32(x, _mm256_set1_epi32(int32_t(dimension))), _mm256_cmpgt_epi32(x, _mm256_set1_epi32(-1)));
+        const __m256i xMasked = _mm256_and_si256(x, mask);
+        const __m256i brick = _mm256_srli_epi32(_mm256_mullo_epi32(xMasked, _mm256_set1_epi32(DivideMagic)), 16);
+        const __m256i cell = _mm256_sub_epi32(xMasked, _mm256_mullo_epi32(brick, _mm256_set1_epi32(CellCount)));
+        const __m256i weight = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_sub_ps(u, floorU), _mm256_set1_ps(256.0f)));
+        return { brick, cell, weight, mask };
+    };
+
+    auto LerpFixed8 = [](__m256i a, __m256i b, __m256i weight) -> __m256i {
+        return _mm256_add_epi32(a, _mm256_srai_epi32(_mm256_mullo_epi32(_mm256_sub_epi32(b, a), weight), 8));
+    };
+
+    auto LerpPair8 = [&](__m256i pair, __m256i weight) -> __m256i {
+        return LerpFixed8(_mm256_and_si256(pair, _mm256_set1_epi32(0xFFFF)), _mm256_srli_epi32(pair, 16), weight);
+    };
+
+    const Axis axisX = ComputeAxis(pX, m_Dimension.x);
+    const Axis axisY = ComputeAxis(pY, m_Dimension.y);
+    const Axis axisZ = ComputeAxis(pZ, m_Dimension.z);
+    const __m256i mask = _mm256_and_si256(_mm256_and_si256(axisX.Mask, axisY.Mask), axisZ.Mask);
+
+    const __m256i brick = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_add_epi32(_mm256_mullo_epi32(axisZ.Brick, _mm256_set1_epi32(m_BrickDimension.y)), axisY.Brick), _mm256_set1_epi32(m_BrickDimension.x)), axisX.Brick);
+    const __m256i slot = _mm256_i32gather_epi32(reinterpret_cast<int const*>(std::data(m_BrickTable)), brick, 4);
+    const __m256i cell = _mm256_add_epi32(_mm256_slli_epi32(_mm256_add_epi32(_mm256_slli_epi32(axisZ.Cell, BrickShift), axisY.Cell), BrickShift), axisX.Cell);
+    const __m256i offset = _mm256_add_epi32(_mm256_slli_epi32(slot, BrickVoxelShift), cell);
+
+    // Both x taps of a cell are adjacent in the brick, one 32-bit gather fetches the pair
+    auto GatherPair = [&](int32_t stride) -> __m256i {
+        return _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), reinterpret_cast<int const*>(std::data(m_Pool)), _mm256_add_epi32(offset, _mm256_set1_epi32(stride)), mask, 2);
+    };
+
+    constexpr int32_t StrideY = BrickSize;
+    constexpr int32_t StrideZ = BrickSize * BrickSize;
+
+    const __m256i c00 = LerpPair8(GatherPair(0), axisX.Weight);
+    const __m256i c10 = LerpPair8(GatherPair(StrideY), axisX.Weight);
+    const __m256i c01 = LerpPair8(GatherPair(StrideZ), axisX.Weight);
+    const __m256i c11 = LerpPair8(GatherPair(StrideZ + StrideY), axisX.Weight);
+    const __m256i c = LerpFixed8(LerpFixed8(c00, c10, axisY.Weight), LerpFixed8(c01, c11, axisY.Weight), axisZ.Weight);
+    _mm256_store_ps(pIntensity, _mm256_mul_ps(_mm256_cvtepi32_ps(c), _mm256_set1_ps(1.0f / 65535.0f)));
+}
+#else
+void BrickPool::SampleIntensity8(F32 const* pX, F32 const* pY, F32 const* pZ, F32* pIntensity) const {
+
+    for (uint32_t lane = 0; lane < 8; lane++)
+        pIntensity[lane] = this->SampleIntensity(Hawk::Math::Vec3(pX[lane], pY[lane], pZ[lane]));
+}
+#endif
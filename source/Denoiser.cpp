@@ -0,0 +1,178 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Denoiser.h"
+#include "SIMD.h"
+
+using namespace SIMD;
+
+namespace {
+    constexpr F32 KernelWeights[] = { 1.0f / 16.0f, 1.0f / 4.0f, 3.0f / 8.0f, 1.0f / 4.0f, 1.0f / 16.0f };
+    constexpr F32 GaussianWeights[] = { 1.0f / 4.0f, 1.0f / 2.0f, 1.0f / 4.0f };
+
+    inline VFloat Luminance(VFloat r, VFloat g, VFloat b) { return SetF(0.2126f) * r + SetF(0.7152f) * g + SetF(0.0722f) * b; }
+
+    alignas(32) constexpr F32 LaneOffsets[LaneCount] = { 0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f };
+
+    // Lanes whose pixel x + offset lies in the row
+    inline VFloat ColumnMask(uint32_t x, int32_t offset, uint32_t width) {
+
+        const VFloat column = SetF(F32(int32_t(x) + offset)) + LoadF(LaneOffsets);
+        return And(GreaterEqual(column, SetF(0.0f)), Less(column, SetF(F32(width))));
+    }
+}
+
+Denoiser::Denoiser(ThreadPool& threadPool)
+    : m_ThreadPool(threadPool) {
+
+}
+
+void Denoiser::Resize(uint32_t width, uint32_t height) {
+
+    m_Width = width;
+    m_Height = height;
+    m_Stride = (width + LaneCount - 1) / LaneCount * LaneCount + 2 * Padding;
+
+    // The padding stays zero, it is only read by masked lanes
+    const size_t count = size_t(m_Stride) * height;
+    for (auto& plane : m_Source)
+        plane.assign(count, 0.0f);
+    for (auto& plane : m_Target)
+        plane.assign(count, 0.0f);
+    m_VarianceFiltered.assign(count, 0.0f);
+}
+
+void Denoiser::SetPixel(uint32_t x, uint32_t y, Hawk::Math::Vec3 const& color, F32 variance, Hawk::Math::Vec3 const& normal, F32 depth) {
+
+    const size_t index = Index(x, y);
+    m_Source[PlaneRed][index] = color.x;
+    m_Source[PlaneGreen][index] = color.y;
+    m_Source[PlaneBlue][index] = color.z;
+    m_Source[PlaneVariance][index] = variance;
+    m_Source[PlaneNormalX][index] = normal.x;
+    m_Source[PlaneNormalY][index] = normal.y;
+    m_Source[PlaneNormalZ][index] = normal.z;
+    m_Source[PlaneDepth][index] = depth;
+}
+
+Hawk::Math::Vec3 Denoiser::GetPixel(uint32_t x, uint32_t y) const {
+
+    const size_t index = Index(x, y);
+    return Hawk::Math::Vec3(m_Source[PlaneRed][index], m_Source[PlaneGreen][index], m_Source[PlaneBlue][index]);
+}
+
+void Denoiser::Execute() {
+
+    const uint32_t iterationCount = std::min(m_Desc.IterationCount, IterationCountMax);
+    for (uint32_t iteration = 0; iteration < iterationCount; iteration++) {
+        m_ThreadPool.ParallelFor(m_Height, [&](uint32_t y, uint32_t threadID) { this->FilterVariance(y); });
+        m_ThreadPool.ParallelFor(m_Height, [&](uint32_t y, uint32_t threadID) { this->FilterIteration(y, 1u << iteration); });
+
+        for (uint32_t plane = PlaneRed; plane <= PlaneVariance; plane++)
+            std::swap(m_Source[plane], m_Target[plane]);
+    }
+}
+
+void Denoiser::FilterVariance(uint32_t y) {
+
+    F32 const* pVariance = std::data(m_Source[PlaneVariance]);
+    for (uint32_t x = 0; x < m_Width; x += LaneCount) {
+        VFloat sum = SetF(0.0f);
+        VFloat sumWeight = SetF(0.0f);
+        for (int32_t dy = -1; dy <= 1; dy++) {
+            if (int32_t(y) + dy < 0 || int32_t(y) + dy >= int32_t(m_Height))
+                continue;
+
+            for (int32_t dx = -1; dx <= 1; dx++) {
+                const VFloat weight = And(ColumnMask(x, dx, m_Width), SetF(GaussianWeights[dx + 1] * GaussianWeights[dy + 1]));
+                sum = sum + weight * LoadUnalignedF(pVariance + Index(x, y + dy) + dx);
+                sumWeight = sumWeight + weight;
+            }
+        }
+        StoreUnalignedF(std::data(m_VarianceFiltered) + Index(x, y), sum / Max(sumWeight, SetF(1.0e-20f)));
+    }
+}
+
+void Denoiser::FilterIteration(uint32_t y, uint32_t step) {
+
+    auto Load = [&](Plane plane, size_t index) { return LoadUnalignedF(std::data(m_Source[plane]) + index); };
+
+    const VFloat sigmaNormal = SetF(-m_Desc.SigmaNormal);
+    const VFloat invSigmaDepth = SetF(-1.0f / (m_Desc.SigmaDepth * step));
+
+    for (uint32_t x = 0; x < m_Width; x += LaneCount) {
+        const size_t center = Index(x, y);
+        const VFloat normalX = Load(PlaneNormalX, center);
+        const VFloat normalY = Load(PlaneNormalY, center);
+        const VFloat normalZ = Load(PlaneNormalZ, center);
+        const VFloat depth = Load(PlaneDepth, center);
+        const VFloat luminance = Luminance(Load(PlaneRed, center), Load(PlaneGreen, center), Load(PlaneBlue, center));
+
+        // A pixel without variance keeps its value, as the weights of all the other taps vanish
+        const VFloat invSigmaLuminance = SetF(-1.0f) / (SetF(m_Desc.SigmaLuminance) * Sqrt(LoadUnalignedF(std::data(m_VarianceFiltered) + center)) + SetF(1.0e-6f));
+
+        VFloat sumR = SetF(0.0f);
+        VFloat sumG = SetF(0.0f);
+        VFloat sumB = SetF(0.0f);
+        VFloat sumVariance = SetF(0.0f);
+        VFloat sumWeight = SetF(0.0f);
+        for (int32_t dy = -2; dy <= 2; dy++) {
+            const int32_t row = int32_t(y) + dy * int32_t(step);
+            if (row < 0 || row >= int32_t(m_Height))
+                continue;
+
+            for (int32_t dx = -2; dx <= 2; dx++) {
+                const int32_t offset = dx * int32_t(step);
+                const size_t index = Index(x, row) + offset;
+
+                const VFloat r = Load(PlaneRed, index);
+                const VFloat g = Load(PlaneGreen, index);
+                const VFloat b = Load(PlaneBlue, index);
+
+                const VFloat deltaX = Load(PlaneNormalX, index) - normalX;
+                const VFloat deltaY = Load(PlaneNormalY, index) - normalY;
+                const VFloat deltaZ = Load(PlaneNormalZ, index) - normalZ;
+                const VFloat distanceNormal = deltaX * deltaX + deltaY * deltaY + deltaZ * deltaZ;
+                const VFloat distanceDepth = Abs(Load(PlaneDepth, index) - depth);
+                const VFloat distanceLuminance = Abs(Luminance(r, g, b) - luminance);
+
+                const VFloat exponent = sigmaNormal * distanceNormal + invSigmaDepth * distanceDepth + invSigmaLuminance * distanceLuminance;
+                const VFloat weight = And(ColumnMask(x, offset, m_Width), SetF(KernelWeights[dx + 2] * KernelWeights[dy + 2]) * Exp(exponent));
+
+                sumR = sumR + weight * r;
+                sumG = sumG + weight * g;
+                sumB = sumB + weight * b;
+                sumVariance = sumVariance + weight * weight * Load(PlaneVariance, index);
+                sumWeight = sumWeight + weight;
+            }
+        }
+
+        // Lanes past the end of the row have no weight, they write zeros into the padding
+        const VFloat invWeight = SetF(1.0f) / Max(sumWeight, SetF(1.0e-20f));
+        StoreUnalignedF(std::data(m_Target[PlaneRed]) + center, sumR * invWeight);
+        StoreUnalignedF(std::data(m_Target[PlaneGreen]) + center, sumG * invWeight);
+        StoreUnalignedF(std::data(m_Target[PlaneBlue]) + center, sumB * invWeight);
+        StoreUnalignedF(std::data(m_Target[PlaneVariance]) + center, sumVariance * invWeight * invWeight);
+    }
+}
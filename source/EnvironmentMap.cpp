@@ -0,0 +1,442 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "EnvironmentMap.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+    constexpr F32 Pi = 3.14159265f;
+
+    constexpr uint32_t DDSMagic = 0x20534444;
+    constexpr uint32_t DDSFourCCDX10 = 0x30315844;
+    constexpr uint32_t D3DFMTA16B16G16R16F = 113;
+    constexpr uint32_t D3DFMTA32B32G32R32F = 116;
+
+    constexpr uint32_t DXGIFormatR32G32B32A32Float = 2;
+    constexpr uint32_t DXGIFormatR16G16B16A16Float = 10;
+    constexpr uint32_t DXGIFormatBC6HUF16 = 95;
+    constexpr uint32_t DXGIFormatBC6HSF16 = 96;
+
+    F32 HalfToFloat(uint16_t value) {
+
+        const uint32_t sign = uint32_t(value & 0x8000) << 16;
+        const uint32_t exponent = (value >> 10) & 0x1F;
+        const uint32_t mantissa = value & 0x3FF;
+
+        if (exponent == 0) {
+            const F32 result = std::ldexp(static_cast<F32>(mantissa), -24);
+            return sign ? -result : result;
+        }
+
+        if (exponent == 31)
+            return std::bit_cast<F32>(sign | 0x7F800000 | (mantissa << 13));
+
+        return std::bit_cast<F32>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+    }
+
+    // BC6H decoder following the D3D11 functional specification
+    class BC6HBlockDecoder {
+    public:
+        BC6HBlockDecoder(uint8_t const* pBlock, bool isSigned)
+            : m_IsSigned(isSigned) {
+            std::memcpy(m_Bits, pBlock, sizeof(m_Bits));
+        }
+
+        void Decode(Hawk::Math::Vec3* pTexels) {
+
+            enum Field : uint8_t { RW, RX, RY, RZ, GW, GX, GY, GZ, BW, BX, BY, BZ };
+
+            struct Segment {
+                uint8_t Field;
+                uint8_t First;
+                uint8_t Count;
+            };
+
+            struct ModeDesc {
+                bool     IsTransformed;
+                uint32_t RegionCount;
+                uint32_t EndpointBits;
+                uint32_t DeltaBits[3];
+                std::vector<Segment> Segments;
+            };
+
+            static const ModeDesc modes[14] = {
+                { true, 2, 10, { 5, 5, 5 }, { {GY,4,1},{BY,4,1},{BZ,4,1},{RW,0,10},{GW,0,10},{BW,0,10},{RX,0,5},{GZ,4,1},{GY,0,4},{GX,0,5},{BZ,0,1},{GZ,0,4},{BX,0,5},{BZ,1,1},{BY,0,4},{RY,0,5},{BZ,2,1},{RZ,0,5},{BZ,3,1} } },
+                { true, 2, 7, { 6, 6, 6 }, { {GY,5,1},{GZ,4,1},{GZ,5,1},{RW,0,7},{BZ,0,1},{BZ,1,1},{BY,4,1},{GW,0,7},{BY,5,1},{BZ,2,1},{GY,4,1},{BW,0,7},{BZ,3,1},{BZ,5,1},{BZ,4,1},{RX,0,6},{GY,0,4},{GX,0,6},{GZ,0,4},{BX,0,6},{BY,0,4},{RY,0,6},{RZ,0,6} } },
+                { true, 2, 11, { 5, 4, 4 }, { {RW,0,10},{GW,0,10},{BW,0,10},{RX,0,5},{RW,10,1},{GY,0,4},{GX,0,4},{GW,10,1},{BZ,0,1},{GZ,0,4},{BX,0,4},{BW,10,1},{BZ,1,1},{BY,0,4},{RY,0,5},{BZ,2,1},{RZ,0,5},{BZ,3,1} } },
+                { true, 2, 11, { 4, 5, 4 }, { {RW,0,10},{GW,0,10},{BW,0,10},{RX,0,4},{RW,10,1},{GZ,4,1},{GY,0,4},{GX,0,5},{GW,10,1},{GZ,0,4},{BX,0,4},{BW,10,1},{BZ,1,1},{BY,0,4},{RY,0,4},{BZ,0,1},{BZ,2,1},{RZ,0,4},{GY,4,1},{BZ,3,1} } },
+                { true, 2, 11, { 4, 4, 5 }, { {RW,0,10},{GW,0,10},{BW,0,10},{RX,0,4},{RW,10,1},{BY,4,1},{GY,0,4},{GX,0,4},{GW,10,1},{BZ,0,1},{GZ,0,4},{BX,0,5},{BW,10,1},{BY,0,4},{RY,0,4},{BZ,1,1},{BZ,2,1},{RZ,0,4},{BZ,4,1},{BZ,3,1} } },
+                { true, 2, 9, { 5, 5, 5 }, { {RW,0,9},{BY,4,1},{GW,0,9},{GY,4,1},{BW,0,9},{BZ,4,1},{RX,0,5},{GZ,4,1},{GY,0,4},{GX,0,5},{BZ,0,1},{GZ,0,4},{BX,0,5},{BZ,1,1},{BY,0,4},{RY,0,5},{BZ,2,1},{RZ,0,5},{BZ,3,1} } },
+                { true, 2, 8, { 6, 5, 5 }, { {RW,0,8},{GZ,4,1},{BY,4,1},{GW,0,8},{BZ,2,1},{GY,4,1},{BW,0,8},{BZ,3,1},{BZ,4,1},{RX,0,6},{GY,0,4},{GX,0,5},{BZ,0,1},{GZ,0,4},{BX,0,5},{BZ,1,1},{BY,0,4},{RY,0,6},{RZ,0,6} } },
+                { true, 2, 8, { 5, 6, 5 }, { {RW,0,8},{BZ,0,1},{BY,4,1},{GW,0,8},{GY,5,1},{GY,4,1},{BW,0,8},{GZ,5,1},{BZ,4,1},{RX,0,5},{GZ,4,1},{GY,0,4},{GX,0,6},{GZ,0,4},{BX,0,5},{BZ,1,1},{BY,0,4},{RY,0,5},{BZ,2,1},{RZ,0,5},{BZ,3,1} } },
+                { true, 2, 8, { 5, 5, 6 }, { {RW,0,8},{BZ,1,1},{BY,4,1},{GW,0,8},{BY,5,1},{GY,4,1},{BW,0,8},{BZ,5,1},{BZ,4,1},{RX,0,5},{GZ,4,1},{GY,0,4},{GX,0,5},{BZ,0,1},{GZ,0,4},{BX,0,6},{BY,0,4},{RY,0,5},{BZ,2,1},{RZ,0,5},{BZ,3,1} } },
+                { false, 2, 6, { 6, 6, 6 }, { {RW,0,6},{GZ,4,1},{BZ,0,1},{BZ,1,1},{BY,4,1},{GW,0,6},{GY,5,1},{BY,5,1},{BZ,2,1},{GY,4,1},{BW,0,6},{GZ,5,1},{BZ,3,1},{BZ,5,1},{BZ,4,1},{RX,0,6},{GY,0,4},{GX,0,6},{GZ,0,4},{BX,0,6},{BY,0,4},{RY,0,6},{RZ,0,6} } },
+                { false, 1, 10, { 10, 10, 10 }, { {RW,0,10},{GW,0,10},{BW,0,10},{RX,0,10},{GX,0,10},{BX,0,10} } },
+                { true, 1, 11, { 9, 9, 9 }, { {RW,0,10},{GW,0,10},{BW,0,10},{RX,0,9},{RW,10,1},{GX,0,9},{GW,10,1},{BX,0,9},{BW,10,1} } },
+                { true, 1, 12, { 8, 8, 8 }, { {RW,0,10},{GW,0,10},{BW,0,10},{RX,0,8},{RW,11,1},{RW,10,1},{GX,0,8},{GW,11,1},{GW,10,1},{BX,0,8},{BW,11,1},{BW,10,1} } },
+                { true, 1, 16, { 4, 4, 4 }, { {RW,0,10},{GW,0,10},{BW,0,10},{RX,0,4},{RW,15,1},{RW,14,1},{RW,13,1},{RW,12,1},{RW,11,1},{RW,10,1},{GX,0,4},{GW,15,1},{GW,14,1},{GW,13,1},{GW,12,1},{GW,11,1},{GW,10,1},{BX,0,4},{BW,15,1},{BW,14,1},{BW,13,1},{BW,12,1},{BW,11,1},{BW,10,1} } }
+            };
+
+            // Mode numbers are indexed by the 5-bit value, two-bit modes are 0b00 and 0b01
+            constexpr int32_t modeLookup[32] = {
+                0, 1, 2, 10, 0, 1, 3, 11, 0, 1, 4, 12, 0, 1, 5, 13,
+                0, 1, 6, -1, 0, 1, 7, -1, 0, 1, 8, -1, 0, 1, 9, -1
+            };
+
+            uint32_t modeValue = this->ReadBits(2);
+            if (modeValue > 1)
+                modeValue |= this->ReadBits(3) << 2;
+
+            const auto modeIndex = modeLookup[modeValue];
+            if (modeIndex < 0) {
+                std::fill(pTexels, pTexels + 16, Hawk::Math::Vec3(0.0f, 0.0f, 0.0f));
+                return;
+            }
+
+            auto const& mode = modes[modeIndex];
+
+            int32_t endpoints[12] = {};
+            for (auto const& segment : mode.Segments)
+                for (uint32_t index = 0; index < segment.Count; index++)
+                    endpoints[segment.Field] |= this->ReadBits(1) << (segment.First + index);
+
+            const uint32_t partition = mode.RegionCount == 2 ? this->ReadBits(5) : 0;
+            const uint32_t endpointCount = 2 * mode.RegionCount;
+
+            // Endpoints are stored per channel as [W, X, Y, Z] = [E0, E1, E2, E3]
+            for (uint32_t channel = 0; channel < 3; channel++) {
+                int32_t* pChannel = &endpoints[4 * channel];
+                if (m_IsSigned)
+                    pChannel[0] = SignExtend(pChannel[0], mode.EndpointBits);
+
+                for (uint32_t index = 1; index < endpointCount; index++) {
+                    if (mode.IsTransformed) {
+                        pChannel[index] = SignExtend(pChannel[index], mode.DeltaBits[channel]);
+                        pChannel[index] = (pChannel[0] + pChannel[index]) & ((1 << mode.EndpointBits) - 1);
+                        if (m_IsSigned)
+                            pChannel[index] = SignExtend(pChannel[index], mode.EndpointBits);
+                    } else if (m_IsSigned) {
+                        pChannel[index] = SignExtend(pChannel[index], mode.EndpointBits);
+                    }
+                }
+
+                for (uint32_t index = 0; index < endpointCount; index++)
+                    pChannel[index] = this->Unquantize(pChannel[index], mode.EndpointBits);
+            }
+
+            constexpr uint16_t partitionMasks[32] = {
+                0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+                0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+                0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+                0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C
+            };
+
+            constexpr uint8_t anchorIndices[32] = {
+                15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+                15, 2, 8, 2, 2, 8, 8, 15, 2, 8, 2, 2, 8, 8, 2, 2
+            };
+
+            constexpr int32_t weights3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+            constexpr int32_t weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+            for (uint32_t pixel = 0; pixel < 16; pixel++) {
+                const uint32_t subset = mode.RegionCount == 2 ? (partitionMasks[partition] >> pixel) & 0x1 : 0;
+                const bool isAnchor = pixel == 0 || (mode.RegionCount == 2 && pixel == anchorIndices[partition]);
+                const uint32_t indexBits = (mode.RegionCount == 2 ? 3 : 4) - (isAnchor ? 1 : 0);
+                const uint32_t index = this->ReadBits(indexBits);
+                const int32_t weight = mode.RegionCount == 2 ? weights3[index] : weights4[index];
+
+                F32 color[3] = {};
+                for (uint32_t channel = 0; channel < 3; channel++) {
+                    const int32_t e0 = endpoints[4 * channel + 2 * subset + 0];
+                    const int32_t e1 = endpoints[4 * channel + 2 * subset + 1];
+                    color[channel] = HalfToFloat(this->FinishUnquantize((e0 * (64 - weight) + e1 * weight + 32) >> 6));
+                }
+                pTexels[pixel] = Hawk::Math::Vec3(color[0], color[1], color[2]);
+            }
+        }
+
+    private:
+        uint32_t ReadBits(uint32_t count) {
+
+            uint32_t value = 0;
+            for (uint32_t index = 0; index < count; index++, m_Position++)
+                value |= ((m_Bits[m_Position >> 3] >> (m_Position & 0x7)) & 0x1) << index;
+            return value;
+        }
+
+        static int32_t SignExtend(int32_t value, uint32_t bits) {
+
+            const int32_t mask = 1 << (bits - 1);
+            value &= (1 << bits) - 1;
+            return (value ^ mask) - mask;
+        }
+
+        int32_t Unquantize(int32_t value, uint32_t bits) const {
+
+            if (!m_IsSigned) {
+                if (bits >= 15)
+                    return value;
+                if (value == 0)
+                    return 0;
+                if (value == ((1 << bits) - 1))
+                    return 0xFFFF;
+                return ((value << 16) + 0x8000) >> bits;
+            }
+
+            if (bits >= 16)
+                return value;
+
+            const bool isNegative = value < 0;
+            int32_t magnitude = isNegative ? -value : value;
+            if (magnitude != 0) {
+                if (magnitude >= ((1 << (bits - 1)) - 1))
+                    magnitude = 0x7FFF;
+                else
+                    magnitude = ((magnitude << 15) + 0x4000) >> (bits - 1);
+            }
+            return isNegative ? -magnitude : magnitude;
+        }
+
+        uint16_t FinishUnquantize(int32_t value) const {
+
+            if (!m_IsSigned)
+                return static_cast<uint16_t>((value * 31) >> 6);
+
+            return value < 0 ? static_cast<uint16_t>(0x8000 | (((-value) * 31) >> 5)) : static_cast<uint16_t>((value * 31) >> 5);
+        }
+
+    private:
+        uint8_t  m_Bits[16] = {};
+        uint32_t m_Position = 0;
+        bool     m_IsSigned = false;
+    };
+}
+
+void EnvironmentMap::LoadFromFile(std::string const& fileName) {
+
+    std::ifstream file(fileName, std::ios::binary);
+    if (!file.is_open())
+        throw std::runtime_error("Failed to open file: " + fileName);
+
+    uint32_t header[32] = {};
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!file || header[0] != DDSMagic)
+        throw std::runtime_error("Invalid DDS file: " + fileName);
+
+    const uint32_t height = header[3];
+    const uint32_t width = header[4];
+    const uint32_t fourCC = header[21];
+
+    uint32_t format = 0;
+    if (fourCC == DDSFourCCDX10) {
+        uint32_t headerDX10[5] = {};
+        file.read(reinterpret_cast<char*>(headerDX10), sizeof(headerDX10));
+        format = headerDX10[0];
+    } else if (fourCC == D3DFMTA16B16G16R16F) {
+        format = DXGIFormatR16G16B16A16Float;
+    } else if (fourCC == D3DFMTA32B32G32R32F) {
+        format = DXGIFormatR32G32B32A32Float;
+    }
+
+    std::vector<Hawk::Math::Vec3> texels(size_t(width) * height);
+    switch (format) {
+        case DXGIFormatBC6HUF16:
+        case DXGIFormatBC6HSF16: {
+            const uint32_t blocksX = (width + 3) / 4;
+            const uint32_t blocksY = (height + 3) / 4;
+
+            std::vector<uint8_t> blocks(size_t(blocksX) * blocksY * 16);
+            file.read(reinterpret_cast<char*>(std::data(blocks)), std::size(blocks));
+
+            Hawk::Math::Vec3 block[16];
+            for (uint32_t blockY = 0; blockY < blocksY; blockY++) {
+                for (uint32_t blockX = 0; blockX < blocksX; blockX++) {
+                    BC6HBlockDecoder(&blocks[16 * (size_t(blockY) * blocksX + blockX)], format == DXGIFormatBC6HSF16).Decode(block);
+                    for (uint32_t pixel = 0; pixel < 16; pixel++) {
+                        const uint32_t x = 4 * blockX + (pixel & 0x3);
+                        const uint32_t y = 4 * blockY + (pixel >> 2);
+                        if (x < width && y < height)
+                            texels[size_t(y) * width + x] = block[pixel];
+                    }
+                }
+            }
+            break;
+        }
+        case DXGIFormatR16G16B16A16Float: {
+            std::vector<uint16_t> data(4 * std::size(texels));
+            file.read(reinterpret_cast<char*>(std::data(data)), sizeof(uint16_t) * std::size(data));
+            for (size_t index = 0; index < std::size(texels); index++)
+                texels[index] = Hawk::Math::Vec3(HalfToFloat(data[4 * index + 0]), HalfToFloat(data[4 * index + 1]), HalfToFloat(data[4 * index + 2]));
+            break;
+        }
+        case DXGIFormatR32G32B32A32Float: {
+            std::vector<F32> data(4 * std::size(texels));
+            file.read(reinterpret_cast<char*>(std::data(data)), sizeof(F32) * std::size(data));
+            for (size_t index = 0; index < std::size(texels); index++)
+                texels[index] = Hawk::Math::Vec3(data[4 * index + 0], data[4 * index + 1], data[4 * index + 2]);
+            break;
+        }
+        default:
+            throw std::runtime_error("Unsupported DDS format: " + fileName);
+    }
+
+    if (!file)
+        throw std::runtime_error("Failed to read file: " + fileName);
+
+    this->Initialize(width, height, std::move(texels));
+}
+
+void EnvironmentMap::Initialize(uint32_t width, uint32_t height, std::vector<Hawk::Math::Vec3>&& texels) {
+
+    assert(std::size(texels) == size_t(width) * height);
+
+    m_Width = width;
+    m_Height = height;
+    m_Texels = std::move(texels);
+    this->BuildAliasTable();
+}
+
+Hawk::Math::Vec3 EnvironmentMap::SampleTexcoord(Hawk::Math::Vec2 const& texcoord) const {
+
+    const auto u = texcoord.x * m_Width - 0.5f;
+    const auto v = texcoord.y * m_Height - 0.5f;
+
+    const auto x0 = static_cast<int32_t>(std::floor(u));
+    const auto y0 = static_cast<int32_t>(std::floor(v));
+
+    const auto fx = u - x0;
+    const auto fy = v - y0;
+
+    auto Load = [&](int32_t x, int32_t y) -> Hawk::Math::Vec3 {
+        x = ((x % int32_t(m_Width)) + int32_t(m_Width)) % int32_t(m_Width);
+        y = ((y % int32_t(m_Height)) + int32_t(m_Height)) % int32_t(m_Height);
+        return m_Texels[size_t(y) * m_Width + x];
+    };
+
+    const auto c0 = Load(x0, y0 + 0) + fx * (Load(x0 + 1, y0 + 0) - Load(x0, y0 + 0));
+    const auto c1 = Load(x0, y0 + 1) + fx * (Load(x0 + 1, y0 + 1) - Load(x0, y0 + 1));
+    return c0 + fy * (c1 - c0);
+}
+
+Hawk::Math::Vec3 EnvironmentMap::Sample(Hawk::Math::Vec3 const& direction) const {
+
+    const auto theta = std::acos(std::clamp(direction.y, -1.0f, 1.0f)) / Pi;
+    const auto phi = std::atan2(direction.x, -direction.z) / Pi * 0.5f;
+    return this->SampleTexcoord(Hawk::Math::Vec2(phi, theta));
+}
+
+Hawk::Math::Vec3 EnvironmentMap::SampleDirection(F32 u0, F32 u1, F32 u2, F32 u3, F32& pdf) const {
+
+    const size_t count = std::size(m_AliasTable);
+
+    size_t index = std::min(static_cast<size_t>(u0 * count), count - 1);
+    if (u1 >= m_AliasTable[index].Probability)
+        index = m_AliasTable[index].Alias;
+
+    const F32 theta = Pi * (index / m_Width + u3) / m_Height;
+    const F32 phi = 2.0f * Pi * (index % m_Width + u2) / m_Width;
+    const F32 sinTheta = std::sin(theta);
+
+    // Texel densities are over [0, 1]^2, the lat-long mapping stretches a texel over 2 pi^2 sin(theta) of solid angle
+    pdf = sinTheta > 0.0f ? m_AliasTable[index].Pdf / (2.0f * Pi * Pi * sinTheta) : 0.0f;
+    return Hawk::Math::Vec3(sinTheta * std::sin(phi), std::cos(theta), -sinTheta * std::cos(phi));
+}
+
+F32 EnvironmentMap::EvaluatePdf(Hawk::Math::Vec3 const& direction) const {
+
+    const F32 cosTheta = std::clamp(direction.y, -1.0f, 1.0f);
+    const F32 sinTheta = std::sqrt(std::max(0.0f, 1.0f - cosTheta * cosTheta));
+    if (sinTheta == 0.0f)
+        return 0.0f;
+
+    const F32 u = std::atan2(direction.x, -direction.z) / Pi * 0.5f;
+    const F32 v = std::acos(cosTheta) / Pi;
+
+    const int32_t x = ((static_cast<int32_t>(std::floor(u * m_Width)) % int32_t(m_Width)) + int32_t(m_Width)) % int32_t(m_Width);
+    const int32_t y = std::min(static_cast<int32_t>(v * m_Height), int32_t(m_Height) - 1);
+    return m_AliasTable[size_t(y) * m_Width + x].Pdf / (2.0f * Pi * Pi * sinTheta);
+}
+
+void EnvironmentMap::BuildAliasTable() {
+
+    const size_t count = std::size(m_Texels);
+
+    // Luminance times sin(theta), the solid angle of a texel shrinks towards the poles
+    std::vector<F64> weights(count);
+    F64 weightSum = 0.0;
+    for (uint32_t y = 0; y < m_Height; y++) {
+        const F64 sinTheta = std::sin(Pi * (y + 0.5) / m_Height);
+        for (uint32_t x = 0; x < m_Width; x++) {
+            const size_t index = size_t(y) * m_Width + x;
+            const F64 luminance = 0.2126 * m_Texels[index].x + 0.7152 * m_Texels[index].y + 0.0722 * m_Texels[index].z;
+            weights[index] = luminance > 0.0 ? luminance * sinTheta : 0.0;
+            weightSum += weights[index];
+        }
+    }
+
+    if (!(weightSum > 0.0)) {
+        std::fill(weights.begin(), weights.end(), 1.0);
+        weightSum = F64(count);
+    }
+
+    // Vose's method: under-full entries take the rest of their bucket from an over-full one
+    std::vector<F64> scaled(count);
+    std::vector<uint32_t> small;
+    std::vector<uint32_t> large;
+    m_AliasTable.resize(count);
+    for (size_t index = 0; index < count; index++) {
+        scaled[index] = weights[index] * count / weightSum;
+        m_AliasTable[index].Pdf = static_cast<F32>(scaled[index]);
+        (scaled[index] < 1.0 ? small : large).push_back(static_cast<uint32_t>(index));
+    }
+
+    while (!small.empty() && !large.empty()) {
+        const uint32_t indexSmall = small.back();
+        const uint32_t indexLarge = large.back();
+        small.pop_back();
+
+        m_AliasTable[indexSmall].Probability = static_cast<F32>(scaled[indexSmall]);
+        m_AliasTable[indexSmall].Alias = indexLarge;
+
+        scaled[indexLarge] -= 1.0 - scaled[indexSmall];
+        if (scaled[indexLarge] < 1.0) {
+            large.pop_back();
+            small.push_back(indexLarge);
+        }
+    }
+
+    // Leftovers are full up to rounding
+    for (uint32_t index : large)
+        m_AliasTable[index] = { 1.0f, index, m_AliasTable[index].Pdf };
+    for (uint32_t index : small)
+        m_AliasTable[index] = { 1.0f, index, m_AliasTable[index].Pdf };
+}
@@ -0,0 +1,198 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "MajorantGrid.h"
+
+void MajorantGrid::Initialize(VolumeData const& volume, uint32_t mipLevel) {
+
+    const auto dimension = volume.GetDimension(mipLevel);
+
+    m_MipLevel = mipLevel;
+    m_MipLevelMax = std::min(mipLevel + MipLevelRange, volume.GetMipLevelCount() - 1);
+    m_Dimension = Hawk::Math::Vec3u((dimension.x + CellSize - 1) / CellSize, (dimension.y + CellSize - 1) / CellSize, (dimension.z + CellSize - 1) / CellSize);
+
+    // Voxels touched by linear filtering anywhere in [cell / grid, (cell + 1) / grid) of the normalized coordinates
+    auto VoxelRange = [](uint32_t cell, uint32_t cellCount, uint32_t voxelCount) -> std::pair<int32_t, int32_t> {
+        const F64 scale = F64(voxelCount) / cellCount;
+        return { static_cast<int32_t>(std::floor(cell * scale - 0.5)), static_cast<int32_t>(std::floor((cell + 1) * scale - 0.5)) + 1 };
+    };
+
+    m_Ranges.assign(size_t(m_Dimension.x) * m_Dimension.y * m_Dimension.z, IntensityRange{ uint16_t(0xFFFF), uint16_t(0) });
+    for (uint32_t level = m_MipLevel; level <= m_MipLevelMax; level++) {
+        const auto levelDimension = volume.GetDimension(level);
+        auto const& intensity = volume.GetIntensity(level);
+
+        for (uint32_t cellZ = 0; cellZ < m_Dimension.z; cellZ++) {
+            for (uint32_t cellY = 0; cellY < m_Dimension.y; cellY++) {
+                for (uint32_t cellX = 0; cellX < m_Dimension.x; cellX++) {
+                    const auto [x0, x1] = VoxelRange(cellX, m_Dimension.x, levelDimension.x);
+                    const auto [y0, y1] = VoxelRange(cellY, m_Dimension.y, levelDimension.y);
+                    const auto [z0, z1] = VoxelRange(cellZ, m_Dimension.z, levelDimension.z);
+
+                    // The border color is zero
+                    auto& range = m_Ranges[(size_t(cellZ) * m_Dimension.y + cellY) * m_Dimension.x + cellX];
+                    if (x0 < 0 || y0 < 0 || z0 < 0 || x1 >= int32_t(levelDimension.x) || y1 >= int32_t(levelDimension.y) || z1 >= int32_t(levelDimension.z))
+                        range.Min = 0;
+
+                    for (int32_t z = std::max(z0, 0); z <= std::min(z1, int32_t(levelDimension.z) - 1); z++) {
+                        for (int32_t y = std::max(y0, 0); y <= std::min(y1, int32_t(levelDimension.y) - 1); y++) {
+                            const auto pRow = &intensity[(size_t(z) * levelDimension.y + size_t(y)) * levelDimension.x];
+                            for (int32_t x = std::max(x0, 0); x <= std::min(x1, int32_t(levelDimension.x) - 1); x++) {
+                                range.Min = std::min(range.Min, pRow[x]);
+                                range.Max = std::max(range.Max, pRow[x]);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // A cell holds at most CellSize voxels per axis of the base level, the counts fit 16 bits
+    auto CellIndices = [](uint32_t voxelCount, uint32_t cellCount) -> std::vector<uint32_t> {
+        std::vector<uint32_t> cells(voxelCount);
+        for (uint32_t voxel = 0; voxel < voxelCount; voxel++)
+            cells[voxel] = static_cast<uint32_t>((uint64_t(2 * voxel + 1) * cellCount) / (2 * uint64_t(voxelCount)));
+        return cells;
+    };
+
+    const auto cellsX = CellIndices(dimension.x, m_Dimension.x);
+    const auto cellsY = CellIndices(dimension.y, m_Dimension.y);
+    const auto cellsZ = CellIndices(dimension.z, m_Dimension.z);
+    auto const& intensity = volume.GetIntensity(mipLevel);
+
+    m_Histograms.assign(std::size(m_Ranges) * HistogramBinCount, 0);
+    for (uint32_t z = 0; z < dimension.z; z++) {
+        for (uint32_t y = 0; y < dimension.y; y++) {
+            const auto pRow = &intensity[(size_t(z) * dimension.y + size_t(y)) * dimension.x];
+            const auto pCells = &m_Histograms[(size_t(cellsZ[z]) * m_Dimension.y + cellsY[y]) * m_Dimension.x * HistogramBinCount];
+            for (uint32_t x = 0; x < dimension.x; x++)
+                pCells[size_t(cellsX[x]) * HistogramBinCount + pRow[x] * HistogramBinCount / 65536]++;
+        }
+    }
+
+    m_Majorants.assign(std::size(m_Ranges), 0.0f);
+    m_Minorants.assign(std::size(m_Ranges), 0.0f);
+    m_Controls.assign(std::size(m_Ranges), Control{});
+}
+
+void MajorantGrid::Update(ScalarTransferFunction1D const& opacity, uint32_t samplingCount, Shading::ClipRegion const& clipRegion) {
+
+    // Texel i of the table holds the opacity at i / (count - 1). Below a quarter of a R8_UNORM step the texels round
+    // to zero with a margin, so the cells the index finds invisible have only zero texels whatever the rounding.
+    const auto opacityTable = opacity.GenerateTable(samplingCount);
+    const auto count = static_cast<int32_t>(std::size(opacityTable));
+    const auto texelSize = 1.0f / F32(count - 1);
+    m_OpacityIndex.Build(opacity.PLF, 0.25f / 255.0f);
+
+    // Mean of the texels over the intensities of every histogram bin, the nearest texel when a bin holds none
+    std::array<F32, HistogramBinCount> binOpacity = {};
+    for (uint32_t bin = 0; bin < HistogramBinCount; bin++) {
+        const auto first = static_cast<int32_t>(std::ceil(F32(bin) / HistogramBinCount * (count - 1)));
+        const auto last = bin + 1 < HistogramBinCount ? static_cast<int32_t>(std::ceil(F32(bin + 1) / HistogramBinCount * (count - 1))) - 1 : count - 1;
+
+        uint32_t sum = 0;
+        for (int32_t texel = first; texel <= last; texel++)
+            sum += opacityTable[texel];
+        binOpacity[bin] = last >= first ? sum / (255.0f * F32(last - first + 1)) : opacityTable[static_cast<int32_t>(std::round((bin + 0.5f) / HistogramBinCount * (count - 1)))] / 255.0f;
+    }
+
+    m_Majorants.resize(std::size(m_Ranges));
+    m_Minorants.resize(std::size(m_Ranges));
+    m_Controls.resize(std::size(m_Ranges));
+    for (size_t index = 0; index < std::size(m_Ranges); index++) {
+        // A linear lookup in [a, b] blends the texels from floor(a * count - 0.5) to floor(b * count - 0.5) + 1
+        const auto first = static_cast<int32_t>(std::floor(m_Ranges[index].Min / 65535.0f * count - 0.5f));
+        const auto last = static_cast<int32_t>(std::floor(m_Ranges[index].Max / 65535.0f * count - 0.5f)) + 1;
+
+        // Most cells hold air or tissue the transfer function hides, they are rejected without scanning their texels
+        if (!m_OpacityIndex.IsVisible((F32(first) - 0.5f) * texelSize, (F32(last) + 0.5f) * texelSize)) {
+            m_Majorants[index] = 0.0f;
+            m_Minorants[index] = 0.0f;
+            m_Controls[index] = Control{};
+            continue;
+        }
+
+        // Texels outside of the table read the zero border color
+        uint8_t majorant = 0;
+        uint8_t minorant = (first < 0 || last >= count) ? 0 : 0xFF;
+        for (int32_t texel = std::max(first, 0); texel <= std::min(last, count - 1); texel++) {
+            majorant = std::max(majorant, opacityTable[texel]);
+            minorant = std::min(minorant, opacityTable[texel]);
+        }
+        m_Majorants[index] = majorant / 255.0f;
+        m_Minorants[index] = minorant / 255.0f;
+
+        // Any control keeps residual ratio tracking unbiased as long as the residual bounds the distance to it
+        F32 sum = 0.0f;
+        uint32_t voxelCount = 0;
+        const auto pHistogram = &m_Histograms[index * HistogramBinCount];
+        for (uint32_t bin = 0; bin < HistogramBinCount; bin++) {
+            sum += pHistogram[bin] * binOpacity[bin];
+            voxelCount += pHistogram[bin];
+        }
+        const F32 mean = std::clamp(voxelCount > 0 ? sum / F32(voxelCount) : 0.0f, m_Minorants[index], m_Majorants[index]);
+        m_Controls[index] = Control{ mean, std::max(m_Majorants[index] - mean, mean - m_Minorants[index]) };
+    }
+
+    // Culled cells read as empty, so rays skip them and the content bounds shrink to the clip region
+    const auto cellSize = (VolumeBoundingBoxMax - VolumeBoundingBoxMin) / Hawk::Math::Vec3(F32(m_Dimension.x), F32(m_Dimension.y), F32(m_Dimension.z));
+
+    for (uint32_t cellZ = 0; cellZ < m_Dimension.z; cellZ++) {
+        for (uint32_t cellY = 0; cellY < m_Dimension.y; cellY++) {
+            for (uint32_t cellX = 0; cellX < m_Dimension.x; cellX++) {
+                const auto cellMin = VolumeBoundingBoxMin + Hawk::Math::Vec3(F32(cellX), F32(cellY), F32(cellZ)) * cellSize;
+                if (Shading::IsOutsideClipRegion({ cellMin, cellMin + cellSize }, clipRegion)) {
+                    m_Majorants[this->CellIndex(cellX, cellY, cellZ)] = 0.0f;
+                    m_Minorants[this->CellIndex(cellX, cellY, cellZ)] = 0.0f;
+                    m_Controls[this->CellIndex(cellX, cellY, cellZ)] = Control{};
+                }
+            }
+        }
+    }
+
+    // The majorants bound the opacity over every mip level rays sample, so the cells outside the bounds are empty for all of them
+    Hawk::Math::Vec3u cellMin = m_Dimension;
+    Hawk::Math::Vec3u cellMax = Hawk::Math::Vec3u(0u, 0u, 0u);
+    for (uint32_t cellZ = 0; cellZ < m_Dimension.z; cellZ++) {
+        for (uint32_t cellY = 0; cellY < m_Dimension.y; cellY++) {
+            const auto pRow = &m_Majorants[this->CellIndex(0, cellY, cellZ)];
+            for (uint32_t cellX = 0; cellX < m_Dimension.x; cellX++) {
+                if (pRow[cellX] > 0.0f) {
+                    cellMin = Hawk::Math::Vec3u(std::min(cellMin.x, cellX), std::min(cellMin.y, cellY), std::min(cellMin.z, cellZ));
+                    cellMax = Hawk::Math::Vec3u(std::max(cellMax.x, cellX + 1), std::max(cellMax.y, cellY + 1), std::max(cellMax.z, cellZ + 1));
+                }
+            }
+        }
+    }
+
+    const auto dimension = Hawk::Math::Vec3(F32(m_Dimension.x), F32(m_Dimension.y), F32(m_Dimension.z));
+    if (cellMax.x == 0) {
+        m_ContentMin = Hawk::Math::Vec3(0.0f, 0.0f, 0.0f);
+        m_ContentMax = Hawk::Math::Vec3(0.0f, 0.0f, 0.0f);
+    } else {
+        m_ContentMin = Hawk::Math::Vec3(F32(cellMin.x), F32(cellMin.y), F32(cellMin.z)) / dimension;
+        m_ContentMax = Hawk::Math::Vec3(F32(cellMax.x), F32(cellMax.y), F32(cellMax.z)) / dimension;
+    }
+}
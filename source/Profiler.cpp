@@ -0,0 +1,129 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Profiler.h"
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+#include <stdexcept>
+
+Profiler::Profiler()
+    : m_TimeStart(std::chrono::high_resolution_clock::now()) {
+
+    m_Frames.push_back(Frame{ 0 });
+}
+
+void Profiler::BeginFrame() {
+
+    assert(m_ScopeStack.empty() && "A frame begins with a scope still open");
+
+    m_FrameIndex++;
+    m_Frames.push_back(Frame{ m_FrameIndex });
+    while (std::size(m_Frames) > TraceFrameCount)
+        m_Frames.pop_front();
+}
+
+void Profiler::BeginScope(std::string_view name) {
+
+    Event event = {};
+    event.Name = name;
+    event.Timeline = TimelineCPU;
+    event.Depth = this->GetDepth();
+    event.FrameIndex = m_FrameIndex;
+    event.Begin = this->GetTime();
+    m_ScopeStack.push_back(std::move(event));
+}
+
+void Profiler::EndScope() {
+
+    assert(!m_ScopeStack.empty() && "A scope ends without a scope open");
+
+    Event event = std::move(m_ScopeStack.back());
+    m_ScopeStack.pop_back();
+    event.End = this->GetTime();
+    this->AddEvent(event);
+}
+
+void Profiler::AddEvent(Event const& event) {
+
+    Pass& pass = this->GetPass(event.Name, event.Timeline, event.Depth);
+    pass.Times.Push(static_cast<F32>(event.End - event.Begin));
+
+    // The GPU events of the frames that have left the trace only go to the history
+    const uint32_t frameFirst = m_Frames.front().Index;
+    if (event.FrameIndex >= frameFirst && event.FrameIndex - frameFirst < std::size(m_Frames))
+        m_Frames[event.FrameIndex - frameFirst].Events.push_back(event);
+}
+
+F64 Profiler::GetTime() const {
+
+    return std::chrono::duration<F64>(std::chrono::high_resolution_clock::now() - m_TimeStart).count();
+}
+
+Profiler::Pass const* Profiler::FindPass(std::string_view name, Timeline timeline) const {
+
+    auto iterator = std::find_if(m_Passes.begin(), m_Passes.end(), [&](Pass const& pass) { return pass.Timeline == timeline && pass.Name == name; });
+    return iterator != m_Passes.end() ? &*iterator : nullptr;
+}
+
+Profiler::Pass& Profiler::GetPass(std::string_view name, Timeline timeline, uint32_t depth) {
+
+    if (auto pPass = this->FindPass(name, timeline))
+        return const_cast<Pass&>(*pPass);
+
+    Pass pass = {};
+    pass.Name = name;
+    pass.Timeline = timeline;
+    pass.Depth = depth;
+    return m_Passes.emplace_back(std::move(pass));
+}
+
+void Profiler::WriteChromeTrace(std::string const& fileName) const {
+
+    // Complete events ("ph": "X") in microseconds, one track per timeline
+    nlohmann::json events = nlohmann::json::array();
+    for (uint32_t timeline : { TimelineCPU, TimelineGPU }) {
+        events.push_back({
+            { "name", "thread_name" }, { "ph", "M" }, { "pid", 0 }, { "tid", timeline },
+            { "args", { { "name", timeline == TimelineCPU ? "CPU" : "GPU" } } }
+        });
+    }
+
+    for (auto const& frame : m_Frames) {
+        for (auto const& event : frame.Events) {
+            events.push_back({
+                { "name", event.Name }, { "cat", event.Timeline == TimelineCPU ? "CPU" : "GPU" }, { "ph", "X" },
+                { "ts", 1.0e6 * event.Begin }, { "dur", 1.0e6 * (event.End - event.Begin) },
+                { "pid", 0 }, { "tid", event.Timeline }, { "args", { { "frame", event.FrameIndex } } }
+            });
+        }
+    }
+
+    std::ofstream file(fileName);
+    if (!file.is_open())
+        throw std::runtime_error("Failed to open file: " + fileName);
+    file << nlohmann::json{ { "traceEvents", events }, { "displayTimeUnit", "ms" } }.dump();
+}
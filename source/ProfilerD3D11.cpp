@@ -0,0 +1,158 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ProfilerD3D11.h"
+
+#include <cstring>
+#include <limits>
+
+ProfilerD3D11::ProfilerD3D11(DX::ComPtr<ID3D11Device> pDevice, DX::ComPtr<ID3D11DeviceContext> pImmediateContext, DX::ComPtr<ID3DUserDefinedAnnotation> pAnnotation, Profiler& profiler)
+    : m_pImmediateContext(pImmediateContext)
+    , m_pAnnotation(pAnnotation)
+    , m_Profiler(profiler) {
+
+    D3D11_QUERY_DESC desc = {};
+    for (auto& frame : m_Frames) {
+        desc.Query = D3D11_QUERY_TIMESTAMP_DISJOINT;
+        DX::ThrowIfFailed(pDevice->CreateQuery(&desc, frame.pQueryDisjoint.ReleaseAndGetAddressOf()));
+        desc.Query = D3D11_QUERY_TIMESTAMP;
+        for (auto& pQuery : frame.pQueryTimestamps)
+            DX::ThrowIfFailed(pDevice->CreateQuery(&desc, pQuery.ReleaseAndGetAddressOf()));
+    }
+}
+
+void ProfilerD3D11::BeginFrame() {
+
+    assert(!m_IsFrameActive && "A frame begins before the last one has ended");
+
+    // A frame that is still not ready after FrameCount frames is dropped
+    this->Resolve();
+
+    auto& frame = m_Frames[m_FrameSlot];
+    frame.Scopes.clear();
+    frame.TimestampCount = 1;
+    frame.FrameIndex = m_Profiler.GetFrameIndex();
+    frame.Time = m_Profiler.GetTime();
+    frame.IsPending = false;
+
+    m_pImmediateContext->Begin(frame.pQueryDisjoint.Get());
+    m_pImmediateContext->End(frame.pQueryTimestamps[0].Get());
+    m_IsFrameActive = true;
+}
+
+void ProfilerD3D11::EndFrame() {
+
+    assert(m_IsFrameActive && m_ScopeStack.empty() && "A frame ends with a scope still open");
+
+    auto& frame = m_Frames[m_FrameSlot];
+    m_pImmediateContext->End(frame.pQueryTimestamps[frame.TimestampCount++].Get());
+    m_pImmediateContext->End(frame.pQueryDisjoint.Get());
+    frame.IsPending = true;
+
+    m_FrameSlot = (m_FrameSlot + 1) % FrameCount;
+    m_IsFrameActive = false;
+}
+
+void ProfilerD3D11::BeginScope(char const* name) {
+
+    m_pAnnotation->BeginEvent(std::wstring(name, name + std::strlen(name)).c_str());
+    m_Profiler.BeginScope(name);
+
+    auto& frame = m_Frames[m_FrameSlot];
+    if (!m_IsFrameActive || std::size(frame.Scopes) == ScopeCountMax) {
+        m_ScopeStack.push_back(std::numeric_limits<uint32_t>::max());
+        return;
+    }
+
+    // The frame is the root of the GPU timeline
+    ScopeRecord scope = {};
+    scope.Name = name;
+    scope.Depth = static_cast<uint32_t>(std::size(m_ScopeStack)) + 1;
+    scope.TimestampBegin = frame.TimestampCount++;
+    m_pImmediateContext->End(frame.pQueryTimestamps[scope.TimestampBegin].Get());
+
+    m_ScopeStack.push_back(static_cast<uint32_t>(std::size(frame.Scopes)));
+    frame.Scopes.push_back(std::move(scope));
+}
+
+void ProfilerD3D11::EndScope() {
+
+    assert(!m_ScopeStack.empty() && "A scope ends without a scope open");
+
+    const uint32_t scopeIndex = m_ScopeStack.back();
+    m_ScopeStack.pop_back();
+
+    if (scopeIndex != std::numeric_limits<uint32_t>::max()) {
+        auto& frame = m_Frames[m_FrameSlot];
+        auto& scope = frame.Scopes[scopeIndex];
+        scope.TimestampEnd = frame.TimestampCount++;
+        m_pImmediateContext->End(frame.pQueryTimestamps[scope.TimestampEnd].Get());
+    }
+
+    m_Profiler.EndScope();
+    m_pAnnotation->EndEvent();
+}
+
+void ProfilerD3D11::Resolve() {
+
+    // From the oldest frame to the newest, a newer frame is not ready before an older one
+    for (uint32_t offset = 0; offset < FrameCount; offset++) {
+        auto& frame = m_Frames[(m_FrameSlot + offset) % FrameCount];
+        if (!frame.IsPending)
+            continue;
+
+        D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint = {};
+        if (m_pImmediateContext->GetData(frame.pQueryDisjoint.Get(), &disjoint, sizeof(disjoint), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+            return;
+
+        std::array<uint64_t, std::tuple_size_v<decltype(frame.pQueryTimestamps)>> timestamps = {};
+        for (uint32_t index = 0; index < frame.TimestampCount; index++)
+            if (m_pImmediateContext->GetData(frame.pQueryTimestamps[index].Get(), &timestamps[index], sizeof(uint64_t), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+                return;
+
+        frame.IsPending = false;
+        if (disjoint.Disjoint)
+            continue;
+
+        auto GetTime = [&](uint32_t index) -> F64 {
+            return frame.Time + F64(timestamps[index] - timestamps[0]) / F64(disjoint.Frequency);
+        };
+
+        Profiler::Event event = {};
+        event.Name = "Frame";
+        event.Timeline = Profiler::TimelineGPU;
+        event.FrameIndex = frame.FrameIndex;
+        event.Begin = GetTime(0);
+        event.End = GetTime(frame.TimestampCount - 1);
+        m_Profiler.AddEvent(event);
+
+        for (auto const& scope : frame.Scopes) {
+            event.Name = scope.Name;
+            event.Depth = scope.Depth;
+            event.Begin = GetTime(scope.TimestampBegin);
+            event.End = GetTime(scope.TimestampEnd);
+            m_Profiler.AddEvent(event);
+        }
+    }
+}
@@ -0,0 +1,100 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "RenderStatistics.h"
+
+#include <algorithm>
+#include <cmath>
+
+void ValueHistory::Push(F32 value) {
+
+    if (m_Count < Length)
+        m_Count++;
+    else
+        m_Offset = (m_Offset + 1) % Length;
+    m_Values[(m_Offset + m_Count - 1) % Length] = value;
+}
+
+void ValueHistory::Clear() {
+
+    m_Count = 0;
+    m_Offset = 0;
+}
+
+F32 ValueHistory::GetAverage() const {
+
+    F32 sum = 0.0f;
+    for (uint32_t index = 0; index < m_Count; index++)
+        sum += (*this)[index];
+    return m_Count > 0 ? sum / F32(m_Count) : 0.0f;
+}
+
+F32 ValueHistory::GetMax() const {
+
+    F32 value = 0.0f;
+    for (uint32_t index = 0; index < m_Count; index++)
+        value = std::max(value, (*this)[index]);
+    return value;
+}
+
+ValueHistory::Percentiles ValueHistory::GetPercentiles() const {
+
+    if (m_Count == 0)
+        return {};
+
+    // The order of the ring does not matter once the values are sorted
+    std::array<F32, Length> values = m_Values;
+    std::sort(values.begin(), values.begin() + m_Count);
+
+    auto GetPercentile = [&](F32 percentile) -> F32 {
+        const auto rank = static_cast<uint32_t>(std::ceil(percentile * F32(m_Count)));
+        return values[std::clamp(rank, 1u, m_Count) - 1];
+    };
+
+    Percentiles percentiles = {};
+    percentiles.P50 = GetPercentile(0.50f);
+    percentiles.P95 = GetPercentile(0.95f);
+    percentiles.P99 = GetPercentile(0.99f);
+    return percentiles;
+}
+
+void RenderStatistics::AddFrame(Frame const& frame) {
+
+    m_FrameTimes.Push(frame.FrameTime);
+    m_RenderTimes.Push(frame.RenderTime);
+    m_SampleRates.Push(frame.RenderTime > 0.0f ? static_cast<F32>(F64(frame.SampleCount) / frame.RenderTime) : 0.0f);
+    m_ActiveTileCounts.Push(static_cast<F32>(frame.ActiveTileCount));
+    m_FrameCount++;
+    m_SampleCount += frame.SampleCount;
+}
+
+void RenderStatistics::Clear() {
+
+    m_FrameTimes.Clear();
+    m_RenderTimes.Clear();
+    m_SampleRates.Clear();
+    m_ActiveTileCounts.Clear();
+    m_FrameCount = 0;
+    m_SampleCount = 0;
+}
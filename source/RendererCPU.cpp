@@ -0,0 +1,901 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "RendererCPU.h"
+
+#include <chrono>
+#include <numeric>
+
+namespace {
+    using Hawk::Math::Vec2;
+    using Hawk::Math::Vec3;
+    using Hawk::Math::Vec4;
+    using Hawk::Math::Vec2u;
+
+    constexpr F32 Pi = 3.14159265f;
+
+    F32 Luminance(Vec3 const& color) {
+
+        return Hawk::Math::Dot(Vec3(0.2126f, 0.7152f, 0.0722f), color);
+    }
+
+    // RMS standard error of the pixel means over the mean luminance of a tile, from the sums over its pixels
+    F32 ComputeTileError(F32 luminanceSum, F32 varianceSum, uint32_t pixelCount) {
+
+        constexpr F32 LuminanceEpsilon = 1.0e-3f;
+        return std::sqrt(varianceSum / pixelCount) / (luminanceSum / pixelCount + LuminanceEpsilon);
+    }
+
+    Vec3 TransformDirection(Hawk::Math::Mat4x4 const& matrix, Vec3 const& direction) {
+
+        const auto v = matrix * Vec4(direction.x, direction.y, direction.z, 0.0f);
+        return Vec3(v.x, v.y, v.z);
+    }
+
+    Vec3 FresnelSchlick(Vec3 const& F0, F32 VdotH) {
+
+        return F0 + (Vec3(1.0f, 1.0f, 1.0f) - F0) * std::pow(1.0f - VdotH, 5.0f);
+    }
+
+    F32 GGX_PartialGeometry(F32 NdotX, F32 alpha) {
+
+        const F32 aa = alpha * alpha;
+        return 2.0f * NdotX / std::max((NdotX + std::sqrt(aa + (1.0f - aa) * (NdotX * NdotX))), 1e-6f);
+    }
+
+    F32 GGX_Distribution(F32 NdotH, F32 alpha) {
+
+        const F32 aa = alpha * alpha;
+        const F32 f = (aa - 1.0f) * NdotH * NdotH + 1.0f;
+        return aa / (Pi * f * f);
+    }
+
+    Vec3 SampleGGXDir(Vec3 const& normal, F32 alpha, Vec2 const& xi) {
+
+        const F32 phi = 2.0f * Pi * xi.x;
+        const F32 cosTheta = std::sqrt(std::max(0.0f, (1.0f - xi.y) / (1.0f + alpha * alpha * xi.y - xi.y)));
+        const F32 sinTheta = std::sqrt(std::max(0.0f, 1.0f - cosTheta * cosTheta));
+
+        const Vec3 helper = std::abs(normal.y) > 0.999f ? Vec3(0.0f, 0.0f, 1.0f) : Vec3(0.0f, 1.0f, 0.0f);
+        const Vec3 tangent = Hawk::Math::Normalize(Hawk::Math::Cross(normal, helper));
+        const Vec3 binormal = Hawk::Math::Cross(normal, tangent);
+        return std::cos(phi) * sinTheta * tangent + std::sin(phi) * sinTheta * binormal + cosTheta * normal;
+    }
+
+    struct GBuffer {
+        Vec3 Normal;
+        Vec3 View;
+        Vec3 Diffuse;
+        Vec3 Specular;
+        F32  Roughness;
+    };
+
+    F32 GetSpecularProbability(GBuffer const& buffer) {
+
+        const Vec3 F = FresnelSchlick(buffer.Specular, Shading::Saturate(Hawk::Math::Dot(buffer.Normal, buffer.View)));
+        const F32 ps = Hawk::Math::Length(F);
+        const F32 pd = Hawk::Math::Length(Vec3(1.0f, 1.0f, 1.0f) - F);
+        return ps / (ps + pd);
+    }
+
+    // Sample dimensions of the radiance vertex, as in ComputeRadiance.hlsl
+    enum RadianceDimension : uint32_t {
+        RadianceDimensionDirection = 0,
+        RadianceDimensionLobe = 2,
+        RadianceDimensionLight = 4,
+        RadianceDimensionRayBSDF = 8,
+        RadianceDimensionRayLight = 10
+    };
+
+    Vec3 SampleBSDF(GBuffer const& buffer, F32 specularProbability, Shading::CSampler const& sampler) {
+
+        const Vec2 xi = Shading::Sample2D(sampler, RadianceDimensionDirection);
+        if (Shading::Sample1D(sampler, RadianceDimensionLobe) < specularProbability)
+            return Shading::Reflect(-buffer.View, SampleGGXDir(buffer.Normal, buffer.Roughness * buffer.Roughness, xi));
+        return SampleGGXDir(buffer.Normal, 1.0f, xi);
+    }
+
+    Vec3 EvaluateBSDF(GBuffer const& buffer, Vec3 const& L, F32 specularProbability, F32& pdf) {
+
+        const Vec3 N = buffer.Normal;
+        const Vec3 V = buffer.View;
+        const Vec3 H = Hawk::Math::Normalize(V + L);
+        const F32 alpha = buffer.Roughness * buffer.Roughness;
+
+        const F32 NdotL = Hawk::Math::Dot(N, L);
+        const F32 NdotV = Shading::Saturate(Hawk::Math::Dot(N, V));
+        const F32 NdotH = Shading::Saturate(Hawk::Math::Dot(N, H));
+        const F32 VdotH = Shading::Saturate(Hawk::Math::Dot(V, H));
+
+        const F32 D = GGX_Distribution(NdotH, alpha);
+        const F32 pdfDiffuse = Shading::Saturate(NdotL) / Pi;
+        pdf = pdfDiffuse + specularProbability * (D * NdotH / std::max(4.0f * VdotH, 1e-6f) - pdfDiffuse);
+
+        if (NdotL <= 0.0f)
+            return Vec3(0.0f, 0.0f, 0.0f);
+
+        const Vec3 F = FresnelSchlick(buffer.Specular, VdotH);
+        const F32 G = GGX_PartialGeometry(NdotV, alpha) * GGX_PartialGeometry(NdotL, alpha);
+        return (Vec3(1.0f, 1.0f, 1.0f) - F) * buffer.Diffuse * (NdotL / Pi) + (D * G / std::max(4.0f * NdotV, 1e-6f)) * F;
+    }
+
+    F32 PowerHeuristic(F32 pdf, F32 pdfOther) {
+
+        return pdf * pdf / (pdf * pdf + pdfOther * pdfOther);
+    }
+
+    F32 Determinant3x3(Hawk::Math::Mat4x4 const& m) {
+
+        return m(0, 0) * (m(1, 1) * m(2, 2) - m(1, 2) * m(2, 1))
+             - m(0, 1) * (m(1, 0) * m(2, 2) - m(1, 2) * m(2, 0))
+             + m(0, 2) * (m(1, 0) * m(2, 1) - m(1, 1) * m(2, 0));
+    }
+
+    // Environment lookups and densities of ray directions, see GetEnvironmentPdf() in ComputeRadiance.hlsl
+    Vec3 GetEnvironmentDirection(FrameBuffer const& frame, Vec3 const& direction) {
+
+        return Hawk::Math::Normalize(TransformDirection(frame.NormalMatrix, direction));
+    }
+
+    F32 GetEnvironmentPdf(FrameBuffer const& frame, EnvironmentMap const& environment, Vec3 const& direction) {
+
+        const Vec3 v = TransformDirection(frame.NormalMatrix, direction);
+        const F32 r = Hawk::Math::Length(v);
+        return environment.EvaluatePdf(v / r) * std::abs(Determinant3x3(frame.NormalMatrix)) / (r * r * r);
+    }
+
+    Vec3 SampleEnvironment(FrameBuffer const& frame, EnvironmentMap const& environment, Shading::CSampler const& sampler, F32& pdf) {
+
+        const Vec2 u0 = Shading::Sample2D(sampler, RadianceDimensionLight);
+        const Vec2 u1 = Shading::Sample2D(sampler, RadianceDimensionLight + 2);
+
+        const Vec3 v = TransformDirection(frame.InvNormalMatrix, environment.SampleDirection(u0.x, u0.y, u1.x, u1.y, pdf));
+        const F32 r = Hawk::Math::Length(v);
+        pdf *= std::abs(Determinant3x3(frame.NormalMatrix)) * r * r * r;
+        return v / r;
+    }
+
+    Vec3 ToneMapUncharted2Function(Vec3 const& x, F32 exposure) {
+
+        return Vec3(Shading::ToneMapUncharted2(x.x, exposure), Shading::ToneMapUncharted2(x.y, exposure), Shading::ToneMapUncharted2(x.z, exposure));
+    }
+
+    // Storing to the R8G8B8A8_UNORM tone map target
+    F32 QuantizeUNORM8(F32 value) {
+
+        return std::round(255.0f * Shading::Saturate(value)) / 255.0f;
+    }
+}
+
+RendererCPU::RendererCPU(ThreadPool& threadPool)
+    : m_ThreadPool(threadPool)
+    , m_TileScheduler(threadPool)
+    , m_Denoiser(threadPool)
+    , m_AutoExposure(threadPool) {
+
+    m_RayQueues.resize(threadPool.GetThreadCount());
+    m_ThreadBusyTime.resize(threadPool.GetThreadCount());
+    m_ThreadSlowestTile.resize(threadPool.GetThreadCount());
+}
+
+void RendererCPU::Resize(uint32_t width, uint32_t height) {
+
+    m_Width = width;
+    m_Height = height;
+
+    const size_t count = size_t(width) * height;
+    m_Diffuse.assign(count, Vec3(0.0f, 0.0f, 0.0f));
+    m_Specular.assign(count, Vec3(0.0f, 0.0f, 0.0f));
+    m_Normal.assign(count, Vec4(0.0f, 0.0f, 0.0f, 0.0f));
+    m_Depth.assign(count, 0.0f);
+    m_Radiance.assign(count, Vec3(0.0f, 0.0f, 0.0f));
+    m_ColorSum.assign(count, Vec4(0.0f, 0.0f, 0.0f, 0.0f));
+    m_ColorMoment.assign(count, 0.0f);
+    m_ToneMap.assign(count, Vec4(0.0f, 0.0f, 0.0f, 0.0f));
+    m_Denoised.assign(count, Vec4(0.0f, 0.0f, 0.0f, 0.0f));
+    m_Denoiser.Resize(width, height);
+    m_Surface.assign(count, SurfaceSum{});
+    m_HistoryColorSum.assign(count, Vec4(0.0f, 0.0f, 0.0f, 0.0f));
+    m_HistoryColorMoment.assign(count, 0.0f);
+    m_HistorySurface.assign(count, SurfaceSum{});
+    m_IsHistoryValid = false;
+    m_TileCosts.assign(size_t((width + TileSize - 1) / TileSize) * ((height + TileSize - 1) / TileSize), 0.0f);
+    m_TileSampleCounts.assign(std::size(m_TileCosts), 0);
+    m_AutoExposure.Resize(static_cast<uint32_t>(std::size(m_TileCosts)));
+    m_Tiles.clear();
+    m_TilePasses.clear();
+    m_ActiveTileCount = std::numeric_limits<uint32_t>::max();
+    m_ActiveTilePassCount = std::numeric_limits<uint32_t>::max();
+}
+
+void RendererCPU::SetTransferFunctions(TransferFunctionSet const& functions, uint32_t samplingCount) {
+
+    auto ConvertColor = [](std::vector<Hawk::Math::Vector<uint8_t, 4>> const& table) {
+        std::vector<Vec3> texels(std::size(table));
+        for (size_t index = 0; index < std::size(table); index++)
+            texels[index] = Vec3(table[index].x / 255.0f, table[index].y / 255.0f, table[index].z / 255.0f);
+        return texels;
+    };
+
+    auto ConvertScalar = [](std::vector<uint8_t> const& table) {
+        std::vector<F32> texels(std::size(table));
+        for (size_t index = 0; index < std::size(table); index++)
+            texels[index] = table[index] / 255.0f;
+        return texels;
+    };
+
+    m_DiffuseTF.Texels = ConvertColor(functions.Diffuse.GenerateTable(samplingCount));
+    m_SpecularTF.Texels = ConvertColor(functions.Specular.GenerateTable(samplingCount));
+    m_RoughnessTF.Texels = ConvertScalar(functions.Roughness.GenerateTable(samplingCount));
+    m_OpacityTF.Texels = ConvertScalar(functions.Opacity.GenerateTable(samplingCount));
+}
+
+void RendererCPU::RenderFrame(FrameBuffer const& frame) {
+
+    assert(m_pVolume != nullptr && m_pEnvironmentMap != nullptr && m_pBlueNoise != nullptr);
+    assert(frame.BlueNoiseSize == m_pBlueNoise->GetSize());
+    assert((frame.TrackingMode != TrackingModeDelta && frame.TransmittanceEstimator == TransmittanceEstimatorTracking) || m_pMajorantGrid != nullptr);
+
+    Profiler::Scope scope(m_pProfiler, "Path Tracing");
+
+    const auto timeStart = std::chrono::high_resolution_clock::now();
+    m_TileScheduler.ResetCancel();
+    m_FrameStatistics = {};
+
+    if (!m_IsAutoExposure || !m_AutoExposure.IsAdapted())
+        m_Exposure = frame.Exposure;
+
+    // The first frame reads the history from the previous image while it writes the new one
+    m_IsReprojectionFrame = m_IsReprojection && m_IsHistoryValid && frame.FrameIndex == 0;
+    if (m_IsReprojectionFrame) {
+        std::swap(m_ColorSum, m_HistoryColorSum);
+        std::swap(m_ColorMoment, m_HistoryColorMoment);
+        std::swap(m_Surface, m_HistorySurface);
+    }
+
+    if (frame.FrameIndex < m_SampleDispersion) {
+        const uint32_t tilesX = (m_Width + TileSize - 1) / TileSize;
+        const uint32_t tilesY = (m_Height + TileSize - 1) / TileSize;
+
+        m_Tiles.clear();
+        for (uint32_t tileY = 0; tileY < tilesY; tileY++)
+            for (uint32_t tileX = 0; tileX < tilesX; tileX++)
+                m_Tiles.push_back((0xFFFF & tileX) | ((0xFFFF & tileY) << 16));
+        m_TilePasses.assign(std::size(m_Tiles), 1);
+    } else {
+        Profiler::Scope scopeTiles(m_pProfiler, "Compute Tiles");
+        this->ComputeTiles(frame);
+    }
+
+    for (uint32_t tile : m_Tiles)
+        m_TileSampleCounts[this->TileIndex(tile)] = 0;
+
+    std::fill(m_Diffuse.begin(), m_Diffuse.end(), Vec3(0.0f, 0.0f, 0.0f));
+    std::fill(m_Normal.begin(), m_Normal.end(), Vec4(0.0f, 0.0f, 0.0f, 0.0f));
+    std::fill(m_Depth.begin(), m_Depth.end(), 0.0f);
+    std::fill(m_Radiance.begin(), m_Radiance.end(), Vec3(0.0f, 0.0f, 0.0f));
+
+    // Primary rays march at depth 0, the rays of ComputeRadiance at depth 1
+    auto CreateMarcher = [&](uint32_t depth) {
+        VolumeMarcher::Desc desc = {};
+        desc.pVolume = m_pVolume;
+        desc.pMajorantGrid = m_pMajorantGrid;
+        desc.MipLevel = Shading::GetLevelOfDetail(frame, depth);
+        desc.pOpacityTable = std::data(m_OpacityTF.Texels);
+        desc.OpacityTableSize = static_cast<uint32_t>(std::size(m_OpacityTF.Texels));
+        desc.BoundingBoxMin = frame.BoundingBoxMin;
+        desc.BoundingBoxMax = frame.BoundingBoxMax;
+        desc.ClipRegion = Shading::GetClipRegion(frame);
+        desc.StepSize = Shading::GetStepSize(frame, desc.MipLevel);
+        desc.Density = frame.Density;
+        return VolumeMarcher(desc);
+    };
+
+    const VolumeMarcher marcherPrimary = CreateMarcher(0);
+    const VolumeMarcher marcherSecondary = CreateMarcher(1);
+
+    std::fill(m_ThreadBusyTime.begin(), m_ThreadBusyTime.end(), 0.0);
+    std::fill(m_ThreadSlowestTile.begin(), m_ThreadSlowestTile.end(), 0.0);
+    const auto timeTiles = std::chrono::high_resolution_clock::now();
+
+    {
+        Profiler::Scope scopeRender(m_pProfiler, "Render Tiles");
+        if (m_Schedule == ScheduleWavefront) {
+            this->RenderWavefront(frame, marcherPrimary, marcherSecondary);
+        } else {
+            auto RenderTile = [&](uint32_t index, uint32_t threadID) {
+                if (m_TileScheduler.IsCancelled())
+                    return;
+
+                const auto tileStart = std::chrono::high_resolution_clock::now();
+
+                auto& queues = m_RayQueues[threadID];
+                queues.PrimaryPixels.clear();
+                this->AppendTilePixels(queues.PrimaryPixels, m_Tiles[index]);
+                this->ResizeQueues(queues);
+
+                for (uint32_t pass = 0; pass < m_TilePasses[index]; pass++) {
+                    if (m_Schedule == SchedulePixel) {
+                        for (size_t pixel = 0; pixel < std::size(queues.PrimaryPixels); pixel++)
+                            this->RenderWave(frame, marcherPrimary, marcherSecondary, queues, pixel, 1, false);
+                    } else {
+                        this->RenderWave(frame, marcherPrimary, marcherSecondary, queues, 0, std::size(queues.PrimaryPixels), m_IsPacketMarching);
+                    }
+                }
+
+                const F64 tileTime = std::chrono::duration<F64>(std::chrono::high_resolution_clock::now() - tileStart).count();
+                m_TileCosts[this->TileIndex(m_Tiles[index])] = static_cast<F32>(tileTime);
+                m_TileSampleCounts[this->TileIndex(m_Tiles[index])] = static_cast<uint32_t>(std::size(queues.PrimaryPixels)) * m_TilePasses[index];
+                m_ThreadBusyTime[threadID] += tileTime;
+                m_ThreadSlowestTile[threadID] = std::max(m_ThreadSlowestTile[threadID], tileTime);
+            };
+
+            if (m_IsWorkStealing) {
+                m_SelectedTileCosts.resize(std::size(m_Tiles));
+                for (size_t index = 0; index < std::size(m_Tiles); index++)
+                    m_SelectedTileCosts[index] = m_TileCosts[this->TileIndex(m_Tiles[index])];
+                m_FrameStatistics.StealCount = m_TileScheduler.Run(m_SelectedTileCosts, RenderTile);
+            } else {
+                m_ThreadPool.ParallelFor(static_cast<uint32_t>(std::size(m_Tiles)), RenderTile);
+            }
+        }
+    }
+
+    const F64 tileLoopTime = std::chrono::duration<F64>(std::chrono::high_resolution_clock::now() - timeTiles).count();
+    m_FrameStatistics.IsCancelled = m_TileScheduler.IsCancelled();
+    m_FrameStatistics.SlowestTileTime = *std::max_element(m_ThreadSlowestTile.begin(), m_ThreadSlowestTile.end());
+    m_FrameStatistics.Utilization = std::accumulate(m_ThreadBusyTime.begin(), m_ThreadBusyTime.end(), 0.0) / (tileLoopTime * m_ThreadPool.GetThreadCount());
+
+    // Only the samples that were taken count, a cancelled frame skips tiles and the wavefront stops between waves
+    uint64_t sampleCount = 0;
+    uint32_t tileCount = 0;
+    uint32_t tilePassCount = 0;
+    for (size_t index = 0; index < std::size(m_Tiles); index++) {
+        const uint32_t countX = std::min(TileSize, m_Width - (m_Tiles[index] & 0xFFFF) * TileSize);
+        const uint32_t countY = std::min(TileSize, m_Height - ((m_Tiles[index] >> 16) & 0xFFFF) * TileSize);
+        const uint32_t tileSampleCount = m_TileSampleCounts[this->TileIndex(m_Tiles[index])];
+        sampleCount += tileSampleCount;
+        tileCount += tileSampleCount >= countX * countY ? 1 : 0;
+        tilePassCount += tileSampleCount / (countX * countY);
+    }
+
+    if (m_IsAutoExposure && !m_FrameStatistics.IsCancelled) {
+        Profiler::Scope scopeExposure(m_pProfiler, "Auto Exposure");
+        this->UpdateExposure(frame);
+    }
+
+    // The tiles that are no longer rendered are tone mapped again when the exposure has moved on, from the auto
+    // exposure or from the frame. Denoised frames tone map every pixel anyway.
+    if (!m_FrameStatistics.IsCancelled && std::abs(m_Exposure - m_ExposureToneMapped) > AutoExposure::ExposureTolerance * m_ExposureToneMapped) {
+        m_ExposureToneMapped = m_Exposure;
+        if (!m_IsDenoising) {
+            m_ThreadPool.ParallelFor(m_Height, [&](uint32_t y, uint32_t threadID) {
+                for (uint32_t x = 0; x < m_Width; x++)
+                    this->ToneMap(frame, Vec2u(x, y));
+            });
+        }
+    }
+
+    if (m_IsDenoising && !m_FrameStatistics.IsCancelled) {
+        Profiler::Scope scopeDenoise(m_pProfiler, "Denoise");
+        this->Denoise(frame);
+    }
+
+    // A cancelled first frame holds a partial image, the previous one goes back in place and stays the history
+    if (m_IsReprojectionFrame && m_FrameStatistics.IsCancelled) {
+        std::swap(m_ColorSum, m_HistoryColorSum);
+        std::swap(m_ColorMoment, m_HistoryColorMoment);
+        std::swap(m_Surface, m_HistorySurface);
+    } else {
+        m_HistoryWorldViewProjection = frame.WorldViewProjectionMatrix;
+        m_IsHistoryValid = m_IsReprojection && !m_FrameStatistics.IsCancelled;
+    }
+
+    m_FrameStatistics.TileCount = tileCount;
+    m_FrameStatistics.SampleCount = sampleCount;
+    m_FrameStatistics.FrameTime = std::chrono::duration<F64>(std::chrono::high_resolution_clock::now() - timeStart).count();
+    m_ActiveTileCount = m_FrameStatistics.TileCount;
+    m_ActiveTilePassCount = tilePassCount;
+    m_IsFrameTimeRead = false;
+}
+
+void RendererCPU::ToneMapImage(FrameBuffer const& frame) {
+
+    Profiler::Scope scope(m_pProfiler, "Tone Map");
+
+    if (!m_IsAutoExposure || !m_AutoExposure.IsAdapted())
+        m_Exposure = frame.Exposure;
+    m_ExposureToneMapped = m_Exposure;
+
+    // Denoised frames keep the output of the Denoiser, ToneMap reads it instead of the accumulation
+    m_ThreadPool.ParallelFor(m_Height, [&](uint32_t y, uint32_t threadID) {
+        for (uint32_t x = 0; x < m_Width; x++)
+            this->ToneMap(frame, Vec2u(x, y));
+    });
+}
+
+bool RendererCPU::ReadFrameTime(F32& frameTime, Vec2u& renderDimension) {
+
+    if (m_IsFrameTimeRead)
+        return false;
+
+    frameTime = static_cast<F32>(m_FrameStatistics.FrameTime);
+    renderDimension = Vec2u(m_Width, m_Height);
+    m_IsFrameTimeRead = true;
+    return true;
+}
+
+void RendererCPU::ComputeTiles(FrameBuffer const& frame) {
+
+    const uint32_t tilesX = (m_Width + TileSize - 1) / TileSize;
+    const uint32_t tilesY = (m_Height + TileSize - 1) / TileSize;
+
+    std::vector<uint32_t> passCounts(size_t(tilesX) * tilesY);
+    m_ThreadPool.ParallelFor(tilesX * tilesY, [&](uint32_t index, uint32_t threadID) {
+        const uint32_t x0 = (index % tilesX) * TileSize;
+        const uint32_t y0 = (index / tilesX) * TileSize;
+        const uint32_t x1 = std::min(x0 + TileSize, m_Width);
+        const uint32_t y1 = std::min(y0 + TileSize, m_Height);
+
+        // The variance of a pixel mean is the sample variance of the luminance over the number of samples
+        F32 luminanceSum = 0.0f;
+        F32 varianceSum = 0.0f;
+        for (uint32_t y = y0; y < y1; y++) {
+            for (uint32_t x = x0; x < x1; x++) {
+                const auto& color = m_ColorSum[PixelIndex(Vec2u(x, y))];
+                const F32 luminance = Luminance(Vec3(color.x, color.y, color.z));
+                luminanceSum += luminance;
+                varianceSum += std::max(m_ColorMoment[PixelIndex(Vec2u(x, y))] - luminance * luminance, 0.0f) / std::max(color.w, 1.0f);
+            }
+        }
+        passCounts[index] = Shading::GetTilePassCount(ComputeTileError(luminanceSum, varianceSum, (x1 - x0) * (y1 - y0)), frame.TileErrorThreshold);
+    });
+
+    uint32_t histogram[Shading::TilePassCountMax] = {};
+    for (uint32_t passCount : passCounts)
+        if (passCount > 0)
+            histogram[passCount - 1]++;
+
+    m_Tiles.clear();
+    m_TilePasses.clear();
+    for (uint32_t index = 0; index < tilesX * tilesY; index++) {
+        if (passCounts[index] > 0) {
+            m_Tiles.push_back((0xFFFF & (index % tilesX)) | ((0xFFFF & (index / tilesX)) << 16));
+            m_TilePasses.push_back(Shading::ApplyTilePassBudget(passCounts[index], histogram, tilesX * tilesY));
+        }
+    }
+}
+
+void RendererCPU::RenderWave(FrameBuffer const& frame, VolumeMarcher const& marcherPrimary, VolumeMarcher const& marcherSecondary, RayQueues& queues, size_t first, size_t count, bool isPacketMarching) {
+
+    this->GenerateRays(frame, queues, first, count);
+    this->March(frame, marcherPrimary, queues.Primary, first, count, isPacketMarching);
+    this->EvaluateScattering(frame, queues, first, count);
+
+    const size_t shadowCount = this->GenerateShadowRays(frame, queues, first, count);
+    this->TraceShadowRays(frame, marcherSecondary, queues, 2 * first, shadowCount, isPacketMarching);
+    this->ResolveShadowRays(frame, queues, 2 * first, shadowCount);
+    this->AccumulatePixels(frame, queues, first, count);
+}
+
+void RendererCPU::RenderWavefront(FrameBuffer const& frame, VolumeMarcher const& marcherPrimary, VolumeMarcher const& marcherSecondary) {
+
+    // Every pass runs over the pixels of the tiles that have that many passes
+    auto& queues = m_WavefrontQueues;
+    for (uint32_t pass = 0; pass < Shading::TilePassCountMax; pass++) {
+        m_WavefrontPixels.clear();
+        for (size_t index = 0; index < std::size(m_Tiles); index++)
+            if (m_TilePasses[index] > pass)
+                this->AppendTilePixels(m_WavefrontPixels, m_Tiles[index]);
+
+        for (size_t waveFirst = 0; waveFirst < std::size(m_WavefrontPixels) && !m_TileScheduler.IsCancelled(); waveFirst += WaveSize) {
+            const size_t waveCount = std::min<size_t>(WaveSize, std::size(m_WavefrontPixels) - waveFirst);
+            queues.PrimaryPixels.assign(m_WavefrontPixels.begin() + waveFirst, m_WavefrontPixels.begin() + waveFirst + waveCount);
+            this->ResizeQueues(queues);
+
+            const auto chunkCount = static_cast<uint32_t>((waveCount + WaveChunkSize - 1) / WaveChunkSize);
+            queues.ShadowCount.resize(chunkCount);
+
+            auto Dispatch = [&](auto const& stage) {
+                m_ThreadPool.ParallelFor(chunkCount, [&](uint32_t chunk, uint32_t threadID) {
+                    const size_t first = size_t(chunk) * WaveChunkSize;
+                    stage(chunk, first, std::min<size_t>(WaveChunkSize, waveCount - first));
+                });
+            };
+
+            Dispatch([&](uint32_t chunk, size_t first, size_t count) { this->GenerateRays(frame, queues, first, count); });
+            Dispatch([&](uint32_t chunk, size_t first, size_t count) { this->March(frame, marcherPrimary, queues.Primary, first, count, m_IsPacketMarching); });
+            Dispatch([&](uint32_t chunk, size_t first, size_t count) { this->EvaluateScattering(frame, queues, first, count); });
+            Dispatch([&](uint32_t chunk, size_t first, size_t count) { queues.ShadowCount[chunk] = this->GenerateShadowRays(frame, queues, first, count); });
+            Dispatch([&](uint32_t chunk, size_t first, size_t count) { this->TraceShadowRays(frame, marcherSecondary, queues, 2 * first, queues.ShadowCount[chunk], m_IsPacketMarching); });
+            Dispatch([&](uint32_t chunk, size_t first, size_t count) { this->ResolveShadowRays(frame, queues, 2 * first, queues.ShadowCount[chunk]); });
+            Dispatch([&](uint32_t chunk, size_t first, size_t count) { this->AccumulatePixels(frame, queues, first, count); });
+
+            for (size_t index = waveFirst; index < waveFirst + waveCount; index++) {
+                const uint32_t pixel = m_WavefrontPixels[index];
+                m_TileSampleCounts[this->TileIndex(((pixel & 0xFFFF) / TileSize) | (((pixel >> 16) / TileSize) << 16))]++;
+            }
+        }
+    }
+}
+
+void RendererCPU::AppendTilePixels(std::vector<uint32_t>& pixels, uint32_t tile) const {
+
+    const uint32_t tileX = tile & 0xFFFF;
+    const uint32_t tileY = (tile >> 16) & 0xFFFF;
+    for (uint32_t y = tileY * TileSize; y < std::min((tileY + 1) * TileSize, m_Height); y++)
+        for (uint32_t x = tileX * TileSize; x < std::min((tileX + 1) * TileSize, m_Width); x++)
+            pixels.push_back((0xFFFF & x) | ((0xFFFF & y) << 16));
+}
+
+void RendererCPU::ResizeQueues(RayQueues& queues) const {
+
+    const size_t count = std::size(queues.PrimaryPixels);
+    queues.Primary.Resize(count);
+    queues.Shadow.Resize(2 * count);
+    queues.ShadowPixels.resize(2 * count);
+    queues.Throughput.resize(2 * count);
+}
+
+void RendererCPU::March(FrameBuffer const& frame, VolumeMarcher const& marcher, RayStream& stream, size_t first, size_t count, bool isPacketMarching) const {
+
+    if (frame.TrackingMode == TrackingModeDelta)
+        marcher.TrackDelta(stream, first, count);
+    else if (isPacketMarching)
+        marcher.MarchPacket(stream, first, count);
+    else
+        marcher.MarchScalar(stream, first, count);
+}
+
+void RendererCPU::GenerateRays(FrameBuffer const& frame, RayQueues& queues, size_t first, size_t count) {
+
+    auto& stream = queues.Primary;
+    auto const& pixels = queues.PrimaryPixels;
+
+    for (size_t index = first; index < first + count; index++) {
+        const Vec2u id = Vec2u(pixels[index] & 0xFFFF, pixels[index] >> 16);
+
+        const Shading::CSampler sampler = Shading::InitSampler(frame, std::data(m_pBlueNoise->GetTexels()), id, this->SampleIndex(frame, id), 0);
+        const Shading::Ray ray = Shading::CreateCameraRay(id, Shading::SamplePixelJitter(sampler), frame.InvRenderTargetDim, frame.InvWorldViewProjectionMatrix);
+
+        stream.OriginX[index] = ray.Origin.x;
+        stream.OriginY[index] = ray.Origin.y;
+        stream.OriginZ[index] = ray.Origin.z;
+        stream.DirectionX[index] = ray.Direction.x;
+        stream.DirectionY[index] = ray.Direction.y;
+        stream.DirectionZ[index] = ray.Direction.z;
+        stream.Min[index] = ray.Min;
+        stream.Max[index] = ray.Max;
+        if (frame.TrackingMode == TrackingModeDelta) {
+            stream.Seed[index] = Shading::SampleRNG(sampler, 2).Seed;
+        } else {
+            stream.Threshold[index] = -std::log(1.0f - Shading::Sample1D(sampler, 2)) / frame.Density;
+            stream.Jitter[index] = Shading::Sample1D(sampler, 3);
+        }
+
+        // The extra passes of a tile start from the buffers the previous pass left
+        const size_t pixel = PixelIndex(id);
+        m_Diffuse[pixel] = Vec3(0.0f, 0.0f, 0.0f);
+        m_Normal[pixel] = Vec4(0.0f, 0.0f, 0.0f, 0.0f);
+        m_Depth[pixel] = 0.0f;
+        m_Radiance[pixel] = Vec3(0.0f, 0.0f, 0.0f);
+    }
+}
+
+void RendererCPU::EvaluateScattering(FrameBuffer const& frame, RayQueues& queues, size_t first, size_t count) {
+
+    auto const& stream = queues.Primary;
+    auto const& pixels = queues.PrimaryPixels;
+
+    const Shading::AABB aabb = { VolumeBoundingBoxMin, VolumeBoundingBoxMax };
+    for (size_t index = first; index < first + count; index++) {
+        if (!stream.IsScattered[index])
+            continue;
+
+        const Vec3 direction = Vec3(stream.DirectionX[index], stream.DirectionY[index], stream.DirectionZ[index]);
+        const Vec3 texcoord = Shading::GetNormalizedTexcoord(Vec3(stream.PositionX[index], stream.PositionY[index], stream.PositionZ[index]), aabb);
+        const Vec3 gradient = m_pVolume->SampleGradient(texcoord);
+        const F32 lengthSquared = Hawk::Math::Dot(gradient, gradient);
+
+        // rsqrt(0) is +inf on the GPU, the shader rejects the resulting NaN normal
+        if (!(lengthSquared > 0.0f))
+            continue;
+
+        const F32 factor = 1.0f / std::sqrt(lengthSquared);
+        const F32 intensity = m_pVolume->SampleIntensity(texcoord, frame.LevelOfDetail);
+        const Vec3 normal = Hawk::Math::Dot(gradient, -direction) > 0.0f ? gradient * factor : -gradient * factor;
+        const Vec3 position = Vec3(stream.PositionX[index], stream.PositionY[index], stream.PositionZ[index]) + 0.01f * normal;
+
+        auto positionNDC = frame.WorldViewProjectionMatrix * Vec4(position.x, position.y, position.z, 1.0f);
+        positionNDC /= positionNDC.w;
+
+        const size_t pixel = PixelIndex(Vec2u(pixels[index] & 0xFFFF, pixels[index] >> 16));
+        m_Diffuse[pixel] = m_DiffuseTF.Sample(intensity);
+        m_Specular[pixel] = m_SpecularTF.Sample(intensity);
+        m_Normal[pixel] = Vec4(normal.x, normal.y, normal.z, m_RoughnessTF.Sample(intensity));
+        m_Depth[pixel] = Shading::Saturate(positionNDC.z);
+    }
+}
+
+size_t RendererCPU::GenerateShadowRays(FrameBuffer const& frame, RayQueues& queues, size_t first, size_t count) {
+
+    auto& stream = queues.Shadow;
+    auto& pixels = queues.ShadowPixels;
+
+    // Only pixels with a scatter event spawn shadow rays, up to two with next-event estimation. The queue
+    // is compacted as it is built and holds the contribution of every ray besides visibility and radiance.
+    size_t ray = 2 * first;
+    auto PushRay = [&](uint32_t packed, Vec3 const& origin, Vec3 const& direction, Vec3 const& throughput, Shading::CSampler const& sampler, uint32_t dimension) {
+        stream.OriginX[ray] = origin.x;
+        stream.OriginY[ray] = origin.y;
+        stream.OriginZ[ray] = origin.z;
+        stream.DirectionX[ray] = direction.x;
+        stream.DirectionY[ray] = direction.y;
+        stream.DirectionZ[ray] = direction.z;
+        stream.Min[ray] = 0.0f;
+        stream.Max[ray] = std::numeric_limits<F32>::max();
+        if (frame.TransmittanceEstimator != TransmittanceEstimatorTracking || frame.TrackingMode == TrackingModeDelta) {
+            stream.Seed[ray] = Shading::SampleRNG(sampler, dimension).Seed;
+        } else {
+            stream.Threshold[ray] = -std::log(Shading::Sample1D(sampler, dimension)) / frame.Density;
+            stream.Jitter[ray] = Shading::Sample1D(sampler, dimension + 1);
+        }
+
+        pixels[ray] = packed;
+        queues.Throughput[ray] = throughput;
+        ray++;
+    };
+
+    auto IsPositive = [](Vec3 const& v) { return v.x > 0.0f || v.y > 0.0f || v.z > 0.0f; };
+
+    for (size_t primary = first; primary < first + count; primary++) {
+        const uint32_t packed = queues.PrimaryPixels[primary];
+        const Vec2u id = Vec2u(packed & 0xFFFF, packed >> 16);
+        const size_t index = PixelIndex(id);
+        const Shading::CSampler sampler = Shading::InitSampler(frame, std::data(m_pBlueNoise->GetTexels()), id, this->SampleIndex(frame, id), 1);
+
+        const Vec3 diffuse = m_Diffuse[index];
+        if (diffuse.x == 0.0f && diffuse.y == 0.0f && diffuse.z == 0.0f)
+            continue;
+
+        const Vec2 jitter = Shading::SamplePixelJitter(Shading::InitSampler(frame, std::data(m_pBlueNoise->GetTexels()), id, this->SampleIndex(frame, id), 0));
+        const Vec2 ncdXY = Shading::ScreenSpaceToNDC(Vec2(F32(id.x), F32(id.y)) + jitter, frame.InvRenderTargetDim);
+        auto rayStart = frame.InvWorldViewProjectionMatrix * Vec4(ncdXY.x, ncdXY.y, 0.0f, 1.0f);
+        auto rayEnd = frame.InvWorldViewProjectionMatrix * Vec4(ncdXY.x, ncdXY.y, m_Depth[index], 1.0f);
+        rayStart /= rayStart.w;
+        rayEnd /= rayEnd.w;
+
+        const Vec4 normal = m_Normal[index];
+
+        GBuffer buffer;
+        buffer.Normal = Vec3(normal.x, normal.y, normal.z);
+        buffer.View = Hawk::Math::Normalize(Vec3(rayStart.x - rayEnd.x, rayStart.y - rayEnd.y, rayStart.z - rayEnd.z));
+        buffer.Diffuse = diffuse;
+        buffer.Specular = m_Specular[index];
+        buffer.Roughness = normal.w;
+
+        const Vec3 P = Vec3(rayEnd.x, rayEnd.y, rayEnd.z);
+        const F32 specularProbability = GetSpecularProbability(buffer);
+
+        F32 pdfBSDF = 0.0f;
+        const Vec3 directionBSDF = SampleBSDF(buffer, specularProbability, sampler);
+        Vec3 throughputBSDF = EvaluateBSDF(buffer, directionBSDF, specularProbability, pdfBSDF);
+        throughputBSDF = pdfBSDF > 0.0f ? throughputBSDF / pdfBSDF : Vec3(0.0f, 0.0f, 0.0f);
+
+        if (frame.LightSampling == LightSamplingMIS) {
+            throughputBSDF *= PowerHeuristic(pdfBSDF, GetEnvironmentPdf(frame, *m_pEnvironmentMap, directionBSDF));
+
+            F32 pdfLight = 0.0f;
+            F32 pdfLightBSDF = 0.0f;
+            const Vec3 directionLight = SampleEnvironment(frame, *m_pEnvironmentMap, sampler, pdfLight);
+            Vec3 throughputLight = EvaluateBSDF(buffer, directionLight, specularProbability, pdfLightBSDF);
+            throughputLight = pdfLight > 0.0f ? throughputLight / pdfLight * PowerHeuristic(pdfLight, pdfLightBSDF) : Vec3(0.0f, 0.0f, 0.0f);
+
+            if (IsPositive(throughputLight))
+                PushRay(packed, P, directionLight, throughputLight, sampler, RadianceDimensionRayLight);
+        }
+
+        if (IsPositive(throughputBSDF))
+            PushRay(packed, P, directionBSDF, throughputBSDF, sampler, RadianceDimensionRayBSDF);
+    }
+
+    return ray - 2 * first;
+}
+
+void RendererCPU::TraceShadowRays(FrameBuffer const& frame, VolumeMarcher const& marcher, RayQueues& queues, size_t first, size_t count, bool isPacketMarching) const {
+
+    auto& stream = queues.Shadow;
+    if (frame.TransmittanceEstimator != TransmittanceEstimatorTracking) {
+        marcher.TrackRatio(stream, first, count, frame.TransmittanceEstimator == TransmittanceEstimatorResidualRatio);
+    } else {
+        this->March(frame, marcher, stream, first, count, isPacketMarching);
+        for (size_t ray = first; ray < first + count; ray++)
+            stream.Transmittance[ray] = stream.IsScattered[ray] ? 0.0f : 1.0f;
+    }
+}
+
+void RendererCPU::ResolveShadowRays(FrameBuffer const& frame, RayQueues& queues, size_t first, size_t count) {
+
+    auto const& stream = queues.Shadow;
+    auto const& pixels = queues.ShadowPixels;
+
+    for (size_t ray = first; ray < first + count; ray++) {
+        if (stream.Transmittance[ray] == 0.0f)
+            continue;
+
+        const Vec3 direction = Vec3(stream.DirectionX[ray], stream.DirectionY[ray], stream.DirectionZ[ray]);
+        const size_t index = PixelIndex(Vec2u(pixels[ray] & 0xFFFF, pixels[ray] >> 16));
+        m_Radiance[index] += stream.Transmittance[ray] * queues.Throughput[ray] * m_pEnvironmentMap->Sample(GetEnvironmentDirection(frame, direction));
+    }
+}
+
+void RendererCPU::AccumulatePixels(FrameBuffer const& frame, RayQueues& queues, size_t first, size_t count) {
+
+    for (size_t index = first; index < first + count; index++) {
+        const Vec2u id = Vec2u(queues.PrimaryPixels[index] & 0xFFFF, queues.PrimaryPixels[index] >> 16);
+        this->Accumulate(frame, id);
+        if (!m_IsDenoising)
+            this->ToneMap(frame, id);
+    }
+}
+
+void RendererCPU::Accumulate(FrameBuffer const& frame, Vec2u const& id) {
+
+    const size_t index = PixelIndex(id);
+    const Vec4 normal = m_Normal[index];
+    const F32 depth = m_Depth[index];
+
+    SurfaceSum surface = {};
+    if (normal.x != 0.0f || normal.y != 0.0f || normal.z != 0.0f)
+        surface = { Vec3(normal.x, normal.y, normal.z), depth, depth * depth, 1.0f };
+
+    Vec4 colorSum = m_ColorSum[index];
+    F32 colorMoment = m_ColorMoment[index];
+    SurfaceSum surfaceSum = m_Surface[index];
+    if (frame.FrameIndex == 0 && !(m_IsReprojectionFrame && surface.Coverage > 0.0f && this->ReprojectHistory(frame, id, colorSum, colorMoment, surfaceSum))) {
+        colorSum = Vec4(0.0f, 0.0f, 0.0f, 0.0f);
+        colorMoment = 0.0f;
+        surfaceSum = {};
+    }
+
+    const F32 count = colorSum.w + 1.0f;
+    const F32 alpha = 1.0f / count;
+    const F32 luminance = Luminance(m_Radiance[index]);
+
+    const Vec3 color = Vec3(colorSum.x, colorSum.y, colorSum.z) + alpha * (m_Radiance[index] - Vec3(colorSum.x, colorSum.y, colorSum.z));
+    m_ColorSum[index] = Vec4(color.x, color.y, color.z, count);
+    m_ColorMoment[index] = colorMoment + alpha * (luminance * luminance - colorMoment);
+
+    surfaceSum.Normal += alpha * (surface.Normal - surfaceSum.Normal);
+    surfaceSum.Depth += alpha * (surface.Depth - surfaceSum.Depth);
+    surfaceSum.DepthMoment += alpha * (surface.DepthMoment - surfaceSum.DepthMoment);
+    surfaceSum.Coverage += alpha * (surface.Coverage - surfaceSum.Coverage);
+    m_Surface[index] = surfaceSum;
+}
+
+bool RendererCPU::ReprojectHistory(FrameBuffer const& frame, Vec2u const& id, Vec4& colorSum, F32& colorMoment, SurfaceSum& surfaceSum) const {
+
+    // The point of the new sample in the previous view, rounded to the pixel that contains it. The samples
+    // that leave the volume see the environment turn with the camera and are never reprojected.
+    const size_t index = PixelIndex(id);
+    const Vec2 ncdXY = Shading::ScreenSpaceToNDC(Vec2(F32(id.x), F32(id.y)), frame.InvRenderTargetDim);
+    auto position = frame.InvWorldViewProjectionMatrix * Vec4(ncdXY.x, ncdXY.y, m_Depth[index], 1.0f);
+    position /= position.w;
+    auto positionPrev = m_HistoryWorldViewProjection * position;
+    positionPrev /= positionPrev.w;
+
+    const F32 x = std::floor(0.5f * (positionPrev.x + 1.0f) * m_Width);
+    const F32 y = std::floor(0.5f * (1.0f - positionPrev.y) * m_Height);
+    if (!(x >= 0.0f && y >= 0.0f && x < F32(m_Width) && y < F32(m_Height)))
+        return false;
+
+    // Mostly empty pixels have no depth to compare with
+    const size_t indexPrev = PixelIndex(Vec2u(static_cast<uint32_t>(x), static_cast<uint32_t>(y)));
+    const SurfaceSum& history = m_HistorySurface[indexPrev];
+    if (history.Coverage < 0.5f)
+        return false;
+
+    const F32 depthMean = history.Depth / history.Coverage;
+    const F32 depthDeviation = std::sqrt(std::max(history.DepthMoment / history.Coverage - depthMean * depthMean, 0.0f));
+    if (std::abs(positionPrev.z - depthMean) > ReprojectionDepthTolerance + ReprojectionDepthDeviations * depthDeviation)
+        return false;
+
+    const Vec3 normal = Vec3(m_Normal[index].x, m_Normal[index].y, m_Normal[index].z);
+    const F32 normalLength = Hawk::Math::Length(history.Normal);
+    if (normalLength > 0.5f * history.Coverage && Hawk::Math::Dot(history.Normal, normal) < ReprojectionNormalTolerance * normalLength)
+        return false;
+
+    colorSum = m_HistoryColorSum[indexPrev];
+    colorSum.w = std::min(colorSum.w, F32(m_HistoryCountMax));
+    colorMoment = m_HistoryColorMoment[indexPrev];
+
+    // The depths move by as much as the depth of the new sample did between the views
+    const F32 offset = m_Depth[index] - positionPrev.z;
+    surfaceSum = history;
+    surfaceSum.DepthMoment += 2.0f * offset * history.Depth + offset * offset * history.Coverage;
+    surfaceSum.Depth += offset * history.Coverage;
+    return true;
+}
+
+void RendererCPU::Denoise(FrameBuffer const& frame) {
+
+    const auto timeStart = std::chrono::high_resolution_clock::now();
+
+    // A single sample has no variance estimate, its squared luminance stands in as if the noise were as large as the signal
+    m_ThreadPool.ParallelFor(m_Height, [&](uint32_t y, uint32_t threadID) {
+        for (uint32_t x = 0; x < m_Width; x++) {
+            const size_t index = PixelIndex(Vec2u(x, y));
+            const Vec4 color = m_ColorSum[index];
+            const F32 luminance = Luminance(Vec3(color.x, color.y, color.z));
+            const F32 count = std::max(color.w, 1.0f);
+            const F32 variance = color.w > 1.0f ? std::max(m_ColorMoment[index] - luminance * luminance, 0.0f) * count / (count - 1.0f) : luminance * luminance;
+
+            const SurfaceSum& surface = m_Surface[index];
+            m_Denoiser.SetPixel(x, y, Vec3(color.x, color.y, color.z), variance / count, surface.Normal, surface.Depth + 1.0f - surface.Coverage);
+        }
+    });
+
+    m_Denoiser.Execute();
+
+    m_ThreadPool.ParallelFor(m_Height, [&](uint32_t y, uint32_t threadID) {
+        for (uint32_t x = 0; x < m_Width; x++) {
+            const size_t index = PixelIndex(Vec2u(x, y));
+            const Vec3 color = m_Denoiser.GetPixel(x, y);
+            m_Denoised[index] = Vec4(color.x, color.y, color.z, m_ColorSum[index].w);
+            this->ToneMap(frame, Vec2u(x, y));
+        }
+    });
+
+    m_FrameStatistics.DenoiseTime = std::chrono::duration<F64>(std::chrono::high_resolution_clock::now() - timeStart).count();
+}
+
+void RendererCPU::UpdateExposure(FrameBuffer const& frame) {
+
+    const auto timeStart = std::chrono::high_resolution_clock::now();
+    const uint32_t tilesX = (m_Width + TileSize - 1) / TileSize;
+
+    m_ThreadPool.ParallelFor(static_cast<uint32_t>(std::size(m_Tiles)), [&](uint32_t index, uint32_t threadID) {
+        const uint32_t tileX = m_Tiles[index] & 0xFFFF;
+        const uint32_t tileY = (m_Tiles[index] >> 16) & 0xFFFF;
+        const uint32_t x0 = tileX * TileSize;
+        const uint32_t y0 = tileY * TileSize;
+        m_AutoExposure.UpdateTile(tileY * tilesX + tileX, threadID, m_ColorSum, m_Width, x0, y0, std::min(x0 + TileSize, m_Width), std::min(y0 + TileSize, m_Height));
+    });
+
+    // Adapts over the time between the frames, the first histogram is taken as it is
+    const F32 deltaTime = m_AutoExposure.IsAdapted() ? static_cast<F32>(std::chrono::duration<F64>(timeStart - m_ExposureUpdateTime).count()) : 0.0f;
+    m_AutoExposure.Update(deltaTime);
+    m_ExposureUpdateTime = timeStart;
+    m_Exposure = m_AutoExposure.GetExposure();
+
+    m_FrameStatistics.ExposureTime = std::chrono::duration<F64>(std::chrono::high_resolution_clock::now() - timeStart).count();
+}
+
+void RendererCPU::ToneMap(FrameBuffer const& frame, Vec2u const& id) {
+
+    const size_t index = PixelIndex(id);
+    const Vec4 colorHDR = m_IsDenoising ? m_Denoised[index] : m_ColorSum[index];
+    const Vec3 colorLDR = ToneMapUncharted2Function(Vec3(colorHDR.x, colorHDR.y, colorHDR.z), m_Exposure);
+    m_ToneMap[index] = Vec4(QuantizeUNORM8(colorLDR.x), QuantizeUNORM8(colorLDR.y), QuantizeUNORM8(colorLDR.z), 1.0f);
+}
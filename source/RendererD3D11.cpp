@@ -0,0 +1,984 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "RendererD3D11.h"
+
+#include <DirectXPackedVector.h>
+
+struct DispatchIndirectBuffer {
+    uint32_t ThreadGroupX;
+    uint32_t ThreadGroupY;
+    uint32_t ThreadGroupZ;
+};
+
+struct DrawInstancedIndirectBuffer {
+    uint32_t VertexCount;
+    uint32_t InstanceCount;
+    uint32_t VertexOffset;
+    uint32_t InstanceOffset;
+};
+
+RendererD3D11::RendererD3D11(DX::ComPtr<ID3D11Device> pDevice, DX::ComPtr<ID3D11DeviceContext> pImmediateContext, ProfilerD3D11& profiler, ThreadPool& threadPool)
+    : m_pDevice(pDevice)
+    , m_pImmediateContext(pImmediateContext)
+    , m_Profiler(profiler)
+    , m_AutoExposure(threadPool) {
+
+    this->ReloadShaders();
+    this->InitializeSamplerStates();
+    this->InitializeBuffers();
+    this->InitializeTimestampQueries();
+}
+
+void RendererD3D11::ReloadShaders() {
+
+    //TODO AMD 8x8x1 NV 8x4x1
+    const auto threadSizeX = std::to_string(8);
+    const auto threadSizeY = std::to_string(8);
+
+    D3D_SHADER_MACRO macros[] = {
+        {"THREAD_GROUP_SIZE_X", threadSizeX.c_str()},
+        {"THREAD_GROUP_SIZE_Y", threadSizeY.c_str()},
+        { nullptr, nullptr}
+    };
+
+    auto pBlobCSGeneratePrimaryRays = DX::CompileShaderFromFile(L"content/Shaders/ComputePrimaryRays.hlsl", "GenerateRays", "cs_5_0", macros);
+    auto pBlobCSComputeDiffuseLight = DX::CompileShaderFromFile(L"content/Shaders/ComputeRadiance.hlsl", "ComputeRadiance", "cs_5_0", macros);
+    auto pBlobCSAccumulate = DX::CompileShaderFromFile(L"content/Shaders/Accumulation.hlsl", "Accumulate", "cs_5_0", macros);
+    auto pBlobCSComputeTiles = DX::CompileShaderFromFile(L"content/Shaders/ComputeTiles.hlsl", "ComputeTiles", "cs_5_0", macros);
+    auto pBlobCSToneMap = DX::CompileShaderFromFile(L"content/Shaders/ToneMap.hlsl", "ToneMap", "cs_5_0", macros);
+    auto pBlobCSToneMapImage = DX::CompileShaderFromFile(L"content/Shaders/ToneMap.hlsl", "ToneMapImage", "cs_5_0", macros);
+    auto pBlobCSComputeHistogram = DX::CompileShaderFromFile(L"content/Shaders/ComputeHistogram.hlsl", "ComputeHistogram", "cs_5_0", macros);
+    auto pBlobCSComputeGradient = DX::CompileShaderFromFile(L"content/Shaders/ComputeGradient.hlsl", "ComputeGradient", "cs_5_0", macros);
+    auto pBlobCSGenerateMipLevel = DX::CompileShaderFromFile(L"content/Shaders/ComputeLevelOfDetail.hlsl", "GenerateMipLevel", "cs_5_0", macros);
+    auto pBlobCSResetTiles = DX::CompileShaderFromFile(L"content/Shaders/ComputeTiles.hlsl", "ResetTiles", "cs_5_0", macros);
+    auto pBlobVSDebugTiles = DX::CompileShaderFromFile(L"content/Shaders/DebugTiles.hlsl", "DebugTilesVS", "vs_5_0", macros);
+    auto pBlobGSDebugTiles = DX::CompileShaderFromFile(L"content/Shaders/DebugTiles.hlsl", "DebugTilesGS", "gs_5_0", macros);
+    auto pBlobPSDegugTiles = DX::CompileShaderFromFile(L"content/Shaders/DebugTiles.hlsl", "DebugTilesPS", "ps_5_0", macros);
+
+
+    DX::ThrowIfFailed(m_pDevice->CreateComputeShader(pBlobCSGeneratePrimaryRays->GetBufferPointer(), pBlobCSGeneratePrimaryRays->GetBufferSize(), nullptr, m_PSOGeneratePrimaryRays.pCS.ReleaseAndGetAddressOf()));
+    DX::ThrowIfFailed(m_pDevice->CreateComputeShader(pBlobCSComputeDiffuseLight->GetBufferPointer(), pBlobCSComputeDiffuseLight->GetBufferSize(), nullptr, m_PSOComputeDiffuseLight.pCS.ReleaseAndGetAddressOf()));
+    DX::ThrowIfFailed(m_pDevice->CreateComputeShader(pBlobCSAccumulate->GetBufferPointer(), pBlobCSAccumulate->GetBufferSize(), nullptr, m_PSOAccumulate.pCS.ReleaseAndGetAddressOf()));
+    DX::ThrowIfFailed(m_pDevice->CreateComputeShader(pBlobCSComputeTiles->GetBufferPointer(), pBlobCSComputeTiles->GetBufferSize(), nullptr, m_PSOComputeTiles.pCS.ReleaseAndGetAddressOf()));
+    DX::ThrowIfFailed(m_pDevice->CreateComputeShader(pBlobCSToneMap->GetBufferPointer(), pBlobCSToneMap->GetBufferSize(), nullptr, m_PSOToneMap.pCS.ReleaseAndGetAddressOf()));
+    DX::ThrowIfFailed(m_pDevice->CreateComputeShader(pBlobCSToneMapImage->GetBufferPointer(), pBlobCSToneMapImage->GetBufferSize(), nullptr, m_PSOToneMapImage.pCS.ReleaseAndGetAddressOf()));
+    DX::ThrowIfFailed(m_pDevice->CreateComputeShader(pBlobCSComputeHistogram->GetBufferPointer(), pBlobCSComputeHistogram->GetBufferSize(), nullptr, m_PSOComputeHistogram.pCS.ReleaseAndGetAddressOf()));
+    DX::ThrowIfFailed(m_pDevice->CreateComputeShader(pBlobCSGenerateMipLevel->GetBufferPointer(), pBlobCSGenerateMipLevel->GetBufferSize(), nullptr, m_PSOGenerateMipLevel.pCS.ReleaseAndGetAddressOf()));
+    DX::ThrowIfFailed(m_pDevice->CreateComputeShader(pBlobCSComputeGradient->GetBufferPointer(), pBlobCSComputeGradient->GetBufferSize(), nullptr, m_PSOComputeGradient.pCS.ReleaseAndGetAddressOf()));
+    DX::ThrowIfFailed(m_pDevice->CreateComputeShader(pBlobCSResetTiles->GetBufferPointer(), pBlobCSResetTiles->GetBufferSize(), nullptr, m_PSOResetTiles.pCS.ReleaseAndGetAddressOf()));
+
+
+    DX::ThrowIfFailed(m_pDevice->CreateVertexShader(pBlobVSDebugTiles->GetBufferPointer(), pBlobVSDebugTiles->GetBufferSize(), nullptr, m_PSODegugTiles.pVS.ReleaseAndGetAddressOf()));
+    DX::ThrowIfFailed(m_pDevice->CreateGeometryShader(pBlobGSDebugTiles->GetBufferPointer(), pBlobGSDebugTiles->GetBufferSize(), nullptr, m_PSODegugTiles.pGS.ReleaseAndGetAddressOf()));
+    DX::ThrowIfFailed(m_pDevice->CreatePixelShader(pBlobPSDegugTiles->GetBufferPointer(), pBlobPSDegugTiles->GetBufferSize(), nullptr, m_PSODegugTiles.pPS.ReleaseAndGetAddressOf()));
+}
+
+void RendererD3D11::Resize(uint32_t width, uint32_t height) {
+
+    m_Width = width;
+    m_Height = height;
+    this->InitializeRenderTextures();
+    this->InitializeTileBuffer();
+    m_ActiveTileCount = std::numeric_limits<uint32_t>::max();
+    m_ActiveTilePassCount = std::numeric_limits<uint32_t>::max();
+    m_ExposureToneMapped = 0.0f;
+}
+
+void RendererD3D11::SetVolume(VolumeData const* pVolume) {
+
+    m_pVolume = pVolume;
+
+    const auto dimension = pVolume->GetDimension();
+    const auto mipLevels = pVolume->GetMipLevelCount();
+
+    m_pSRVVolumeIntensity.clear();
+    m_pUAVVolumeIntensity.clear();
+
+    {
+        DX::ComPtr<ID3D11Texture3D> pTextureIntensity;
+        D3D11_TEXTURE3D_DESC desc = {};
+        desc.Width = dimension.x;
+        desc.Height = dimension.y;
+        desc.Depth = dimension.z;
+        desc.Format = DXGI_FORMAT_R16_UNORM;
+        desc.MipLevels = mipLevels;
+        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
+        desc.Usage = D3D11_USAGE_DEFAULT;
+        DX::ThrowIfFailed(m_pDevice->CreateTexture3D(&desc, nullptr, pTextureIntensity.GetAddressOf()));
+
+        for (uint32_t mipLevelID = 0; mipLevelID < desc.MipLevels; mipLevelID++) {
+            D3D11_SHADER_RESOURCE_VIEW_DESC descSRV = {};
+            descSRV.Format = DXGI_FORMAT_R16_UNORM;
+            descSRV.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE3D;
+            descSRV.Texture3D.MipLevels = 1;
+            descSRV.Texture3D.MostDetailedMip = mipLevelID;
+
+            DX::ComPtr<ID3D11ShaderResourceView> pSRVVolumeIntensity;
+            DX::ThrowIfFailed(m_pDevice->CreateShaderResourceView(pTextureIntensity.Get(), &descSRV, pSRVVolumeIntensity.GetAddressOf()));
+            m_pSRVVolumeIntensity.push_back(pSRVVolumeIntensity);
+        }
+
+        {
+            D3D11_SHADER_RESOURCE_VIEW_DESC descSRV = {};
+            descSRV.Format = DXGI_FORMAT_R16_UNORM;
+            descSRV.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE3D;
+            descSRV.Texture3D.MipLevels = desc.MipLevels;
+            descSRV.Texture3D.MostDetailedMip = 0;
+            DX::ThrowIfFailed(m_pDevice->CreateShaderResourceView(pTextureIntensity.Get(), &descSRV, m_pSRVVolumeIntensityMips.ReleaseAndGetAddressOf()));
+        }
+
+        for (uint32_t mipLevelID = 0; mipLevelID < desc.MipLevels; mipLevelID++) {
+            D3D11_UNORDERED_ACCESS_VIEW_DESC descUAV = {};
+            descUAV.Format = DXGI_FORMAT_R16_UNORM;
+            descUAV.ViewDimension = D3D11_UAV_DIMENSION_TEXTURE3D;
+            descUAV.Texture3D.MipSlice = mipLevelID;
+            descUAV.Texture3D.FirstWSlice = 0;
+            descUAV.Texture3D.WSize = std::max(dimension.z >> mipLevelID, 1u);
+
+            DX::ComPtr<ID3D11UnorderedAccessView> pUAVVolumeIntensity;
+            DX::ThrowIfFailed(m_pDevice->CreateUnorderedAccessView(pTextureIntensity.Get(), &descUAV, pUAVVolumeIntensity.GetAddressOf()));
+            m_pUAVVolumeIntensity.push_back(pUAVVolumeIntensity);
+        }
+
+        D3D11_BOX box = { 0, 0, 0,  desc.Width, desc.Height,  desc.Depth };
+        m_pImmediateContext->UpdateSubresource(pTextureIntensity.Get(), 0, &box, std::data(pVolume->GetIntensity()), sizeof(uint16_t) * desc.Width, sizeof(uint16_t) * desc.Height * desc.Width);
+
+        for (uint32_t mipLevelID = 1; mipLevelID < desc.MipLevels; mipLevelID++) {
+            uint32_t threadGroupX = std::max(static_cast<uint32_t>(std::ceil((dimension.x >> mipLevelID) / 4.0f)), 1u);
+            uint32_t threadGroupY = std::max(static_cast<uint32_t>(std::ceil((dimension.y >> mipLevelID) / 4.0f)), 1u);
+            uint32_t threadGroupZ = std::max(static_cast<uint32_t>(std::ceil((dimension.z >> mipLevelID) / 4.0f)), 1u);
+
+            ID3D11ShaderResourceView* ppSRVTextures[] = { m_pSRVVolumeIntensity[mipLevelID - 1].Get() };
+            ID3D11UnorderedAccessView* ppUAVTextures[] = { m_pUAVVolumeIntensity[mipLevelID + 0].Get() };
+            ID3D11SamplerState* ppSamplers[] = { m_pSamplerLinear.Get() };
+
+            ID3D11UnorderedAccessView* ppUAVClear[] = { nullptr };
+            ID3D11ShaderResourceView* ppSRVClear[] = { nullptr };
+            ID3D11SamplerState* ppSamplerClear[] = { nullptr };
+
+            m_Profiler.BeginScope("Generate Mip Level");
+            m_PSOGenerateMipLevel.Apply(m_pImmediateContext);
+            m_pImmediateContext->CSSetShaderResources(0, _countof(ppSRVTextures), ppSRVTextures);
+            m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVTextures), ppUAVTextures, nullptr);
+            m_pImmediateContext->CSSetSamplers(0, _countof(ppSamplers), ppSamplers);
+            m_pImmediateContext->Dispatch(threadGroupX, threadGroupY, threadGroupZ);
+
+            m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVClear), ppUAVClear, nullptr);
+            m_pImmediateContext->CSSetShaderResources(0, _countof(ppSRVClear), ppSRVClear);
+            m_pImmediateContext->CSSetSamplers(0, _countof(ppSamplerClear), ppSamplerClear);
+            m_Profiler.EndScope();
+        }
+        m_pImmediateContext->Flush();
+    }
+
+    {
+        DX::ComPtr<ID3D11Texture3D> pTextureGradient;
+        D3D11_TEXTURE3D_DESC desc = {};
+        desc.Width = dimension.x;
+        desc.Height = dimension.y;
+        desc.Depth = dimension.z;
+        desc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
+        desc.MipLevels = 1;
+        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
+        desc.Usage = D3D11_USAGE_DEFAULT;
+        DX::ThrowIfFailed(m_pDevice->CreateTexture3D(&desc, nullptr, pTextureGradient.ReleaseAndGetAddressOf()));
+        DX::ThrowIfFailed(m_pDevice->CreateShaderResourceView(pTextureGradient.Get(), nullptr, m_pSRVGradient.ReleaseAndGetAddressOf()));
+        DX::ThrowIfFailed(m_pDevice->CreateUnorderedAccessView(pTextureGradient.Get(), nullptr, m_pUAVGradient.ReleaseAndGetAddressOf()));
+        {
+            const auto threadGroupX = static_cast<uint32_t>(std::ceil(dimension.x / 4.0f));
+            const auto threadGroupY = static_cast<uint32_t>(std::ceil(dimension.y / 4.0f));
+            const auto threadGroupZ = static_cast<uint32_t>(std::ceil(dimension.z / 4.0f));
+
+            ID3D11ShaderResourceView* ppSRVTextures[] = { m_pSRVVolumeIntensity[0].Get(), m_pSRVOpacityTF.Get() };
+            ID3D11UnorderedAccessView* ppUAVTextures[] = { m_pUAVGradient.Get() };
+            ID3D11SamplerState* ppSamplers[] = { m_pSamplerPoint.Get(), m_pSamplerLinear.Get() };
+
+            ID3D11UnorderedAccessView* ppUAVClear[] = { nullptr };
+            ID3D11ShaderResourceView* ppSRVClear[] = { nullptr, nullptr };
+            ID3D11SamplerState* ppSamplerClear[] = { nullptr, nullptr };
+
+            m_Profiler.BeginScope("Compute Gradient");
+            m_PSOComputeGradient.Apply(m_pImmediateContext);
+            m_pImmediateContext->CSSetShaderResources(0, _countof(ppSRVTextures), ppSRVTextures);
+            m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVTextures), ppUAVTextures, nullptr);
+            m_pImmediateContext->Dispatch(threadGroupX, threadGroupY, threadGroupZ);
+
+            m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVClear), ppUAVClear, nullptr);
+            m_pImmediateContext->CSSetShaderResources(0, _countof(ppSRVClear), ppSRVClear);
+            m_pImmediateContext->CSSetSamplers(0, _countof(ppSamplerClear), ppSamplerClear);
+            m_Profiler.EndScope();
+        }
+        m_pImmediateContext->Flush();
+    }
+}
+
+void RendererD3D11::SetEnvironmentMap(EnvironmentMap const* pEnvironmentMap) {
+
+    // The texels are decoded from BC6H, so they convert to half floats without loss
+    auto const& texels = pEnvironmentMap->GetTexels();
+    std::vector<DirectX::PackedVector::HALF> texelsHalf(4 * std::size(texels), DirectX::PackedVector::XMConvertFloatToHalf(1.0f));
+    for (uint32_t channel = 0; channel < 3; channel++)
+        DirectX::PackedVector::XMConvertFloatToHalfStream(std::data(texelsHalf) + channel, 4 * sizeof(DirectX::PackedVector::HALF), &texels[0][channel], sizeof(Hawk::Math::Vec3), std::size(texels));
+
+    {
+        D3D11_TEXTURE2D_DESC desc = {};
+        desc.Width = pEnvironmentMap->GetWidth();
+        desc.Height = pEnvironmentMap->GetHeight();
+        desc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
+        desc.ArraySize = 1;
+        desc.MipLevels = 1;
+        desc.SampleDesc.Count = 1;
+        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+        desc.Usage = D3D11_USAGE_IMMUTABLE;
+
+        D3D11_SUBRESOURCE_DATA resourceData = {};
+        resourceData.pSysMem = std::data(texelsHalf);
+        resourceData.SysMemPitch = 4 * sizeof(DirectX::PackedVector::HALF) * desc.Width;
+
+        DX::ComPtr<ID3D11Texture2D> pTexture;
+        DX::ThrowIfFailed(m_pDevice->CreateTexture2D(&desc, &resourceData, pTexture.GetAddressOf()));
+        DX::ThrowIfFailed(m_pDevice->CreateShaderResourceView(pTexture.Get(), nullptr, m_pSRVEnvironment.ReleaseAndGetAddressOf()));
+    }
+
+    auto const& table = pEnvironmentMap->GetAliasTable();
+    DX::ComPtr<ID3D11Buffer> pBuffer = DX::CreateStructuredBuffer<EnvironmentMap::AliasEntry>(m_pDevice, static_cast<uint32_t>(std::size(table)), false, false, std::data(table));
+    {
+        D3D11_SHADER_RESOURCE_VIEW_DESC desc = {};
+        desc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+        desc.BufferEx.FirstElement = 0;
+        desc.BufferEx.NumElements = static_cast<uint32_t>(std::size(table));
+        DX::ThrowIfFailed(m_pDevice->CreateShaderResourceView(pBuffer.Get(), &desc, m_pSRVEnvironmentAlias.ReleaseAndGetAddressOf()));
+    }
+}
+
+void RendererD3D11::SetBlueNoise(BlueNoise const* pBlueNoise) {
+
+    D3D11_TEXTURE2D_DESC desc = {};
+    desc.Width = pBlueNoise->GetSize();
+    desc.Height = pBlueNoise->GetSize();
+    desc.Format = DXGI_FORMAT_R32_FLOAT;
+    desc.ArraySize = 1;
+    desc.MipLevels = 1;
+    desc.SampleDesc.Count = 1;
+    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    desc.Usage = D3D11_USAGE_IMMUTABLE;
+
+    D3D11_SUBRESOURCE_DATA resourceData = {};
+    resourceData.pSysMem = std::data(pBlueNoise->GetTexels());
+    resourceData.SysMemPitch = sizeof(F32) * pBlueNoise->GetSize();
+
+    DX::ComPtr<ID3D11Texture2D> pTexture;
+    DX::ThrowIfFailed(m_pDevice->CreateTexture2D(&desc, &resourceData, pTexture.GetAddressOf()));
+    DX::ThrowIfFailed(m_pDevice->CreateShaderResourceView(pTexture.Get(), nullptr, m_pSRVBlueNoise.ReleaseAndGetAddressOf()));
+}
+
+void RendererD3D11::SetMajorantGrid(MajorantGrid const* pMajorantGrid) {
+
+    const auto dimension = pMajorantGrid->GetDimension();
+
+    auto CreateGridTexture = [&](void const* pData, uint32_t stride, DXGI_FORMAT format, DX::ComPtr<ID3D11ShaderResourceView>& pSRV) {
+        D3D11_TEXTURE3D_DESC desc = {};
+        desc.Width = dimension.x;
+        desc.Height = dimension.y;
+        desc.Depth = dimension.z;
+        desc.Format = format;
+        desc.MipLevels = 1;
+        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+        desc.Usage = D3D11_USAGE_IMMUTABLE;
+
+        D3D11_SUBRESOURCE_DATA resourceData = {};
+        resourceData.pSysMem = pData;
+        resourceData.SysMemPitch = stride * dimension.x;
+        resourceData.SysMemSlicePitch = stride * dimension.x * dimension.y;
+
+        DX::ComPtr<ID3D11Texture3D> pTexture;
+        DX::ThrowIfFailed(m_pDevice->CreateTexture3D(&desc, &resourceData, pTexture.GetAddressOf()));
+        DX::ThrowIfFailed(m_pDevice->CreateShaderResourceView(pTexture.Get(), nullptr, pSRV.ReleaseAndGetAddressOf()));
+    };
+
+    CreateGridTexture(std::data(pMajorantGrid->GetMajorants()), sizeof(F32), DXGI_FORMAT_R32_FLOAT, m_pSRVMajorant);
+    CreateGridTexture(std::data(pMajorantGrid->GetControls()), sizeof(MajorantGrid::Control), DXGI_FORMAT_R32G32_FLOAT, m_pSRVControl);
+}
+
+void RendererD3D11::SetTransferFunctions(TransferFunctionSet const& functions, uint32_t samplingCount) {
+
+    m_pSRVOpacityTF = DX::CreateTexture1D(m_pDevice, DXGI_FORMAT_R8_UNORM, functions.Opacity.GenerateTable(samplingCount));
+    m_pSRVDiffuseTF = DX::CreateTexture1D(m_pDevice, DXGI_FORMAT_R8G8B8A8_UNORM, functions.Diffuse.GenerateTable(samplingCount));
+    m_pSRVSpecularTF = DX::CreateTexture1D(m_pDevice, DXGI_FORMAT_R8G8B8A8_UNORM, functions.Specular.GenerateTable(samplingCount));
+    m_pSRVRoughnessTF = DX::CreateTexture1D(m_pDevice, DXGI_FORMAT_R8_UNORM, functions.Roughness.GenerateTable(samplingCount));
+}
+
+void RendererD3D11::InitializeSamplerStates() {
+
+    auto createSamplerState = [this](auto filter, auto addressMode) -> DX::ComPtr<ID3D11SamplerState> {
+        D3D11_SAMPLER_DESC desc = {};
+        desc.Filter = filter;
+        desc.AddressU = addressMode;
+        desc.AddressV = addressMode;
+        desc.AddressW = addressMode;
+        desc.MaxAnisotropy = D3D11_MAX_MAXANISOTROPY;
+        desc.MaxLOD = FLT_MAX;
+        desc.ComparisonFunc = D3D11_COMPARISON_NEVER;
+
+        DX::ComPtr<ID3D11SamplerState> pSamplerState;
+        DX::ThrowIfFailed(m_pDevice->CreateSamplerState(&desc, pSamplerState.GetAddressOf()));
+        return pSamplerState;
+    };
+
+    m_pSamplerPoint = createSamplerState(D3D11_FILTER_MIN_MAG_MIP_POINT, D3D11_TEXTURE_ADDRESS_BORDER);
+    m_pSamplerLinear = createSamplerState(D3D11_FILTER_MIN_MAG_LINEAR_MIP_POINT, D3D11_TEXTURE_ADDRESS_BORDER);
+    m_pSamplerAnisotropic = createSamplerState(D3D11_FILTER_ANISOTROPIC, D3D11_TEXTURE_ADDRESS_WRAP);
+}
+
+void RendererD3D11::InitializeBuffers() {
+
+    m_pConstantBufferFrame = DX::CreateConstantBuffer<FrameBuffer>(m_pDevice);
+    m_pDispatchIndirectBufferArgs = DX::CreateIndirectBuffer<DispatchIndirectBuffer>(m_pDevice, DispatchIndirectBuffer{ 1, 1, 1 });
+    m_pDrawInstancedIndirectBufferArgs = DX::CreateIndirectBuffer<DrawInstancedIndirectBuffer>(m_pDevice, DrawInstancedIndirectBuffer{ 0, 1, 0, 0 });
+}
+
+void RendererD3D11::InitializeRenderTextures() {
+
+    {
+        D3D11_TEXTURE2D_DESC desc = {};
+        desc.ArraySize = 1;
+        desc.MipLevels = 1;
+        desc.Format = DXGI_FORMAT_R11G11B10_FLOAT;
+        desc.Width = m_Width;
+        desc.Height = m_Height;
+        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
+        desc.SampleDesc.Count = 1;
+        desc.SampleDesc.Quality = 0;
+
+        DX::ComPtr<ID3D11Texture2D> pTextureDiffuse;
+        DX::ThrowIfFailed(m_pDevice->CreateTexture2D(&desc, nullptr, pTextureDiffuse.ReleaseAndGetAddressOf()));
+        DX::ThrowIfFailed(m_pDevice->CreateShaderResourceView(pTextureDiffuse.Get(), nullptr, m_pSRVDiffuse.ReleaseAndGetAddressOf()));
+        DX::ThrowIfFailed(m_pDevice->CreateUnorderedAccessView(pTextureDiffuse.Get(), nullptr, m_pUAVDiffuse.ReleaseAndGetAddressOf()));
+    }
+
+    {
+        D3D11_TEXTURE2D_DESC desc = {};
+        desc.ArraySize = 1;
+        desc.MipLevels = 1;
+        desc.Format = DXGI_FORMAT_R11G11B10_FLOAT;
+        desc.Width = m_Width;
+        desc.Height = m_Height;
+        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
+        desc.SampleDesc.Count = 1;
+        desc.SampleDesc.Quality = 0;
+
+        DX::ComPtr<ID3D11Texture2D> pTextureSpecular;
+        DX::ThrowIfFailed(m_pDevice->CreateTexture2D(&desc, nullptr, pTextureSpecular.ReleaseAndGetAddressOf()));
+        DX::ThrowIfFailed(m_pDevice->CreateShaderResourceView(pTextureSpecular.Get(), nullptr, m_pSRVSpecular.ReleaseAndGetAddressOf()));
+        DX::ThrowIfFailed(m_pDevice->CreateUnorderedAccessView(pTextureSpecular.Get(), nullptr, m_pUAVSpecular.ReleaseAndGetAddressOf()));
+    }
+
+    {
+        D3D11_TEXTURE2D_DESC desc = {};
+        desc.ArraySize = 1;
+        desc.MipLevels = 1;
+        desc.Format = DXGI_FORMAT_R11G11B10_FLOAT;
+        desc.Width = m_Width;
+        desc.Height = m_Height;
+        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
+        desc.SampleDesc.Count = 1;
+        desc.SampleDesc.Quality = 0;
+
+        DX::ComPtr<ID3D11Texture2D> pTextureDiffuseLight;
+        DX::ThrowIfFailed(m_pDevice->CreateTexture2D(&desc, nullptr, pTextureDiffuseLight.ReleaseAndGetAddressOf()));
+        DX::ThrowIfFailed(m_pDevice->CreateShaderResourceView(pTextureDiffuseLight.Get(), nullptr, m_pSRVRadiance.ReleaseAndGetAddressOf()));
+        DX::ThrowIfFailed(m_pDevice->CreateUnorderedAccessView(pTextureDiffuseLight.Get(), nullptr, m_pUAVRadiance.ReleaseAndGetAddressOf()));
+    }
+
+    {
+        D3D11_TEXTURE2D_DESC desc = {};
+        desc.ArraySize = 1;
+        desc.MipLevels = 1;
+        desc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
+        desc.Width = m_Width;
+        desc.Height = m_Height;
+        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
+        desc.SampleDesc.Count = 1;
+        desc.SampleDesc.Quality = 0;
+
+        DX::ComPtr<ID3D11Texture2D> pTextureNormal;
+        DX::ThrowIfFailed(m_pDevice->CreateTexture2D(&desc, nullptr, pTextureNormal.ReleaseAndGetAddressOf()));
+        DX::ThrowIfFailed(m_pDevice->CreateShaderResourceView(pTextureNormal.Get(), nullptr, m_pSRVNormal.ReleaseAndGetAddressOf()));
+        DX::ThrowIfFailed(m_pDevice->CreateUnorderedAccessView(pTextureNormal.Get(), nullptr, m_pUAVNormal.ReleaseAndGetAddressOf()));
+    }
+
+    {
+        D3D11_TEXTURE2D_DESC desc = {};
+        desc.ArraySize = 1;
+        desc.MipLevels = 1;
+        desc.Format = DXGI_FORMAT_R32_FLOAT;
+        desc.Width = m_Width;
+        desc.Height = m_Height;
+        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
+        desc.SampleDesc.Count = 1;
+        desc.SampleDesc.Quality = 0;
+
+        DX::ComPtr<ID3D11Texture2D> pTextureDepth;
+        DX::ThrowIfFailed(m_pDevice->CreateTexture2D(&desc, nullptr, pTextureDepth.ReleaseAndGetAddressOf()));
+        DX::ThrowIfFailed(m_pDevice->CreateShaderResourceView(pTextureDepth.Get(), nullptr, m_pSRVDepth.ReleaseAndGetAddressOf()));
+        DX::ThrowIfFailed(m_pDevice->CreateUnorderedAccessView(pTextureDepth.Get(), nullptr, m_pUAVDepth.ReleaseAndGetAddressOf()));
+    }
+
+    {
+        D3D11_TEXTURE2D_DESC desc = {};
+        desc.ArraySize = 1;
+        desc.MipLevels = 1;
+        desc.Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+        desc.Width = m_Width;
+        desc.Height = m_Height;
+        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
+        desc.SampleDesc.Count = 1;
+        desc.SampleDesc.Quality = 0;
+
+        DX::ComPtr<ID3D11Texture2D> pTextureColorSum;
+        DX::ThrowIfFailed(m_pDevice->CreateTexture2D(&desc, nullptr, pTextureColorSum.ReleaseAndGetAddressOf()));
+        DX::ThrowIfFailed(m_pDevice->CreateShaderResourceView(pTextureColorSum.Get(), nullptr, m_pSRVColorSum.ReleaseAndGetAddressOf()));
+        DX::ThrowIfFailed(m_pDevice->CreateUnorderedAccessView(pTextureColorSum.Get(), nullptr, m_pUAVColorSum.ReleaseAndGetAddressOf()));
+    }
+
+    {
+        D3D11_TEXTURE2D_DESC desc = {};
+        desc.ArraySize = 1;
+        desc.MipLevels = 1;
+        desc.Format = DXGI_FORMAT_R32_FLOAT;
+        desc.Width = m_Width;
+        desc.Height = m_Height;
+        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
+        desc.SampleDesc.Count = 1;
+        desc.SampleDesc.Quality = 0;
+
+        DX::ComPtr<ID3D11Texture2D> pTextureColorMoment;
+        DX::ThrowIfFailed(m_pDevice->CreateTexture2D(&desc, nullptr, pTextureColorMoment.ReleaseAndGetAddressOf()));
+        DX::ThrowIfFailed(m_pDevice->CreateShaderResourceView(pTextureColorMoment.Get(), nullptr, m_pSRVColorMoment.ReleaseAndGetAddressOf()));
+        DX::ThrowIfFailed(m_pDevice->CreateUnorderedAccessView(pTextureColorMoment.Get(), nullptr, m_pUAVColorMoment.ReleaseAndGetAddressOf()));
+    }
+
+    {
+        D3D11_TEXTURE2D_DESC desc = {};
+        desc.ArraySize = 1;
+        desc.MipLevels = 1;
+        desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        desc.Width = m_Width;
+        desc.Height = m_Height;
+        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
+        desc.SampleDesc.Count = 1;
+        desc.SampleDesc.Quality = 0;
+
+        DX::ComPtr<ID3D11Texture2D> pTextureToneMap;
+        DX::ThrowIfFailed(m_pDevice->CreateTexture2D(&desc, nullptr, pTextureToneMap.ReleaseAndGetAddressOf()));
+        DX::ThrowIfFailed(m_pDevice->CreateShaderResourceView(pTextureToneMap.Get(), nullptr, m_pSRVToneMap.ReleaseAndGetAddressOf()));
+        DX::ThrowIfFailed(m_pDevice->CreateUnorderedAccessView(pTextureToneMap.Get(), nullptr, m_pUAVToneMap.ReleaseAndGetAddressOf()));
+    }
+}
+
+void RendererD3D11::InitializeTileBuffer() {
+
+    const uint32_t threadGroupsX = (m_Width + 7) / 8;
+    const uint32_t threadGroupsY = (m_Height + 7) / 8;
+
+    DX::ComPtr<ID3D11Buffer> pBuffer = DX::CreateStructuredBuffer<uint32_t>(m_pDevice, threadGroupsX * threadGroupsY, false, true, nullptr);
+    {
+        D3D11_SHADER_RESOURCE_VIEW_DESC desc = {};
+        desc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+        desc.BufferEx.FirstElement = 0;
+        desc.BufferEx.NumElements = threadGroupsX * threadGroupsY;
+        DX::ThrowIfFailed(m_pDevice->CreateShaderResourceView(pBuffer.Get(), &desc, m_pSRVDispersionTiles.ReleaseAndGetAddressOf()));
+    }
+
+    {
+        D3D11_UNORDERED_ACCESS_VIEW_DESC desc = {};
+        desc.ViewDimension = D3D11_UAV_DIMENSION_BUFFER;
+        desc.Buffer.FirstElement = 0;
+        desc.Buffer.NumElements = threadGroupsX * threadGroupsY;
+        desc.Buffer.Flags = D3D11_BUFFER_UAV_FLAG_APPEND;
+        DX::ThrowIfFailed(m_pDevice->CreateUnorderedAccessView(pBuffer.Get(), &desc, m_pUAVDispersionTiles.ReleaseAndGetAddressOf()));
+    }
+
+    // The counter of the selected tiles is followed by the histogram of their pass counts
+    for (auto& pBuffer : m_pTileCounterReadback)
+        pBuffer = DX::CreateStagingBuffer<uint32_t>(m_pDevice, 1 + Shading::TilePassCountMax);
+    m_TileCounterFrames.fill(std::numeric_limits<uint32_t>::max());
+
+    // AutoExposure::BinCount counts per tile of the full resolution, the reduced resolutions use a part of them
+    auto CreateHistogramUAV = [&](DX::ComPtr<ID3D11Buffer> pBuffer, uint32_t elementCount, DX::ComPtr<ID3D11UnorderedAccessView>& pUAV) {
+        D3D11_UNORDERED_ACCESS_VIEW_DESC desc = {};
+        desc.ViewDimension = D3D11_UAV_DIMENSION_BUFFER;
+        desc.Buffer.FirstElement = 0;
+        desc.Buffer.NumElements = elementCount;
+        DX::ThrowIfFailed(m_pDevice->CreateUnorderedAccessView(pBuffer.Get(), &desc, pUAV.ReleaseAndGetAddressOf()));
+    };
+
+    const uint32_t tileCount = ((m_Width + 7) / 8) * ((m_Height + 7) / 8);
+    m_pHistogram = DX::CreateStructuredBuffer<uint32_t>(m_pDevice, AutoExposure::BinCount, false, true, nullptr);
+    CreateHistogramUAV(m_pHistogram, AutoExposure::BinCount, m_pUAVHistogram);
+    CreateHistogramUAV(DX::CreateStructuredBuffer<uint32_t>(m_pDevice, tileCount * AutoExposure::BinCount, false, true, nullptr), tileCount * AutoExposure::BinCount, m_pUAVTileHistograms);
+
+    m_pBufferTilePasses = DX::CreateStructuredBuffer<uint32_t>(m_pDevice, Shading::TilePassCountMax + tileCount, false, true, nullptr);
+    DX::ThrowIfFailed(m_pDevice->CreateShaderResourceView(m_pBufferTilePasses.Get(), nullptr, m_pSRVTilePasses.ReleaseAndGetAddressOf()));
+    DX::ThrowIfFailed(m_pDevice->CreateUnorderedAccessView(m_pBufferTilePasses.Get(), nullptr, m_pUAVTilePasses.ReleaseAndGetAddressOf()));
+
+    for (auto& pBuffer : m_pHistogramReadback)
+        pBuffer = DX::CreateStagingBuffer<uint32_t>(m_pDevice, AutoExposure::BinCount);
+    m_HistogramFrames.fill(std::numeric_limits<uint32_t>::max());
+}
+
+void RendererD3D11::InitializeTimestampQueries() {
+
+    D3D11_QUERY_DESC desc = {};
+    for (uint32_t index = 0; index < FrameCount; index++) {
+        desc.Query = D3D11_QUERY_TIMESTAMP_DISJOINT;
+        DX::ThrowIfFailed(m_pDevice->CreateQuery(&desc, m_pQueryDisjoint[index].ReleaseAndGetAddressOf()));
+        desc.Query = D3D11_QUERY_TIMESTAMP;
+        DX::ThrowIfFailed(m_pDevice->CreateQuery(&desc, m_pQueryFrameBegin[index].ReleaseAndGetAddressOf()));
+        DX::ThrowIfFailed(m_pDevice->CreateQuery(&desc, m_pQueryFrameEnd[index].ReleaseAndGetAddressOf()));
+    }
+    m_TimestampDimensions.fill(Hawk::Math::Vec2u(0, 0));
+}
+
+void RendererD3D11::UpdateExposure() {
+
+    // The histograms come back a few frames late like the tile counters, the newest one that is ready is used
+    std::array<uint32_t, AutoExposure::BinCount> histogram = {};
+    bool isReady = false;
+    for (uint32_t offset = 0; offset < FrameCount; offset++) {
+        const uint32_t index = (m_HistogramIndex + offset) % FrameCount;
+        if (m_HistogramFrames[index] == std::numeric_limits<uint32_t>::max())
+            continue;
+
+        D3D11_MAPPED_SUBRESOURCE resource = {};
+        if (m_pImmediateContext->Map(m_pHistogramReadback[index].Get(), 0, D3D11_MAP_READ, D3D11_MAP_FLAG_DO_NOT_WAIT, &resource) == S_OK) {
+            std::copy_n(static_cast<uint32_t const*>(resource.pData), AutoExposure::BinCount, std::begin(histogram));
+            m_pImmediateContext->Unmap(m_pHistogramReadback[index].Get(), 0);
+            m_HistogramFrames[index] = std::numeric_limits<uint32_t>::max();
+            isReady = true;
+        }
+    }
+
+    // Adapts over the time between the histograms, the first one is taken as it is
+    const auto time = std::chrono::high_resolution_clock::now();
+    if (isReady) {
+        const F32 deltaTime = m_AutoExposure.IsAdapted() ? std::chrono::duration<F32>(time - m_ExposureUpdateTime).count() : 0.0f;
+        m_AutoExposure.Adapt(histogram, deltaTime);
+        m_ExposureUpdateTime = time;
+    }
+}
+
+void RendererD3D11::RenderFrame(FrameBuffer const& frame) {
+
+    ProfilerD3D11::Scope scope(m_Profiler, "Path Tracing");
+
+    ID3D11UnorderedAccessView* ppUAVClear[] = { nullptr, nullptr, nullptr, nullptr };
+    ID3D11ShaderResourceView* ppSRVClear[] = { nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr };
+
+    const auto renderDimension = Hawk::Math::Vec2u(static_cast<uint32_t>(frame.RenderTargetDim.x), static_cast<uint32_t>(frame.RenderTargetDim.y));
+    const auto threadGroupsX = static_cast<uint32_t>(std::ceil(renderDimension.x / 8.0f));
+    const auto threadGroupsY = static_cast<uint32_t>(std::ceil(renderDimension.y / 8.0f));
+
+    // Every tile is selected again from the first frame, the counters of the previous image are dropped
+    if (frame.FrameIndex == 0) {
+        m_ActiveTileCount = std::numeric_limits<uint32_t>::max();
+        m_ActiveTilePassCount = std::numeric_limits<uint32_t>::max();
+        m_TileCounterFrames.fill(std::numeric_limits<uint32_t>::max());
+    }
+
+    if (m_IsAutoExposure)
+        this->UpdateExposure();
+    m_Exposure = m_IsAutoExposure && m_AutoExposure.IsAdapted() ? m_AutoExposure.GetExposure() : frame.Exposure;
+
+    {
+        DX::MapHelper<FrameBuffer> map(m_pImmediateContext, m_pConstantBufferFrame, D3D11_MAP_WRITE_DISCARD, 0);
+        *map = frame;
+        map->Exposure = m_Exposure;
+        map->TilePass = 0;
+    }
+
+    m_pImmediateContext->CSSetConstantBuffers(0, 1, m_pConstantBufferFrame.GetAddressOf());
+    m_pImmediateContext->CSSetShaderResources(15, 1, m_pSRVBlueNoise.GetAddressOf());
+
+    m_pImmediateContext->Begin(m_pQueryDisjoint[m_TimestampIndex].Get());
+    m_pImmediateContext->End(m_pQueryFrameBegin[m_TimestampIndex].Get());
+
+    if (frame.FrameIndex < m_SampleDispersion) {
+        ID3D11UnorderedAccessView* ppUAVResources[] = { m_pUAVDispersionTiles.Get() };
+        constexpr uint32_t pCounters[] = { 0 };
+
+        m_Profiler.BeginScope("Reset Tiles");
+        m_PSOResetTiles.Apply(m_pImmediateContext);
+        m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVResources), ppUAVResources, pCounters);
+        m_pImmediateContext->Dispatch(threadGroupsX, threadGroupsY, 1);
+        m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVClear), ppUAVClear, nullptr);
+        m_Profiler.EndScope();
+    } else {
+        ID3D11ShaderResourceView* ppSRVResources[] = { m_pSRVColorSum.Get(), m_pSRVColorMoment.Get() };
+        ID3D11UnorderedAccessView* ppUAVResources[] = { m_pUAVDispersionTiles.Get(), m_pUAVTilePasses.Get() };
+        constexpr uint32_t pCounters[] = { 0, 0 };
+        constexpr uint32_t clearValue[] = { 0, 0, 0, 0 };
+
+        m_Profiler.BeginScope("Compute Tiles");
+        m_pImmediateContext->ClearUnorderedAccessViewUint(m_pUAVTilePasses.Get(), clearValue);
+        m_PSOComputeTiles.Apply(m_pImmediateContext);
+        m_pImmediateContext->CSSetShaderResources(0, _countof(ppSRVResources), ppSRVResources);
+        m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVResources), ppUAVResources, pCounters);
+        m_pImmediateContext->Dispatch(threadGroupsX, threadGroupsY, 1);
+        m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVClear), ppUAVClear, nullptr);
+        m_pImmediateContext->CSSetShaderResources(0, _countof(ppSRVClear), ppSRVClear);
+        m_Profiler.EndScope();
+    }
+
+    auto ClearBuffers = [&]() {
+        constexpr float clearColor[] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        m_Profiler.BeginScope("Clear Buffers");
+        m_pImmediateContext->ClearUnorderedAccessViewFloat(m_pUAVDiffuse.Get(), clearColor);
+        m_pImmediateContext->ClearUnorderedAccessViewFloat(m_pUAVNormal.Get(), clearColor);
+        m_pImmediateContext->ClearUnorderedAccessViewFloat(m_pUAVDepth.Get(), clearColor);
+        m_pImmediateContext->ClearUnorderedAccessViewFloat(m_pUAVRadiance.Get(), clearColor);
+        m_Profiler.EndScope();
+    };
+    ClearBuffers();
+
+    m_Profiler.BeginScope("Copy Tile Counters");
+    m_pImmediateContext->CopyStructureCount(m_pDispatchIndirectBufferArgs.Get(), 0, m_pUAVDispersionTiles.Get());
+    m_pImmediateContext->CopyStructureCount(m_pDrawInstancedIndirectBufferArgs.Get(), 0, m_pUAVDispersionTiles.Get());
+    m_pImmediateContext->CopyStructureCount(m_pTileCounterReadback[m_TileCounterIndex].Get(), 0, m_pUAVDispersionTiles.Get());
+    if (frame.FrameIndex >= m_SampleDispersion) {
+        const D3D11_BOX box = { 0, 0, 0, sizeof(uint32_t) * Shading::TilePassCountMax, 1, 1 };
+        m_pImmediateContext->CopySubresourceRegion(m_pTileCounterReadback[m_TileCounterIndex].Get(), 0, sizeof(uint32_t), 0, 0, m_pBufferTilePasses.Get(), 0, &box);
+    }
+    m_TileCounterFrames[m_TileCounterIndex] = frame.FrameIndex;
+    m_TileCounterTileCounts[m_TileCounterIndex] = threadGroupsX * threadGroupsY;
+    m_TileCounterIndex = (m_TileCounterIndex + 1) % FrameCount;
+    m_Profiler.EndScope();
+
+    auto RenderTiles = [&]() {
+        {
+            ID3D11SamplerState* ppSamplers[] = {
+                m_pSamplerPoint.Get(),
+                m_pSamplerLinear.Get(),
+                m_pSamplerAnisotropic.Get()
+            };
+
+            ID3D11ShaderResourceView* ppSRVResources[] = {
+                m_pSRVVolumeIntensityMips.Get(),
+                m_pSRVGradient.Get(),
+                m_pSRVDiffuseTF.Get(),
+                m_pSRVSpecularTF.Get(),
+                m_pSRVRoughnessTF.Get(),
+                m_pSRVOpacityTF.Get(),
+                m_pSRVDispersionTiles.Get(),
+                m_pSRVMajorant.Get(),
+                m_pSRVColorSum.Get()
+            };
+
+            ID3D11UnorderedAccessView* ppUAVResources[] = {
+                m_pUAVDiffuse.Get(),
+                m_pUAVSpecular.Get(),
+                m_pUAVNormal.Get(),
+                m_pUAVDepth.Get()
+            };
+
+            m_Profiler.BeginScope("Generate Rays");
+            m_PSOGeneratePrimaryRays.Apply(m_pImmediateContext);
+            m_pImmediateContext->CSSetSamplers(0, _countof(ppSamplers), ppSamplers);
+            m_pImmediateContext->CSSetShaderResources(0, _countof(ppSRVResources), ppSRVResources);
+            m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVResources), ppUAVResources, nullptr);
+            m_pImmediateContext->DispatchIndirect(m_pDispatchIndirectBufferArgs.Get(), 0);
+            m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVClear), ppUAVClear, nullptr);
+            m_pImmediateContext->CSSetShaderResources(0, _countof(ppSRVClear), ppSRVClear);
+            m_Profiler.EndScope();
+        }
+
+        {
+            ID3D11SamplerState* ppSamplers[] = {
+                m_pSamplerPoint.Get(),
+                m_pSamplerLinear.Get(),
+                m_pSamplerAnisotropic.Get()
+            };
+
+            ID3D11ShaderResourceView* ppSRVResources[] = {
+                m_pSRVVolumeIntensityMips.Get(),
+                m_pSRVOpacityTF.Get(),
+                m_pSRVDiffuse.Get(),
+                m_pSRVSpecular.Get(),
+                m_pSRVNormal.Get(),
+                m_pSRVDepth.Get(),
+                m_pSRVEnvironment.Get(),
+                m_pSRVDispersionTiles.Get(),
+                m_pSRVMajorant.Get(),
+                m_pSRVControl.Get(),
+                m_pSRVEnvironmentAlias.Get(),
+                m_pSRVColorSum.Get()
+            };
+
+            ID3D11UnorderedAccessView* ppUAVResources[] = {
+                m_pUAVRadiance.Get()
+            };
+
+            m_Profiler.BeginScope("Compute Radiance");
+            m_PSOComputeDiffuseLight.Apply(m_pImmediateContext);
+            m_pImmediateContext->CSSetSamplers(0, _countof(ppSamplers), ppSamplers);
+            m_pImmediateContext->CSSetShaderResources(0, _countof(ppSRVResources), ppSRVResources);
+            m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVResources), ppUAVResources, nullptr);
+            m_pImmediateContext->DispatchIndirect(m_pDispatchIndirectBufferArgs.Get(), 0);
+            m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVClear), ppUAVClear, nullptr);
+            m_pImmediateContext->CSSetShaderResources(0, _countof(ppSRVClear), ppSRVClear);
+            m_Profiler.EndScope();
+        }
+
+        {
+            ID3D11ShaderResourceView* ppSRVResources[] = { m_pSRVRadiance.Get(),  m_pSRVDispersionTiles.Get() };
+            ID3D11UnorderedAccessView* ppUAVResources[] = { m_pUAVColorSum.Get(), m_pUAVColorMoment.Get() };
+
+            m_Profiler.BeginScope("Accumulate");
+            m_PSOAccumulate.Apply(m_pImmediateContext);
+            m_pImmediateContext->CSSetShaderResources(0, _countof(ppSRVResources), ppSRVResources);
+            m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVResources), ppUAVResources, nullptr);
+            m_pImmediateContext->DispatchIndirect(m_pDispatchIndirectBufferArgs.Get(), 0);
+            m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVClear), ppUAVClear, nullptr);
+            m_pImmediateContext->CSSetShaderResources(0, _countof(ppSRVClear), ppSRVClear);
+            m_Profiler.EndScope();
+        }
+    };
+    RenderTiles();
+
+    // The tiles with the largest error take the passes the retired tiles leave, each pass draws its own samples
+    if (frame.FrameIndex >= m_SampleDispersion && frame.TileErrorThreshold > 0.0f) {
+        ProfilerD3D11::Scope scopePasses(m_Profiler, "Tile Passes");
+        m_pImmediateContext->CSSetShaderResources(14, 1, m_pSRVTilePasses.GetAddressOf());
+        for (uint32_t pass = 1; pass < Shading::TilePassCountMax; pass++) {
+            {
+                DX::MapHelper<FrameBuffer> map(m_pImmediateContext, m_pConstantBufferFrame, D3D11_MAP_WRITE_DISCARD, 0);
+                *map = frame;
+                map->Exposure = m_Exposure;
+                map->TilePass = pass;
+            }
+            ClearBuffers();
+            RenderTiles();
+        }
+
+        ID3D11ShaderResourceView* pSRVNull = nullptr;
+        m_pImmediateContext->CSSetShaderResources(14, 1, &pSRVNull);
+
+        DX::MapHelper<FrameBuffer> map(m_pImmediateContext, m_pConstantBufferFrame, D3D11_MAP_WRITE_DISCARD, 0);
+        *map = frame;
+        map->Exposure = m_Exposure;
+        map->TilePass = 0;
+    }
+
+    if (m_IsAutoExposure) {
+        ID3D11ShaderResourceView* ppSRVResources[] = { m_pSRVColorSum.Get(), m_pSRVDispersionTiles.Get() };
+        ID3D11UnorderedAccessView* ppUAVResources[] = { m_pUAVTileHistograms.Get(), m_pUAVHistogram.Get() };
+
+        // Every tile is selected again from the first frame, the histograms of the previous image are dropped
+        constexpr uint32_t clearValue[] = { 0, 0, 0, 0 };
+        if (frame.FrameIndex == 0) {
+            m_pImmediateContext->ClearUnorderedAccessViewUint(m_pUAVTileHistograms.Get(), clearValue);
+            m_pImmediateContext->ClearUnorderedAccessViewUint(m_pUAVHistogram.Get(), clearValue);
+        }
+
+        m_Profiler.BeginScope("Compute Histogram");
+        m_PSOComputeHistogram.Apply(m_pImmediateContext);
+        m_pImmediateContext->CSSetShaderResources(0, _countof(ppSRVResources), ppSRVResources);
+        m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVResources), ppUAVResources, nullptr);
+        m_pImmediateContext->DispatchIndirect(m_pDispatchIndirectBufferArgs.Get(), 0);
+        m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVClear), ppUAVClear, nullptr);
+        m_pImmediateContext->CSSetShaderResources(0, _countof(ppSRVClear), ppSRVClear);
+
+        m_pImmediateContext->CopySubresourceRegion(m_pHistogramReadback[m_HistogramIndex].Get(), 0, 0, 0, 0, m_pHistogram.Get(), 0, nullptr);
+        m_HistogramFrames[m_HistogramIndex] = frame.FrameIndex;
+        m_HistogramIndex = (m_HistogramIndex + 1) % FrameCount;
+        m_Profiler.EndScope();
+    }
+
+    {
+        ID3D11ShaderResourceView* ppSRVResources[] = { m_pSRVColorSum.Get(), m_pSRVDispersionTiles.Get() };
+        ID3D11UnorderedAccessView* ppUAVResources[] = { m_pUAVToneMap.Get() };
+
+        // The tiles that are no longer rendered are tone mapped again when the exposure has moved on
+        const bool isToneMapImage = std::abs(m_Exposure - m_ExposureToneMapped) > AutoExposure::ExposureTolerance * m_ExposureToneMapped;
+        if (isToneMapImage)
+            m_ExposureToneMapped = m_Exposure;
+
+        m_Profiler.BeginScope("Tone Map");
+        (isToneMapImage ? m_PSOToneMapImage : m_PSOToneMap).Apply(m_pImmediateContext);
+        m_pImmediateContext->CSSetShaderResources(0, _countof(ppSRVResources), ppSRVResources);
+        m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVResources), ppUAVResources, nullptr);
+        if (isToneMapImage)
+            m_pImmediateContext->Dispatch(threadGroupsX, threadGroupsY, 1);
+        else
+            m_pImmediateContext->DispatchIndirect(m_pDispatchIndirectBufferArgs.Get(), 0);
+        m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVClear), ppUAVClear, nullptr);
+        m_pImmediateContext->CSSetShaderResources(0, _countof(ppSRVClear), ppSRVClear);
+        m_Profiler.EndScope();
+    }
+
+    m_pImmediateContext->End(m_pQueryFrameEnd[m_TimestampIndex].Get());
+    m_pImmediateContext->End(m_pQueryDisjoint[m_TimestampIndex].Get());
+    m_TimestampDimensions[m_TimestampIndex] = renderDimension;
+    m_TimestampIndex = (m_TimestampIndex + 1) % FrameCount;
+}
+
+void RendererD3D11::ToneMapImage(FrameBuffer const& frame) {
+
+    ID3D11UnorderedAccessView* ppUAVClear[] = { nullptr };
+    ID3D11ShaderResourceView* ppSRVClear[] = { nullptr, nullptr };
+
+    const auto threadGroupsX = static_cast<uint32_t>(std::ceil(frame.RenderTargetDim.x / 8.0f));
+    const auto threadGroupsY = static_cast<uint32_t>(std::ceil(frame.RenderTargetDim.y / 8.0f));
+
+    m_Exposure = m_IsAutoExposure && m_AutoExposure.IsAdapted() ? m_AutoExposure.GetExposure() : frame.Exposure;
+    m_ExposureToneMapped = m_Exposure;
+
+    {
+        DX::MapHelper<FrameBuffer> map(m_pImmediateContext, m_pConstantBufferFrame, D3D11_MAP_WRITE_DISCARD, 0);
+        *map = frame;
+        map->Exposure = m_Exposure;
+        map->TilePass = 0;
+    }
+
+    ID3D11ShaderResourceView* ppSRVResources[] = { m_pSRVColorSum.Get(), m_pSRVDispersionTiles.Get() };
+    ID3D11UnorderedAccessView* ppUAVResources[] = { m_pUAVToneMap.Get() };
+
+    m_Profiler.BeginScope("Tone Map");
+    m_PSOToneMapImage.Apply(m_pImmediateContext);
+    m_pImmediateContext->CSSetConstantBuffers(0, 1, m_pConstantBufferFrame.GetAddressOf());
+    m_pImmediateContext->CSSetShaderResources(0, _countof(ppSRVResources), ppSRVResources);
+    m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVResources), ppUAVResources, nullptr);
+    m_pImmediateContext->Dispatch(threadGroupsX, threadGroupsY, 1);
+    m_pImmediateContext->CSSetUnorderedAccessViews(0, _countof(ppUAVClear), ppUAVClear, nullptr);
+    m_pImmediateContext->CSSetShaderResources(0, _countof(ppSRVClear), ppSRVClear);
+    m_Profiler.EndScope();
+}
+
+void RendererD3D11::DrawTiles(DX::ComPtr<ID3D11RenderTargetView> pRTV, uint32_t width, uint32_t height) {
+
+    ID3D11ShaderResourceView* ppSRVClear[] = { nullptr };
+
+    m_pImmediateContext->VSSetConstantBuffers(0, 1, m_pConstantBufferFrame.GetAddressOf());
+    m_pImmediateContext->GSSetConstantBuffers(0, 1, m_pConstantBufferFrame.GetAddressOf());
+    m_pImmediateContext->PSSetConstantBuffers(0, 1, m_pConstantBufferFrame.GetAddressOf());
+
+    ID3D11ShaderResourceView* ppSRVResources[] = { m_pSRVDispersionTiles.Get() };
+    D3D11_VIEWPORT viewport = { 0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height), 0.0f, 1.0f };
+
+    m_Profiler.BeginScope("Debug Tiles");
+    m_pImmediateContext->OMSetRenderTargets(1, pRTV.GetAddressOf(), nullptr);
+    m_pImmediateContext->RSSetViewports(1, &viewport);
+
+    m_PSODegugTiles.Apply(m_pImmediateContext);
+    m_pImmediateContext->VSSetShaderResources(0, _countof(ppSRVResources), ppSRVResources);
+    m_pImmediateContext->DrawInstancedIndirect(m_pDrawInstancedIndirectBufferArgs.Get(), 0);
+
+    m_pImmediateContext->VSSetShaderResources(0, _countof(ppSRVClear), ppSRVClear);
+    m_PSODefault.Apply(m_pImmediateContext);
+    m_pImmediateContext->RSSetViewports(0, nullptr);
+    m_pImmediateContext->OMSetRenderTargets(0, nullptr, nullptr);
+    m_Profiler.EndScope();
+}
+
+uint32_t RendererD3D11::ReadActiveTileCount() {
+
+    // The counters of the selected tiles come back a few frames late, from the oldest copy to the newest, without stalling
+    for (uint32_t offset = 0; offset < FrameCount; offset++) {
+        const uint32_t index = (m_TileCounterIndex + offset) % FrameCount;
+        if (m_TileCounterFrames[index] == std::numeric_limits<uint32_t>::max())
+            continue;
+
+        D3D11_MAPPED_SUBRESOURCE resource = {};
+        if (m_pImmediateContext->Map(m_pTileCounterReadback[index].Get(), 0, D3D11_MAP_READ, D3D11_MAP_FLAG_DO_NOT_WAIT, &resource) == S_OK) {
+            // The dispersion frames render every tile once, the others the passes the histogram budgets
+            auto const* pData = static_cast<uint32_t const*>(resource.pData);
+            m_ActiveTileCount = pData[0];
+            m_ActiveTilePassCount = m_ActiveTileCount;
+            if (m_TileCounterFrames[index] >= m_SampleDispersion) {
+                m_ActiveTilePassCount = 0;
+                for (uint32_t passCount = 1; passCount <= Shading::TilePassCountMax; passCount++)
+                    m_ActiveTilePassCount += pData[passCount] * Shading::ApplyTilePassBudget(passCount, pData + 1, m_TileCounterTileCounts[index]);
+            }
+            m_pImmediateContext->Unmap(m_pTileCounterReadback[index].Get(), 0);
+            m_TileCounterFrames[index] = std::numeric_limits<uint32_t>::max();
+        }
+    }
+    return m_ActiveTileCount;
+}
+
+bool RendererD3D11::ReadFrameTime(F32& frameTime, Hawk::Math::Vec2u& renderDimension) {
+
+    // The queries are read in the order of the frames, the newer ones are not ready before the older one
+    for (uint32_t offset = 0; offset < FrameCount; offset++) {
+        const uint32_t index = (m_TimestampIndex + offset) % FrameCount;
+        if (m_TimestampDimensions[index].x == 0)
+            continue;
+
+        D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint = {};
+        uint64_t timestampBegin = 0;
+        uint64_t timestampEnd = 0;
+        if (m_pImmediateContext->GetData(m_pQueryDisjoint[index].Get(), &disjoint, sizeof(disjoint), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+            m_pImmediateContext->GetData(m_pQueryFrameBegin[index].Get(), &timestampBegin, sizeof(timestampBegin), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+            m_pImmediateContext->GetData(m_pQueryFrameEnd[index].Get(), &timestampEnd, sizeof(timestampEnd), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+            return false;
+
+        const auto dimension = m_TimestampDimensions[index];
+        m_TimestampDimensions[index] = Hawk::Math::Vec2u(0, 0);
+        if (!disjoint.Disjoint) {
+            frameTime = static_cast<F32>(F64(timestampEnd - timestampBegin) / F64(disjoint.Frequency));
+            renderDimension = dimension;
+            return true;
+        }
+    }
+    return false;
+}
+
+void RendererD3D11::ReadColorSum(std::vector<Hawk::Math::Vec4>& colorSum) {
+
+    DX::ComPtr<ID3D11Resource> pResource;
+    DX::ComPtr<ID3D11Texture2D> pTextureColorSum;
+    m_pSRVColorSum->GetResource(pResource.GetAddressOf());
+    DX::ThrowIfFailed(pResource.As(&pTextureColorSum));
+
+    D3D11_TEXTURE2D_DESC desc = {};
+    pTextureColorSum->GetDesc(&desc);
+    desc.BindFlags = 0;
+    desc.Usage = D3D11_USAGE_STAGING;
+    desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+
+    DX::ComPtr<ID3D11Texture2D> pTextureStaging;
+    DX::ThrowIfFailed(m_pDevice->CreateTexture2D(&desc, nullptr, pTextureStaging.GetAddressOf()));
+    m_pImmediateContext->CopyResource(pTextureStaging.Get(), pTextureColorSum.Get());
+
+    D3D11_MAPPED_SUBRESOURCE resource = {};
+    DX::ThrowIfFailed(m_pImmediateContext->Map(pTextureStaging.Get(), 0, D3D11_MAP_READ, 0, &resource));
+
+    colorSum.resize(size_t(desc.Width) * desc.Height);
+    for (uint32_t y = 0; y < desc.Height; y++) {
+        auto const pRow = reinterpret_cast<Hawk::Math::Vec4 const*>(static_cast<uint8_t const*>(resource.pData) + size_t(y) * resource.RowPitch);
+        std::copy_n(pRow, desc.Width, std::begin(colorSum) + size_t(y) * desc.Width);
+    }
+    m_pImmediateContext->Unmap(pTextureStaging.Get(), 0);
+}
@@ -0,0 +1,60 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ResolutionController.h"
+
+#include <algorithm>
+#include <cmath>
+
+void ResolutionController::Reset() {
+
+    m_LogScale = 0.0f;
+    m_Error = 0.0f;
+    m_Scale = 1.0f;
+}
+
+bool ResolutionController::Update(F32 frameTime, F32 frameScale) {
+
+    if (frameTime <= 0.0f)
+        return false;
+
+    // Velocity form, the clamp of the output keeps the integral from winding up
+    const F32 error = std::log2(frameScale) + 0.5f * std::log2(m_Desc.FrameTimeTarget / frameTime) - m_LogScale;
+    m_LogScale = std::clamp(m_LogScale + m_Desc.GainProportional * (error - m_Error) + m_Desc.GainIntegral * error, std::log2(ScaleMin), std::log2(ScaleMax));
+    m_Error = error;
+
+    const F32 scale = std::exp2(m_LogScale);
+    if (std::abs(scale - m_Scale) < ScaleStep)
+        return false;
+
+    m_Scale = std::clamp(std::round(scale / ScaleStep) * ScaleStep, ScaleMin, ScaleMax);
+    return true;
+}
+
+Hawk::Math::Vec2u ResolutionController::GetRenderDimension(uint32_t width, uint32_t height, F32 scale) {
+
+    return Hawk::Math::Vec2u(
+        std::max(static_cast<uint32_t>(std::round(width * scale)), 1u),
+        std::max(static_cast<uint32_t>(std::round(height * scale)), 1u));
+}
@@ -0,0 +1,91 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(uint32_t threadCount) {
+
+    for (uint32_t threadID = 1; threadID < std::max(threadCount, 1u); threadID++)
+        m_Workers.emplace_back(&ThreadPool::WorkerLoop, this, threadID);
+}
+
+ThreadPool::~ThreadPool() {
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_IsStopped = true;
+    }
+    m_ConditionStart.notify_all();
+
+    for (auto& worker : m_Workers)
+        worker.join();
+}
+
+void ThreadPool::ParallelFor(uint32_t count, Task const& task) {
+
+    if (count == 0)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_pTask = &task;
+        m_TaskCount = count;
+        m_TaskIndex.store(0, std::memory_order_relaxed);
+        m_ActiveWorkers = static_cast<uint32_t>(std::size(m_Workers));
+        m_Generation++;
+    }
+    m_ConditionStart.notify_all();
+
+    this->Execute(0);
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_ConditionFinish.wait(lock, [this] { return m_ActiveWorkers == 0; });
+    m_pTask = nullptr;
+}
+
+void ThreadPool::WorkerLoop(uint32_t threadID) {
+
+    uint32_t generation = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_ConditionStart.wait(lock, [&] { return m_IsStopped || m_Generation != generation; });
+            if (m_IsStopped)
+                return;
+            generation = m_Generation;
+        }
+
+        this->Execute(threadID);
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (--m_ActiveWorkers == 0)
+            m_ConditionFinish.notify_one();
+    }
+}
+
+void ThreadPool::Execute(uint32_t threadID) {
+
+    for (uint32_t index = m_TaskIndex.fetch_add(1, std::memory_order_relaxed); index < m_TaskCount; index = m_TaskIndex.fetch_add(1, std::memory_order_relaxed))
+        (*m_pTask)(index, threadID);
+}
@@ -0,0 +1,136 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "TileScheduler.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <numeric>
+
+void WorkStealingDeque::Reset(uint32_t capacity) {
+
+    const uint32_t size = std::bit_ceil(std::max(capacity, 1u));
+    if (std::size(m_Items) < size)
+        m_Items = std::vector<std::atomic<uint32_t>>(size);
+    m_Mask = static_cast<int64_t>(std::size(m_Items)) - 1;
+    m_Top.store(0, std::memory_order_relaxed);
+    m_Bottom.store(0, std::memory_order_relaxed);
+}
+
+void WorkStealingDeque::Push(uint32_t item) {
+
+    const int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+    assert(bottom - m_Top.load(std::memory_order_relaxed) <= m_Mask);
+    m_Items[bottom & m_Mask].store(item, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+}
+
+uint32_t WorkStealingDeque::Pop() {
+
+    const int64_t bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+    m_Bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = m_Top.load(std::memory_order_relaxed);
+
+    if (top > bottom) {
+        m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+        return Empty;
+    }
+
+    uint32_t item = m_Items[bottom & m_Mask].load(std::memory_order_relaxed);
+    if (top == bottom) {
+        // The last item, a thief may be taking it at the same time
+        if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            item = Empty;
+        m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return item;
+}
+
+uint32_t WorkStealingDeque::Steal() {
+
+    int64_t top = m_Top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t bottom = m_Bottom.load(std::memory_order_acquire);
+
+    if (top >= bottom)
+        return Empty;
+
+    const uint32_t item = m_Items[top & m_Mask].load(std::memory_order_relaxed);
+    if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        return Empty;
+    return item;
+}
+
+TileScheduler::TileScheduler(ThreadPool& threadPool)
+    : m_ThreadPool(threadPool) {
+
+    for (uint32_t index = 0; index < threadPool.GetThreadCount(); index++)
+        m_Deques.push_back(std::make_unique<WorkStealingDeque>());
+}
+
+uint64_t TileScheduler::Run(std::span<F32 const> costs, Task const& task) {
+
+    const auto count = static_cast<uint32_t>(std::size(costs));
+    const auto dequeCount = static_cast<uint32_t>(std::size(m_Deques));
+
+    m_Order.resize(count);
+    std::iota(m_Order.begin(), m_Order.end(), 0);
+    std::stable_sort(m_Order.begin(), m_Order.end(), [&](uint32_t lhs, uint32_t rhs) { return costs[lhs] > costs[rhs]; });
+
+    // Item i of the cost order goes to deque i % dequeCount, pushed from the cheapest so the most expensive is at the bottom
+    for (auto& pDeque : m_Deques)
+        pDeque->Reset((count + dequeCount - 1) / dequeCount);
+    for (uint32_t index = count; index-- > 0;)
+        m_Deques[index % dequeCount]->Push(m_Order[index]);
+
+    std::atomic<uint64_t> stealCount = 0;
+
+    // Each index is the owner of one deque, a thread that runs more than one of them runs them one after the other
+    m_ThreadPool.ParallelFor(dequeCount, [&](uint32_t owner, uint32_t threadID) {
+        auto& deque = *m_Deques[owner];
+        uint64_t steals = 0;
+        while (!this->IsCancelled()) {
+            uint32_t item = deque.Pop();
+            for (uint32_t offset = 1; item == WorkStealingDeque::Empty && offset < dequeCount; offset++) {
+                item = m_Deques[(owner + offset) % dequeCount]->Steal();
+                steals += item != WorkStealingDeque::Empty;
+            }
+
+            if (item == WorkStealingDeque::Empty) {
+                // A failed steal may have lost a race for an item that is still there
+                const bool isDone = std::all_of(m_Deques.begin(), m_Deques.end(), [](auto const& pDeque) { return pDeque->IsEmpty(); });
+                if (isDone)
+                    break;
+                continue;
+            }
+            task(item, threadID);
+        }
+        stealCount.fetch_add(steals, std::memory_order_relaxed);
+    });
+
+    return stealCount.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,67 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "TransferFunction.h"
+#include <nlohmann/json.hpp>
+#include <fstream>
+
+void TransferFunctionSet::LoadFromFile(std::string const& fileName) {
+
+    std::ifstream file(fileName);
+    if (!file.is_open())
+        throw std::runtime_error("Failed to open file: " + fileName);
+
+    nlohmann::json root;
+    file >> root;
+
+    Opacity.Clear();
+    Diffuse.Clear();
+    Specular.Clear();
+    Emission.Clear();
+    Roughness.Clear();
+
+    auto ExtractVec3FromJson = [](auto const& tree, auto const& key) -> Hawk::Math::Vec3 {
+        Hawk::Math::Vec3 v{};
+        uint32_t index = 0;
+        for (auto& e : tree[key]) {
+            v[index] = e.template get<float>();
+            index++;
+        }
+        return v;
+    };
+
+    for (auto const& e : root["NodesColor"]) {
+        const auto intensity = e["Intensity"].get<float>();
+        const auto diffuse = ExtractVec3FromJson(e, "Diffuse");
+        const auto specular = ExtractVec3FromJson(e, "Specular");
+        const auto roughness = e["Roughness"].get<float>();
+
+        Diffuse.AddNode(intensity, diffuse);
+        Specular.AddNode(intensity, specular);
+        Roughness.AddNode(intensity, roughness);
+    }
+
+    for (auto const& e : root["NodesOpacity"])
+        Opacity.AddNode(e["Intensity"].get<F32>(), e["Opacity"].get<F32>());
+}
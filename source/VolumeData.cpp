@@ -0,0 +1,151 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "VolumeData.h"
+
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+
+void VolumeData::LoadFromFile(std::string const& fileName) {
+
+    std::ifstream file(fileName, std::ios::binary);
+    if (!file.is_open())
+        throw std::runtime_error("Failed to open file: " + fileName);
+
+    uint16_t dimension[3] = {};
+    file.read(reinterpret_cast<char*>(dimension), sizeof(dimension));
+
+    std::vector<uint16_t> intensity(size_t(dimension[0]) * size_t(dimension[1]) * size_t(dimension[2]));
+    file.read(reinterpret_cast<char*>(std::data(intensity)), sizeof(uint16_t) * std::size(intensity));
+    if (!file)
+        throw std::runtime_error("Failed to read file: " + fileName);
+
+    auto NormalizeIntensity = [](uint16_t intensity, uint16_t min, uint16_t max) -> uint16_t {
+        const auto value = std::round(std::numeric_limits<uint16_t>::max() * ((intensity - min) / static_cast<F32>(max - min)));
+        return static_cast<uint16_t>(std::clamp(value, 0.0f, 65535.0f));
+    };
+
+    uint16_t tmin = 0 << 12; // Min HU [0, 4096]
+    uint16_t tmax = 1 << 12; // Max HU [0, 4096]
+    for (size_t index = 0u; index < std::size(intensity); index++)
+        intensity[index] = NormalizeIntensity(intensity[index], tmin, tmax);
+
+    this->Initialize(dimension[0], dimension[1], dimension[2], std::move(intensity));
+}
+
+void VolumeData::Initialize(uint32_t dimensionX, uint32_t dimensionY, uint32_t dimensionZ, std::vector<uint16_t>&& intensity) {
+
+    assert(std::size(intensity) == size_t(dimensionX) * size_t(dimensionY) * size_t(dimensionZ));
+
+    m_MipLevels.clear();
+    m_MipLevels.push_back(MipLevel{ Hawk::Math::Vec3u(dimensionX, dimensionY, dimensionZ), std::move(intensity) });
+    m_MipLevels.back().Intensity.push_back(0);
+    this->GenerateMipLevels();
+}
+
+void VolumeData::GenerateMipLevels() {
+
+    m_MipLevels.resize(1);
+
+    const auto dimension = m_MipLevels[0].Dimension;
+    const auto mipLevels = static_cast<uint32_t>(std::ceil(std::log2(std::max(std::max(dimension.x, dimension.y), dimension.z)))) + 1;
+
+    // Same as ComputeLevelOfDetail.hlsl: linear sample of the previous level at the texel center
+    for (uint32_t mipLevelID = 1; mipLevelID < mipLevels; mipLevelID++) {
+        MipLevel level;
+        level.Dimension.x = std::max(dimension.x >> mipLevelID, 1u);
+        level.Dimension.y = std::max(dimension.y >> mipLevelID, 1u);
+        level.Dimension.z = std::max(dimension.z >> mipLevelID, 1u);
+        level.Intensity.resize(size_t(level.Dimension.x) * level.Dimension.y * level.Dimension.z + 1);
+
+        const auto invDimension = Hawk::Math::Vec3(1.0f / level.Dimension.x, 1.0f / level.Dimension.y, 1.0f / level.Dimension.z);
+        for (uint32_t z = 0; z < level.Dimension.z; z++) {
+            for (uint32_t y = 0; y < level.Dimension.y; y++) {
+                for (uint32_t x = 0; x < level.Dimension.x; x++) {
+                    const auto texcoord = (Hawk::Math::Vec3(F32(x), F32(y), F32(z)) + Hawk::Math::Vec3(0.5f, 0.5f, 0.5f)) * invDimension;
+                    const auto intensity = this->SampleIntensity(texcoord, mipLevelID - 1);
+                    level.Intensity[(size_t(z) * level.Dimension.y + y) * level.Dimension.x + x] = static_cast<uint16_t>(std::round(65535.0f * intensity));
+                }
+            }
+        }
+        m_MipLevels.push_back(std::move(level));
+    }
+}
+
+F32 VolumeData::SampleIntensity(Hawk::Math::Vec3 const& texcoord, uint32_t mipLevel) const {
+
+    return SampleLinear<F32>(m_MipLevels[mipLevel].Dimension, texcoord, [&](int32_t x, int32_t y, int32_t z) {
+        return this->LoadIntensity(x, y, z, mipLevel);
+    });
+}
+
+Hawk::Math::Vec3 VolumeData::SampleGradient(Hawk::Math::Vec3 const& texcoord) const {
+
+    return SampleLinear<Hawk::Math::Vec3>(m_MipLevels[0].Dimension, texcoord, [&](int32_t x, int32_t y, int32_t z) {
+        return this->ComputeGradient(x, y, z);
+    });
+}
+
+Hawk::Math::Vec3 VolumeData::ComputeGradient(int32_t x, int32_t y, int32_t z) const {
+
+    // Kernels are copied from ComputeGradient.hlsl as is, including the last Gz slice
+    constexpr int32_t Gx[3][3][3] = {
+        { { -1, -2, -1 }, { -2, -4, -2 }, { -1, -2, -1 } },
+        { { +0, +0, +0 }, { +0, +0, +0 }, { +0, +0, +0 } },
+        { { +1, +2, +1 }, { +2, +4, +2 }, { +1, +2, +1 } }
+    };
+
+    constexpr int32_t Gy[3][3][3] = {
+        { { -1, -2, -1 }, { +0, +0, +0 }, { +1, +2, +1 } },
+        { { -2, -4, -2 }, { +0, +0, +0 }, { +2, +4, +2 } },
+        { { -1, -2, -1 }, { +0, +0, +0 }, { +1, +2, +1 } }
+    };
+
+    constexpr int32_t Gz[3][3][3] = {
+        { { -1, +0, +1 }, { -2, +0, +2 }, { -1, 0, +1 } },
+        { { -2, +0, +2 }, { -4, +0, +4 }, { -2, 0, +2 } },
+        { { -1, +0, +1 }, { -1, +0, +1 }, { -1, 0, +1 } }
+    };
+
+    const auto dimension = m_MipLevels[0].Dimension;
+
+    F32 dx = 0.0f;
+    F32 dy = 0.0f;
+    F32 dz = 0.0f;
+    for (int32_t offsetX = -1; offsetX <= 1; offsetX++) {
+        for (int32_t offsetY = -1; offsetY <= 1; offsetY++) {
+            for (int32_t offsetZ = -1; offsetZ <= 1; offsetZ++) {
+                const auto intensity = this->LoadIntensity(
+                    std::clamp(x + offsetX, 0, int32_t(dimension.x) - 1),
+                    std::clamp(y + offsetY, 0, int32_t(dimension.y) - 1),
+                    std::clamp(z + offsetZ, 0, int32_t(dimension.z) - 1));
+                dx += Gx[offsetX + 1][offsetY + 1][offsetZ + 1] * intensity;
+                dy += Gy[offsetX + 1][offsetY + 1][offsetZ + 1] * intensity;
+                dz += Gz[offsetX + 1][offsetY + 1][offsetZ + 1] * intensity;
+            }
+        }
+    }
+    return Hawk::Math::Vec3(dx, dy, dz) / 16.0f;
+}
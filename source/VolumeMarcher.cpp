@@ -0,0 +1,476 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "VolumeMarcher.h"
+#include "RenderCommon.h"
+#include "SIMD.h"
+
+#include <bit>
+
+namespace {
+    using namespace SIMD;
+
+    // Packet state, lanes with a negative ray index are free
+    struct alignas(32) PacketLanes {
+        F32     OriginX[LaneCount];
+        F32     OriginY[LaneCount];
+        F32     OriginZ[LaneCount];
+        F32     DirectionX[LaneCount];
+        F32     DirectionY[LaneCount];
+        F32     DirectionZ[LaneCount];
+        F32     T[LaneCount];
+        F32     MaxT[LaneCount];
+        F32     Sum[LaneCount];
+        F32     Threshold[LaneCount];
+        int32_t RayIndex[LaneCount];
+    };
+}
+
+VolumeMarcher::VolumeMarcher(Desc const& desc)
+    : m_Desc(desc) {
+
+    assert(desc.pVolume != nullptr && desc.pOpacityTable != nullptr);
+}
+
+const char* VolumeMarcher::GetInstructionSet() {
+#if defined(__AVX2__)
+    return "AVX2";
+#else
+    return "SSE2";
+#endif
+}
+
+F32 VolumeMarcher::SampleOpacity(Hawk::Math::Vec3 const& position) const {
+
+    const auto texcoord = Shading::GetNormalizedTexcoord(position, { VolumeBoundingBoxMin, VolumeBoundingBoxMax });
+    const F32 intensity = m_Desc.pVolume->SampleIntensity(texcoord, m_Desc.MipLevel);
+
+    const auto count = static_cast<int32_t>(m_Desc.OpacityTableSize);
+    const auto x = intensity * count - 0.5f;
+    const auto x0 = static_cast<int32_t>(std::floor(x));
+    const auto t = x - x0;
+
+    const F32 v0 = (x0 >= 0 && x0 < count) ? m_Desc.pOpacityTable[x0] : 0.0f;
+    const F32 v1 = (x0 + 1 >= 0 && x0 + 1 < count) ? m_Desc.pOpacityTable[x0 + 1] : 0.0f;
+    return v0 + t * (v1 - v0);
+}
+
+void VolumeMarcher::MarchScalar(RayStream& stream, size_t first, size_t count) const {
+
+    for (size_t index = first; index < first + count; index++) {
+        const Hawk::Math::Vec3 origin = Hawk::Math::Vec3(stream.OriginX[index], stream.OriginY[index], stream.OriginZ[index]);
+        const Hawk::Math::Vec3 direction = Hawk::Math::Vec3(stream.DirectionX[index], stream.DirectionY[index], stream.DirectionZ[index]);
+
+        const Shading::Ray ray = { origin, direction, 0.0f, 0.0f };
+        const Shading::Intersection intersect = Shading::ClipRay(ray, Shading::IntersectAABB(ray, { m_Desc.BoundingBoxMin, m_Desc.BoundingBoxMax }), m_Desc.ClipRegion);
+        stream.IsScattered[index] = false;
+
+        if (intersect.Max < intersect.Min)
+            continue;
+
+        const F32 minT = std::max(intersect.Min, stream.Min[index]);
+        const F32 maxT = std::min(intersect.Max, stream.Max[index]);
+        const F32 threshold = stream.Threshold[index];
+
+        F32 sum = 0.0f;
+        F32 t = minT + stream.Jitter[index] * m_Desc.StepSize;
+        Hawk::Math::Vec3 position = Hawk::Math::Vec3(0.0f, 0.0f, 0.0f);
+        bool isScattered = true;
+
+        while (sum < threshold) {
+            position = origin + t * direction;
+            if (t >= maxT) {
+                isScattered = false;
+                break;
+            }
+            sum += m_Desc.Density * this->SampleOpacity(position) * m_Desc.StepSize;
+            t += m_Desc.StepSize;
+        }
+
+        stream.IsScattered[index] = isScattered;
+        stream.PositionX[index] = position.x;
+        stream.PositionY[index] = position.y;
+        stream.PositionZ[index] = position.z;
+    }
+}
+
+void VolumeMarcher::TrackDelta(RayStream& stream, size_t first, size_t count) const {
+
+    assert(m_Desc.pMajorantGrid != nullptr);
+
+    const auto dimension = m_Desc.pMajorantGrid->GetDimension();
+    const auto scale = Hawk::Math::Vec3(F32(dimension.x), F32(dimension.y), F32(dimension.z)) / (VolumeBoundingBoxMax - VolumeBoundingBoxMin);
+
+    for (size_t index = first; index < first + count; index++) {
+        const Hawk::Math::Vec3 origin = Hawk::Math::Vec3(stream.OriginX[index], stream.OriginY[index], stream.OriginZ[index]);
+        const Hawk::Math::Vec3 direction = Hawk::Math::Vec3(stream.DirectionX[index], stream.DirectionY[index], stream.DirectionZ[index]);
+
+        const Shading::Ray ray = { origin, direction, 0.0f, 0.0f };
+        const Shading::Intersection intersect = Shading::ClipRay(ray, Shading::IntersectAABB(ray, { m_Desc.BoundingBoxMin, m_Desc.BoundingBoxMax }), m_Desc.ClipRegion);
+        stream.IsScattered[index] = false;
+
+        if (intersect.Max < intersect.Min)
+            continue;
+
+        const F32 minT = std::max(intersect.Min, stream.Min[index]);
+        const F32 maxT = std::min(intersect.Max, stream.Max[index]);
+
+        Shading::CRNG rng = { stream.Seed[index] };
+        Shading::GridTraversal grid = Shading::InitGridTraversal((origin - VolumeBoundingBoxMin) * scale, direction * scale, minT, dimension);
+
+        F32 t = minT;
+        while (t < maxT) {
+            const F32 exitT = std::min(Shading::GetGridTraversalExit(grid), maxT);
+            const F32 majorant = m_Desc.Density * m_Desc.pMajorantGrid->GetMajorant(grid.Cell.x, grid.Cell.y, grid.Cell.z);
+
+            // Free-flight distances are memoryless, a sample past the cell restarts at its exit
+            if (majorant > 0.0f) {
+                const F32 sampleT = t - std::log(1.0f - Shading::Rand(rng)) / majorant;
+                if (sampleT < exitT) {
+                    t = sampleT;
+                    const Hawk::Math::Vec3 position = origin + t * direction;
+                    if (Shading::Rand(rng) * majorant < m_Desc.Density * this->SampleOpacity(position)) {
+                        stream.IsScattered[index] = true;
+                        stream.PositionX[index] = position.x;
+                        stream.PositionY[index] = position.y;
+                        stream.PositionZ[index] = position.z;
+                        break;
+                    }
+                    continue;
+                }
+            }
+
+            t = exitT;
+            if (!Shading::AdvanceGridTraversal(grid, dimension))
+                break;
+        }
+        stream.Seed[index] = rng.Seed;
+    }
+}
+
+void VolumeMarcher::TrackRatio(RayStream& stream, size_t first, size_t count, bool isResidual) const {
+
+    assert(m_Desc.pMajorantGrid != nullptr);
+
+    constexpr F32 RouletteThreshold = 0.1f;
+
+    const auto dimension = m_Desc.pMajorantGrid->GetDimension();
+    const auto scale = Hawk::Math::Vec3(F32(dimension.x), F32(dimension.y), F32(dimension.z)) / (VolumeBoundingBoxMax - VolumeBoundingBoxMin);
+
+    for (size_t index = first; index < first + count; index++) {
+        const Hawk::Math::Vec3 origin = Hawk::Math::Vec3(stream.OriginX[index], stream.OriginY[index], stream.OriginZ[index]);
+        const Hawk::Math::Vec3 direction = Hawk::Math::Vec3(stream.DirectionX[index], stream.DirectionY[index], stream.DirectionZ[index]);
+
+        const Shading::Ray ray = { origin, direction, 0.0f, 0.0f };
+        const Shading::Intersection intersect = Shading::ClipRay(ray, Shading::IntersectAABB(ray, { m_Desc.BoundingBoxMin, m_Desc.BoundingBoxMax }), m_Desc.ClipRegion);
+        stream.Transmittance[index] = 1.0f;
+
+        if (intersect.Max < intersect.Min)
+            continue;
+
+        const F32 minT = std::max(intersect.Min, stream.Min[index]);
+        const F32 maxT = std::min(intersect.Max, stream.Max[index]);
+
+        Shading::CRNG rng = { stream.Seed[index] };
+        Shading::GridTraversal grid = Shading::InitGridTraversal((origin - VolumeBoundingBoxMin) * scale, direction * scale, minT, dimension);
+
+        F32 transmittance = 1.0f;
+        F32 t = minT;
+        while (t < maxT) {
+            const F32 exitT = std::min(Shading::GetGridTraversalExit(grid), maxT);
+            MajorantGrid::Control cell = { 0.0f, m_Desc.pMajorantGrid->GetMajorant(grid.Cell.x, grid.Cell.y, grid.Cell.z) };
+            if (isResidual)
+                cell = m_Desc.pMajorantGrid->GetControl(grid.Cell.x, grid.Cell.y, grid.Cell.z);
+            const F32 control = m_Desc.Density * cell.Mean;
+            const F32 residual = m_Desc.Density * cell.Residual;
+
+            // The control part of the optical depth is integrated analytically, only the residual is tracked. The weights
+            // are in [0, 2] around a mean control, the density below it makes the transmittance grow.
+            transmittance *= std::exp(-control * (exitT - t));
+
+            if (residual > 0.0f) {
+                while (transmittance > 0.0f) {
+                    t -= std::log(1.0f - Shading::Rand(rng)) / residual;
+                    if (t >= exitT)
+                        break;
+                    transmittance *= 1.0f - (m_Desc.Density * this->SampleOpacity(origin + t * direction) - control) / residual;
+
+                    if (transmittance < RouletteThreshold)
+                        transmittance = Shading::Rand(rng) * RouletteThreshold < transmittance ? RouletteThreshold : 0.0f;
+                }
+            }
+
+            if (transmittance == 0.0f)
+                break;
+
+            t = exitT;
+            if (!Shading::AdvanceGridTraversal(grid, dimension))
+                break;
+        }
+        stream.Transmittance[index] = transmittance;
+        stream.Seed[index] = rng.Seed;
+    }
+}
+
+void VolumeMarcher::MarchPacket(RayStream& stream, size_t first, size_t count) const {
+
+    auto const& volume = m_Desc.pVolume->GetIntensity(m_Desc.MipLevel);
+    const auto dimension = m_Desc.pVolume->GetDimension(m_Desc.MipLevel);
+
+    const VFloat boundingBoxMinX = SetF(m_Desc.BoundingBoxMin.x);
+    const VFloat boundingBoxMinY = SetF(m_Desc.BoundingBoxMin.y);
+    const VFloat boundingBoxMinZ = SetF(m_Desc.BoundingBoxMin.z);
+    const VFloat boundingBoxMaxX = SetF(m_Desc.BoundingBoxMax.x);
+    const VFloat boundingBoxMaxY = SetF(m_Desc.BoundingBoxMax.y);
+    const VFloat boundingBoxMaxZ = SetF(m_Desc.BoundingBoxMax.z);
+    const VFloat volumeMinX = SetF(VolumeBoundingBoxMin.x);
+    const VFloat volumeMinY = SetF(VolumeBoundingBoxMin.y);
+    const VFloat volumeMinZ = SetF(VolumeBoundingBoxMin.z);
+    const VFloat extentX = SetF(VolumeBoundingBoxMax.x - VolumeBoundingBoxMin.x);
+    const VFloat extentY = SetF(VolumeBoundingBoxMax.y - VolumeBoundingBoxMin.y);
+    const VFloat extentZ = SetF(VolumeBoundingBoxMax.z - VolumeBoundingBoxMin.z);
+
+    const VFloat dimensionXF = SetF(static_cast<F32>(dimension.x));
+    const VFloat dimensionYF = SetF(static_cast<F32>(dimension.y));
+    const VFloat dimensionZF = SetF(static_cast<F32>(dimension.z));
+    const VInt   dimensionX = SetI(static_cast<int32_t>(dimension.x));
+    const VInt   dimensionY = SetI(static_cast<int32_t>(dimension.y));
+    const VInt   dimensionZ = SetI(static_cast<int32_t>(dimension.z));
+    const VInt   tableSize = SetI(static_cast<int32_t>(m_Desc.OpacityTableSize));
+    const VFloat tableSizeF = SetF(static_cast<F32>(m_Desc.OpacityTableSize));
+
+    const VFloat step = SetF(m_Desc.StepSize);
+    const VFloat density = SetF(m_Desc.Density);
+    const VFloat half = SetF(0.5f);
+    const VInt   one = SetI(1);
+    const VInt   lowMask = SetI(0xFFFF);
+
+    // Trilinear fetch: every 32-bit gather returns the texels at x0 and x0 + 1 of one row
+    auto SampleIntensity = [&](VFloat u, VFloat v, VFloat w) -> VFloat {
+        const VFloat x = u * dimensionXF - half;
+        const VFloat y = v * dimensionYF - half;
+        const VFloat z = w * dimensionZF - half;
+
+        const VFloat x0F = Floor(x);
+        const VFloat y0F = Floor(y);
+        const VFloat z0F = Floor(z);
+        const VFloat fx = x - x0F;
+        const VFloat fy = y - y0F;
+        const VFloat fz = z - z0F;
+
+        const VInt x0 = ToInt(x0F);
+        const VInt y0 = ToInt(y0F);
+        const VInt z0 = ToInt(z0F);
+
+        const VInt isLeftBorder = Greater(SetI(0), x0);
+        const VInt isRightValid = InRange(x0 + one, dimensionX);
+        const VInt isRowValid = InRange(x0 + one, dimensionX + one);
+        const VInt xFetch = Select(isLeftBorder, SetI(0), x0);
+
+        auto LoadRow = [&](VInt y, VInt z) -> VFloat {
+            const VInt mask = isRowValid & InRange(y, dimensionY) & InRange(z, dimensionZ);
+            const VInt pair = GatherPair(std::data(volume), (z * dimensionY + y) * dimensionX + xFetch, mask);
+            const VInt left = Select(isLeftBorder, SetI(0), pair & lowMask);
+            const VInt right = Select(isLeftBorder, pair & lowMask, ShiftRight16(pair) & isRightValid);
+            const VFloat scale = SetF(1.0f / 65535.0f);
+            return Lerp(ToFloat(left) * scale, ToFloat(right) * scale, fx);
+        };
+
+        const VFloat c00 = LoadRow(y0, z0);
+        const VFloat c10 = LoadRow(y0 + one, z0);
+        const VFloat c01 = LoadRow(y0, z0 + one);
+        const VFloat c11 = LoadRow(y0 + one, z0 + one);
+        return Lerp(Lerp(c00, c10, fy), Lerp(c01, c11, fy), fz);
+    };
+
+    auto SampleOpacity = [&](VFloat intensity) -> VFloat {
+        const VFloat x = intensity * tableSizeF - half;
+        const VFloat x0F = Floor(x);
+        const VInt x0 = ToInt(x0F);
+
+        const VFloat v0 = Gather(m_Desc.pOpacityTable, x0, InRange(x0, tableSize));
+        const VFloat v1 = Gather(m_Desc.pOpacityTable, x0 + one, InRange(x0 + one, tableSize));
+        return Lerp(v0, v1, x - x0F);
+    };
+
+    PacketLanes lanes;
+    std::fill(std::begin(lanes.RayIndex), std::end(lanes.RayIndex), -1);
+
+    // Rays that passed the slab test, waiting for a free lane
+    alignas(32) F32 pendingT[LaneCount];
+    alignas(32) F32 pendingMaxT[LaneCount];
+    int32_t pendingRays[LaneCount];
+    uint32_t pendingCount = 0;
+    uint32_t pendingNext = 0;
+
+    size_t nextRay = first;
+    const size_t lastRay = first + count;
+
+    // Slab test and start point of the next 8 rays, resolves the rays that never enter the march loop
+    auto SetupRays = [&]() {
+        const uint32_t rayCount = static_cast<uint32_t>(std::min<size_t>(LaneCount, lastRay - nextRay));
+
+        auto Load = [&](std::vector<F32> const& values, F32 padding) -> VFloat {
+            alignas(32) F32 block[LaneCount];
+            for (uint32_t lane = 0; lane < LaneCount; lane++)
+                block[lane] = lane < rayCount ? values[nextRay + lane] : padding;
+            return LoadF(block);
+        };
+
+        const VFloat originX = Load(stream.OriginX, 0.0f);
+        const VFloat originY = Load(stream.OriginY, 0.0f);
+        const VFloat originZ = Load(stream.OriginZ, 0.0f);
+        const VFloat invDirectionX = SetF(1.0f) / Load(stream.DirectionX, 1.0f);
+        const VFloat invDirectionY = SetF(1.0f) / Load(stream.DirectionY, 1.0f);
+        const VFloat invDirectionZ = SetF(1.0f) / Load(stream.DirectionZ, 1.0f);
+
+        const VFloat botX = invDirectionX * (boundingBoxMinX - originX);
+        const VFloat botY = invDirectionY * (boundingBoxMinY - originY);
+        const VFloat botZ = invDirectionZ * (boundingBoxMinZ - originZ);
+        const VFloat topX = invDirectionX * (boundingBoxMaxX - originX);
+        const VFloat topY = invDirectionY * (boundingBoxMaxY - originY);
+        const VFloat topZ = invDirectionZ * (boundingBoxMaxZ - originZ);
+
+        const VFloat largestMin = Max(Max(Min(topX, botX), Min(topY, botY)), Min(topZ, botZ));
+        const VFloat largestMax = Min(Min(Max(topX, botX), Max(topY, botY)), Max(topZ, botZ));
+
+        alignas(32) F32 boxMinT[LaneCount];
+        alignas(32) F32 boxMaxT[LaneCount];
+        StoreF(boxMinT, largestMin);
+        StoreF(boxMaxT, largestMax);
+
+        const uint32_t isScattered = MoveMask(NotLess(SetF(0.0f), Load(stream.Threshold, 0.0f)));
+
+        pendingCount = 0;
+        pendingNext = 0;
+        for (uint32_t lane = 0; lane < rayCount; lane++) {
+            const size_t index = nextRay + lane;
+
+            // Clipping is once per ray, the lanes take it in scalar code
+            const Shading::Ray ray = { Hawk::Math::Vec3(stream.OriginX[index], stream.OriginY[index], stream.OriginZ[index]), Hawk::Math::Vec3(stream.DirectionX[index], stream.DirectionY[index], stream.DirectionZ[index]), 0.0f, 0.0f };
+            const Shading::Intersection intersect = Shading::ClipRay(ray, { boxMinT[lane], boxMaxT[lane] }, m_Desc.ClipRegion);
+            pendingT[lane] = std::max(intersect.Min, stream.Min[index]) + stream.Jitter[index] * m_Desc.StepSize;
+            pendingMaxT[lane] = std::min(intersect.Max, stream.Max[index]);
+
+            if (intersect.Max < intersect.Min) {
+                stream.IsScattered[index] = false;
+            } else if (isScattered & (1u << lane)) {
+                stream.IsScattered[index] = true;
+                stream.PositionX[index] = 0.0f;
+                stream.PositionY[index] = 0.0f;
+                stream.PositionZ[index] = 0.0f;
+            } else {
+                pendingT[pendingCount] = pendingT[lane];
+                pendingMaxT[pendingCount] = pendingMaxT[lane];
+                pendingRays[pendingCount++] = static_cast<int32_t>(index);
+            }
+        }
+        nextRay += rayCount;
+    };
+
+    for (;;) {
+        uint32_t activeCount = 0;
+        for (uint32_t lane = 0; lane < LaneCount; lane++) {
+            if (lanes.RayIndex[lane] < 0) {
+                while (pendingNext == pendingCount && nextRay < lastRay)
+                    SetupRays();
+                if (pendingNext == pendingCount)
+                    continue;
+
+                const uint32_t slot = pendingNext++;
+                const int32_t index = pendingRays[slot];
+                lanes.OriginX[lane] = stream.OriginX[index];
+                lanes.OriginY[lane] = stream.OriginY[index];
+                lanes.OriginZ[lane] = stream.OriginZ[index];
+                lanes.DirectionX[lane] = stream.DirectionX[index];
+                lanes.DirectionY[lane] = stream.DirectionY[index];
+                lanes.DirectionZ[lane] = stream.DirectionZ[index];
+                lanes.T[lane] = pendingT[slot];
+                lanes.MaxT[lane] = pendingMaxT[slot];
+                lanes.Sum[lane] = 0.0f;
+                lanes.Threshold[lane] = stream.Threshold[index];
+                lanes.RayIndex[lane] = index;
+            }
+            activeCount++;
+        }
+
+        if (activeCount == 0)
+            break;
+
+        // Keep marching until the packet runs too empty, or to the end once the stream is drained
+        const bool isDrained = pendingNext == pendingCount && nextRay == lastRay;
+        const uint32_t minActiveCount = isDrained ? 1 : RefillThreshold;
+
+        const VFloat originX = LoadF(lanes.OriginX);
+        const VFloat originY = LoadF(lanes.OriginY);
+        const VFloat originZ = LoadF(lanes.OriginZ);
+        const VFloat directionX = LoadF(lanes.DirectionX);
+        const VFloat directionY = LoadF(lanes.DirectionY);
+        const VFloat directionZ = LoadF(lanes.DirectionZ);
+        const VFloat maxT = LoadF(lanes.MaxT);
+        const VFloat threshold = LoadF(lanes.Threshold);
+        VFloat t = LoadF(lanes.T);
+        VFloat sum = LoadF(lanes.Sum);
+        VFloat active = AsFloat(Greater(LoadI(lanes.RayIndex), SetI(-1)));
+
+        do {
+            const VFloat positionX = originX + t * directionX;
+            const VFloat positionY = originY + t * directionY;
+            const VFloat positionZ = originZ + t * directionZ;
+
+            const VFloat isMissed = And(active, GreaterEqual(t, maxT));
+            const VFloat isMarching = AndNot(isMissed, active);
+
+            const VFloat intensity = SampleIntensity((positionX - volumeMinX) / extentX, (positionY - volumeMinY) / extentY, (positionZ - volumeMinZ) / extentZ);
+            sum = Select(isMarching, sum + density * SampleOpacity(intensity) * step, sum);
+            t = Select(isMarching, t + step, t);
+
+            const VFloat isScattered = And(isMarching, NotLess(sum, threshold));
+            const uint32_t terminated = MoveMask(Or(isMissed, isScattered));
+            if (terminated) {
+                alignas(32) F32 positions[3][LaneCount];
+                StoreF(positions[0], positionX);
+                StoreF(positions[1], positionY);
+                StoreF(positions[2], positionZ);
+
+                const uint32_t scattered = MoveMask(isScattered);
+                for (uint32_t lane = 0; lane < LaneCount; lane++) {
+                    if (!(terminated & (1u << lane)))
+                        continue;
+                    const int32_t index = lanes.RayIndex[lane];
+                    stream.IsScattered[index] = (scattered >> lane) & 1u;
+                    stream.PositionX[index] = positions[0][lane];
+                    stream.PositionY[index] = positions[1][lane];
+                    stream.PositionZ[index] = positions[2][lane];
+                    lanes.RayIndex[lane] = -1;
+                }
+                active = AndNot(Or(isMissed, isScattered), active);
+                activeCount -= std::popcount(terminated);
+            }
+        } while (activeCount >= minActiveCount);
+
+        StoreF(lanes.T, t);
+        StoreF(lanes.Sum, sum);
+    }
+}
@@ -0,0 +1,248 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2021-2023 Mikhail Gorobets
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "BlueNoise.h"
+#include "EnvironmentMap.h"
+#include "MajorantGrid.h"
+#include "RendererCPU.h"
+#include "ThreadPool.h"
+#include "TransferFunction.h"
+#include "VolumeData.h"
+
+#include <Hawk/Components/Camera.hpp>
+#include <fmt/format.h>
+
+#include <iostream>
+
+namespace {
+    constexpr uint32_t Width = 4 * RendererCPU::TileSize;
+    constexpr uint32_t Height = 3 * RendererCPU::TileSize;
+    constexpr uint32_t FrameCount = 96;
+    constexpr uint32_t VolumeSize = 32;
+    constexpr F32      TileErrorThreshold = 0.15f;
+
+    uint32_t FailureCount = 0;
+
+    void Check(bool condition, std::string const& message) {
+
+        if (!condition) {
+            fmt::print("FAILED: {}\n", message);
+            FailureCount++;
+        }
+    }
+
+    void TestTilePassCount() {
+
+        Check(Shading::GetTilePassCount(0.10f, 0.15f) == 0, "tiles at or below the threshold get no pass");
+        Check(Shading::GetTilePassCount(0.15f, 0.15f) == 0, "tiles at the threshold get no pass");
+        Check(Shading::GetTilePassCount(0.20f, 0.15f) == 1, "tiles above the threshold get one pass");
+        Check(Shading::GetTilePassCount(0.31f, 0.15f) == 2, "tiles above twice the threshold get two passes");
+        Check(Shading::GetTilePassCount(0.61f, 0.15f) == 3, "tiles above four times the threshold get three passes");
+        Check(Shading::GetTilePassCount(1.0e6f, 0.15f) == Shading::TilePassCountMax, "pass counts are capped");
+        Check(Shading::GetTilePassCount(1.0e6f, 0.0f) == 1, "a zero threshold renders every tile once");
+        Check(Shading::GetTilePassCount(0.0f, 0.0f) == 0, "tiles without error get no pass");
+
+        uint32_t previous = 0;
+        for (F32 error = 0.0f; error < 4.0f; error += 0.01f) {
+            const uint32_t passCount = Shading::GetTilePassCount(error, 0.15f);
+            Check(passCount >= previous, fmt::format("pass count decreases at error {}", error));
+            previous = passCount;
+        }
+    }
+
+    void TestTilePassBudget() {
+
+        // Histograms of every shape over a small tile count
+        constexpr uint32_t TileCount = 12;
+        uint32_t histogram[Shading::TilePassCountMax] = {};
+        for (histogram[0] = 0; histogram[0] <= TileCount; histogram[0]++) {
+            for (histogram[1] = 0; histogram[0] + histogram[1] <= TileCount; histogram[1]++) {
+                for (histogram[2] = 0; histogram[0] + histogram[1] + histogram[2] <= TileCount; histogram[2]++) {
+                    for (histogram[3] = 0; histogram[0] + histogram[1] + histogram[2] + histogram[3] <= TileCount; histogram[3]++) {
+                        const auto context = fmt::format("histogram {} {} {} {}", histogram[0], histogram[1], histogram[2], histogram[3]);
+
+                        uint32_t passSum = 0;
+                        uint32_t previous = 1;
+                        for (uint32_t passCount = 1; passCount <= Shading::TilePassCountMax; passCount++) {
+                            const uint32_t budgeted = Shading::ApplyTilePassBudget(passCount, histogram, TileCount);
+                            Check(budgeted >= 1 && budgeted <= passCount, "budgeted passes out of range for " + context);
+                            Check(budgeted >= previous, "tiles with more error get fewer passes for " + context);
+                            passSum += budgeted * histogram[passCount - 1];
+                            previous = budgeted;
+                        }
+                        Check(passSum <= TileCount, "frame costs more than one pass per tile for " + context);
+                        Check(Shading::ApplyTilePassBudget(0, histogram, TileCount) == 0, "retired tiles get a pass for " + context);
+                    }
+                }
+            }
+        }
+    }
+
+    F64 ComputeMeanLuminance(std::vector<Hawk::Math::Vec4> const& image) {
+
+        F64 sum = 0.0;
+        for (auto const& color : image)
+            sum += 0.2126 * color.x + 0.7152 * color.y + 0.0722 * color.z;
+        return sum / std::size(image);
+    }
+
+    void GenerateSphereVolume(VolumeData& volume, uint32_t size) {
+
+        // Ball with the raw intensity of the tissue and bone of the benchmark phantom, 1750 of 4096
+        std::vector<uint16_t> intensity(size_t(size) * size * size);
+        for (uint32_t z = 0; z < size; z++) {
+            for (uint32_t y = 0; y < size; y++) {
+                for (uint32_t x = 0; x < size; x++) {
+                    const auto p = 2.0f * (Hawk::Math::Vec3(F32(x), F32(y), F32(z)) + Hawk::Math::Vec3(0.5f, 0.5f, 0.5f)) / F32(size) - Hawk::Math::Vec3(1.0f, 1.0f, 1.0f);
+                    const F32 t = std::clamp((0.85f - Hawk::Math::Length(p)) / 0.1f, 0.0f, 1.0f);
+                    intensity[(size_t(z) * size + y) * size + x] = static_cast<uint16_t>(65535.0f * t * 1750.0f / 4096.0f);
+                }
+            }
+        }
+        volume.Initialize(size, size, size, std::move(intensity));
+    }
+
+    // Every frame the selected tiles take exactly their budgeted passes and the retired ones keep their samples
+    void TestRendererCPU(RendererCPU::Schedule schedule, char const* name) {
+
+        VolumeData volume;
+        EnvironmentMap environment;
+        TransferFunctionSet functions;
+        MajorantGrid majorants;
+        BlueNoise noise;
+
+        GenerateSphereVolume(volume, VolumeSize);
+        environment.LoadFromFile("content/Textures/qwantani_2k.dds");
+        functions.LoadFromFile("content/TransferFunctions/ManixTransferFunction.json");
+        majorants.Initialize(volume, 0);
+        majorants.Update(functions.Opacity, 256);
+        noise.Initialize(BlueNoise::DefaultSize);
+
+        ThreadPool threadPool(4);
+        RendererCPU renderer(threadPool);
+        renderer.Resize(Width, Height);
+        renderer.SetVolume(&volume);
+        renderer.SetEnvironmentMap(&environment);
+        renderer.SetBlueNoise(&noise);
+        renderer.SetMajorantGrid(&majorants);
+        renderer.SetTransferFunctions(functions, 256);
+        renderer.SetSchedule(schedule);
+
+        const auto dimension = volume.GetDimension();
+        const auto world = ComputeWorldMatrix(dimension.x, dimension.y, dimension.z);
+
+        FrameBuffer frame = {};
+        SetFrameMatrices(frame, world, Hawk::Components::Camera().ToMatrix(), ComputeProjectionMatrix(1.0f, Width, Height));
+        SetFrameBoundingBox(frame, majorants.GetContentMin(), majorants.GetContentMax());
+        SetFrameClipRegion(frame, {}, Hawk::Math::Box(), Hawk::Math::Mat4x4(1.0f));
+        SetFrameLevelOfDetail(frame, 0.0f, 0, 0, 0);
+        frame.StepSize = Hawk::Math::Distance(VolumeBoundingBoxMin, VolumeBoundingBoxMax) / 180;
+        frame.Density = 100.0f;
+        frame.Exposure = 12.0f;
+        frame.TrackingMode = TrackingModeDelta;
+        frame.TransmittanceEstimator = TransmittanceEstimatorRatio;
+        frame.LightSampling = LightSamplingMIS;
+        frame.EnvironmentDimension = Hawk::Math::Vec2u(environment.GetWidth(), environment.GetHeight());
+        frame.MajorantGridDimension = majorants.GetDimension();
+        frame.SampleSequence = SampleSequenceSobol;
+        frame.TileErrorThreshold = TileErrorThreshold;
+        frame.BlueNoiseSize = noise.GetSize();
+        frame.RenderTargetDim = Hawk::Math::Vec2(static_cast<F32>(Width), static_cast<F32>(Height));
+        frame.InvRenderTargetDim = Hawk::Math::Vec2(1.0f, 1.0f) / frame.RenderTargetDim;
+
+        constexpr uint32_t TileCount = (Width / RendererCPU::TileSize) * (Height / RendererCPU::TileSize);
+        uint32_t tileCountMin = TileCount;
+        uint32_t extraPassCount = 0;
+
+        for (uint32_t frameIndex = 0; frameIndex < FrameCount; frameIndex++) {
+            const std::vector<Hawk::Math::Vec4> colorSum = renderer.GetColorSum();
+
+            frame.FrameIndex = frameIndex;
+            renderer.RenderFrame(frame);
+
+            auto const& tiles = renderer.GetTiles();
+            auto const& tilePasses = renderer.GetTilePasses();
+            const auto context = fmt::format("frame {} of {}", frameIndex, name);
+
+            // Samples of every pixel this frame, from the tiles the renderer reports
+            std::vector<uint32_t> expected(size_t(Width) * Height, 0);
+            uint32_t passSum = 0;
+            Check(std::size(tiles) == std::size(tilePasses), "tiles and passes differ in size in " + context);
+            for (size_t index = 0; index < std::size(tiles); index++) {
+                Check(tilePasses[index] >= 1 && tilePasses[index] <= Shading::TilePassCountMax, "pass count out of range in " + context);
+                for (uint32_t y = 0; y < RendererCPU::TileSize; y++)
+                    for (uint32_t x = 0; x < RendererCPU::TileSize; x++)
+                        expected[size_t(((tiles[index] >> 16) & 0xFFFF) * RendererCPU::TileSize + y) * Width + (tiles[index] & 0xFFFF) * RendererCPU::TileSize + x] = tilePasses[index];
+                passSum += tilePasses[index];
+                extraPassCount += tilePasses[index] - 1;
+            }
+            Check(passSum <= TileCount, "frame costs more than one pass per tile in " + context);
+            Check(renderer.GetFrameStatistics().SampleCount == uint64_t(passSum) * RendererCPU::TileSize * RendererCPU::TileSize, "sample count differs from the passes in " + context);
+            Check(renderer.GetActiveTilePassCount() == passSum, "active tile passes differ from the passes in " + context);
+
+            uint32_t mismatchCount = 0;
+            for (size_t index = 0; index < std::size(expected); index++) {
+                const F32 count = frameIndex == 0 ? 0.0f : colorSum[index].w;
+                mismatchCount += renderer.GetColorSum()[index].w != count + F32(expected[index]);
+            }
+            Check(mismatchCount == 0, fmt::format("{} pixels took other samples than their tile passes in {}", mismatchCount, context));
+            tileCountMin = std::min(tileCountMin, static_cast<uint32_t>(std::size(tiles)));
+        }
+
+        // The extra passes add samples of the same image, the mean stays within the noise of the non-adaptive one
+        const F64 meanAdaptive = ComputeMeanLuminance(renderer.GetColorSum());
+        frame.TileErrorThreshold = 0.0f;
+        for (uint32_t frameIndex = 0; frameIndex < FrameCount; frameIndex++) {
+            frame.FrameIndex = frameIndex;
+            renderer.RenderFrame(frame);
+        }
+        const F64 meanReference = ComputeMeanLuminance(renderer.GetColorSum());
+
+        fmt::print("RendererCPU {}: {} of {} tiles left after {} frames, {} extra passes, mean luminance {:.5f} (non-adaptive {:.5f})\n", name, tileCountMin, TileCount, FrameCount, extraPassCount, meanAdaptive, meanReference);
+        Check(std::abs(meanAdaptive - meanReference) <= 0.02 * meanReference, fmt::format("mean luminance differs from the non-adaptive image with {}", name));
+        Check(tileCountMin < TileCount, fmt::format("no tile retires at the default threshold with {}", name));
+        Check(extraPassCount > 0, fmt::format("no tile takes an extra pass with {}", name));
+    }
+}
+
+int main() {
+
+    try {
+        TestTilePassCount();
+        TestTilePassBudget();
+        TestRendererCPU(RendererCPU::ScheduleTile, "tile");
+        TestRendererCPU(RendererCPU::ScheduleWavefront, "wavefront");
+        TestRendererCPU(RendererCPU::SchedulePixel, "pixel");
+    } catch (std::exception const& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (FailureCount > 0) {
+        fmt::print("{} checks failed\n", FailureCount);
+        return EXIT_FAILURE;
+    }
+    fmt::print("All checks passed\n");
+    return EXIT_SUCCESS;
+}